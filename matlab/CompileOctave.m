@@ -19,9 +19,12 @@ NAMES = { ...
 LIB_NAMES = { ...
   'G2lib', ...
   'G2lib_intersect', ...
+  'G2lib_table', ...
   'AABBtree', ...
   'Line',...
   'PolyLine', ...
+  'CurveBinary', ...
+  'CurveIndex', ...
   'Circle', ...
   'Biarc', ...
   'BiarcList', ...
@@ -389,6 +389,759 @@ namespace G2lib {
     min_maxdist_select( x, y, mmDist, *this, candidateList );
   }
 
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtree::intersect(
+    AABBtree const & tree,
+    VecPairIpos    & intersectionList
+  ) const {
+    VecPairPtrBBox iList;
+    this->intersect( tree, iList );
+    intersectionList.clear();
+    intersectionList.reserve( iList.size() );
+    VecPairPtrBBox::const_iterator ip;
+    for ( ip = iList.begin(); ip != iList.end(); ++ip )
+      intersectionList.push_back(
+        PairIpos( ip->first->Ipos(), ip->second->Ipos() )
+      );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtree::self_intersect( VecPairPtrBBox & intersectionList ) const {
+    vector<PtrAABB>::const_iterator c1, c2;
+    for ( c1 = children.begin(); c1 != children.end(); ++c1 )
+      (*c1)->self_intersect( intersectionList );
+    for ( c1 = children.begin(); c1 != children.end(); ++c1 )
+      for ( c2 = c1+1; c2 != children.end(); ++c2 )
+        (*c1)->intersect( **c2, intersectionList );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtree::self_intersect( VecPairIpos & intersectionList ) const {
+    VecPairPtrBBox iList;
+    this->self_intersect( iList );
+    intersectionList.clear();
+    intersectionList.reserve( iList.size() );
+    VecPairPtrBBox::const_iterator ip;
+    for ( ip = iList.begin(); ip != iList.end(); ++ip )
+      intersectionList.push_back(
+        PairIpos( ip->first->Ipos(), ip->second->Ipos() )
+      );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtree::split_pairs(
+    AABBtree const   & tree,
+    size_t             ntasks,
+    vector<PairTree> & tasks
+  ) const {
+    tasks.clear();
+    if ( !tree.pBBox->collision(*pBBox) ) return;
+    PairTree p0 = { this, &tree, false };
+    tasks.push_back( p0 );
+    // each pair is replaced by its overlapping children in the order of
+    // the recursion of `intersect`, until there are enough pairs
+    vector<PairTree> next;
+    bool split = true;
+    while ( split && tasks.size() < ntasks ) {
+      split = false;
+      next.clear();
+      vector<PairTree>::const_iterator ip;
+      for ( ip = tasks.begin(); ip != tasks.end(); ++ip ) {
+        AABBtree const & A = *ip->t1;
+        AABBtree const & B = *ip->t2;
+        vector<PtrAABB>::const_iterator c1, c2;
+        if ( A.children.empty() && B.children.empty() ) {
+          next.push_back( *ip );
+        } else if ( B.children.empty() ) {
+          for ( c1 = A.children.begin(); c1 != A.children.end(); ++c1 ) {
+            if ( !(*c1)->pBBox->collision(*B.pBBox) ) continue;
+            PairTree p = { &B, &**c1, !ip->swap };
+            next.push_back( p );
+          }
+        } else if ( A.children.empty() ) {
+          for ( c2 = B.children.begin(); c2 != B.children.end(); ++c2 ) {
+            if ( !(*c2)->pBBox->collision(*A.pBBox) ) continue;
+            PairTree p = { &A, &**c2, ip->swap };
+            next.push_back( p );
+          }
+        } else {
+          for ( c1 = A.children.begin(); c1 != A.children.end(); ++c1 ) {
+            for ( c2 = B.children.begin(); c2 != B.children.end(); ++c2 ) {
+              if ( !(*c2)->pBBox->collision(*(*c1)->pBBox) ) continue;
+              PairTree p = { &**c1, &**c2, ip->swap };
+              next.push_back( p );
+            }
+          }
+        }
+        split = split || !( A.children.empty() && B.children.empty() );
+      }
+      tasks.swap( next );
+    }
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtree::intersect_parallel(
+    AABBtree const & tree,
+    VecPairPtrBBox & intersectionList,
+    int_type         nthreads
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    if ( nthreads > 1 && !empty() && !tree.empty() ) {
+      vector<PairTree> tasks;
+      this->split_pairs( tree, size_t(16*nthreads), tasks );
+      vector<VecPairPtrBBox> lists( tasks.size() );
+      AABBrunTasks( tasks.size(), nthreads, [&]( size_t k ) {
+        tasks[k].t1->intersect( *tasks[k].t2, lists[k], tasks[k].swap );
+      } );
+      size_t n = intersectionList.size();
+      for ( size_t k = 0; k < lists.size(); ++k ) n += lists[k].size();
+      intersectionList.reserve( n );
+      for ( size_t k = 0; k < lists.size(); ++k )
+        intersectionList.insert( intersectionList.end(), lists[k].begin(), lists[k].end() );
+      return;
+    }
+    #else
+    (void)nthreads;
+    #endif
+    this->intersect( tree, intersectionList );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtree::intersect_parallel(
+    AABBtree const & tree,
+    VecPairIpos    & intersectionList,
+    int_type         nthreads
+  ) const {
+    VecPairPtrBBox iList;
+    this->intersect_parallel( tree, iList, nthreads );
+    intersectionList.clear();
+    intersectionList.reserve( iList.size() );
+    VecPairPtrBBox::const_iterator ip;
+    for ( ip = iList.begin(); ip != iList.end(); ++ip )
+      intersectionList.push_back(
+        PairIpos( ip->first->Ipos(), ip->second->Ipos() )
+      );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtree::min_distance(
+    real_type x,
+    real_type y,
+    VecIpos & candidateList
+  ) const {
+    VecPtrBBox cList;
+    this->min_distance( x, y, cList );
+    candidateList.clear();
+    candidateList.reserve( cList.size() );
+    VecPtrBBox::const_iterator ic;
+    for ( ic = cList.begin(); ic != cList.end(); ++ic )
+      candidateList.push_back( (*ic)->Ipos() );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtree::within_distance(
+    real_type x,
+    real_type y,
+    real_type dst,
+    VecIpos & candidateList
+  ) const {
+    candidateList.clear();
+    if ( empty() ) return;
+    VecPtrBBox cList;
+    min_maxdist_select( x, y, dst, *this, cList );
+    candidateList.reserve( cList.size() );
+    VecPtrBBox::const_iterator ic;
+    for ( ic = cList.begin(); ic != cList.end(); ++ic )
+      candidateList.push_back( (*ic)->Ipos() );
+  }
+
+  /*\
+   |      _        _    ____  ____  _                 _____ _       _
+   |     / \      / \  | __ )| __ )| |_ _ __ ___  ___|  ___| | __ _| |_
+   |    / _ \    / _ \ |  _ \|  _ \| __| '__/ _ \/ _ \ |_  | |/ _` | __|
+   |   / ___ \  / ___ \| |_) | |_) | |_| | |  __/  __/  _| | | (_| | |_
+   |  /_/   \_\/_/   \_\____/|____/ \__|_|  \___|\___|_|   |_|\__,_|\__|
+  \*/
+
+  AABBtreeFlat::AABBtreeFlat()
+  : leaf_size(4)
+  {}
+
+  AABBtreeFlat::~AABBtreeFlat() {
+    clear();
+  }
+
+  void
+  AABBtreeFlat::clear() {
+    nd_xmin.clear(); nd_ymin.clear();
+    nd_xmax.clear(); nd_ymax.clear();
+    nd_first.clear(); nd_num.clear();
+    bb_xmin.clear(); bb_ymin.clear();
+    bb_xmax.clear(); bb_ymax.clear();
+    bb_ipos.clear();
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::build(
+    int_type        nbox,
+    real_type const xmin[],
+    real_type const ymin[],
+    real_type const xmax[],
+    real_type const ymax[]
+  ) {
+    size_t n = size_t(nbox);
+    bb_xmin.assign( xmin, xmin+n );
+    bb_ymin.assign( ymin, ymin+n );
+    bb_xmax.assign( xmax, xmax+n );
+    bb_ymax.assign( ymax, ymax+n );
+    this->build_tree();
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::build_tree() {
+    size_t n = bb_xmin.size();
+
+    nd_xmin.clear(); nd_ymin.clear();
+    nd_xmax.clear(); nd_ymax.clear();
+    nd_first.clear(); nd_num.clear();
+    bb_ipos.clear();
+
+    if ( n == 0 ) return;
+
+    // a binary tree with leaves of at least one box has less than 2n nodes
+    size_t nmax = 2*n;
+    nd_xmin.reserve(nmax); nd_ymin.reserve(nmax);
+    nd_xmax.reserve(nmax); nd_ymax.reserve(nmax);
+    nd_first.reserve(nmax); nd_num.reserve(nmax);
+
+    vector<int_type>  idx(n);
+    vector<real_type> cx(n), cy(n);
+    for ( size_t i = 0; i < n; ++i ) {
+      idx[i] = int_type(i);
+      cx[i]  = (bb_xmin[i]+bb_xmax[i])/2;
+      cy[i]  = (bb_ymin[i]+bb_ymax[i])/2;
+    }
+
+    nd_xmin.push_back(0); nd_ymin.push_back(0);
+    nd_xmax.push_back(0); nd_ymax.push_back(0);
+    nd_first.push_back(0); nd_num.push_back(0);
+    build_node( 0, 0, int_type(n), idx, cx, cy );
+
+    // store the boxes in leaf order
+    vector<real_type> tmp(n);
+    for ( size_t i = 0; i < n; ++i ) tmp[i] = bb_xmin[size_t(idx[i])];
+    bb_xmin.swap(tmp);
+    for ( size_t i = 0; i < n; ++i ) tmp[i] = bb_ymin[size_t(idx[i])];
+    bb_ymin.swap(tmp);
+    for ( size_t i = 0; i < n; ++i ) tmp[i] = bb_xmax[size_t(idx[i])];
+    bb_xmax.swap(tmp);
+    for ( size_t i = 0; i < n; ++i ) tmp[i] = bb_ymax[size_t(idx[i])];
+    bb_ymax.swap(tmp);
+    bb_ipos.swap(idx);
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  // comparison of the box centers along x or y, used for the median split
+  class AABBtreeFlat_less {
+    real_type const * c;
+  public:
+    explicit AABBtreeFlat_less( real_type const * _c ) : c(_c) {}
+    bool
+    operator () ( int_type i, int_type j ) const
+    { return c[i] < c[j]; }
+  };
+
+  // true if the box center is in the left part of the binned split
+  class AABBtreeFlat_left {
+    real_type const * c;
+    real_type         c0, scale;
+    int_type          nbin, ibin;
+  public:
+    AABBtreeFlat_left(
+      real_type const * _c,
+      real_type         _c0,
+      real_type         _scale,
+      int_type          _nbin,
+      int_type          _ibin
+    )
+    : c(_c), c0(_c0), scale(_scale), nbin(_nbin), ibin(_ibin)
+    {}
+    bool
+    operator () ( int_type i ) const {
+      int_type b = int_type( (c[i]-c0)*scale );
+      if ( b >= nbin ) b = nbin-1;
+      return b <= ibin;
+    }
+  };
+
+  void
+  AABBtreeFlat::build_node(
+    int_type           inode,
+    int_type           ibegin,
+    int_type           iend,
+    vector<int_type> & idx,
+    vector<real_type>& cx,
+    vector<real_type>& cy
+  ) {
+
+    size_t nd = size_t(inode);
+
+    // bbox of the node and of the centers of the boxes
+    real_type xmin, ymin, xmax, ymax;
+    real_type cxmin, cymin, cxmax, cymax;
+    {
+      size_t k = size_t(idx[size_t(ibegin)]);
+      xmin  = bb_xmin[k]; ymin  = bb_ymin[k];
+      xmax  = bb_xmax[k]; ymax  = bb_ymax[k];
+      cxmin = cxmax = cx[k];
+      cymin = cymax = cy[k];
+    }
+    for ( int_type i = ibegin+1; i < iend; ++i ) {
+      size_t k = size_t(idx[size_t(i)]);
+      if ( bb_xmin[k] < xmin ) xmin = bb_xmin[k];
+      if ( bb_ymin[k] < ymin ) ymin = bb_ymin[k];
+      if ( bb_xmax[k] > xmax ) xmax = bb_xmax[k];
+      if ( bb_ymax[k] > ymax ) ymax = bb_ymax[k];
+      if      ( cx[k] < cxmin ) cxmin = cx[k];
+      else if ( cx[k] > cxmax ) cxmax = cx[k];
+      if      ( cy[k] < cymin ) cymin = cy[k];
+      else if ( cy[k] > cymax ) cymax = cy[k];
+    }
+    nd_xmin[nd] = xmin; nd_ymin[nd] = ymin;
+    nd_xmax[nd] = xmax; nd_ymax[nd] = ymax;
+
+    int_type num = iend - ibegin;
+    if ( num <= leaf_size ) {
+      nd_first[nd] = ibegin;
+      nd_num[nd]   = num;
+      return;
+    }
+
+    // split along the largest extension of the centers
+    bool              along_x = (cxmax-cxmin) >= (cymax-cymin);
+    real_type const * c       = along_x ? &cx.front() : &cy.front();
+    real_type         c0      = along_x ? cxmin : cymin;
+    real_type         ext     = along_x ? cxmax-cxmin : cymax-cymin;
+
+    int_type * pb = &idx.front() + ibegin;
+    int_type * pe = &idx.front() + iend;
+    int_type * pm = pb;
+
+    if ( ext > 0 ) {
+      // binned surface area heuristic, in 2D the half perimeter is used
+      // in place of the area: it does not vanish for the flat boxes
+      // of axis aligned segments
+      int_type const NBIN = 16;
+      int_type  cnt[NBIN];
+      real_type bxmin[NBIN], bymin[NBIN], bxmax[NBIN], bymax[NBIN];
+      for ( int_type b = 0; b < NBIN; ++b ) {
+        cnt[b]   = 0;
+        bxmin[b] = bymin[b] =  numeric_limits<real_type>::infinity();
+        bxmax[b] = bymax[b] = -numeric_limits<real_type>::infinity();
+      }
+      real_type scale = NBIN/ext;
+      for ( int_type * p = pb; p != pe; ++p ) {
+        size_t   k = size_t(*p);
+        int_type b = int_type( (c[k]-c0)*scale );
+        if ( b >= NBIN ) b = NBIN-1;
+        ++cnt[b];
+        bxmin[b] = min( bxmin[b], bb_xmin[k] );
+        bymin[b] = min( bymin[b], bb_ymin[k] );
+        bxmax[b] = max( bxmax[b], bb_xmax[k] );
+        bymax[b] = max( bymax[b], bb_ymax[k] );
+      }
+      // sweep from the right to accumulate the cost of the right part
+      real_type rcost[NBIN];
+      {
+        real_type x0 =  numeric_limits<real_type>::infinity(), y0 = x0;
+        real_type x1 = -numeric_limits<real_type>::infinity(), y1 = x1;
+        int_type  n  = 0;
+        for ( int_type b = NBIN-1; b > 0; --b ) {
+          x0 = min( x0, bxmin[b] ); y0 = min( y0, bymin[b] );
+          x1 = max( x1, bxmax[b] ); y1 = max( y1, bymax[b] );
+          n += cnt[b];
+          rcost[b] = n > 0 ? n*( (x1-x0) + (y1-y0) ) : 0;
+        }
+      }
+      int_type  best      = -1;
+      real_type best_cost = numeric_limits<real_type>::infinity();
+      {
+        real_type x0 =  numeric_limits<real_type>::infinity(), y0 = x0;
+        real_type x1 = -numeric_limits<real_type>::infinity(), y1 = x1;
+        int_type  n  = 0;
+        for ( int_type b = 0; b < NBIN-1; ++b ) {
+          x0 = min( x0, bxmin[b] ); y0 = min( y0, bymin[b] );
+          x1 = max( x1, bxmax[b] ); y1 = max( y1, bymax[b] );
+          n += cnt[b];
+          if ( n == 0 || n == num ) continue;
+          real_type cost = n*( (x1-x0) + (y1-y0) ) + rcost[b+1];
+          if ( cost < best_cost ) { best_cost = cost; best = b; }
+        }
+      }
+      if ( best >= 0 )
+        pm = std::partition( pb, pe, AABBtreeFlat_left( c, c0, scale, NBIN, best ) );
+    }
+
+    // degenerate split, use the median
+    if ( pm == pb || pm == pe ) {
+      pm = pb + num/2;
+      std::nth_element( pb, pm, pe, AABBtreeFlat_less( c ) );
+    }
+
+    int_type ichild = int_type(nd_first.size());
+    nd_first[nd] = ichild;
+    nd_num[nd]   = 0;
+    for ( int_type k = 0; k < 2; ++k ) {
+      nd_xmin.push_back(0); nd_ymin.push_back(0);
+      nd_xmax.push_back(0); nd_ymax.push_back(0);
+      nd_first.push_back(0); nd_num.push_back(0);
+    }
+    int_type imid = int_type(pm - &idx.front());
+    build_node( ichild,   ibegin, imid, idx, cx, cy );
+    build_node( ichild+1, imid,   iend, idx, cx, cy );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::print( ostream_type & stream ) const {
+    if ( empty() ) {
+      stream << "[EMPTY AABB tree]\n";
+      return;
+    }
+    vector<PairIpos> stack; // (node,level)
+    stack.push_back( PairIpos(0,0) );
+    while ( !stack.empty() ) {
+      size_t   i     = size_t(stack.back().first);
+      int_type level = stack.back().second;
+      stack.pop_back();
+      stream
+        << "BBOX xmin = " << setw(12) << nd_xmin[i]
+        << " ymin = "     << setw(12) << nd_ymin[i]
+        << " xmax = "     << setw(12) << nd_xmax[i]
+        << " ymax = "     << setw(12) << nd_ymax[i]
+        << " level = "    << level;
+      if ( nd_num[i] > 0 ) {
+        stream << " leaf [";
+        for ( int_type k = 0; k < nd_num[i]; ++k )
+          stream << ' ' << bb_ipos[size_t(nd_first[i]+k)];
+        stream << " ]";
+      } else {
+        stack.push_back( PairIpos(nd_first[i]+1,level+1) );
+        stack.push_back( PairIpos(nd_first[i],level+1) );
+      }
+      stream << '\n';
+    }
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::intersect(
+    AABBtreeFlat const & tree,
+    VecPairIpos        & intersectionList
+  ) const {
+    if ( empty() || tree.empty() ) return;
+    this->intersect_pair( tree, PairIpos(0,0), intersectionList );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::intersect_pair(
+    AABBtreeFlat const & tree,
+    PairIpos const     & ij,
+    VecPairIpos        & intersectionList
+  ) const {
+    vector<PairIpos> stack;
+    stack.reserve(64);
+    stack.push_back( ij );
+    while ( !stack.empty() ) {
+      int_type i = stack.back().first;
+      int_type j = stack.back().second;
+      stack.pop_back();
+      if ( !node_overlap( i, tree, j ) ) continue;
+      if ( is_leaf(i) && tree.is_leaf(j) ) {
+        int_type ie = nd_first[size_t(i)]+nd_num[size_t(i)];
+        int_type je = tree.nd_first[size_t(j)]+tree.nd_num[size_t(j)];
+        for ( int_type ii = nd_first[size_t(i)]; ii < ie; ++ii )
+          for ( int_type jj = tree.nd_first[size_t(j)]; jj < je; ++jj )
+            if ( box_overlap( ii, tree, jj ) )
+              intersectionList.push_back(
+                PairIpos( bb_ipos[size_t(ii)], tree.bb_ipos[size_t(jj)] )
+              );
+      } else if ( descend_first( i, tree, j ) ) {
+        int_type c = nd_first[size_t(i)];
+        stack.push_back( PairIpos(c+1,j) );
+        stack.push_back( PairIpos(c,j) );
+      } else {
+        int_type c = tree.nd_first[size_t(j)];
+        stack.push_back( PairIpos(i,c+1) );
+        stack.push_back( PairIpos(i,c) );
+      }
+    }
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::self_intersect( VecPairIpos & intersectionList ) const {
+    for ( int_type i = 0; i < num_nodes(); ++i ) {
+      int_type c = nd_first[size_t(i)];
+      if ( is_leaf(i) ) {
+        int_type ie = c+nd_num[size_t(i)];
+        for ( int_type ii = c; ii < ie; ++ii )
+          for ( int_type jj = ii+1; jj < ie; ++jj )
+            if ( box_overlap( ii, *this, jj ) )
+              intersectionList.push_back(
+                PairIpos( bb_ipos[size_t(ii)], bb_ipos[size_t(jj)] )
+              );
+      } else {
+        this->intersect_pair( *this, PairIpos(c,c+1), intersectionList );
+      }
+    }
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::split_pairs(
+    AABBtreeFlat const & tree,
+    size_t               ntasks,
+    vector<PairIpos>   & tasks
+  ) const {
+    tasks.clear();
+    if ( !node_overlap( 0, tree, 0 ) ) return;
+    tasks.push_back( PairIpos(0,0) );
+    // each pair is replaced by its overlapping children in the order of
+    // the traversal of `intersect`, until there are enough pairs
+    vector<PairIpos> next;
+    bool split = true;
+    while ( split && tasks.size() < ntasks ) {
+      split = false;
+      next.clear();
+      vector<PairIpos>::const_iterator ip;
+      for ( ip = tasks.begin(); ip != tasks.end(); ++ip ) {
+        int_type i = ip->first;
+        int_type j = ip->second;
+        if ( is_leaf(i) && tree.is_leaf(j) ) {
+          next.push_back( *ip );
+          continue;
+        }
+        split = true;
+        if ( descend_first( i, tree, j ) ) {
+          int_type c = nd_first[size_t(i)];
+          if ( node_overlap( c,   tree, j ) ) next.push_back( PairIpos(c,j) );
+          if ( node_overlap( c+1, tree, j ) ) next.push_back( PairIpos(c+1,j) );
+        } else {
+          int_type c = tree.nd_first[size_t(j)];
+          if ( node_overlap( i, tree, c   ) ) next.push_back( PairIpos(i,c) );
+          if ( node_overlap( i, tree, c+1 ) ) next.push_back( PairIpos(i,c+1) );
+        }
+      }
+      tasks.swap( next );
+    }
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::intersect_parallel(
+    AABBtreeFlat const & tree,
+    VecPairIpos        & intersectionList,
+    int_type             nthreads
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    if ( nthreads > 1 && !empty() && !tree.empty() ) {
+      vector<PairIpos> tasks;
+      this->split_pairs( tree, size_t(16*nthreads), tasks );
+      vector<VecPairIpos> lists( tasks.size() );
+      AABBrunTasks( tasks.size(), nthreads, [&]( size_t k ) {
+        this->intersect_pair( tree, tasks[k], lists[k] );
+      } );
+      size_t n = intersectionList.size();
+      for ( size_t k = 0; k < lists.size(); ++k ) n += lists[k].size();
+      intersectionList.reserve( n );
+      for ( size_t k = 0; k < lists.size(); ++k )
+        intersectionList.insert( intersectionList.end(), lists[k].begin(), lists[k].end() );
+      return;
+    }
+    #else
+    (void)nthreads;
+    #endif
+    this->intersect( tree, intersectionList );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::min_distance(
+    real_type x,
+    real_type y,
+    VecIpos & candidateList
+  ) const {
+    vector<int_type> stack;
+    stack.reserve(64);
+    this->min_distance(
+      x, y, numeric_limits<real_type>::infinity(), candidateList, stack
+    );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::min_distance(
+    real_type          x,
+    real_type          y,
+    real_type          dmax,
+    VecIpos          & candidateList,
+    vector<int_type> & stack
+  ) const {
+    candidateList.clear();
+    if ( empty() ) return;
+
+    // same selection of AABBtree::min_distance working with squared
+    // distances: first the minimum over the boxes of the maximum
+    // distance, then all the boxes closer than this value
+    stack.clear();
+
+    real_type mmDist = dmax*dmax;
+    stack.push_back(0);
+    while ( !stack.empty() ) {
+      size_t i = size_t(stack.back());
+      stack.pop_back();
+      real_type dx = max( max( nd_xmin[i]-x, x-nd_xmax[i] ), real_type(0) );
+      real_type dy = max( max( nd_ymin[i]-y, y-nd_ymax[i] ), real_type(0) );
+      if ( dx*dx+dy*dy > mmDist ) continue;
+      if ( nd_num[i] > 0 ) {
+        int_type ie = nd_first[i]+nd_num[i];
+        for ( int_type k = nd_first[i]; k < ie; ++k ) {
+          size_t    kk = size_t(k);
+          real_type mx = max( abs(x-bb_xmin[kk]), abs(x-bb_xmax[kk]) );
+          real_type my = max( abs(y-bb_ymin[kk]), abs(y-bb_ymax[kk]) );
+          real_type d  = mx*mx+my*my;
+          if ( d < mmDist ) mmDist = d;
+        }
+      } else {
+        stack.push_back( nd_first[i]+1 );
+        stack.push_back( nd_first[i] );
+      }
+    }
+
+    stack.push_back(0);
+    while ( !stack.empty() ) {
+      size_t i = size_t(stack.back());
+      stack.pop_back();
+      real_type dx = max( max( nd_xmin[i]-x, x-nd_xmax[i] ), real_type(0) );
+      real_type dy = max( max( nd_ymin[i]-y, y-nd_ymax[i] ), real_type(0) );
+      if ( dx*dx+dy*dy > mmDist ) continue;
+      if ( nd_num[i] > 0 ) {
+        int_type ie = nd_first[i]+nd_num[i];
+        for ( int_type k = nd_first[i]; k < ie; ++k ) {
+          size_t kk = size_t(k);
+          dx = max( max( bb_xmin[kk]-x, x-bb_xmax[kk] ), real_type(0) );
+          dy = max( max( bb_ymin[kk]-y, y-bb_ymax[kk] ), real_type(0) );
+          if ( dx*dx+dy*dy <= mmDist ) candidateList.push_back( bb_ipos[kk] );
+        }
+      } else {
+        stack.push_back( nd_first[i]+1 );
+        stack.push_back( nd_first[i] );
+      }
+    }
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  AABBtreeFlat::within_distance(
+    real_type x,
+    real_type y,
+    real_type dst,
+    VecIpos & candidateList
+  ) const {
+    candidateList.clear();
+    if ( empty() ) return;
+    vector<int_type> stack;
+    stack.reserve(64);
+    real_type dst2 = dst*dst;
+    stack.push_back(0);
+    while ( !stack.empty() ) {
+      size_t i = size_t(stack.back());
+      stack.pop_back();
+      real_type dx = max( max( nd_xmin[i]-x, x-nd_xmax[i] ), real_type(0) );
+      real_type dy = max( max( nd_ymin[i]-y, y-nd_ymax[i] ), real_type(0) );
+      if ( dx*dx+dy*dy > dst2 ) continue;
+      if ( nd_num[i] > 0 ) {
+        int_type ie = nd_first[i]+nd_num[i];
+        for ( int_type k = nd_first[i]; k < ie; ++k ) {
+          size_t kk = size_t(k);
+          dx = max( max( bb_xmin[kk]-x, x-bb_xmax[kk] ), real_type(0) );
+          dy = max( max( bb_ymin[kk]-y, y-bb_ymax[kk] ), real_type(0) );
+          if ( dx*dx+dy*dy <= dst2 ) candidateList.push_back( bb_ipos[kk] );
+        }
+      } else {
+        stack.push_back( nd_first[i]+1 );
+        stack.push_back( nd_first[i] );
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  AABBtreeFlat::within_box(
+    real_type xmin,
+    real_type ymin,
+    real_type xmax,
+    real_type ymax,
+    VecIpos & candidateList
+  ) const {
+    candidateList.clear();
+    if ( empty() ) return;
+    vector<int_type> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while ( !stack.empty() ) {
+      size_t i = size_t(stack.back());
+      stack.pop_back();
+      if ( nd_xmin[i] > xmax || nd_xmax[i] < xmin ||
+           nd_ymin[i] > ymax || nd_ymax[i] < ymin ) continue;
+      if ( nd_num[i] > 0 ) {
+        int_type ie = nd_first[i]+nd_num[i];
+        for ( int_type k = nd_first[i]; k < ie; ++k ) {
+          size_t kk = size_t(k);
+          if ( bb_xmin[kk] <= xmax && bb_xmax[kk] >= xmin &&
+               bb_ymin[kk] <= ymax && bb_ymax[kk] >= ymin )
+            candidateList.push_back( bb_ipos[kk] );
+        }
+      } else {
+        stack.push_back( nd_first[i]+1 );
+        stack.push_back( nd_first[i] );
+      }
+    }
+  }
+
 }
 
 ///
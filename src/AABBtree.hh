@@ -35,9 +35,14 @@
 #include <vector>
 #include <iomanip>
 #include <utility> // pair
+#include <algorithm>
+#include <queue>
+#include <functional> // greater
 
 #ifdef G2LIB_USE_CXX11
 #include <memory>  // shared_ptr
+#include <atomic>
+#include <exception>
 #endif
 
 namespace G2lib {
@@ -174,6 +179,60 @@ namespace G2lib {
    |   / ___ \  / ___ \| |_) | |_) | |_| | |  __/  __/
    |  /_/   \_\/_/   \_\____/|____/ \__|_|  \___|\___|
   \*/
+  //! collect the first `k` objects found by `best_first` of the AABB trees
+  class NearestObjects {
+    int_type                            k;
+    vector<pair<real_type,int_type> > * res;
+  public:
+    NearestObjects( int_type _k, vector<pair<real_type,int_type> > * _res )
+    : k(_k), res(_res)
+    {}
+
+    bool
+    operator () ( real_type d, int_type ipos ) const {
+      res->push_back( pair<real_type,int_type>( d, ipos ) );
+      return int_type(res->size()) < k;
+    }
+  };
+
+  //! stop condition of the serial traversals: never stop
+  class AABBnoStop {
+  public:
+    bool operator () () const { return false; }
+  };
+
+  #ifdef G2LIB_USE_CXX11
+  /*!
+   * Run `task(k)` for `k = 0, 1, ..., ntasks-1` on `nthreads` threads.
+   * Each thread takes the next task from a shared counter, so threads
+   * that finish early take the tasks left by the slower ones.
+   * The first exception thrown by a task is rethrown after the join.
+   */
+  template <typename TASK_fun>
+  void
+  AABBrunTasks( size_t ntasks, int_type nthreads, TASK_fun const & task ) {
+    size_t nt = size_t(nthreads);
+    if ( nt > ntasks ) nt = ntasks;
+    std::atomic<size_t>        next(0);
+    vector<std::exception_ptr> errs( nt );
+    vector<std::thread>        workers;
+    workers.reserve( nt );
+    for ( size_t t = 0; t < nt; ++t ) {
+      std::exception_ptr * perr = &errs[t];
+      workers.push_back( std::thread( [&next,&task,ntasks,perr] {
+        try {
+          for ( size_t k = next++; k < ntasks; k = next++ ) task( k );
+        } catch ( ... ) {
+          *perr = std::current_exception();
+        }
+      } ) );
+    }
+    for ( size_t t = 0; t < nt; ++t ) workers[t].join();
+    for ( size_t t = 0; t < nt; ++t )
+      if ( errs[t] ) std::rethrow_exception( errs[t] );
+  }
+  #endif
+
   //! Class to manage AABB tree
   class AABBtree {
   public:
@@ -186,9 +245,12 @@ namespace G2lib {
     typedef AABBtree *             PtrAABB;
   #endif
 
-  typedef pair<PtrBBox,PtrBBox> PairPtrBBox;
-  typedef vector<PtrBBox>       VecPtrBBox;
-  typedef vector<PairPtrBBox>   VecPairPtrBBox;
+  typedef pair<PtrBBox,PtrBBox>   PairPtrBBox;
+  typedef vector<PtrBBox>         VecPtrBBox;
+  typedef vector<PairPtrBBox>     VecPairPtrBBox;
+  typedef pair<int_type,int_type> PairIpos;
+  typedef vector<int_type>        VecIpos;
+  typedef vector<PairIpos>        VecPairIpos;
 
   private:
 
@@ -198,6 +260,94 @@ namespace G2lib {
 
     AABBtree( AABBtree const & tree );
 
+    // a pair of subtrees of the dual traversal,
+    // `swap` as the argument `swap_tree` of `intersect`
+    class PairTree {
+    public:
+      AABBtree const * t1;
+      AABBtree const * t2;
+      bool             swap;
+    };
+
+    // split the dual traversal of `intersect` and `collision` in about
+    // `ntasks` pairs of overlapping subtrees, in the order of the serial
+    // traversal (the results of the pairs, concatenated, are the serial ones)
+    void
+    split_pairs(
+      AABBtree const   & tree,
+      size_t             ntasks,
+      vector<PairTree> & tasks
+    ) const;
+
+    // `collision` giving up (returning false) as soon as `stop()` is true
+    template <typename COLLISION_fun, typename STOP_fun>
+    bool
+    collision_stop(
+      AABBtree const & tree,
+      COLLISION_fun  & ifun,
+      bool             swap_tree,
+      STOP_fun const & stop
+    ) const {
+
+      if ( stop() ) return false;
+
+      // check bbox with
+      if ( !tree.pBBox->collision(*pBBox) ) return false;
+
+      int icase = (children.empty() ? 0 : 1) +
+                  (tree.children.empty()? 0 : 2);
+
+      switch ( icase ) {
+      case 0: // both leaf, use GeomPrimitive intersection algorithm
+        if ( swap_tree ) return ifun( tree.pBBox, pBBox );
+        else             return ifun( pBBox, tree.pBBox );
+      case 1: // first is a tree, second is a leaf
+        { typename vector<PtrAABB>::const_iterator it;
+          for ( it = children.begin(); it != children.end(); ++it )
+            if ( tree.collision_stop( **it, ifun, !swap_tree, stop ) )
+              return true;
+        }
+        break;
+      case 2: // first leaf, second is a tree
+        { typename vector<PtrAABB>::const_iterator it;
+          for ( it = tree.children.begin();
+                it != tree.children.end(); ++it )
+            if ( this->collision_stop( **it, ifun, swap_tree, stop ) )
+              return true;
+        }
+        break;
+      case 3: // first is a tree, second is a tree
+        { typename vector<PtrAABB>::const_iterator c1;
+          typename vector<PtrAABB>::const_iterator c2;
+          for ( c1 = children.begin(); c1 != children.end(); ++c1 )
+            for ( c2 = tree.children.begin();
+                  c2 != tree.children.end(); ++c2 )
+              if ( (*c1)->collision_stop( **c2, ifun, swap_tree, stop ) )
+                return true;
+        }
+        break;
+      }
+      return false;
+    }
+
+    // entry of the priority queue of `best_first`:
+    // a node or (`node == nullptr`) the object `ipos`
+    class NearestItem {
+    public:
+      real_type        d;
+      AABBtree const * node;
+      int_type         ipos;
+
+      NearestItem( real_type _d, AABBtree const * _node, int_type _ipos )
+      : d(_d), node(_node), ipos(_ipos)
+      {}
+
+      // reversed, the top of the queue is the nearest
+      bool
+      operator < ( NearestItem const & rhs ) const
+      { return d > rhs.d; }
+    };
+
     /*!
      * Compute the minimum of the maximum distance
      * between a point
@@ -277,44 +427,44 @@ namespace G2lib {
       COLLISION_fun    ifun,
       bool             swap_tree = false
     ) const {
+      return collision_stop( tree, ifun, swap_tree, AABBnoStop() );
+    }
 
-      // check bbox with
-      if ( !tree.pBBox->collision(*pBBox) ) return false;
-
-      int icase = (children.empty() ? 0 : 1) +
-                  (tree.children.empty()? 0 : 2);
-
-      switch ( icase ) {
-      case 0: // both leaf, use GeomPrimitive intersection algorithm
-        if ( swap_tree ) return ifun( tree.pBBox, pBBox );
-        else             return ifun( pBBox, tree.pBBox );
-      case 1: // first is a tree, second is a leaf
-        { typename vector<PtrAABB>::const_iterator it;
-          for ( it = children.begin(); it != children.end(); ++it )
-            if ( tree.collision( **it, ifun, !swap_tree ) )
-              return true;
-        }
-        break;
-      case 2: // first leaf, second is a tree
-        { typename vector<PtrAABB>::const_iterator it;
-          for ( it = tree.children.begin();
-                it != tree.children.end(); ++it )
-            if ( this->collision( **it, ifun, swap_tree ) )
-              return true;
-        }
-        break;
-      case 3: // first is a tree, second is a tree
-        { typename vector<PtrAABB>::const_iterator c1;
-          typename vector<PtrAABB>::const_iterator c2;
-          for ( c1 = children.begin(); c1 != children.end(); ++c1 )
-            for ( c2 = tree.children.begin();
-                  c2 != tree.children.end(); ++c2 )
-              if ( (*c1)->collision( **c2, ifun, swap_tree ) )
-                return true;
-        }
-        break;
+    /*!
+     * As `collision` but the traversal is split among `nthreads`
+     * threads.  The pairs of overlapping subtrees near the roots are
+     * the tasks taken by the threads; the first thread that finds a
+     * collision stops all the others.
+     * `ifun` is copied in each thread and must be safe to call
+     * concurrently (the collision functions of the curves are).
+     */
+    template <typename COLLISION_fun>
+    bool
+    collision_parallel(
+      AABBtree const & tree,
+      COLLISION_fun    ifun,
+      int_type         nthreads
+    ) const {
+      #ifdef G2LIB_USE_CXX11
+      if ( nthreads > 1 && !empty() && !tree.empty() ) {
+        vector<PairTree> tasks;
+        this->split_pairs( tree, size_t(16*nthreads), tasks );
+        std::atomic<bool> found(false);
+        AABBrunTasks( tasks.size(), nthreads, [&]( size_t k ) {
+          if ( found.load( std::memory_order_relaxed ) ) return;
+          COLLISION_fun f( ifun );
+          PairTree const & p = tasks[k];
+          if ( p.t1->collision_stop(
+                 *p.t2, f, p.swap,
+                 [&found]() { return found.load( std::memory_order_relaxed ); }
+               ) ) found = true;
+        } );
+        return found;
       }
-      return false;
+      #else
+      (void)nthreads;
+      #endif
+      return collision( tree, ifun );
     }
 
     /*!
@@ -333,6 +483,60 @@ namespace G2lib {
       bool             swap_tree = false
     ) const;
 
+    //! as `intersect` but returns the pairs of `Ipos()` of the overlapping bbox
+    void
+    intersect(
+      AABBtree const & tree,
+      VecPairIpos    & intersectionList
+    ) const;
+
+    /*!
+     * As `intersect` but the traversal is split among `nthreads` threads.
+     * Each pair of subtrees taken by a thread fills its own list and the
+     * lists are appended in order: the result is the one of `intersect`.
+     */
+    void
+    intersect_parallel(
+      AABBtree const & tree,
+      VecPairPtrBBox & intersectionList,
+      int_type         nthreads
+    ) const;
+
+    //! as `intersect_parallel` but returns the pairs of `Ipos()` of the overlapping bbox
+    void
+    intersect_parallel(
+      AABBtree const & tree,
+      VecPairIpos    & intersectionList,
+      int_type         nthreads
+    ) const;
+
+    /*!
+     * Check if two bbox of the tree collide (self traversal):
+     * `ifun( ptr1, ptr2 )` is called for the pairs of distinct
+     * overlapping bbox, each unordered pair once, until it returns true.
+     * The pairs that are not a collision (e.g. adjacent pieces of the
+     * curve) must be rejected by `ifun`.
+     */
+    template <typename COLLISION_fun>
+    bool
+    self_collision( COLLISION_fun ifun ) const {
+      typename vector<PtrAABB>::const_iterator c1, c2;
+      for ( c1 = children.begin(); c1 != children.end(); ++c1 )
+        if ( (*c1)->self_collision( ifun ) ) return true;
+      for ( c1 = children.begin(); c1 != children.end(); ++c1 )
+        for ( c2 = c1+1; c2 != children.end(); ++c2 )
+          if ( (*c1)->collision( **c2, ifun ) ) return true;
+      return false;
+    }
+
+    //! the pairs of distinct overlapping bbox of the tree, each unordered pair once
+    void
+    self_intersect( VecPairPtrBBox & intersectionList ) const;
+
+    //! as `self_intersect` but returns the pairs of `Ipos()` of the overlapping bbox
+    void
+    self_intersect( VecPairIpos & intersectionList ) const;
+
     void
     min_distance(
       real_type    x,
@@ -340,6 +544,557 @@ namespace G2lib {
       VecPtrBBox & candidateList
     ) const;
 
+    //! as `min_distance` but returns the `Ipos()` of the candidate bbox
+    void
+    min_distance(
+      real_type x,
+      real_type y,
+      VecIpos & candidateList
+    ) const;
+
+    //! select the `Ipos()` of the bbox with distance from `(x,y)` not greater than `dst`
+    void
+    within_distance(
+      real_type x,
+      real_type y,
+      real_type dst,
+      VecIpos & candidateList
+    ) const;
+
+    //! best first search of the objects nearest to `(x,y)`, as `AABBtreeFlat::best_first`
+    template <typename DIST_fun, typename FOUND_fun>
+    void
+    best_first(
+      real_type x,
+      real_type y,
+      real_type dmax,
+      DIST_fun  dst,
+      FOUND_fun found
+    ) const {
+      if ( empty() ) return;
+      std::priority_queue<NearestItem> Q;
+      Q.push( NearestItem( pBBox->distance( x, y ), this, 0 ) );
+      while ( !Q.empty() ) {
+        NearestItem I = Q.top();
+        Q.pop();
+        if ( I.d > dmax ) break;
+        if ( I.node == nullptr ) {
+          if ( !found( I.d, I.ipos ) ) return;
+        } else if ( I.node->children.empty() ) {
+          int_type  ipos = I.node->pBBox->Ipos();
+          real_type d    = dst( ipos );
+          if ( d <= dmax && d < std::numeric_limits<real_type>::infinity() )
+            Q.push( NearestItem( d, nullptr, ipos ) );
+        } else {
+          typename vector<PtrAABB>::const_iterator it;
+          for ( it = I.node->children.begin(); it != I.node->children.end(); ++it ) {
+            real_type d = (*it)->pBBox->distance( x, y );
+            if ( d <= dmax ) Q.push( NearestItem( d, &(**it), 0 ) );
+          }
+        }
+      }
+    }
+
+    //! the (at most) `k` objects nearest to `(x,y)`, as `AABBtreeFlat::nearest`
+    template <typename DIST_fun>
+    void
+    nearest(
+      real_type                           x,
+      real_type                           y,
+      int_type                            k,
+      real_type                           dmax,
+      DIST_fun                            dst,
+      vector<pair<real_type,int_type> > & res
+    ) const {
+      res.clear();
+      if ( k > 0 ) best_first( x, y, dmax, dst, NearestObjects( k, &res ) );
+    }
+
+  };
+
+  /*\
+   |      _        _    ____  ____  _                 _____ _       _
+   |     / \      / \  | __ )| __ )| |_ _ __ ___  ___|  ___| | __ _| |_
+   |    / _ \    / _ \ |  _ \|  _ \| __| '__/ _ \/ _ \ |_  | |/ _` | __|
+   |   / ___ \  / ___ \| |_) | |_) | |_| | |  __/  __/  _| | | (_| | |_
+   |  /_/   \_\/_/   \_\____/|____/ \__|_|  \___|\___|_|   |_|\__,_|\__|
+  \*/
+  /*!
+   * AABB tree stored in contiguous arrays.
+   *
+   * Nodes and boxes are kept in structure of arrays layout and the
+   * children of a node are addressed by index, so the whole tree is
+   * a handful of vectors: no allocation per node or per box, and the
+   * traversal does not chase pointers.
+   * The build is top-down with a binned SAH split (median split as
+   * fallback) and leaves holding up to `max_leaf_size()` boxes.
+   * The box `i` passed to `build` is reported back as `i`
+   * (the same role of `BBox::Ipos()` for `AABBtree`).
+   */
+  class AABBtreeFlat {
+    friend class CurveBinary; // the arrays are saved as they are
+  public:
+
+    typedef AABBtree::PairIpos    PairIpos;
+    typedef AABBtree::VecIpos     VecIpos;
+    typedef AABBtree::VecPairIpos VecPairIpos;
+
+  private:
+
+    // bounding box of the nodes, node 0 is the root
+    vector<real_type> nd_xmin, nd_ymin, nd_xmax, nd_ymax;
+    // internal node: children are `nd_first[i]` and `nd_first[i]+1`
+    // leaf:          boxes `nd_first[i]`, ..., `nd_first[i]+nd_num[i]-1`
+    vector<int_type>  nd_first, nd_num;
+
+    // boxes sorted by leaf, `bb_ipos` is the position in the input
+    vector<real_type> bb_xmin, bb_ymin, bb_xmax, bb_ymax;
+    vector<int_type>  bb_ipos;
+
+    int_type leaf_size;
+
+    bool
+    is_leaf( int_type i ) const
+    { return nd_num[size_t(i)] > 0; }
+
+    bool
+    node_overlap(
+      int_type             i,
+      AABBtreeFlat const & tree,
+      int_type             j
+    ) const {
+      size_t ii = size_t(i);
+      size_t jj = size_t(j);
+      return !( ( tree.nd_xmin[jj] > nd_xmax[ii] ) ||
+                ( tree.nd_xmax[jj] < nd_xmin[ii] ) ||
+                ( tree.nd_ymin[jj] > nd_ymax[ii] ) ||
+                ( tree.nd_ymax[jj] < nd_ymin[ii] ) );
+    }
+
+    bool
+    box_overlap(
+      int_type             i,
+      AABBtreeFlat const & tree,
+      int_type             j
+    ) const {
+      size_t ii = size_t(i);
+      size_t jj = size_t(j);
+      return !( ( tree.bb_xmin[jj] > bb_xmax[ii] ) ||
+                ( tree.bb_xmax[jj] < bb_xmin[ii] ) ||
+                ( tree.bb_ymin[jj] > bb_ymax[ii] ) ||
+                ( tree.bb_ymax[jj] < bb_ymin[ii] ) );
+    }
+
+    real_type
+    node_area( int_type i ) const {
+      size_t ii = size_t(i);
+      return (nd_xmax[ii]-nd_xmin[ii])*(nd_ymax[ii]-nd_ymin[ii]);
+    }
+
+    // distance of `(x,y)` from the node `i` and from the box `i`
+    real_type
+    node_distance( int_type i, real_type x, real_type y ) const {
+      size_t    ii = size_t(i);
+      real_type dx = std::max( std::max( nd_xmin[ii]-x, x-nd_xmax[ii] ), real_type(0) );
+      real_type dy = std::max( std::max( nd_ymin[ii]-y, y-nd_ymax[ii] ), real_type(0) );
+      return hypot( dx, dy );
+    }
+
+    real_type
+    box_distance( int_type i, real_type x, real_type y ) const {
+      size_t    ii = size_t(i);
+      real_type dx = std::max( std::max( bb_xmin[ii]-x, x-bb_xmax[ii] ), real_type(0) );
+      real_type dy = std::max( std::max( bb_ymin[ii]-y, y-bb_ymax[ii] ), real_type(0) );
+      return hypot( dx, dy );
+    }
+
+    // true if the pair (i,j) must be refined splitting node `i`
+    bool
+    descend_first(
+      int_type             i,
+      AABBtreeFlat const & tree,
+      int_type             j
+    ) const {
+      if ( tree.is_leaf(j) ) return true;
+      if ( is_leaf(i) )      return false;
+      return node_area(i) >= tree.node_area(j);
+    }
+
+    // build the nodes from the boxes stored (unsorted) in `bb_*`
+    void build_tree();
+
+    // split the dual traversal of `intersect` and `collision` in about
+    // `ntasks` pairs of overlapping nodes, in the order of the serial
+    // traversal (the results of the pairs, concatenated, are the serial ones)
+    void
+    split_pairs(
+      AABBtreeFlat const & tree,
+      size_t               ntasks,
+      vector<PairIpos>   & tasks
+    ) const;
+
+    // the traversal of `intersect` starting from the pair of nodes `ij`
+    void
+    intersect_pair(
+      AABBtreeFlat const & tree,
+      PairIpos const     & ij,
+      VecPairIpos        & intersectionList
+    ) const;
+
+    // the traversal of `collision` starting from the pair of nodes `ij`,
+    // giving up (returning false) as soon as `stop()` is true
+    template <typename COLLISION_fun, typename STOP_fun>
+    bool
+    collision_pair(
+      AABBtreeFlat const & tree,
+      PairIpos const     & ij,
+      COLLISION_fun      & ifun,
+      STOP_fun const     & stop
+    ) const {
+      vector<PairIpos> stack;
+      stack.reserve(64);
+      stack.push_back( ij );
+      while ( !stack.empty() ) {
+        if ( stop() ) return false;
+        int_type i = stack.back().first;
+        int_type j = stack.back().second;
+        stack.pop_back();
+        if ( !node_overlap( i, tree, j ) ) continue;
+        if ( is_leaf(i) && tree.is_leaf(j) ) {
+          int_type ie = nd_first[size_t(i)]+nd_num[size_t(i)];
+          int_type je = tree.nd_first[size_t(j)]+tree.nd_num[size_t(j)];
+          for ( int_type ii = nd_first[size_t(i)]; ii < ie; ++ii )
+            for ( int_type jj = tree.nd_first[size_t(j)]; jj < je; ++jj )
+              if ( box_overlap( ii, tree, jj ) &&
+                   ifun( bb_ipos[size_t(ii)], tree.bb_ipos[size_t(jj)] ) )
+                return true;
+        } else if ( descend_first( i, tree, j ) ) {
+          int_type c = nd_first[size_t(i)];
+          stack.push_back( PairIpos(c+1,j) );
+          stack.push_back( PairIpos(c,j) );
+        } else {
+          int_type c = tree.nd_first[size_t(j)];
+          stack.push_back( PairIpos(i,c+1) );
+          stack.push_back( PairIpos(i,c) );
+        }
+      }
+      return false;
+    }
+
+    void
+    build_node(
+      int_type           inode,
+      int_type           ibegin,
+      int_type           iend,
+      vector<int_type> & idx,
+      vector<real_type>& cx,
+      vector<real_type>& cy
+    );
+
+  public:
+
+    AABBtreeFlat();
+    ~AABBtreeFlat();
+
+    void clear(); //!< initialized AABB tree
+
+    bool empty() const { return nd_first.empty(); } //!< check if AABB tree is empty
+
+    int_type num_nodes() const { return int_type(nd_first.size()); }
+    int_type num_boxes() const { return int_type(bb_ipos.size()); }
+
+    //! maximum number of boxes stored in a leaf (used by the next `build`)
+    int_type max_leaf_size() const { return leaf_size; }
+
+    void
+    set_max_leaf_size( int_type n ) {
+      G2LIB_ASSERT( n > 0, "AABBtreeFlat::set_max_leaf_size( " << n << " ) bad size" )
+      leaf_size = n;
+    }
+
+    void
+    bbox(
+      real_type & xmin,
+      real_type & ymin,
+      real_type & xmax,
+      real_type & ymax
+    ) const {
+      xmin = nd_xmin.front();
+      ymin = nd_ymin.front();
+      xmax = nd_xmax.front();
+      ymax = nd_ymax.front();
+    }
+
+    //! build AABB tree given the `nbox` bbox `[xmin,xmax]x[ymin,ymax]`
+    void
+    build(
+      int_type        nbox,
+      real_type const xmin[],
+      real_type const ymin[],
+      real_type const xmax[],
+      real_type const ymax[]
+    );
+
+    /*!
+     * Build AABB tree using the bbox of the objects in `objs`,
+     * `OBJ` must have the method `bbox( xmin, ymin, xmax, ymax )`
+     * (e.g. `Triangle2D` or `LineSegment`).
+     */
+    template <typename OBJ>
+    void
+    build( vector<OBJ> const & objs ) {
+      size_t n = objs.size();
+      bb_xmin.resize(n); bb_ymin.resize(n);
+      bb_xmax.resize(n); bb_ymax.resize(n);
+      for ( size_t i = 0; i < n; ++i )
+        objs[i].bbox( bb_xmin[i], bb_ymin[i], bb_xmax[i], bb_ymax[i] );
+      this->build_tree();
+    }
+
+    void
+    print( ostream_type & stream ) const;
+
+    /*!
+     * Check if two AABB tree collide
+     *
+     * \param[in] tree an AABB tree that is used to check collision
+     * \param[in] ifun function `ifun( ipos, ipos_tree )` that check if
+     *                 the contents of two bbox (curve) collide
+     * \return true if the two tree collides
+     *
+     */
+    template <typename COLLISION_fun>
+    bool
+    collision(
+      AABBtreeFlat const & tree,
+      COLLISION_fun        ifun
+    ) const {
+      if ( empty() || tree.empty() ) return false;
+      return collision_pair( tree, PairIpos(0,0), ifun, AABBnoStop() );
+    }
+
+    /*!
+     * As `collision` but the traversal is split among `nthreads`
+     * threads.  The pairs of overlapping subtrees near the roots are
+     * the tasks taken by the threads; the first thread that finds a
+     * collision stops all the others.
+     * `ifun` is copied in each thread and must be safe to call
+     * concurrently (the collision functions of the curves are).
+     */
+    template <typename COLLISION_fun>
+    bool
+    collision_parallel(
+      AABBtreeFlat const & tree,
+      COLLISION_fun        ifun,
+      int_type             nthreads
+    ) const {
+      #ifdef G2LIB_USE_CXX11
+      if ( nthreads > 1 && !empty() && !tree.empty() ) {
+        vector<PairIpos> tasks;
+        this->split_pairs( tree, size_t(16*nthreads), tasks );
+        std::atomic<bool> found(false);
+        AABBrunTasks( tasks.size(), nthreads, [&]( size_t k ) {
+          if ( found.load( std::memory_order_relaxed ) ) return;
+          COLLISION_fun f( ifun );
+          if ( this->collision_pair(
+                 tree, tasks[k], f,
+                 [&found]() { return found.load( std::memory_order_relaxed ); }
+               ) ) found = true;
+        } );
+        return found;
+      }
+      #else
+      (void)nthreads;
+      #endif
+      return collision( tree, ifun );
+    }
+
+    /*!
+     * Compute all the intersection of AABB trees
+     *
+     * \param[in]  tree             an AABB tree that is used to check collision
+     * \param[out] intersectionList list of pair `(ipos,ipos_tree)` of the
+     *                              bbox that overlaps
+     *
+     */
+    void
+    intersect(
+      AABBtreeFlat const & tree,
+      VecPairIpos        & intersectionList
+    ) const;
+
+    /*!
+     * As `intersect` but the traversal is split among `nthreads` threads.
+     * Each pair of subtrees taken by a thread fills its own list and the
+     * lists are appended in order: the result is the one of `intersect`.
+     */
+    void
+    intersect_parallel(
+      AABBtreeFlat const & tree,
+      VecPairIpos        & intersectionList,
+      int_type             nthreads
+    ) const;
+
+    /*!
+     * Check if two boxes of the tree collide (self traversal):
+     * `ifun( ipos1, ipos2 )` is called for the pairs of distinct
+     * overlapping boxes, each unordered pair once, until it returns true.
+     * Each node is paired with itself only to pair its two children,
+     * so no pair is visited twice.
+     * The pairs that are not a collision (e.g. adjacent pieces of the
+     * curve) must be rejected by `ifun`.
+     */
+    template <typename COLLISION_fun>
+    bool
+    self_collision( COLLISION_fun ifun ) const {
+      for ( int_type i = 0; i < num_nodes(); ++i ) {
+        int_type c = nd_first[size_t(i)];
+        if ( is_leaf(i) ) {
+          int_type ie = c+nd_num[size_t(i)];
+          for ( int_type ii = c; ii < ie; ++ii )
+            for ( int_type jj = ii+1; jj < ie; ++jj )
+              if ( box_overlap( ii, *this, jj ) &&
+                   ifun( bb_ipos[size_t(ii)], bb_ipos[size_t(jj)] ) )
+                return true;
+        } else if ( collision_pair( *this, PairIpos(c,c+1), ifun, AABBnoStop() ) ) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    //! the pairs of distinct overlapping boxes of the tree, each unordered pair once
+    void
+    self_intersect( VecPairIpos & intersectionList ) const;
+
+    /*!
+     * Select the bbox which are candidate to contain the point
+     * at minimum distance from `(x,y)`
+     */
+    void
+    min_distance(
+      real_type x,
+      real_type y,
+      VecIpos & candidateList
+    ) const;
+
+    /*!
+     * As `min_distance` but only the bbox not farther than `dmax`
+     * from `(x,y)` are selected.  `dmax` is an upper bound of the
+     * distance (e.g. the distance of a point of the curve already
+     * known), a tight bound prunes most of the tree.
+     * The traversal uses `stack` as workspace, so a loop of queries
+     * does not allocate memory.
+     */
+    void
+    min_distance(
+      real_type          x,
+      real_type          y,
+      real_type          dmax,
+      VecIpos          & candidateList,
+      vector<int_type> & stack
+    ) const;
+
+    //! select the `Ipos()` of the bbox with distance from `(x,y)` not greater than `dst`
+    void
+    within_distance(
+      real_type x,
+      real_type y,
+      real_type dst,
+      VecIpos & candidateList
+    ) const;
+
+    //! select the `Ipos()` of the bbox overlapping `[xmin,xmax]x[ymin,ymax]`
+    void
+    within_box(
+      real_type xmin,
+      real_type ymin,
+      real_type xmax,
+      real_type ymax,
+      VecIpos & candidateList
+    ) const;
+
+    /*!
+     * Best first search of the objects nearest to `(x,y)`.
+     * `dst( ipos )` returns the distance from `(x,y)` of the object in
+     * the bbox `ipos`, not less than the distance of the bbox (infinity
+     * to discard the object).  Nodes, bbox and objects are visited by
+     * increasing distance (priority queue) and each object is passed
+     * to `found( distance, ipos )`, which returns false to stop, so
+     * `dst` is called only for the bbox nearer than the last object
+     * found.  Objects farther than `dmax` are not visited.
+     */
+    template <typename DIST_fun, typename FOUND_fun>
+    void
+    best_first(
+      real_type x,
+      real_type y,
+      real_type dmax,
+      DIST_fun  dst,
+      FOUND_fun found
+    ) const {
+      typedef pair<real_type,int_type> DistIpos;
+      if ( empty() ) return;
+      // (distance,3*i+kind), kind 0: node `i`, 1: box `i`, 2: object in the box `i`
+      std::priority_queue<
+        DistIpos, vector<DistIpos>, std::greater<DistIpos>
+      > Q;
+      Q.push( DistIpos( node_distance( 0, x, y ), 0 ) );
+      while ( !Q.empty() ) {
+        real_type d = Q.top().first;
+        int_type  i = Q.top().second/3;
+        int_type  c = Q.top().second%3;
+        Q.pop();
+        if ( d > dmax ) break;
+        if ( c == 0 ) {
+          int_type f = nd_first[size_t(i)];
+          if ( is_leaf(i) ) {
+            int_type ie = f+nd_num[size_t(i)];
+            for ( int_type j = f; j < ie; ++j ) {
+              real_type dj = box_distance( j, x, y );
+              if ( dj <= dmax ) Q.push( DistIpos( dj, 3*j+1 ) );
+            }
+          } else {
+            real_type d0 = node_distance( f, x, y );
+            real_type d1 = node_distance( f+1, x, y );
+            if ( d0 <= dmax ) Q.push( DistIpos( d0, 3*f ) );
+            if ( d1 <= dmax ) Q.push( DistIpos( d1, 3*f+3 ) );
+          }
+        } else if ( c == 1 ) {
+          real_type dj = dst( bb_ipos[size_t(i)] );
+          if ( dj <= dmax && dj < std::numeric_limits<real_type>::infinity() )
+            Q.push( DistIpos( dj, 3*i+2 ) );
+        } else {
+          if ( !found( d, bb_ipos[size_t(i)] ) ) return;
+        }
+      }
+    }
+
+    /*!
+     * The (at most) `k` objects nearest to `(x,y)` and not farther
+     * than `dmax` (see `best_first`).
+     *
+     * \param[in]  x,y   query point
+     * \param[in]  k     maximum number of objects
+     * \param[in]  dmax  maximum distance of the objects
+     * \param[in]  dst   function `dst( ipos )`
+     * \param[out] res   pairs `(distance,ipos)` of the objects,
+     *                   by increasing distance
+     */
+    template <typename DIST_fun>
+    void
+    nearest(
+      real_type                           x,
+      real_type                           y,
+      int_type                            k,
+      real_type                           dmax,
+      DIST_fun                            dst,
+      vector<pair<real_type,int_type> > & res
+    ) const {
+      res.clear();
+      if ( k > 0 ) best_first( x, y, dmax, dst, NearestObjects( k, &res ) );
+    }
+
   };
 
 }
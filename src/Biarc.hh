@@ -44,6 +44,8 @@ namespace G2lib {
    */
 
   class Biarc : public BaseCurve {
+    friend class CurveBinary;
+
     CircleArc C0, C1;
 
     void
@@ -445,6 +447,19 @@ namespace G2lib {
       real_type & ty_DDD
     ) const G2LIB_OVERRIDE;
 
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    virtual
+    void
+    sample_stations_ISO(
+      real_type                offs,
+      real_type                tol,
+      std::vector<real_type> & s
+    ) const G2LIB_OVERRIDE {
+      sample_piece_ISO( 0, C0.length(), C0.curvature(), 0, offs, tol, s );
+      sample_piece_ISO( C0.length(), C1.length(), C1.curvature(), 0, offs, tol, s );
+    }
+
     /*\
      |  _                        __
      | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -197,15 +197,16 @@ namespace G2lib {
 
   void
   BiarcList::push_back( PolyLine const & c ) {
-    s0.reserve( s0.size() + c.polylineList.size() + 1 );
-    biarcList.reserve( biarcList.size() + c.polylineList.size() );
+    size_t ns = size_t(c.numSegment());
+    s0.reserve( s0.size() + ns + 1 );
+    biarcList.reserve( biarcList.size() + ns );
 
     if ( s0.empty() ) s0.push_back(0);
 
-    vector<LineSegment>::const_iterator ip = c.polylineList.begin();
-    for (; ip != c.polylineList.end(); ++ip ) {
-      s0.push_back(s0.back()+ip->length());
-      biarcList.push_back(Biarc(*ip));
+    for ( size_t i = 0; i < ns; ++i ) {
+      LineSegment LS = c.getSegment( int_type(i) );
+      s0.push_back(s0.back()+LS.length());
+      biarcList.push_back(Biarc(LS));
     }
   }
 
@@ -867,6 +868,23 @@ namespace G2lib {
     return c.eval_ISO_DDD( s - s0[idx], offs, x_DDD, y_DDD );
   }
 
+  void
+  BiarcList::sample_stations_ISO(
+    real_type           offs,
+    real_type           tol,
+    vector<real_type> & s
+  ) const {
+    vector<Biarc>::const_iterator ic = biarcList.begin();
+    for ( size_t k = 0; ic != biarcList.end(); ++ic, ++k ) {
+      size_t i0 = s.size();
+      ic->sample_stations_ISO( offs, tol, s );
+      for ( size_t i = i0; i < s.size(); ++i ) s[i] += s0[k];
+    }
+    if ( !s.empty() ) s.back() = s0.back();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   /*\
    |  _                        __
    | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -988,34 +1006,42 @@ namespace G2lib {
   ) const {
 
     if ( aabb_done &&
+         aabb_is_flat == use_flat_AABBtree &&
          isZero( offs-aabb_offs ) &&
          isZero( max_angle-aabb_max_angle ) &&
          isZero( max_size-aabb_max_size ) ) return;
 
-    #ifdef G2LIB_USE_CXX11
-    vector<shared_ptr<BBox const> > bboxes;
-    #else
-    vector<BBox const *> bboxes;
-    #endif
-
+    aabb_tri.clear(); // bbTriangles_ISO append to the list
     bbTriangles_ISO( offs, aabb_tri, max_angle, max_size );
-    bboxes.reserve(aabb_tri.size());
-    vector<Triangle2D>::const_iterator it;
-    int_type ipos = 0;
-    for ( it = aabb_tri.begin(); it != aabb_tri.end(); ++it, ++ipos ) {
-      real_type xmin, ymin, xmax, ymax;
-      it->bbox( xmin, ymin, xmax, ymax );
+    aabb_is_flat = use_flat_AABBtree;
+    if ( aabb_is_flat ) {
+      aabb_tree.clear();
+      aabb_flat.build( aabb_tri );
+    } else {
       #ifdef G2LIB_USE_CXX11
-      bboxes.push_back( make_shared<BBox const>(
-        xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos
-      ) );
+      vector<shared_ptr<BBox const> > bboxes;
       #else
-      bboxes.push_back(
-        new BBox( xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos )
-      );
+      vector<BBox const *> bboxes;
       #endif
+      bboxes.reserve(aabb_tri.size());
+      vector<Triangle2D>::const_iterator it;
+      int_type ipos = 0;
+      for ( it = aabb_tri.begin(); it != aabb_tri.end(); ++it, ++ipos ) {
+        real_type xmin, ymin, xmax, ymax;
+        it->bbox( xmin, ymin, xmax, ymax );
+        #ifdef G2LIB_USE_CXX11
+        bboxes.push_back( make_shared<BBox const>(
+          xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos
+        ) );
+        #else
+        bboxes.push_back(
+          new BBox( xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos )
+        );
+        #endif
+      }
+      aabb_flat.clear();
+      aabb_tree.build(bboxes);
     }
-    aabb_tree.build(bboxes);
     aabb_done      = true;
     aabb_offs      = offs;
     aabb_max_angle = max_angle;
@@ -1037,6 +1063,7 @@ namespace G2lib {
     this->build_AABBtree_ISO( 0 );
     C.build_AABBtree_ISO( 0 );
     T2D_collision_list_ISO fun( this, 0, &C, 0 );
+    if ( aabb_is_flat ) return aabb_flat.collision( C.aabb_flat, fun );
     return aabb_tree.collision( C.aabb_tree, fun, false );
   }
 
@@ -1051,6 +1078,7 @@ namespace G2lib {
     this->build_AABBtree_ISO( offs );
     C.build_AABBtree_ISO( offs_C );
     T2D_collision_list_ISO fun( this, offs, &C, offs_C );
+    if ( aabb_is_flat ) return aabb_flat.collision( C.aabb_flat, fun );
     return aabb_tree.collision( C.aabb_tree, fun, false );
   }
 
@@ -1074,13 +1102,14 @@ namespace G2lib {
     if ( intersect_with_AABBtree ) {
       this->build_AABBtree_ISO( offs );
       CL.build_AABBtree_ISO( offs_CL );
-      AABBtree::VecPairPtrBBox iList;
-      aabb_tree.intersect( CL.aabb_tree, iList );
+      AABBtree::VecPairIpos iList;
+      if ( aabb_is_flat ) aabb_flat.intersect( CL.aabb_flat, iList );
+      else                aabb_tree.intersect( CL.aabb_tree, iList );
 
-      AABBtree::VecPairPtrBBox::const_iterator ip;
+      AABBtree::VecPairIpos::const_iterator ip;
       for ( ip = iList.begin(); ip != iList.end(); ++ip ) {
-        size_t ipos1 = size_t(ip->first->Ipos());
-        size_t ipos2 = size_t(ip->second->Ipos());
+        size_t ipos1 = size_t(ip->first);
+        size_t ipos2 = size_t(ip->second);
 
         Triangle2D const & T1 = aabb_tri[ipos1];
         Triangle2D const & T2 = CL.aabb_tri[ipos2];
@@ -1100,6 +1129,10 @@ namespace G2lib {
         }
       }
     } else {
+      // the triangles are not those of the AABB tree, drop the tree
+      aabb_done = CL.aabb_done = false;
+      aabb_tri.clear();
+      CL.aabb_tri.clear();
       bbTriangles_ISO( offs, aabb_tri, m_pi/18, 1e100 );
       CL.bbTriangles_ISO( offs_CL, CL.aabb_tri, m_pi/18, 1e100 );
       for ( vector<Triangle2D>::const_iterator i1 = aabb_tri.begin();
@@ -1150,9 +1183,10 @@ namespace G2lib {
 
     this->build_AABBtree_ISO( offs );
 
-    AABBtree::VecPtrBBox candidateList;
-    aabb_tree.min_distance( qx, qy, candidateList );
-    AABBtree::VecPtrBBox::const_iterator ic;
+    AABBtree::VecIpos candidateList;
+    if ( aabb_is_flat ) aabb_flat.min_distance( qx, qy, candidateList );
+    else                aabb_tree.min_distance( qx, qy, candidateList );
+    AABBtree::VecIpos::const_iterator ic;
     G2LIB_ASSERT(
       candidateList.size() > 0,
       "BiarcList::closestPoint no candidate"
@@ -1160,7 +1194,7 @@ namespace G2lib {
     int_type icurve = 0;
     DST = numeric_limits<real_type>::infinity();
     for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
-      size_t ipos = size_t((*ic)->Ipos());
+      size_t ipos = size_t(*ic);
       Triangle2D const & T = aabb_tri[ipos];
       real_type dst = T.distMin( qx, qy );
       if ( dst < DST ) {
@@ -1337,6 +1371,32 @@ namespace G2lib {
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  /*\
+   |   __ _  _ _ _ ___ ___ _ _
+   |  / _| || | '_(_-</ _ \ '_|
+   |  \__|\_,_|_| /__/\___/_|
+  \*/
+
+  void
+  BiarcListCursor::anchor( real_type s ) {
+    int_type      i = BL.findAtS( s, idx );
+    Biarc const & B = BL.biarcList[size_t(i)];
+    real_type     t = s - BL.s0[size_t(i)];
+    // pieces are the two arcs, the last one is extended as in `eval`
+    real_type L0 = B.getC0().length();
+    bool      a1 = t >= L0;
+    CircleArc const & C = a1 ? B.getC1() : B.getC0();
+    if ( a1 ) t -= L0;
+    real_type sb = s-t;
+    real_type se = sb+C.length();
+    if ( a1 && i+1 == BL.numSegment() )
+      se = numeric_limits<real_type>::infinity();
+    this->setPiece( sb, se, C.thetaBegin(), C.curvature(), 0 );
+    real_type x, y;
+    C.eval( t, x, y );
+    this->setState( s, x, y );
+  }
+
 }
 
 // EOF: BiarcList.cc
@@ -45,19 +45,21 @@ namespace G2lib {
   class BiarcList : public BaseCurve {
 
     friend class ClothoidList;
+    friend class BiarcListCursor;
+    friend class CurveBinary;
+    friend class CurveIndex;
 
     vector<real_type> s0;
     vector<Biarc>     biarcList;
 
-    #ifdef G2LIB_USE_CXX11
-    mutable std::mutex                         lastInterval_mutex;
-    mutable std::map<std::thread::id,int_type> lastInterval_by_thread;
-    #else
+    #ifndef G2LIB_USE_CXX11
     mutable int_type lastInterval;
     #endif
 
     mutable bool               aabb_done;
+    mutable bool               aabb_is_flat; // aabb_flat used in place of aabb_tree
     mutable AABBtree           aabb_tree;
+    mutable AABBtreeFlat       aabb_flat;
     mutable real_type          aabb_offs;
     mutable real_type          aabb_max_angle;
     mutable real_type          aabb_max_size;
@@ -82,19 +84,26 @@ namespace G2lib {
       {}
 
       bool
-      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const {
-        Triangle2D const & T1 = pList1->aabb_tri[size_t(ptr1->Ipos())];
-        Triangle2D const & T2 = pList2->aabb_tri[size_t(ptr2->Ipos())];
+      operator () ( int_type ipos1, int_type ipos2 ) const {
+        Triangle2D const & T1 = pList1->aabb_tri[size_t(ipos1)];
+        Triangle2D const & T2 = pList2->aabb_tri[size_t(ipos2)];
         Biarc      const & C1 = pList1->get(T1.Icurve());
         Biarc      const & C2 = pList2->get(T2.Icurve());
         return C1.collision_ISO( offs1, C2, offs2 );
       }
+
+      bool
+      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const
+      { return (*this)( ptr1->Ipos(), ptr2->Ipos() ); }
     };
 
     void
     resetLastInterval() {
-      std::lock_guard<std::mutex> lck(lastInterval_mutex);
-      lastInterval_by_thread[std::this_thread::get_id()] = 0;
+      #ifdef G2LIB_USE_CXX11
+      findAtS_thread_hint( this ) = 0;
+      #else
+      lastInterval = 0;
+      #endif
     }
 
   public:
@@ -165,13 +174,24 @@ namespace G2lib {
     int_type
     findAtS( real_type s ) const {
       #ifdef G2LIB_USE_CXX11
-      std::lock_guard<std::mutex> lck(lastInterval_mutex);
-      return ::G2lib::findAtS( s, lastInterval_by_thread[std::this_thread::get_id()], s0 );
+      return this->findAtS( s, findAtS_thread_hint( this ) );
       #else
-      return ::G2lib::findAtS( s, lastInterval, s0 );
+      return this->findAtS( s, lastInterval );
       #endif
     }
 
+    /*!
+     * Find the segment containing `s` starting the search from the
+     * caller owned hint `last_idx` (updated on exit).
+     * No shared state is touched, so a thread or a sweep can keep
+     * its own cursor without any synchronization.
+     */
+    int_type
+    findAtS( real_type s, int_type & last_idx ) const {
+      if ( last_idx < 0 || last_idx >= this->numSegment() ) last_idx = 0;
+      return ::G2lib::findAtS( s, last_idx, s0 );
+    }
+
     // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
 
     virtual
@@ -636,6 +656,16 @@ namespace G2lib {
       real_type & y_DDD
     ) const G2LIB_OVERRIDE;
 
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    virtual
+    void
+    sample_stations_ISO(
+      real_type           offs,
+      real_type           tol,
+      vector<real_type> & s
+    ) const G2LIB_OVERRIDE;
+
     /*\
      |  _                        __
      | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -832,6 +862,32 @@ namespace G2lib {
 
   };
 
+  //! Forward cursor on a `BiarcList` (see `CurveCursor`),
+  //! the list must outlive the cursor
+  class BiarcListCursor : public CurveCursor {
+    BiarcList const & BL;
+    int_type          idx; // hint of the segment search
+
+    void anchor( real_type s ) G2LIB_OVERRIDE;
+
+  public:
+
+    /*!
+     *  \param[in] _BL  the list
+     *  \param[in] _tol maximum position error
+     *  \param[in] s    initial curvilinear abscissa
+     */
+    BiarcListCursor(
+      BiarcList const & _BL,
+      real_type         _tol = 1e-10,
+      real_type         s    = 0
+    )
+    : CurveCursor(_tol)
+    , BL(_BL)
+    , idx(0)
+    { this->anchor( s ); }
+  };
+
 }
 
 #endif
@@ -317,7 +317,7 @@ namespace G2lib {
     virtual
     real_type
     length_ISO( real_type offs ) const G2LIB_OVERRIDE
-    { return L*(1+k*offs); }
+    { return L*std::abs(1-k*offs); }
 
     virtual
     real_type
@@ -506,6 +506,17 @@ namespace G2lib {
     void
     tg_DDD( real_type s, real_type & tx_DDD, real_type & ty_DDD ) const G2LIB_OVERRIDE;
 
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    virtual
+    void
+    sample_stations_ISO(
+      real_type                offs,
+      real_type                tol,
+      std::vector<real_type> & s
+    ) const G2LIB_OVERRIDE
+    { sample_piece_ISO( 0, L, k, 0, offs, tol, s ); }
+
     /*\
      |  _                        __
      | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -56,6 +56,8 @@ namespace G2lib {
   ClothoidCurve::ClothoidCurve( BaseCurve const & C )
   : BaseCurve(G2LIB_CLOTHOID)
   , aabb_done(false)
+  , aabb_flat(nullptr)
+  , aabb_prepared(nullptr)
   {
     switch ( C.type() ) {
     case G2LIB_LINE:
@@ -151,6 +153,17 @@ namespace G2lib {
 
   // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
 
+  void
+  ClothoidCurve::sample_stations_ISO(
+    real_type           offs,
+    real_type           tol,
+    vector<real_type> & s
+  ) const {
+    sample_piece_ISO( 0, L, CD.kappa0, CD.dk, offs, tol, s );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
   /*\
    |  _    _   _____    _                _
    | | |__| |_|_   _| _(_)__ _ _ _  __ _| |___
@@ -308,34 +321,44 @@ namespace G2lib {
   ) const {
 
     if ( aabb_done &&
+         aabb_is_flat == use_flat_AABBtree &&
          isZero( offs-aabb_offs ) &&
          isZero( max_angle-aabb_max_angle ) &&
          isZero( max_size-aabb_max_size ) ) return;
 
-    #ifdef G2LIB_USE_CXX11
-    vector<shared_ptr<BBox const> > bboxes;
-    #else
-    vector<BBox const *> bboxes;
-    #endif
-
+    aabb_tri.clear(); // bbTriangles_ISO append to the list
     bbTriangles_ISO( offs, aabb_tri, max_angle, max_size );
-    bboxes.reserve(aabb_tri.size());
-    vector<Triangle2D>::const_iterator it;
-    int_type ipos = 0;
-    for ( it = aabb_tri.begin(); it != aabb_tri.end(); ++it, ++ipos ) {
-      real_type xmin, ymin, xmax, ymax;
-      it->bbox( xmin, ymin, xmax, ymax );
+    aabb_is_flat = use_flat_AABBtree;
+    if ( aabb_is_flat ) {
+      aabb_tree.clear();
+      if ( aabb_flat == nullptr ) aabb_flat = new AABBtreeFlat();
+      aabb_flat->build( aabb_tri );
+    } else {
       #ifdef G2LIB_USE_CXX11
-      bboxes.push_back( make_shared<BBox const>(
-        xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos
-      ) );
+      vector<shared_ptr<BBox const> > bboxes;
       #else
-      bboxes.push_back(
-        new BBox( xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos )
-      );
+      vector<BBox const *> bboxes;
       #endif
+      bboxes.reserve(aabb_tri.size());
+      vector<Triangle2D>::const_iterator it;
+      int_type ipos = 0;
+      for ( it = aabb_tri.begin(); it != aabb_tri.end(); ++it, ++ipos ) {
+        real_type xmin, ymin, xmax, ymax;
+        it->bbox( xmin, ymin, xmax, ymax );
+        #ifdef G2LIB_USE_CXX11
+        bboxes.push_back( make_shared<BBox const>(
+          xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos
+        ) );
+        #else
+        bboxes.push_back(
+          new BBox( xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos )
+        );
+        #endif
+      }
+      delete aabb_flat;
+      aabb_flat = nullptr;
+      aabb_tree.build(bboxes);
     }
-    aabb_tree.build(bboxes);
     aabb_done      = true;
     aabb_offs      = offs;
     aabb_max_angle = max_angle;
@@ -344,6 +367,25 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  ClothoidCurve::prepare_AABBtree_ISO(
+    real_type offs,
+    real_type max_angle,
+    real_type max_size
+  ) {
+    if ( prepared_AABBtree_ISO( offs, max_angle, max_size ) != nullptr ) return;
+    if ( aabb_prepared == nullptr ) aabb_prepared = new vector<AABBtriangles>();
+    aabb_prepared->push_back( AABBtriangles() );
+    AABBtriangles & P = aabb_prepared->back();
+    P.offs      = offs;
+    P.max_angle = max_angle;
+    P.max_size  = max_size;
+    bbTriangles_ISO( offs, P.tri, max_angle, max_size );
+    P.tree.build( P.tri );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   /*\
    |            _ _ _     _
    |   ___ ___ | | (_)___(_) ___  _ __
@@ -354,10 +396,7 @@ namespace G2lib {
 
   bool
   ClothoidCurve::collision( ClothoidCurve const & C ) const {
-    this->build_AABBtree_ISO( 0 );
-    C.build_AABBtree_ISO( 0 );
-    T2D_collision_ISO fun( this, 0, &C, 0 );
-    return aabb_tree.collision( C.aabb_tree, fun, false );
+    return collision_ISO( 0, C, 0 );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -368,9 +407,16 @@ namespace G2lib {
     ClothoidCurve const & C,
     real_type             offs_C
   ) const {
+    AABBtriangles const * P1 = this->prepared_AABBtree_ISO( offs );
+    AABBtriangles const * P2 = C.prepared_AABBtree_ISO( offs_C );
+    if ( P1 != nullptr && P2 != nullptr ) {
+      T2D_collision_ISO fun( this, &P1->tri, offs, &C, &P2->tri, offs_C );
+      return P1->tree.collision( P2->tree, fun );
+    }
     this->build_AABBtree_ISO( offs );
     C.build_AABBtree_ISO( offs_C );
-    T2D_collision_ISO fun( this, offs, &C, offs_C );
+    T2D_collision_ISO fun( this, &aabb_tri, offs, &C, &C.aabb_tri, offs_C );
+    if ( aabb_is_flat ) return aabb_flat->collision( *C.aabb_flat, fun );
     return aabb_tree.collision( C.aabb_tree, fun, false );
   }
 
@@ -385,9 +431,16 @@ namespace G2lib {
     real_type             max_angle,
     real_type             max_size
   ) const {
+    AABBtriangles const * P1 = this->prepared_AABBtree_ISO( offs, max_angle, max_size );
+    AABBtriangles const * P2 = C.prepared_AABBtree_ISO( offs_C, max_angle, max_size );
+    if ( P1 != nullptr && P2 != nullptr ) {
+      T2D_approximate_collision fun( &P1->tri, &P2->tri );
+      return P1->tree.collision( P2->tree, fun );
+    }
     this->build_AABBtree_ISO( offs, max_angle, max_size );
     C.build_AABBtree_ISO( offs_C, max_angle, max_size );
-    T2D_approximate_collision fun( this, &C );
+    T2D_approximate_collision fun( &aabb_tri, &C.aabb_tri );
+    if ( aabb_is_flat ) return aabb_flat->collision( *C.aabb_flat, fun );
     return aabb_tree.collision( C.aabb_tree, fun, false );
   }
 
@@ -475,18 +528,31 @@ namespace G2lib {
     bool                  swap_s_vals
   ) const {
     if ( intersect_with_AABBtree ) {
-      this->build_AABBtree_ISO( offs );
-      C.build_AABBtree_ISO( offs_C );
-      AABBtree::VecPairPtrBBox iList;
-      aabb_tree.intersect( C.aabb_tree, iList );
-      AABBtree::VecPairPtrBBox::const_iterator ip;
+      AABBtriangles const *      P1 = this->prepared_AABBtree_ISO( offs );
+      AABBtriangles const *      P2 = C.prepared_AABBtree_ISO( offs_C );
+      vector<Triangle2D> const * tri1;
+      vector<Triangle2D> const * tri2;
+      AABBtree::VecPairIpos      iList;
+      if ( P1 != nullptr && P2 != nullptr ) {
+        P1->tree.intersect( P2->tree, iList );
+        tri1 = &P1->tri;
+        tri2 = &P2->tri;
+      } else {
+        this->build_AABBtree_ISO( offs );
+        C.build_AABBtree_ISO( offs_C );
+        if ( aabb_is_flat ) aabb_flat->intersect( *C.aabb_flat, iList );
+        else                aabb_tree.intersect( C.aabb_tree, iList );
+        tri1 = &aabb_tri;
+        tri2 = &C.aabb_tri;
+      }
+      AABBtree::VecPairIpos::const_iterator ip;
 
       for ( ip = iList.begin(); ip != iList.end(); ++ip ) {
-        size_t ipos1 = size_t(ip->first->Ipos());
-        size_t ipos2 = size_t(ip->second->Ipos());
+        size_t ipos1 = size_t(ip->first);
+        size_t ipos2 = size_t(ip->second);
 
-        Triangle2D const & T1 = aabb_tri[ipos1];
-        Triangle2D const & T2 = C.aabb_tri[ipos2];
+        Triangle2D const & T1 = (*tri1)[ipos1];
+        Triangle2D const & T2 = (*tri2)[ipos2];
 
         real_type ss1, ss2;
         bool converged = aabb_intersect_ISO( T1, offs, &C, T2, offs_C, ss1, ss2 );
@@ -497,6 +563,10 @@ namespace G2lib {
         }
       }
     } else {
+      // the triangles are not those of the AABB tree, drop the tree
+      aabb_done = C.aabb_done = false;
+      aabb_tri.clear();
+      C.aabb_tri.clear();
       bbTriangles_ISO( offs, aabb_tri, m_pi/18, 1e100 );
       C.bbTriangles_ISO( offs_C, C.aabb_tri, m_pi/18, 1e100 );
       for ( vector<Triangle2D>::const_iterator i1 = aabb_tri.begin();
@@ -596,18 +666,27 @@ namespace G2lib {
     real_type & DST
   ) const {
     DST = numeric_limits<real_type>::infinity();
-    this->build_AABBtree_ISO( offs );
 
-    AABBtree::VecPtrBBox candidateList;
-    aabb_tree.min_distance( qx, qy, candidateList );
-    AABBtree::VecPtrBBox::const_iterator ic;
+    AABBtriangles const *      P = this->prepared_AABBtree_ISO( offs );
+    vector<Triangle2D> const * tri;
+    AABBtree::VecIpos          candidateList;
+    if ( P != nullptr ) {
+      P->tree.min_distance( qx, qy, candidateList );
+      tri = &P->tri;
+    } else {
+      this->build_AABBtree_ISO( offs );
+      if ( aabb_is_flat ) aabb_flat->min_distance( qx, qy, candidateList );
+      else                aabb_tree.min_distance( qx, qy, candidateList );
+      tri = &aabb_tri;
+    }
+    AABBtree::VecIpos::const_iterator ic;
     G2LIB_ASSERT(
       candidateList.size() > 0,
       "ClothoidCurve::closestPoint no candidate"
     )
     for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
-      size_t ipos = size_t((*ic)->Ipos());
-      Triangle2D const & T = aabb_tri[ipos];
+      size_t ipos = size_t(*ic);
+      Triangle2D const & T = (*tri)[ipos];
       real_type dst = T.distMin( qx, qy );
       if ( dst < DST ) {
         // refine distance
@@ -51,6 +51,8 @@ namespace G2lib {
   //! \brief Class to manage Clothoid Curve
   class ClothoidCurve : public BaseCurve {
     friend class ClothoidList;
+    friend class CurveBinaryView;
+    friend class CurveIndex;
   private:
 
     ClothoidData CD;  //!< clothoid data
@@ -94,12 +96,18 @@ namespace G2lib {
     static real_type tolerance;
 
     mutable bool               aabb_done;
+    mutable bool               aabb_is_flat; // aabb_flat used in place of aabb_tree
     mutable AABBtree           aabb_tree;
+    mutable AABBtreeFlat *     aabb_flat;    // allocated when first used
     mutable real_type          aabb_offs;
     mutable real_type          aabb_max_angle;
     mutable real_type          aabb_max_size;
     mutable vector<Triangle2D> aabb_tri;
 
+    // read only AABB trees built by prepare_AABBtree_ISO,
+    // allocated by the first one
+    vector<AABBtriangles> * aabb_prepared;
+
     bool
     aabb_intersect_ISO(
       Triangle2D    const & T1,
@@ -112,50 +120,64 @@ namespace G2lib {
     ) const;
 
     class T2D_approximate_collision {
-      ClothoidCurve const * pC1;
-      ClothoidCurve const * pC2;
+      vector<Triangle2D> const * pT1;
+      vector<Triangle2D> const * pT2;
     public:
       T2D_approximate_collision(
-        ClothoidCurve const * _pC1,
-        ClothoidCurve const * _pC2
+        vector<Triangle2D> const * _pT1,
+        vector<Triangle2D> const * _pT2
       )
-      : pC1(_pC1)
-      , pC2(_pC2)
+      : pT1(_pT1)
+      , pT2(_pT2)
       {}
 
       bool
-      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const {
-        Triangle2D const & T1 = pC1->aabb_tri[size_t(ptr1->Ipos())];
-        Triangle2D const & T2 = pC2->aabb_tri[size_t(ptr2->Ipos())];
+      operator () ( int_type ipos1, int_type ipos2 ) const {
+        Triangle2D const & T1 = (*pT1)[size_t(ipos1)];
+        Triangle2D const & T2 = (*pT2)[size_t(ipos2)];
         return T1.overlap(T2);
       }
+
+      bool
+      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const
+      { return (*this)( ptr1->Ipos(), ptr2->Ipos() ); }
     };
 
     class T2D_collision_ISO {
-      ClothoidCurve const * pC1;
-      real_type     const   offs1;
-      ClothoidCurve const * pC2;
-      real_type     const   offs2;
+      ClothoidCurve      const * pC1;
+      vector<Triangle2D> const * pT1;
+      real_type          const   offs1;
+      ClothoidCurve      const * pC2;
+      vector<Triangle2D> const * pT2;
+      real_type          const   offs2;
     public:
       T2D_collision_ISO(
-        ClothoidCurve const * _pC1,
-        real_type     const   _offs1,
-        ClothoidCurve const * _pC2,
-        real_type     const   _offs2
+        ClothoidCurve      const * _pC1,
+        vector<Triangle2D> const * _pT1,
+        real_type          const   _offs1,
+        ClothoidCurve      const * _pC2,
+        vector<Triangle2D> const * _pT2,
+        real_type          const   _offs2
       )
       : pC1(_pC1)
+      , pT1(_pT1)
       , offs1(_offs1)
       , pC2(_pC2)
+      , pT2(_pT2)
       , offs2(_offs2)
       {}
 
       bool
-      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const {
-        Triangle2D const & T1 = pC1->aabb_tri[size_t(ptr1->Ipos())];
-        Triangle2D const & T2 = pC2->aabb_tri[size_t(ptr2->Ipos())];
+      operator () ( int_type ipos1, int_type ipos2 ) const {
+        Triangle2D const & T1 = (*pT1)[size_t(ipos1)];
+        Triangle2D const & T2 = (*pT2)[size_t(ipos2)];
         real_type ss1, ss2;
         return pC1->aabb_intersect_ISO( T1, offs1, pC2, T2, offs2, ss1, ss2 );
       }
+
+      bool
+      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const
+      { return (*this)( ptr1->Ipos(), ptr2->Ipos() ); }
     };
 
   public:
@@ -166,6 +188,8 @@ namespace G2lib {
     ClothoidCurve()
     : BaseCurve(G2LIB_CLOTHOID)
     , aabb_done(false)
+    , aabb_flat(nullptr)
+    , aabb_prepared(nullptr)
     {
       CD.x0     = 0;
       CD.y0     = 0;
@@ -179,8 +203,14 @@ namespace G2lib {
     ClothoidCurve( ClothoidCurve const & s )
     : BaseCurve(G2LIB_CLOTHOID)
     , aabb_done(false)
+    , aabb_flat(nullptr)
+    , aabb_prepared(nullptr)
     { copy(s); }
 
+    virtual
+    ~ClothoidCurve() G2LIB_OVERRIDE
+    { delete aabb_flat; delete aabb_prepared; }
+
     //! construct a clothoid with the standard parameters
     explicit
     ClothoidCurve(
@@ -193,6 +223,8 @@ namespace G2lib {
     )
     : BaseCurve(G2LIB_CLOTHOID)
     , aabb_done(false)
+    , aabb_flat(nullptr)
+    , aabb_prepared(nullptr)
     {
       CD.x0     = _x0;
       CD.y0     = _y0;
@@ -212,6 +244,8 @@ namespace G2lib {
     )
     : BaseCurve(G2LIB_CLOTHOID)
     , aabb_done(false)
+    , aabb_flat(nullptr)
+    , aabb_prepared(nullptr)
     {
       build_G1( P0[0], P0[1], theta0, P1[0], P1[1], theta1 );
     }
@@ -222,12 +256,15 @@ namespace G2lib {
       L  = c.L;
       aabb_done = false;
       aabb_tree.clear();
+      clear_prepared_AABBtree();
     }
 
     explicit
     ClothoidCurve( LineSegment const & LS )
     : BaseCurve(G2LIB_CLOTHOID)
     , aabb_done(false)
+    , aabb_flat(nullptr)
+    , aabb_prepared(nullptr)
     {
       CD.x0     = LS.x0;
       CD.y0     = LS.y0;
@@ -241,6 +278,8 @@ namespace G2lib {
     ClothoidCurve( CircleArc const & C )
     : BaseCurve(G2LIB_CLOTHOID)
     , aabb_done(false)
+    , aabb_flat(nullptr)
+    , aabb_prepared(nullptr)
     {
       CD.x0     = C.x0;
       CD.y0     = C.y0;
@@ -280,6 +319,7 @@ namespace G2lib {
       L         = _L;
       aabb_done = false;
       aabb_tree.clear();
+      clear_prepared_AABBtree();
     }
 
     /*!
@@ -305,6 +345,7 @@ namespace G2lib {
     ) {
       aabb_done = false;
       aabb_tree.clear();
+      clear_prepared_AABBtree();
       return CD.build_G1( x0, y0, theta0, x1, y1, theta1, tol, L );
     }
 
@@ -334,6 +375,7 @@ namespace G2lib {
     ) {
       aabb_done = false;
       aabb_tree.clear();
+      clear_prepared_AABBtree();
       return CD.build_G1( x0, y0, theta0, x1, y1, theta1, tol, L,
                           true, L_D, k_D, dk_D );
     }
@@ -360,6 +402,7 @@ namespace G2lib {
     ) {
       aabb_done = false;
       aabb_tree.clear();
+      clear_prepared_AABBtree();
       return CD.build_forward( x0, y0, theta0, kappa0, x1, y1, tol, L );
     }
 
@@ -378,6 +421,7 @@ namespace G2lib {
       L         = LS.L;
       aabb_done = false;
       aabb_tree.clear();
+      clear_prepared_AABBtree();
     }
 
     /*!
@@ -395,6 +439,7 @@ namespace G2lib {
       L         = C.L;
       aabb_done = false;
       aabb_tree.clear();
+      clear_prepared_AABBtree();
     }
 
     void
@@ -634,10 +679,8 @@ namespace G2lib {
 
     virtual
     real_type
-    length_ISO( real_type ) const G2LIB_OVERRIDE {
-      G2LIB_DO_ERROR( "Offset length not available for Clothoids" )
-      return 0;
-    }
+    length_ISO( real_type offs ) const G2LIB_OVERRIDE
+    { return CD.length_ISO( L, offs ); }
 
     virtual
     real_type
@@ -998,6 +1041,102 @@ namespace G2lib {
     ) const G2LIB_OVERRIDE
     { CD.eval_ISO_DDD( s, offs, x_DDD, y_DDD ); }
 
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    virtual
+    void
+    eval_batch(
+      real_type const s[],
+      int_type        n,
+      real_type       x[],
+      real_type       y[]
+    ) const G2LIB_OVERRIDE
+    { CD.eval_batch( s, n, x, y ); }
+
+    virtual
+    void
+    eval_batch_D(
+      real_type const s[],
+      int_type        n,
+      real_type       x_D[],
+      real_type       y_D[]
+    ) const G2LIB_OVERRIDE
+    { CD.eval_batch_D( s, n, x_D, y_D ); }
+
+    virtual
+    void
+    eval_batch_DD(
+      real_type const s[],
+      int_type        n,
+      real_type       x_DD[],
+      real_type       y_DD[]
+    ) const G2LIB_OVERRIDE
+    { CD.eval_batch_DD( s, n, x_DD, y_DD ); }
+
+    virtual
+    void
+    eval_batch_DDD(
+      real_type const s[],
+      int_type        n,
+      real_type       x_DDD[],
+      real_type       y_DDD[]
+    ) const G2LIB_OVERRIDE
+    { CD.eval_batch_DDD( s, n, x_DDD, y_DDD ); }
+
+    virtual
+    void
+    eval_batch_ISO(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x[],
+      real_type       y[]
+    ) const G2LIB_OVERRIDE
+    { CD.eval_batch_ISO( s, n, offs, x, y ); }
+
+    virtual
+    void
+    eval_batch_ISO_D(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_D[],
+      real_type       y_D[]
+    ) const G2LIB_OVERRIDE
+    { CD.eval_batch_ISO_D( s, n, offs, x_D, y_D ); }
+
+    virtual
+    void
+    eval_batch_ISO_DD(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_DD[],
+      real_type       y_DD[]
+    ) const G2LIB_OVERRIDE
+    { CD.eval_batch_ISO_DD( s, n, offs, x_DD, y_DD ); }
+
+    virtual
+    void
+    eval_batch_ISO_DDD(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_DDD[],
+      real_type       y_DDD[]
+    ) const G2LIB_OVERRIDE
+    { CD.eval_batch_ISO_DDD( s, n, offs, x_DDD, y_DDD ); }
+
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    virtual
+    void
+    sample_stations_ISO(
+      real_type           offs,
+      real_type           tol,
+      vector<real_type> & s
+    ) const G2LIB_OVERRIDE;
+
     /*\
      |  _                        __
      | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -1098,6 +1237,37 @@ namespace G2lib {
       real_type max_size  = 1e100
     ) const;
 
+    /*!
+     * Build once the triangles covering the curve at offset `offs`
+     * and their AABB tree and keep them (several offsets can be
+     * prepared). `closestPoint_ISO`, `collision_ISO` and `intersect_ISO`
+     * with a prepared offset (on both curves for the binary ones) only
+     * read them: no lazy rebuild, no locking, safe from many threads.
+     * The prepared trees are dropped when the curve is changed.
+     */
+    void
+    prepare_AABBtree_ISO(
+      real_type offs,
+      real_type max_angle = m_pi/18, // 10 degree
+      real_type max_size  = 1e100
+    );
+
+    //! remove all the trees built by `prepare_AABBtree_ISO`
+    void
+    clear_prepared_AABBtree()
+    { delete aabb_prepared; aabb_prepared = nullptr; }
+
+    //! tree built by `prepare_AABBtree_ISO` for `offs`, `nullptr` if not prepared
+    AABBtriangles const *
+    prepared_AABBtree_ISO(
+      real_type offs,
+      real_type max_angle = m_pi/18, // 10 degree
+      real_type max_size  = 1e100
+    ) const {
+      if ( aabb_prepared == nullptr ) return nullptr;
+      return AABBtriangles::find( *aabb_prepared, offs, max_angle, max_size );
+    }
+
     // collision detection
     bool
     approximate_collision_ISO(
@@ -22,6 +22,8 @@
 
 #include <cmath>
 #include <cfloat>
+#include <limits>
+#include <cstdint>
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -42,6 +44,9 @@ namespace G2lib {
   using std::back_inserter;
   using std::fill;
   using std::vector;
+  using std::max;
+  using std::min;
+  using std::sqrt;
 
   inline
   real_type
@@ -58,6 +63,24 @@ namespace G2lib {
   power4( real_type a )
   { real_type a2 = a*a; return a2*a2; }
 
+  // the Fresnel integrals raise an exception for not finite arguments,
+  // in no throw mode the arguments are checked before the evaluations
+  static inline
+  bool
+  all_finite( real_type a, real_type b, real_type c )
+  { return std::isfinite( a+b+c ); }
+
+  // data of the G2 problems: distinct points, finite angles and curvatures
+  static inline
+  bool
+  check_data(
+    real_type x0, real_type y0, real_type theta0, real_type kappa0,
+    real_type x1, real_type y1, real_type theta1, real_type kappa1
+  ) {
+    real_type d = hypot( x1-x0, y1-y0 );
+    return d > 0 && std::isfinite( d + 2/d + theta0 + kappa0 + theta1 + kappa1 );
+  }
+
   /*\
    |    ____ ____            _           ____
    |   / ___|___ \ ___  ___ | |_   _____|___ \ __ _ _ __ ___
@@ -87,6 +110,12 @@ namespace G2lib {
     theta1 = _theta1;
     kappa1 = _kappa1;
 
+    if ( noThrow &&
+         !check_data( x0, y0, theta0, kappa0, x1, y1, theta1, kappa1 ) ) {
+      info.set( G2SOLVE_BAD_DATA, 0, 0 );
+      return -1;
+    }
+
     // scale problem
     real_type dx = x1 - x0;
     real_type dy = y1 - y0;
@@ -177,6 +206,10 @@ namespace G2lib {
     real_type A, X, Y;
     evalA( alpha, L, A );
     real_type ak = alpha*k;
+    if ( noThrow && !all_finite( A, ak*L, th ) ) {
+      G[0] = G[1] = std::numeric_limits<real_type>::quiet_NaN();
+      return;
+    }
     GeneralizedFresnelCS( A, ak*L, th, X, Y );
     G[0] = alpha*X;
     G[1] = alpha*Y;
@@ -199,6 +232,11 @@ namespace G2lib {
     evalA( alpha, L, A, A_1, A_2 );
     real_type ak = alpha*k;
     real_type Lk = L*k;
+    if ( noThrow && !all_finite( A, ak*L, th ) ) {
+      G[0]   = G[1]   = std::numeric_limits<real_type>::quiet_NaN();
+      G_1[0] = G_1[1] = G_2[0] = G_2[1] = 0;
+      return;
+    }
     GeneralizedFresnelCS( 3, A, ak*L, th, X, Y );
 
     G[0]   = alpha*X[0];
@@ -257,12 +295,15 @@ namespace G2lib {
     real_type X[2] = { 0.5, 2 };
     int iter = 0;
     bool converged = false;
+    G2solveStatus st   = G2SOLVE_MAX_ITERATION;
+    real_type     lenF = 0;
     do {
       real_type F[2], J[2][2], d[2];
       evalFJ( X, F, J );
-      if ( !solver.factorize( J ) ) break;
+      lenF = hypot(F[0],F[1]);
+      if ( noThrow && !std::isfinite(lenF) ) { st = G2SOLVE_NOT_FINITE; break; }
+      if ( !solver.factorize( J ) ) { st = G2SOLVE_SINGULAR; break; }
       solver.solve( F, d );
-      real_type lenF = hypot(F[0],F[1]);
       #if 0
       X[0] -= d[0];
       X[1] -= d[1];
@@ -281,14 +322,18 @@ namespace G2lib {
         step_found = hypot( dd[0], dd[1] ) <= (1-tau/2)*nd + 1e-6
                      && XX[0] > 0 && XX[0] < 1 && XX[1] > 0;
       } while ( tau > 1e-6 && !step_found );
-      if ( !step_found ) break;
+      if ( !step_found ) { st = G2SOLVE_NO_STEP; break; }
       X[0] = XX[0];
       X[1] = XX[1];
       #endif
       converged = lenF < tolerance;
     } while ( ++iter < maxIter && !converged );
-    if ( converged ) converged = X[1] > 0 && X[0] > 0 && X[0] < 1;
+    if ( converged ) {
+      converged = X[1] > 0 && X[0] > 0 && X[0] < 1;
+      st        = converged ? G2SOLVE_CONVERGED : G2SOLVE_NOT_FEASIBLE;
+    }
     if ( converged ) buildSolution( X[0], X[1] );
+    info.set( st, iter, lenF );
     return converged ? iter : -1;
   }
 
@@ -349,6 +394,12 @@ namespace G2lib {
     theta1 = _theta1;
     kappa1 = _kappa1;
 
+    if ( noThrow &&
+         !check_data( x0, y0, theta0, kappa0, x1, y1, theta1, kappa1 ) ) {
+      info.set( G2SOLVE_BAD_DATA, 0, 0 );
+      return -1;
+    }
+
     // scale problem
     real_type dx = x1 - x0;
     real_type dy = y1 - y0;
@@ -401,6 +452,8 @@ namespace G2lib {
     real_type thM = 0, sM = 0.0;
     int iter = 0;
     bool converged = false;
+    G2solveStatus st = G2SOLVE_MAX_ITERATION;
+    real_type     F  = 0;
     do {
       real_type D0 = thM - th0;
       real_type D1 = thM - th1;
@@ -408,14 +461,15 @@ namespace G2lib {
       GeneralizedFresnelCS( 3, 2*D0, -2*D0, D0, X0, Y0 );
       GeneralizedFresnelCS( 3, 2*D1, -2*D1, D1, X1, Y1 );
 
-      real_type F  = D0*k1*Y0[0]-D1*k0*Y1[0] - k0*k1*sin(thM);
+      F = D0*k1*Y0[0]-D1*k0*Y1[0] - k0*k1*sin(thM);
       real_type dF = D0*k1*(X0[2]-2*X0[1]+X0[0])
                      - D1*k0*(X1[2]-2*X1[1]+X1[0])
                      - k0*k1*cos(thM)
                      + k1*Y0[0]-k0*Y1[0];
 
-      if ( abs(dF) < 1e-10 ) break;
+      if ( abs(dF) < 1e-10 ) { st = G2SOLVE_SINGULAR; break; }
       real_type d = F/dF;
+      if ( noThrow && !std::isfinite(d) ) { st = G2SOLVE_NOT_FINITE; break; }
       #if 0
       thM -= d;
       #else
@@ -434,12 +488,13 @@ namespace G2lib {
         dd = FF/dF;
         step_found = abs( dd ) <= (1-tau/2)*abs(d) + 1e-6;
       } while ( tau > 1e-6 && !step_found );
-      if ( !step_found ) break;
+      if ( !step_found ) { st = G2SOLVE_NO_STEP; break; }
       thM = thM1;
       #endif
       converged = abs(d) < tolerance;
     } while ( ++iter < maxIter && !converged );
     if ( converged ) {
+      st = G2SOLVE_NOT_FEASIBLE;
       real_type D0 = thM - th0;
       real_type D1 = thM - th1;
       GeneralizedFresnelCS( 1, 2*D0, -2*D0, D0, X0, Y0 );
@@ -448,6 +503,8 @@ namespace G2lib {
       converged = sM > 0 && sM < 1e100;
     }
     if ( converged ) converged = buildSolution( sM, thM );
+    if ( converged ) st = G2SOLVE_CONVERGED;
+    info.set( st, iter, abs(F) );
     return converged ? iter : -1;
   }
 
@@ -461,6 +518,7 @@ namespace G2lib {
     real_type L1  = 2*lambda*(th1-thM)/k1;
 
     if ( ! ( L0 > 0 && L1 > 0 ) ) return false;
+    if ( noThrow && !all_finite( L0+L1, dk0+dk1, 2*sM*lambda ) ) return false;
 
     S0.build( x0, y0, theta0, kappa0, dk0, L0 );
     S1.build( x1, y1, theta1, kappa1, dk1, L1 );
@@ -513,17 +571,67 @@ namespace G2lib {
     real_type Dmax,
     real_type dmax
   ) {
+    // save data
+    x0     = _x0;
+    y0     = _y0;
+    theta0 = _theta0;
+    kappa0 = _kappa0;
+    x1     = _x1;
+    y1     = _y1;
+    theta1 = _theta1;
+    kappa1 = _kappa1;
+
+    if ( noThrow &&
+         !check_data( x0, y0, theta0, kappa0, x1, y1, theta1, kappa1 ) ) {
+      info.set( G2SOLVE_BAD_DATA, 0, 0 );
+      return -1;
+    }
+
     try {
-      // save data
-      x0     = _x0;
-      y0     = _y0;
-      theta0 = _theta0;
-      kappa0 = _kappa0;
-      x1     = _x1;
-      y1     = _y1;
-      theta1 = _theta1;
-      kappa1 = _kappa1;
+      real_type sM, thM;
+      if ( !setup( Dmax, dmax, sM, thM ) ) return -1;
+
+      if ( table != nullptr ) {
+        // the table guess is used only near the heuristic one: far from
+        // it (nearly straight data, where sM is large and badly
+        // interpolated) the iterations may reach another solution
+        real_type sMt, thMt;
+        if ( table->guess( Dmax, dmax, th0, th1, K0/s0, K1/s1, sMt, thMt ) &&
+             sMt < 2*sM && sM < 2*sMt && abs(thMt-thM) < m_pi/4 ) {
+          int iter = solve( sMt, thMt );
+          if ( iter >= 0 ) return iter;
+        }
+      }
+      return solve( sM, thM );
+    } catch (...) {
+      info.set( G2SOLVE_EXCEPTION, 0, 0 );
+      return -1;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  G2solve3arc::guess_G1( ClothoidData & SG, real_type & LG ) {
+    if ( noThrow ) {
+      if ( SG.build_G1_nothrow( -1, 0, th0, 1, 0, th1, 1e-12, LG ) >= 0 ) return true;
+      info.set( G2SOLVE_GUESS_FAILED, 0, 0 );
+      return false;
+    }
+    SG.build_G1( -1, 0, th0, 1, 0, th1, 1e-12, LG );
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool
+  G2solve3arc::setup(
+    real_type & Dmax,
+    real_type & dmax,
+    real_type & sM_guess,
+    real_type & thM_guess
+  ) {
+    try {
       // transform to reference frame
       real_type dx = x1 - x0;
       real_type dy = y1 - y0;
@@ -547,13 +655,14 @@ namespace G2lib {
       if ( dmax > m_pi/4 ) dmax = m_pi/4;
 
       // compute guess G1
-      ClothoidCurve SG;
-      SG.build_G1( -1, 0, th0, 1, 0, th1 );
+      ClothoidData SG;
+      real_type    LG;
+      if ( !guess_G1( SG, LG ) ) return false;
 
-      real_type kA = SG.kappaBegin();
-      real_type kB = SG.kappaEnd();
-      real_type dk = abs(SG.dkappa());
-      real_type L3 = SG.length()/3;
+      real_type kA = SG.kappa0;
+      real_type kB = SG.kappa(LG);
+      real_type dk = abs(SG.dk);
+      real_type L3 = LG/3;
 
       real_type tmp = 0.5*abs(K0-kA)/dmax;
       s0 = L3;
@@ -574,8 +683,8 @@ namespace G2lib {
 
       real_type L   = (3*L3-s0-s1)/2;
       real_type thM = SG.theta(s0+L);
-      th0 = SG.thetaBegin();
-      th1 = SG.thetaEnd();
+      th0 = SG.theta0;
+      th1 = SG.theta(LG);
 
       // setup
 
@@ -600,10 +709,12 @@ namespace G2lib {
       c12 = 0.25*(t1*s0 - t0*s1);
       c13 = 0.5*s0*s1;
       c14 = 0.75*(s0 + s1);
-      return solve( L, thM );
+      sM_guess  = L;
+      thM_guess = thM;
+      return true;
     } catch (...) {
-      return -1;
-      // nothing to do
+      info.set( G2SOLVE_EXCEPTION, 0, 0 );
+      return false;
     }
   }
 
@@ -633,6 +744,12 @@ namespace G2lib {
       theta1 = _theta1;
       kappa1 = _kappa1;
 
+      if ( noThrow &&
+           !check_data( x0, y0, theta0, kappa0, x1, y1, theta1, kappa1 ) ) {
+        info.set( G2SOLVE_BAD_DATA, 0, 0 );
+        return -1;
+      }
+
       // transform to reference frame
       real_type dx = x1 - x0;
       real_type dy = y1 - y0;
@@ -650,16 +767,17 @@ namespace G2lib {
       K1 = (kappa1/Lscale); // k1
 
       // compute guess G1
-      ClothoidCurve SG;
-      SG.build_G1( -1, 0, th0, 1, 0, th1 );
+      ClothoidData SG;
+      real_type    LG;
+      if ( !guess_G1( SG, LG ) ) return -1;
 
       s0 = _s0 * Lscale;
       s1 = _s1 * Lscale;
 
-      real_type L   = (SG.length()-s0-s1)/2;
+      real_type L   = (LG-s0-s1)/2;
       real_type thM = SG.theta(s0+L);
-      th0 = SG.thetaBegin();
-      th1 = SG.thetaEnd();
+      th0 = SG.theta0;
+      th1 = SG.theta(LG);
 
       // setup
 
@@ -688,9 +806,8 @@ namespace G2lib {
       return solve( L, thM );
 
     } catch (...) {
-
+      info.set( G2SOLVE_EXCEPTION, 0, 0 );
       return -1;
-      // nothing to do
     }
   }
 
@@ -738,6 +855,11 @@ namespace G2lib {
     real_type dKM   = dsMsM*(thM*(c7-2*sM) + c8*sM + c9);
     real_type KM    = dsMsM*(c10*thM + c11*sM + c12);
 
+    if ( noThrow && !all_finite( dK0+dK1, dKM+KM, thM ) ) {
+      F[0] = F[1] = std::numeric_limits<real_type>::quiet_NaN();
+      return;
+    }
+
     real_type X0[3],  Y0[3],
               X1[3],  Y1[3],
               XMp[3], YMp[3],
@@ -800,12 +922,16 @@ namespace G2lib {
 
     int iter = 0;
     bool converged = false;
+    G2solveStatus st   = G2SOLVE_MAX_ITERATION;
+    real_type     lenF = 0;
     try {
       do {
         evalFJ(X, F, J);
-        real_type lenF = hypot(F[0], F[1]);
+        lenF = hypot(F[0], F[1]);
         converged = lenF < tolerance;
-        if ( converged || !solver.factorize(J) ) break;
+        if ( converged ) break;
+        if ( noThrow && !std::isfinite(lenF) ) { st = G2SOLVE_NOT_FINITE; break; }
+        if ( !solver.factorize(J) ) { st = G2SOLVE_SINGULAR; break; }
         solver.solve(F, d);
         #if 1
         // use undamped Newton
@@ -834,23 +960,30 @@ namespace G2lib {
       } while ( ++iter < maxIter );
 
       // re-check solution
-      if ( converged )
+      if ( converged ) {
         converged = FP_INFINITE != fpclassify(X[0]) &&
                     FP_NAN      != fpclassify(X[0]) &&
                     FP_INFINITE != fpclassify(X[1]) &&
                     FP_NAN      != fpclassify(X[1]);
+        st = converged ? G2SOLVE_CONVERGED : G2SOLVE_NOT_FINITE;
+      }
     }
     catch (...) {
       std::cerr << "G2solve3arc::solve, something go wrong\n";
+      st = G2SOLVE_EXCEPTION;
       // nothing to do
     }
-    if ( converged ) buildSolution(X[0], X[1]); // costruisco comunque soluzione
+    if ( converged ) { // costruisco comunque soluzione
+      converged = buildSolution(X[0], X[1]);
+      if ( !converged ) st = G2SOLVE_NOT_FEASIBLE;
+    }
+    info.set( st, iter, lenF );
     return converged ? iter : -1;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-  void
+  bool
   G2solve3arc::buildSolution( real_type sM, real_type thM ) {
     // soluzione nel frame di riferimento
     /* real_type k0 = K0
@@ -883,6 +1016,8 @@ namespace G2lib {
     dKM *= power2(Lscale/sM);
     KM  *= Lscale/sM;
 
+    if ( noThrow && !all_finite( dK0+dK1, dKM+KM, LM ) ) return false;
+
     //th0 = theta0 - phi;
     //th1 = theta1 - phi;
     S0.build( x0, y0, phi+th0, kappa0, dK0, L0 );
@@ -902,6 +1037,7 @@ namespace G2lib {
       thM + phi, KM, dKM, 2*LM
     );
     SM.changeCurvilinearOrigin( -LM, 2*LM );
+    return true;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1196,6 +1332,789 @@ namespace G2lib {
     }
   }
 
+  /*\
+   |   _        _     _
+   |  | |_ __ _| |__ | | ___
+   |  | __/ _` | '_ \| |/ _ \
+   |  | || (_| | |_) | |  __/
+   |   \__\__,_|_.__/|_|\___|
+  \*/
+
+  static char const G2solve3arcTable_magic[4] = { 'G', '2', '3', 'T' };
+
+  // angle and scaled curvature of the nodes (cell centers)
+  static inline
+  real_type
+  table_theta( int_type i, int_type n )
+  { return m_pi*((2*i+1)/real_type(n)-1); }
+
+  static inline
+  real_type
+  table_kappa( int_type j, int_type n )
+  { return tan(m_pi_2*((2*j+1)/real_type(n)-1)); }
+
+  // position of `t` in [-1,1] in the grid of the n cell centers
+  static inline
+  real_type
+  table_pos( real_type t, int_type n ) {
+    real_type u = ((t+1)*n-1)/2;
+    return max( real_type(0), min( real_type(n-1), u ) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  G2solve3arcTable::solve_range( int_type ib, int_type ie ) {
+    G2solve3arc g;
+    for ( int_type i0 = ib; i0 < ie; ++i0 ) {
+      real_type th0 = table_theta( i0, nth );
+      for ( int_type i1 = 0; i1 < nth; ++i1 ) {
+        real_type th1 = table_theta( i1, nth );
+        for ( int_type j0 = 0; j0 < nk; ++j0 ) {
+          real_type K0 = table_kappa( j0, nk );
+          for ( int_type j1 = 0; j1 < nk; ++j1 ) {
+            real_type K1 = table_kappa( j1, nk );
+            float * d = &data[index(i0,i1,j0,j1)];
+            // scaled problem: Lscale = 1 and phi = 0
+            if ( g.build( -1, 0, th0, K0, 1, 0, th1, K1, Dmax, dmax ) >= 0 ) {
+              real_type sM = g.SM.length()/2;
+              d[0] = float(sM);
+              d[1] = float(g.SM.theta(sM));
+            } else {
+              d[0] = d[1] = std::numeric_limits<float>::quiet_NaN();
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  G2solve3arcTable::generate(
+    size_t    max_bytes,
+    real_type _Dmax,
+    real_type _dmax,
+    int_type  nthreads
+  ) {
+    int_type n = int_type( sqrt( sqrt( real_type(max_bytes/(2*sizeof(float))) ) ) );
+    G2LIB_ASSERT(
+      n >= 2,
+      "G2solve3arcTable::generate, max_bytes = " << max_bytes << " too small"
+    )
+    // same limits of G2solve3arc::build
+    if ( _Dmax <= 0 ) _Dmax = m_pi;
+    if ( _dmax <= 0 ) _dmax = m_pi/8;
+    if ( _Dmax > m_2pi  ) _Dmax = m_2pi;
+    if ( _dmax > m_pi/4 ) _dmax = m_pi/4;
+
+    nth  = nk = n;
+    Dmax = _Dmax;
+    dmax = _dmax;
+    data.resize( index(n-1,n-1,n-1,n-1)+2 );
+
+    #ifdef G2LIB_USE_CXX11
+    if ( nthreads > n ) nthreads = n;
+    if ( nthreads > 1 ) {
+      // contiguous chunks of the first angle
+      size_t nt = size_t(nthreads);
+      size_t nn = size_t(n);
+      vector<std::exception_ptr> errs( nt );
+      vector<std::thread>        workers;
+      workers.reserve( nt );
+      for ( size_t k = 0; k < nt; ++k ) {
+        int_type ib = int_type( (nn*k)/nt );
+        int_type ie = int_type( (nn*(k+1))/nt );
+        std::exception_ptr * perr = &errs[k];
+        workers.push_back( std::thread( [=] {
+          try {
+            this->solve_range( ib, ie );
+          } catch ( ... ) {
+            *perr = std::current_exception();
+          }
+        } ) );
+      }
+      for ( size_t k = 0; k < nt; ++k ) workers[k].join();
+      for ( size_t k = 0; k < nt; ++k )
+        if ( errs[k] ) std::rethrow_exception( errs[k] );
+    } else
+    #else
+    (void)nthreads;
+    #endif
+    {
+      solve_range( 0, n );
+    }
+
+    // continuation: the failed nodes start from the solution of a
+    // neighbour, repeated while some node is recovered
+    G2solve3arc g;
+    bool changed = true;
+    for ( int_type sweep = 0; sweep < 10 && changed; ++sweep ) {
+      changed = false;
+      for ( int_type i0 = 0; i0 < nth; ++i0 ) {
+        for ( int_type i1 = 0; i1 < nth; ++i1 ) {
+          for ( int_type j0 = 0; j0 < nk; ++j0 ) {
+            for ( int_type j1 = 0; j1 < nk; ++j1 ) {
+              float * d = &data[index(i0,i1,j0,j1)];
+              if ( !std::isnan(d[0]) ) continue;
+              int_type idx[4] = { i0, i1, j0, j1 };
+              int_type nmax[4] = { nth, nth, nk, nk };
+              for ( int_type k = 0; k < 8 && std::isnan(d[0]); ++k ) {
+                int_type nb[4] = { i0, i1, j0, j1 };
+                nb[k/2] += (k%2) == 0 ? -1 : 1;
+                if ( nb[k/2] < 0 || nb[k/2] >= nmax[k/2] ) continue;
+                float const * dn = &data[index(nb[0],nb[1],nb[2],nb[3])];
+                if ( std::isnan(dn[0]) ) continue;
+                g.x0     = -1;
+                g.y0     = 0;
+                g.theta0 = table_theta( idx[0], nth );
+                g.kappa0 = table_kappa( idx[2], nk );
+                g.x1     = 1;
+                g.y1     = 0;
+                g.theta1 = table_theta( idx[1], nth );
+                g.kappa1 = table_kappa( idx[3], nk );
+                real_type D = Dmax, dd = dmax, sM, thM;
+                if ( !g.setup( D, dd, sM, thM ) ) break;
+                if ( g.solve( dn[0], dn[1] ) >= 0 ) {
+                  sM   = g.SM.length()/2;
+                  d[0] = float(sM);
+                  d[1] = float(g.SM.theta(sM));
+                  changed = true;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  G2solve3arcTable::numFailed() const {
+    int_type nf = 0;
+    for ( size_t i = 0; i < data.size(); i += 2 )
+      if ( std::isnan(data[i]) ) ++nf;
+    return nf;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  G2solve3arcTable::guess(
+    real_type   _Dmax,
+    real_type   _dmax,
+    real_type   th0,
+    real_type   th1,
+    real_type   K0,
+    real_type   K1,
+    real_type & sM,
+    real_type & thM
+  ) const {
+    if ( data.empty() || _Dmax != Dmax || _dmax != dmax ) return false;
+    real_type u[4] = {
+      table_pos( th0*m_1_pi, nth ),
+      table_pos( th1*m_1_pi, nth ),
+      table_pos( atan(K0)/m_pi_2, nk ),
+      table_pos( atan(K1)/m_pi_2, nk )
+    };
+    int_type  i[4];
+    real_type w[4];
+    for ( int_type k = 0; k < 4; ++k ) {
+      i[k] = min( int_type(u[k]), (k < 2 ? nth : nk)-2 );
+      w[k] = u[k]-i[k];
+    }
+    real_type s = 0, t = 0;
+    for ( int_type c = 0; c < 16; ++c ) {
+      real_type wc = 1;
+      for ( int_type k = 0; k < 4; ++k )
+        wc *= ((c>>k)&1) != 0 ? w[k] : 1-w[k];
+      if ( wc == 0 ) continue;
+      float const * d = &data[index(
+        i[0]+(c&1), i[1]+((c>>1)&1), i[2]+((c>>2)&1), i[3]+((c>>3)&1)
+      )];
+      if ( std::isnan(d[0]) ) return false;
+      s += wc*d[0];
+      t += wc*d[1];
+    }
+    sM  = s;
+    thM = t;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  G2solve3arcTable::save( ostream_type & stream ) const {
+    int32_t n[2] = { int32_t(nth), int32_t(nk) };
+    double  D[2] = { double(Dmax), double(dmax) };
+    stream.write( G2solve3arcTable_magic, 4 );
+    stream.write( reinterpret_cast<char const*>(n), sizeof(n) );
+    stream.write( reinterpret_cast<char const*>(D), sizeof(D) );
+    if ( !data.empty() )
+      stream.write(
+        reinterpret_cast<char const*>(&data.front()),
+        std::streamsize(data.size()*sizeof(float))
+      );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  G2solve3arcTable::load( std::istream & stream ) {
+    char    magic[4];
+    int32_t n[2];
+    double  D[2];
+    stream.read( magic, 4 );
+    stream.read( reinterpret_cast<char*>(n), sizeof(n) );
+    stream.read( reinterpret_cast<char*>(D), sizeof(D) );
+    if ( !stream || !std::equal( magic, magic+4, G2solve3arcTable_magic ) ) return false;
+    bool none = n[0] == 0 && n[1] == 0;
+    if ( !none && ( n[0] < 2 || n[1] < 2 ) ) return false;
+    real_type nr = none ? 0 : 2*power2(real_type(n[0]))*power2(real_type(n[1]));
+    if ( nr*sizeof(float) > real_type(std::numeric_limits<std::streamsize>::max()) )
+      return false;
+    size_t nn = size_t(nr);
+    // read by blocks: the memory grows with the data actually read,
+    // a bad size in a short file fails without a huge allocation
+    vector<float> dd;
+    while ( dd.size() < nn ) {
+      size_t i = dd.size();
+      dd.resize( min( nn, i + (size_t(1)<<20) ) );
+      stream.read(
+        reinterpret_cast<char*>(&dd[i]),
+        std::streamsize((dd.size()-i)*sizeof(float))
+      );
+      if ( !stream ) return false;
+    }
+    nth  = n[0];
+    nk   = n[1];
+    Dmax = D[0];
+    dmax = D[1];
+    data.swap( dd );
+    return true;
+  }
+
+  /*\
+   |   _           _       _
+   |  | |__   __ _| |_ ___| |__
+   |  | '_ \ / _` | __/ __| '_ \
+   |  | |_) | (_| | || (__| | | |
+   |  |_.__/ \__,_|\__\___|_| |_|
+  \*/
+
+  void
+  G2solve3arcBatch::Arcs::resize( size_t n ) {
+    x0.resize( n );
+    y0.resize( n );
+    theta0.resize( n );
+    kappa0.resize( n );
+    dk.resize( n );
+    L.resize( n );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  G2solve3arcBatch::setTolerance( real_type tol ) {
+    G2LIB_ASSERT(
+      tol > 0 && tol <= 0.1,
+      "G2solve3arcBatch::setTolerance, tolerance = " << tol << " must be in (0,0.1]"
+    )
+    tolerance = tol;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  G2solve3arcBatch::setMaxIter( int miter ) {
+    G2LIB_ASSERT(
+      miter > 0 && miter <= 1000,
+      "G2solve3arcBatch::setMaxIter, maxIter = " << miter << " must be in [1,1000]"
+    )
+    maxIter = miter;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  G2solve3arcBatch::setNumThreads( int_type nt ) {
+    G2LIB_ASSERT(
+      nt > 0,
+      "G2solve3arcBatch::setNumThreads, nt = " << nt << " must be positive"
+    )
+    numThreads = nt;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  G2solve3arcBatch::build(
+    int_type        n,
+    real_type const x0[],
+    real_type const y0[],
+    real_type const theta0[],
+    real_type const kappa0[],
+    real_type const x1[],
+    real_type const y1[],
+    real_type const theta1[],
+    real_type const kappa1[],
+    real_type       Dmax,
+    real_type       dmax
+  ) {
+    G2LIB_ASSERT(
+      n >= 0, "G2solve3arcBatch::build, n = " << n << " must be non negative"
+    )
+    size_t nn = size_t(n);
+    S0.resize( nn );
+    SM.resize( nn );
+    S1.resize( nn );
+    stat.resize( nn );
+    iters.resize( nn );
+    if ( n == 0 ) return 0;
+
+    // same limits of G2solve3arc::build
+    if ( Dmax <= 0 ) Dmax = m_pi;
+    if ( dmax <= 0 ) dmax = m_pi/8;
+    if ( Dmax > m_2pi  ) Dmax = m_2pi;
+    if ( dmax > m_pi/4 ) dmax = m_pi/4;
+
+    int_type nthreads = numThreads;
+    #ifdef G2LIB_USE_CXX11
+    if ( nthreads > n ) nthreads = n;
+    if ( nthreads > 1 ) {
+      // contiguous chunks, each thread writes only its part of the results
+      size_t nt = size_t(nthreads);
+      vector<std::exception_ptr> errs( nt );
+      vector<std::thread>        workers;
+      workers.reserve( nt );
+      for ( size_t k = 0; k < nt; ++k ) {
+        int_type ib = int_type( (nn*k)/nt );
+        int_type ie = int_type( (nn*(k+1))/nt );
+        std::exception_ptr * perr = &errs[k];
+        workers.push_back( std::thread( [=] {
+          try {
+            this->solve_range(
+              ib, ie, x0, y0, theta0, kappa0, x1, y1, theta1, kappa1, Dmax, dmax
+            );
+          } catch ( ... ) {
+            *perr = std::current_exception();
+          }
+        } ) );
+      }
+      for ( size_t k = 0; k < nt; ++k ) workers[k].join();
+      for ( size_t k = 0; k < nt; ++k )
+        if ( errs[k] ) std::rethrow_exception( errs[k] );
+    } else
+    #else
+    (void)nthreads;
+    #endif
+    {
+      solve_range(
+        0, n, x0, y0, theta0, kappa0, x1, y1, theta1, kappa1, Dmax, dmax
+      );
+    }
+
+    int_type nconv = 0;
+    for ( size_t i = 0; i < nn; ++i )
+      if ( stat[i] == CONVERGED ) ++nconv;
+    return nconv;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // the problems are solved in blocks that fit in the cache,
+  // the iterations of a block go on until all its problems are done
+  void
+  G2solve3arcBatch::solve_range(
+    int_type        ib,
+    int_type        ie,
+    real_type const X0[],
+    real_type const Y0[],
+    real_type const THETA0[],
+    real_type const KAPPA0[],
+    real_type const X1[],
+    real_type const Y1[],
+    real_type const THETA1[],
+    real_type const KAPPA1[],
+    real_type       Dmax,
+    real_type       dmax
+  ) {
+    // coefficients of the G1 guess (as in ClothoidData::build_G1)
+    static real_type const CF[] = {
+      2.989696028701907,   0.716228953608281,
+      -0.458969738821509, -0.502821153340377,
+      0.261062141752652,  -0.045854475238709
+    };
+    real_type const tolG1 = 1e-12; // default of ClothoidCurve::build_G1
+    G1guessTable const * TG1 = G1guessTable_get();
+    real_type const NaN   = std::numeric_limits<real_type>::quiet_NaN();
+
+    int_type const BLK = 256;
+    size_t   const B   = size_t(BLK);
+
+    // data of the standard problems of the block
+    vector<real_type> phi(B), Lscale(B), th0(B), th1(B), K0(B), K1(B);
+    vector<real_type> s0(B), s1(B), c(15*B), A(B), delta(B), sM(B), thM(B);
+    vector<int_type>  act(B), niter(B);
+    // arguments and values of the batched Fresnel integrals
+    vector<real_type> fa(4*B), fb(4*B), fc(4*B), fC(12*B), fS(12*B);
+
+    for ( int_type jb = ib; jb < ie; jb += BLK ) {
+      int_type m = min( BLK, ie-jb );
+
+      // - - - transform to the reference frame, start of the G1 guess - - -
+      for ( int_type k = 0; k < m; ++k ) {
+        int_type  i  = jb+k;
+        real_type dx = X1[i] - X0[i];
+        real_type dy = Y1[i] - Y0[i];
+        phi[k]    = atan2( dy, dx );
+        Lscale[k] = 2/hypot( dx, dy );
+        th0[k]    = THETA0[i] - phi[k];
+        th1[k]    = THETA1[i] - phi[k];
+        rangeSymm(th0[k]);
+        rangeSymm(th1[k]);
+        K0[k] = KAPPA0[i]/Lscale[k];
+        K1[k] = KAPPA1[i]/Lscale[k];
+
+        // SG.build_G1( -1, 0, th0, 1, 0, th1 )
+        real_type phi0 = th0[k];
+        real_type phi1 = th1[k];
+        phi0 -= m_2pi*round(phi0/m_2pi);
+        phi1 -= m_2pi*round(phi1/m_2pi);
+        if      ( phi0 >  m_pi ) phi0 -= m_2pi;
+        else if ( phi0 < -m_pi ) phi0 += m_2pi;
+        if      ( phi1 >  m_pi ) phi1 -= m_2pi;
+        else if ( phi1 < -m_pi ) phi1 += m_2pi;
+        delta[k] = phi1 - phi0;
+        fc[k]    = phi0;
+        if ( TG1 != nullptr && !TG1->empty() ) {
+          A[k] = TG1->eval( phi0, phi1 );
+        } else {
+          real_type XX = phi0*m_1_pi;
+          real_type YY = phi1*m_1_pi;
+          real_type xy = XX*YY;
+          YY *= YY; XX *= XX;
+          A[k] = (phi0+phi1) * ( CF[0] + xy*(CF[1] + xy*CF[2]) +
+                                 (CF[3]+xy*CF[4])*(XX+YY) + CF[5]*(XX*XX+YY*YY) );
+        }
+        act[k]   = k;
+        niter[k] = 0;
+      }
+      // phi0 of the guess is kept in c[14*B+k] during the G1 iterations
+      for ( int_type k = 0; k < m; ++k ) c[14*B+size_t(k)] = fc[k];
+
+      // - - - Newton of the G1 guess on the active problems - - -
+      int_type na = m;
+      while ( na > 0 ) {
+        for ( int_type j = 0; j < na; ++j ) {
+          int_type k = act[j];
+          fa[j] = 2*A[k];
+          fb[j] = delta[k]-A[k];
+          fc[j] = c[14*B+size_t(k)];
+        }
+        GeneralizedFresnelCS_batch( 3, na, &fa.front(), &fb.front(), &fc.front(),
+                                    &fC.front(), &fS.front() );
+        int_type na1 = 0;
+        for ( int_type j = 0; j < na; ++j ) {
+          int_type  k  = act[j];
+          real_type g  = fS[j];
+          real_type dg = fC[2*na+j] - fC[na+j];
+          A[k] -= g / dg;
+          if ( ++niter[k] <= 10 && abs(g) > tolG1 ) act[na1++] = k;
+          else niter[k] = abs(g) <= tolG1 ? 0 : -1; // -1 = not converged
+        }
+        na = na1;
+      }
+
+      // length of the guess
+      for ( int_type k = 0; k < m; ++k ) {
+        fa[k] = 2*A[k];
+        fb[k] = delta[k]-A[k];
+        fc[k] = c[14*B+size_t(k)];
+      }
+      GeneralizedFresnelCS_batch( 1, m, &fa.front(), &fb.front(), &fc.front(),
+                                  &fC.front(), &fS.front() );
+
+      // - - - guess and setup of the 3 arc problem (as G2solve3arc::build) - - -
+      na = 0;
+      for ( int_type k = 0; k < m; ++k ) {
+        int_type  i  = jb+k;
+        real_type LG = 2/fC[k];
+        if ( niter[k] < 0 || !( LG > 0 ) ) {
+          stat[i]  = GUESS_FAILED;
+          iters[i] = 0;
+          continue;
+        }
+        real_type kA  = (delta[k]-A[k])/LG;          // SG.kappaBegin()
+        real_type dkG = 2*A[k]/LG/LG;                // SG.dkappa()
+        real_type kB  = kA + dkG*LG;                 // SG.kappaEnd()
+        real_type dk  = abs(dkG);
+        real_type L3  = LG/3;
+
+        real_type tmp = 0.5*abs(K0[k]-kA)/dmax;
+        s0[k] = L3;
+        if ( tmp*s0[k] > 1 ) s0[k] = 1/tmp;
+        tmp = (abs(K0[k]+kA)+s0[k]*dk)/(2*Dmax);
+        if ( tmp*s0[k] > 1 ) s0[k] = 1/tmp;
+
+        tmp = 0.5*abs(K1[k]-kB)/dmax;
+        s1[k] = L3;
+        if ( tmp*s1[k] > 1 ) s1[k] = 1/tmp;
+        tmp = (abs(K1[k]+kB)+s1[k]*dk)/(2*Dmax);
+        if ( tmp*s1[k] > 1 ) s1[k] = 1/tmp;
+
+        real_type dth   = abs(th0[k]-th1[k]) / m_2pi;
+        real_type scale = power3(cos( power4(dth)*m_pi_2 ));
+        s0[k] *= scale;
+        s1[k] *= scale;
+
+        real_type L  = (3*L3-s0[k]-s1[k])/2;
+        real_type sG = s0[k]+L;
+        real_type t0G = th0[k];                      // SG.thetaBegin()
+        thM[k] = t0G + sG*(kA + 0.5*sG*dkG);         // SG.theta(s0+L)
+        sM[k]  = L;
+        th1[k] = t0G + LG*(kA + 0.5*LG*dkG);         // SG.thetaEnd()
+
+        real_type S0k = s0[k], S1k = s1[k];
+        real_type T0  = th0[k], T1 = th1[k];
+        real_type k0  = K0[k] *= S0k;
+        real_type k1  = K1[k] *= S1k;
+        real_type t0  = 2*T0+k0;
+        real_type t1  = 2*T1-k1;
+        real_type * C = &c[size_t(k)];
+        C[ 0*B] = S0k*S1k;
+        C[ 1*B] = 2 * S0k;
+        C[ 2*B] = 0.25*((k1-6*(k0+T0)-2*T1)*S0k - 3*k0*S1k);
+        C[ 3*B] = -C[0] * (k0 + T0);
+        C[ 4*B] = 2 * S1k;
+        C[ 5*B] = 0.25*((6*(k1-T1)-k0-2*T0)*S1k + 3*k1*S0k);
+        C[ 6*B] = C[0] * (k1 - T1);
+        C[ 7*B] = -0.5*(S0k + S1k);
+        C[ 8*B] = T0 + T1 + 0.5*(k0 - k1);
+        C[ 9*B] = 0.25*(t1*S0k + t0*S1k);
+        C[10*B] = 0.5*(S1k - S0k);
+        C[11*B] = 0.5*(T1 - T0) - 0.25*(k0 + k1);
+        C[12*B] = 0.25*(t1*S0k - t0*S1k);
+        C[13*B] = 0.5*S0k*S1k;
+        C[14*B] = 0.75*(S0k + S1k);
+        niter[k]  = 0;
+        act[na++] = k;
+      }
+
+      // - - - Newton of the 3 arc problem (as G2solve3arc::solve) - - -
+      while ( na > 0 ) {
+        for ( int_type j = 0; j < na; ++j ) {
+          int_type          k = act[j];
+          real_type const * C = &c[size_t(k)];
+          real_type sm  = sM[k];
+          real_type th  = thM[k];
+          real_type dsM = 1.0 / (C[13*B]+(C[14*B]+sm)*sm);
+          real_type dK0 = dsM*(C[0]*th + sm*(C[B]*th + C[2*B] - sm*K0[k]) + C[3*B]);
+          real_type dK1 = dsM*(C[0]*th + sm*(C[4*B]*th + C[5*B] + sm*K1[k]) + C[6*B]);
+          real_type dKM = dsM*sm*(th*(C[7*B]-2*sm) + C[8*B]*sm + C[9*B]);
+          real_type KM  = dsM*sm*(C[10*B]*th + C[11*B]*sm + C[12*B]);
+          fa[j]      = dK0; fb[j]      =  K0[k]; fc[j]      = th0[k];
+          fa[na+j]   = dK1; fb[na+j]   = -K1[k]; fc[na+j]   = th1[k];
+          fa[2*na+j] = dKM; fb[2*na+j] =  KM;    fc[2*na+j] = th;
+          fa[3*na+j] = dKM; fb[3*na+j] = -KM;    fc[3*na+j] = th;
+        }
+        int_type nf = 4*na;
+        GeneralizedFresnelCS_batch( 3, nf, &fa.front(), &fb.front(), &fc.front(),
+                                    &fC.front(), &fS.front() );
+        int_type na1 = 0;
+        for ( int_type j = 0; j < na; ++j ) {
+          int_type          k = act[j];
+          int_type          i = jb+k;
+          real_type const * C = &c[size_t(k)];
+          real_type c0 = C[0],    c1 = C[B],     c2 = C[2*B],  c3 = C[3*B];
+          real_type c4 = C[4*B],  c5 = C[5*B],   c6 = C[6*B],  c7 = C[7*B];
+          real_type c8 = C[8*B],  c9 = C[9*B],   c10 = C[10*B], c11 = C[11*B];
+          real_type c12 = C[12*B], c13 = C[13*B], c14 = C[14*B];
+          real_type sm = sM[k];
+          real_type th = thM[k];
+
+          // moment q of the integral r (0..3) of the problem j
+          #define FX(r,q) fC[(q)*nf+(r)*na+j]
+          #define FY(r,q) fS[(q)*nf+(r)*na+j]
+
+          real_type dsM   = 1.0 / (c13+(c14+sm)*sm);
+          real_type dsMsM = dsM*sm;
+          real_type t0 = FX(2,0)+FX(3,0);
+          real_type t1 = FY(2,0)+FY(3,0);
+          real_type F[2], J[2][2], d[2];
+          F[0] = s0[k]*FX(0,0) + s1[k]*FX(1,0) + sm*t0 - 2;
+          F[1] = s0[k]*FY(0,0) + s1[k]*FY(1,0) + sm*t1 - 0;
+
+          real_type lenF = hypot(F[0], F[1]);
+          if ( lenF < tolerance ) {
+            bool ok = std::isfinite(sm) && std::isfinite(th);
+            stat[i]  = ok ? CONVERGED : NOT_FINITE;
+            iters[i] = niter[k];
+            continue;
+          }
+          if ( !std::isfinite(lenF) ) {
+            stat[i]  = NOT_FINITE;
+            iters[i] = niter[k];
+            continue;
+          }
+
+          real_type dsM2 = dsM*dsM;
+          real_type g0   = -(2 * sm + c14)*dsM2;
+          real_type g1   = (c13 - sm*sm)*dsM2;
+          real_type g2   = sm*(sm*c14+2*c13)*dsM2;
+
+          real_type dK0_sM  = (c0*th+c3)*g0 + (c1*th+c2)*g1 - K0[k]*g2;
+          real_type dK1_sM  = (c0*th+c6)*g0 + (c4*th+c5)*g1 + K1[k]*g2;
+          real_type dKM_sM  = (c7*th+c9)*g1 + (c8-2*th)*g2;
+          real_type KM_sM   = (c10*th+c12)*g1 + c11*g2;
+
+          real_type dK0_thM = (c0+c1*sm)*dsM;
+          real_type dK1_thM = (c0+c4*sm)*dsM;
+          real_type dKM_thM = (c7-2*sm)*dsMsM;
+          real_type KM_thM  = c10*dsMsM;
+
+          real_type f0 = -0.5*s0[k]*FY(0,2);
+          real_type f1 = -0.5*s1[k]*FY(1,2);
+          real_type f2 = -0.5*sm*(FY(3,2) + FY(2,2));
+          real_type f3 = sm*(FY(3,1) - FY(2,1));
+          real_type f4 = 0.5*s0[k]*FX(0,2);
+          real_type f5 = 0.5*s1[k]*FX(1,2);
+          real_type f6 = 0.5*sm*(FX(3,2) + FX(2,2));
+          real_type f7 = sm*(FX(2,1) - FX(3,1));
+
+          #undef FX
+          #undef FY
+
+          J[0][0] = f0 * dK0_sM  + f1 * dK1_sM  + f2 * dKM_sM  + f3 * KM_sM  + t0;
+          J[0][1] = f0 * dK0_thM + f1 * dK1_thM + f2 * dKM_thM + f3 * KM_thM - sm * t1;
+          J[1][0] = f4 * dK0_sM  + f5 * dK1_sM  + f6 * dKM_sM  + f7 * KM_sM  + t1;
+          J[1][1] = f4 * dK0_thM + f5 * dK1_thM + f6 * dKM_thM + f7 * KM_thM + sm * t0;
+
+          Solve2x2 solver;
+          if ( !solver.factorize(J) ) {
+            stat[i]  = SINGULAR;
+            iters[i] = niter[k];
+            continue;
+          }
+          solver.solve(F, d);
+          sM[k]  -= d[0];
+          thM[k] -= d[1];
+          if ( ++niter[k] < maxIter ) {
+            act[na1++] = k;
+          } else {
+            stat[i]  = MAX_ITERATION;
+            iters[i] = niter[k];
+          }
+        }
+        na = na1;
+      }
+
+      // - - - arcs of the solutions (as G2solve3arc::buildSolution) - - -
+      // the integrals: end of S0 and start of SM in the standard frame,
+      // start of S1 and of SM in the original frame
+      na = 0;
+      for ( int_type k = 0; k < m; ++k ) {
+        int_type i = jb+k;
+        if ( stat[i] != CONVERGED ) {
+          S0.x0[i] = S0.y0[i] = S0.theta0[i] = S0.kappa0[i] = S0.dk[i] = S0.L[i] = NaN;
+          SM.x0[i] = SM.y0[i] = SM.theta0[i] = SM.kappa0[i] = SM.dk[i] = SM.L[i] = NaN;
+          S1.x0[i] = S1.y0[i] = S1.theta0[i] = S1.kappa0[i] = S1.dk[i] = S1.L[i] = NaN;
+          continue;
+        }
+        act[na++] = k;
+      }
+      if ( na == 0 ) continue;
+
+      for ( int_type j = 0; j < na; ++j ) {
+        int_type          k = act[j];
+        real_type const * C = &c[size_t(k)];
+        real_type sm  = sM[k];
+        real_type th  = thM[k];
+        real_type dsM = 1.0 / (C[13*B]+(C[14*B]+sm)*sm);
+        real_type dK0 = dsM*(C[0]*th + sm*(C[B]*th - K0[k]*sm + C[2*B]) + C[3*B]);
+        real_type dK1 = dsM*(C[0]*th + sm*(C[4*B]*th + K1[k]*sm + C[5*B]) + C[6*B]);
+        real_type dKM = dsM*sm*(C[7*B]*th + sm*(C[8*B] - 2*th) + C[9*B]);
+        real_type KM  = dsM*sm*(C[10*B]*th + C[11*B]*sm + C[12*B]);
+
+        real_type Ls = Lscale[k];
+        real_type L0 = s0[k]/Ls;
+        real_type L1 = s1[k]/Ls;
+        real_type LM = sm/Ls;
+        // store the arcs data in the original frame (start of S0, end of S1)
+        int_type i = jb+k;
+        S0.x0[i]     = X0[i];
+        S0.y0[i]     = Y0[i];
+        S0.theta0[i] = phi[k]+th0[k];
+        S0.kappa0[i] = KAPPA0[i];
+        S0.dk[i]     = dK0*power2(Ls/s0[k]);
+        S0.L[i]      = L0;
+        S1.dk[i]     = dK1*power2(Ls/s1[k]);
+        S1.L[i]      = L1;
+        SM.dk[i]     = dKM*power2(Ls/sm);
+        SM.kappa0[i] = KM*Ls/sm;
+        SM.L[i]      = 2*LM;
+
+        fa[j]      = dK0;  fb[j]      =  K0[k]; fc[j]      = th0[k];
+        fa[na+j]   = dKM;  fb[na+j]   = -KM;    fc[na+j]   = th;
+        // S1 evaluated at -L1 from the end: GeneralizedFresnelCS(dk s^2, kappa s, theta)
+        fa[2*na+j] = S1.dk[i]*L1*L1; fb[2*na+j] = -KAPPA1[i]*L1; fc[2*na+j] = phi[k]+th1[k];
+        // SM evaluated at -LM from the middle point
+        fa[3*na+j] = SM.dk[i]*LM*LM; fb[3*na+j] = -SM.kappa0[i]*LM; fc[3*na+j] = th+phi[k];
+      }
+      int_type nf = 4*na;
+      GeneralizedFresnelCS_batch( 1, nf, &fa.front(), &fb.front(), &fc.front(),
+                                  &fC.front(), &fS.front() );
+      for ( int_type j = 0; j < na; ++j ) {
+        int_type  k  = act[j];
+        int_type  i  = jb+k;
+        real_type Ls = Lscale[k];
+        real_type L1 = S1.L[i];
+        real_type LM = SM.L[i]/2;
+
+        // S1 built at the end point and moved back of L1
+        real_type T1 = phi[k]+th1[k];
+        S1.x0[i]     = X1[i] - L1*fC[2*na+j];
+        S1.y0[i]     = Y1[i] - L1*fS[2*na+j];
+        S1.theta0[i] = T1 - L1*(KAPPA1[i] - 0.5*L1*S1.dk[i]);
+        S1.kappa0[i] = KAPPA1[i] - L1*S1.dk[i];
+
+        // middle point of SM, then moved back of LM
+        real_type xM = s0[k] * fC[j] + sM[k] * fC[na+j] - 1;
+        real_type yM = s0[k] * fS[j] + sM[k] * fS[na+j];
+        real_type C  = cos(phi[k]);
+        real_type S  = sin(phi[k]);
+        real_type dx = (xM + 1) / Ls;
+        real_type dy = yM / Ls;
+        real_type xm = X0[i] + C * dx - S * dy;
+        real_type ym = Y0[i] + C * dy + S * dx;
+        real_type TM = thM[k]+phi[k];
+        real_type KM = SM.kappa0[i];
+        SM.x0[i]     = xm - LM*fC[3*na+j];
+        SM.y0[i]     = ym - LM*fS[3*na+j];
+        SM.theta0[i] = TM - LM*(KM - 0.5*LM*SM.dk[i]);
+        SM.kappa0[i] = KM - LM*SM.dk[i];
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  G2solve3arcBatch::get(
+    int_type        i,
+    ClothoidCurve & C0,
+    ClothoidCurve & CM,
+    ClothoidCurve & C1
+  ) const {
+    size_t k = size_t(i);
+    C0.build( S0.x0[k], S0.y0[k], S0.theta0[k], S0.kappa0[k], S0.dk[k], S0.L[k] );
+    CM.build( SM.x0[k], SM.y0[k], SM.theta0[k], SM.kappa0[k], SM.dk[k], SM.L[k] );
+    C1.build( S1.x0[k], S1.y0[k], S1.theta0[k], S1.kappa0[k], S1.dk[k], S1.L[k] );
+  }
+
   /*\
    |
    |    ___ _     _   _        _    _ ___      _ _           ___ ___
@@ -1656,6 +2575,291 @@ namespace G2lib {
     return true;
   }
 
+  /*\
+   |            _
+   |   ___  ___| |_   _____
+   |  / __|/ _ \ \ \ / / _ \
+   |  \__ \ (_) | |\ V /  __/
+   |  |___/\___/|_| \_/ \___|
+  \*/
+
+  // Solve the tridiagonal system (Thomas algorithm, no pivoting)
+  //   a[i]*x[i-1] + b[i]*x[i] + c[i]*x[i+1] = r[i],  i = 0..n-1
+  // (a[0] and c[n-1] are not used), `w` is a workspace of size n.
+  // The curvature continuity equations behave as the ones of a cubic
+  // spline: the matrix is diagonally dominant near the solution.
+  static
+  bool
+  tridiag_solve(
+    int_type        n,
+    real_type const a[],
+    real_type const b[],
+    real_type const c[],
+    real_type const r[],
+    real_type       x[],
+    real_type       w[]
+  ) {
+    if ( n <= 0 ) return true;
+    real_type piv = b[0];
+    if ( piv == 0 ) return false;
+    x[0] = r[0]/piv;
+    for ( int_type i = 1; i < n; ++i ) {
+      w[i] = c[i-1]/piv;
+      piv  = b[i] - a[i]*w[i];
+      if ( piv == 0 ) return false;
+      x[i] = (r[i] - a[i]*x[i-1])/piv;
+    }
+    for ( int_type i = n-2; i >= 0; --i ) x[i] -= w[i+1]*x[i+1];
+    return std::isfinite(x[0]);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidSplineG2::newton_G2(
+    real_type           theta[],
+    real_type           tol,
+    int_type            max_iter,
+    vector<real_type> & vals
+  ) const {
+    int_type ne     = npts - 1;
+    int_type ne1    = npts - 2;
+    int_type n      = npts - 2; // unknowns: the internal angles
+    bool     cyclic = tt == P2; // and theta[0] = theta[ne] - 2*m*pi
+    size_t   nn     = size_t( n > 0 ? n : 1 );
+
+    vector<real_type> a(nn), b(nn), c(nn), r(nn), dx(nn), z(nn), u(nn), w(nn);
+    vector<real_type> th( theta, theta+npts ), cc( numConstraints() );
+    vals.resize( jacobian_nnz() );
+
+    for ( int_type iter = 0; iter <= max_iter; ++iter ) {
+      // jacobian fills k, dk, L, kL of all the segments
+      this->jacobian( theta, &vals.front() );
+      real_type nrm = 0, rs = 0;
+      for ( int_type j = 0; j < ne1; ++j ) {
+        r[j] = k[j+1]-kL[j];
+        nrm  = max( nrm, abs(r[j]) );
+      }
+      if ( cyclic ) {
+        rs  = k[0]-kL[ne1];
+        nrm = max( nrm, abs(rs) );
+      }
+      if ( nrm <= tol ) return true;
+      if ( iter == max_iter || n == 0 ) break;
+      ++last_inner;
+
+      for ( int_type j = 0; j < n; ++j ) {
+        a[j] = vals[3*j+0];
+        b[j] = vals[3*j+1];
+        c[j] = vals[3*j+2];
+      }
+      if ( !tridiag_solve( n, &a.front(), &b.front(), &c.front(),
+                           &r.front(), &dx.front(), &w.front() ) ) return false;
+
+      real_type dy = 0;
+      if ( cyclic ) {
+        // bordered system, the border is theta[0] (and theta[ne])
+        size_t kk = size_t(3*n);
+        fill( u.begin(), u.end(), 0 );
+        u[0]   += a[0];
+        u[n-1] += c[n-1];
+        if ( !tridiag_solve( n, &a.front(), &b.front(), &c.front(),
+                             &u.front(), &z.front(), &w.front() ) ) return false;
+        real_type d   = vals[kk] + vals[kk+3];
+        real_type vdx = vals[kk+1]*dx[0] + vals[kk+2]*dx[n-1];
+        real_type vz  = vals[kk+1]*z[0]  + vals[kk+2]*z[n-1];
+        if ( d == vz ) return false;
+        dy = (rs - vdx)/(d - vz);
+        for ( int_type i = 0; i < n; ++i ) dx[i] -= z[i]*dy;
+      }
+
+      // backtracking on the maximum curvature jump
+      real_type alpha = 1;
+      bool      ok    = false;
+      for ( int_type ls = 0; ls < 30 && !ok; ++ls ) {
+        for ( int_type i = 0; i < n; ++i ) th[i+1] = theta[i+1] + alpha*dx[i];
+        th[0]  = theta[0]  + alpha*dy;
+        th[ne] = theta[ne] + alpha*dy;
+        this->constraints( &th.front(), &cc.front() );
+        real_type nrm1 = 0;
+        for ( int_type j = 0; j < ne1; ++j ) nrm1 = max( nrm1, abs(cc[j]) );
+        if ( cyclic ) nrm1 = max( nrm1, abs(cc[ne1]) );
+        ok = nrm1 < (1-1e-4*alpha)*nrm;
+        if ( !ok ) alpha /= 2;
+      }
+      if ( !ok ) return false;
+      copy( th.begin(), th.end(), theta );
+    }
+    return false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidSplineG2::reduced_G2(
+    real_type           theta[],
+    real_type           tol,
+    int_type            max_iter,
+    vector<real_type> & vals,
+    real_type         & F,
+    real_type           G[2]
+  ) const {
+    if ( !newton_G2( theta, tol, max_iter, vals ) ) return false;
+    int_type ne = npts - 1;
+    int_type n  = npts - 2;
+    size_t   nn = size_t( n > 0 ? n : 1 );
+    vector<real_type> g( npts ), a(nn), b(nn), c(nn), lambda(nn), w(nn);
+    this->objective( theta, F );
+    this->gradient( theta, &g.front() );
+    if ( n == 0 ) {
+      G[0] = g[0];
+      G[1] = g[ne];
+      return true;
+    }
+    // the internal angles follow the curvature continuity:
+    //   dF/dp = g_p - J_p^T lambda,  J_I^T lambda = g_I
+    // (vals is the jacobian at theta computed by newton_G2)
+    for ( int_type j = 0; j < n; ++j ) {
+      a[j] = j > 0   ? vals[3*j-1] : 0; // transposed matrix
+      b[j] = vals[3*j+1];
+      c[j] = j < n-1 ? vals[3*j+3] : 0;
+    }
+    if ( !tridiag_solve( n, &a.front(), &b.front(), &c.front(),
+                         &g[1], &lambda.front(), &w.front() ) ) return false;
+    G[0] = g[0]  - lambda[0]*vals[0];
+    G[1] = g[ne] - lambda[n-1]*vals[3*n-1];
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidSplineG2::optimize_G2(
+    real_type theta[],
+    real_type tol,
+    int_type  max_iter
+  ) const {
+    int_type ne = npts - 1;
+
+    vector<real_type> vals, th( theta, theta+npts );
+    real_type F, G[2];
+    if ( !reduced_G2( theta, tol, max_iter, vals, F, G ) ) return false;
+
+    // BFGS on the 2 angles at the extrema, H approximates the inverse hessian.
+    // The internal angles are known up to `tol`, so the reduced gradient
+    // is accurate only up to about sqrt(tol)
+    real_type H[2][2] = { { 1, 0 }, { 0, 1 } };
+    real_type gtol    = sqrt(tol);
+    bool      first   = true;
+    for ( last_iter = 0; last_iter < max_iter; ++last_iter ) {
+      if ( max( abs(G[0]), abs(G[1]) ) <= gtol*(1+abs(F)) ) return true;
+
+      real_type d[2] = { -H[0][0]*G[0]-H[0][1]*G[1], -H[1][0]*G[0]-H[1][1]*G[1] };
+      real_type Gd   = G[0]*d[0]+G[1]*d[1];
+      if ( Gd >= 0 ) { // not a descent direction, restart
+        H[0][0] = H[1][1] = 1; H[0][1] = H[1][0] = 0;
+        d[0] = -G[0]; d[1] = -G[1];
+        Gd   = -(G[0]*G[0]+G[1]*G[1]);
+        first = true;
+      }
+      // do not rotate the extrema more than 0.1 rad at once
+      real_type dmax = max( abs(d[0]), abs(d[1]) );
+      if ( dmax > 0.1 ) { d[0] *= 0.1/dmax; d[1] *= 0.1/dmax; Gd *= 0.1/dmax; }
+
+      // Armijo backtracking, each trial is projected on the constraints
+      real_type alpha = 1, F1 = F, G1[2] = { G[0], G[1] };
+      bool      ok    = false;
+      for ( int_type ls = 0; ls < 30 && !ok; ++ls ) {
+        copy( theta, theta+npts, th.begin() );
+        th[0]  += alpha*d[0];
+        th[ne] += alpha*d[1];
+        ok = reduced_G2( &th.front(), tol, max_iter, vals, F1, G1 ) &&
+             F1 <= F + 1e-4*alpha*Gd;
+        if ( !ok ) alpha /= 2;
+      }
+      // no decrease: converged to the precision of the target
+      if ( !ok ) return max( abs(G[0]), abs(G[1]) ) <= 10*gtol*(1+abs(F));
+
+      real_type sv[2] = { alpha*d[0], alpha*d[1] };
+      real_type yv[2] = { G1[0]-G[0], G1[1]-G[1] };
+      real_type sy    = sv[0]*yv[0]+sv[1]*yv[1];
+      if ( sy > 0 ) {
+        if ( first ) { // scale the initial approximation
+          real_type sc = sy/(yv[0]*yv[0]+yv[1]*yv[1]);
+          H[0][0] = H[1][1] = sc; H[0][1] = H[1][0] = 0;
+          first = false;
+        }
+        // H = (I - rho s y^T) H (I - rho y s^T) + rho s s^T
+        real_type rho   = 1/sy;
+        real_type Hy[2] = { H[0][0]*yv[0]+H[0][1]*yv[1], H[1][0]*yv[0]+H[1][1]*yv[1] };
+        real_type yHy   = yv[0]*Hy[0]+yv[1]*Hy[1];
+        for ( int_type i = 0; i < 2; ++i )
+          for ( int_type j = 0; j < 2; ++j )
+            H[i][j] += rho*( (1+rho*yHy)*sv[i]*sv[j] - Hy[i]*sv[j] - sv[i]*Hy[j] );
+      }
+      copy( th.begin(), th.end(), theta );
+      F    = F1;
+      G[0] = G1[0];
+      G[1] = G1[1];
+      // the extrema do not move anymore
+      if ( max( abs(sv[0]), abs(sv[1]) ) <= tol ) return true;
+    }
+    return false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidSplineG2::solve(
+    real_type theta[],
+    real_type tol,
+    int_type  max_iter
+  ) const {
+    G2LIB_ASSERT(
+      npts >= (tt == P2 ? 3 : 2),
+      "ClothoidSplineG2::solve, npts = " << npts << " too few points"
+    )
+    G2LIB_ASSERT(
+      tt != P3, "ClothoidSplineG2::solve, target P3 is not defined"
+    )
+    int_type ne = npts - 1;
+    last_iter  = 0;
+    last_inner = 0;
+    vector<real_type> vals;
+    switch ( tt ) {
+    case P1:
+      // the same angles modulo 2*pi of the guess
+      theta[0]  -= diff2pi( theta[0]  - theta_I );
+      theta[ne] -= diff2pi( theta[ne] - theta_F );
+      { bool ok = newton_G2( theta, tol, max_iter, vals );
+        last_iter = last_inner;
+        return ok; }
+    case P2:
+      theta[ne] -= diff2pi( theta[ne] - theta[0] );
+      { bool ok = newton_G2( theta, tol, max_iter, vals );
+        last_iter = last_inner;
+        return ok; }
+    default:
+      break;
+    }
+    return optimize_G2( theta, tol, max_iter );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidSplineG2::solve(
+    ClothoidList & C,
+    real_type      tol,
+    int_type       max_iter
+  ) const {
+    vector<real_type> theta( npts ), tmin( npts ), tmax( npts );
+    this->guess( &theta.front(), &tmin.front(), &tmax.front() );
+    bool ok = this->solve( &theta.front(), tol, max_iter );
+    C.build_G1( npts, &x.front(), &y.front(), &theta.front() );
+    return ok;
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   ostream_type &
@@ -27,6 +27,10 @@
 #include <limits>
 #include <algorithm>
 
+#ifdef G2LIB_USE_CXX11
+  #include <exception>
+#endif
+
 #ifdef __GNUC__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wsign-conversion"
@@ -40,9 +44,12 @@ namespace G2lib {
 
   using std::numeric_limits;
   using std::lower_bound;
+  using std::upper_bound;
   using std::vector;
   using std::swap;
   using std::abs;
+  using std::max;
+  using std::min;
 
   /*\
    |   ____ _       _   _           _     _ _     _     _
@@ -165,6 +172,7 @@ namespace G2lib {
 
   void
   ClothoidList::init() {
+    this->resetAABBtree();
     this->s0.clear();
     this->clotoidList.clear();
     this->resetLastInterval();
@@ -174,6 +182,7 @@ namespace G2lib {
 
   void
   ClothoidList::copy( ClothoidList const & L ) {
+    this->resetAABBtree();
     clotoidList.clear();
     clotoidList.reserve(L.clotoidList.size());
     std::copy(
@@ -196,6 +205,7 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( LineSegment const & LS ) {
+    this->resetAABBtree();
     if ( clotoidList.empty() ) {
       s0.push_back(0);
       s0.push_back(LS.length());
@@ -209,6 +219,7 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( CircleArc const & C ) {
+    this->resetAABBtree();
     if ( clotoidList.empty() ) {
       s0.push_back(0);
       s0.push_back(C.length());
@@ -222,6 +233,7 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( Biarc const & c ) {
+    this->resetAABBtree();
     if ( clotoidList.empty() ) s0.push_back( 0 );
     CircleArc const & C0 = c.getC0();
     CircleArc const & C1 = c.getC1();
@@ -235,6 +247,7 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( ClothoidCurve const & c ) {
+    this->resetAABBtree();
     if ( clotoidList.empty() ) {
       s0.push_back(0);
       s0.push_back(c.length());
@@ -248,6 +261,7 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( BiarcList const & c ) {
+    this->resetAABBtree();
     s0.reserve( s0.size() + c.biarcList.size() + 1 );
     clotoidList.reserve( clotoidList.size() + 2*c.biarcList.size() );
 
@@ -266,15 +280,17 @@ namespace G2lib {
 
   void
   ClothoidList::push_back( PolyLine const & c ) {
-    s0.reserve( s0.size() + c.polylineList.size() + 1 );
-    clotoidList.reserve( clotoidList.size() + c.polylineList.size() );
+    this->resetAABBtree();
+    size_t ns = size_t(c.numSegment());
+    s0.reserve( s0.size() + ns + 1 );
+    clotoidList.reserve( clotoidList.size() + ns );
 
     if ( s0.empty() ) s0.push_back(0);
 
-    vector<LineSegment>::const_iterator ip = c.polylineList.begin();
-    for (; ip != c.polylineList.end(); ++ip ) {
-      s0.push_back(s0.back()+ip->length());
-      clotoidList.push_back(ClothoidCurve(*ip));
+    for ( size_t i = 0; i < ns; ++i ) {
+      LineSegment LS = c.getSegment( int_type(i) );
+      s0.push_back(s0.back()+LS.length());
+      clotoidList.push_back(ClothoidCurve(LS));
     }
   }
 
@@ -406,12 +422,30 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  // build the segments [ib,ie) of the list, already resized
+  static
+  void
+  build_G1_range(
+    ClothoidCurve * C,
+    int_type        ib,
+    int_type        ie,
+    real_type const x[],
+    real_type const y[],
+    real_type const theta[]
+  ) {
+    for ( int_type k = ib; k < ie; ++k )
+      C[k].build_G1( x[k], y[k], theta[k], x[k+1], y[k+1], theta[k+1] );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   bool
   ClothoidList::build_G1(
     int_type        n,
     real_type const x[],
     real_type const y[],
-    real_type const theta[]
+    real_type const theta[],
+    int_type        nthreads
   ) {
 
     G2LIB_ASSERT(
@@ -419,12 +453,53 @@ namespace G2lib {
     )
 
     init();
-    reserve( n-1 );
-    ClothoidCurve c;
-    for ( int_type k = 1; k < n; ++k ) {
-      c.build_G1( x[k-1], y[k-1], theta[k-1], x[k], y[k], theta[k] );
-      push_back(c);
+    int_type ns = n-1;
+    clotoidList.resize( size_t(ns) );
+    ClothoidCurve * C = &clotoidList.front();
+
+    #ifdef G2LIB_USE_CXX11
+    if ( nthreads > ns ) nthreads = ns;
+    if ( nthreads > 1 ) {
+      size_t nt = size_t(nthreads);
+      vector<std::exception_ptr> errs( nt );
+      vector<std::thread>        workers;
+      workers.reserve( nt );
+      for ( size_t k = 0; k < nt; ++k ) {
+        int_type ib = int_type( (size_t(ns)*k)/nt );
+        int_type ie = int_type( (size_t(ns)*(k+1))/nt );
+        std::exception_ptr * perr = &errs[k];
+        workers.push_back( std::thread( [=] {
+          try {
+            build_G1_range( C, ib, ie, x, y, theta );
+          } catch ( ... ) {
+            *perr = std::current_exception();
+          }
+        } ) );
+      }
+      for ( size_t k = 0; k < nt; ++k ) workers[k].join();
+      for ( size_t k = 0; k < nt; ++k ) {
+        if ( errs[k] ) {
+          init();
+          std::rethrow_exception( errs[k] );
+        }
+      }
+    } else
+    #else
+    (void)nthreads;
+    #endif
+    {
+      try {
+        build_G1_range( C, 0, ns, x, y, theta );
+      } catch ( ... ) {
+        init(); // do not leave a list without abscissae
+        throw;
+      }
     }
+
+    // same sums of push_back
+    s0.resize( size_t(n) );
+    s0[0] = 0;
+    for ( int_type k = 0; k < ns; ++k ) s0[k+1] = s0[k] + C[k].length();
     return true;
   }
 
@@ -1100,6 +1175,96 @@ namespace G2lib {
     return c.eval_ISO_DDD( s - s0[idx], offs, x_DDD, y_DDD );
   }
 
+  /*\
+   |   _           _       _
+   |  | |__   __ _| |_ ___| |__
+   |  | '_ \ / _` | __/ __| '_ \
+   |  | |_) | (_| | || (__| | | |
+   |  |_.__/ \__,_|\__\___|_| |_|
+  \*/
+
+  void
+  ClothoidList::eval_batch_walk(
+    int_type        nder,
+    bool            ISO,
+    real_type       offs,
+    real_type const s[],
+    int_type        n,
+    real_type       x[],
+    real_type       y[]
+  ) const {
+    int_type const NBLK = 64;
+    real_type      ss[NBLK]; // abscissae local to the segment
+
+    int_type ns  = this->numSegment();
+    int_type idx = 0;
+    int_type i   = 0;
+    while ( i < n ) {
+      real_type si = s[i];
+      if ( this->curve_is_closed ) this->wrap_in_range( si );
+      // step to the next segment if possible, search otherwise
+      if ( idx+1 < ns && si > s0[size_t(idx+1)] && si <= s0[size_t(idx+2)] ) ++idx;
+      else idx = this->findAtS( si, idx );
+
+      // collect the run of points in the segment, the first and last
+      // segments accept points outside the range (extrapolation)
+      real_type sa = s0[size_t(idx)];
+      real_type sb = s0[size_t(idx+1)];
+      bool      lo = idx > 0;
+      bool      hi = idx+1 < ns;
+      int_type  m  = 0;
+      ss[m++] = si - sa;
+      while ( i+m < n && m < NBLK ) {
+        real_type t = s[i+m];
+        if ( this->curve_is_closed ) this->wrap_in_range( t );
+        if ( (lo && t < sa) || (hi && t > sb) ) break;
+        ss[m++] = t - sa;
+      }
+
+      ClothoidCurve const & c = clotoidList[size_t(idx)];
+      if ( ISO ) {
+        switch ( nder ) {
+        case 0: c.eval_batch_ISO( ss, m, offs, x+i, y+i );     break;
+        case 1: c.eval_batch_ISO_D( ss, m, offs, x+i, y+i );   break;
+        case 2: c.eval_batch_ISO_DD( ss, m, offs, x+i, y+i );  break;
+        case 3: c.eval_batch_ISO_DDD( ss, m, offs, x+i, y+i ); break;
+        }
+      } else {
+        switch ( nder ) {
+        case 0: c.eval_batch( ss, m, x+i, y+i );     break;
+        case 1: c.eval_batch_D( ss, m, x+i, y+i );   break;
+        case 2: c.eval_batch_DD( ss, m, x+i, y+i );  break;
+        case 3: c.eval_batch_DDD( ss, m, x+i, y+i ); break;
+        }
+      }
+      i += m;
+    }
+  }
+
+  /*\
+   |                       _
+   |   ___  __ _ _ __ ___ | |_ __
+   |  / __|/ _` | '_ ` _ \| | '_ \
+   |  \__ \ (_| | | | | | | | |_) |
+   |  |___/\__,_|_| |_| |_|_| .__/
+   |                        |_|
+  \*/
+
+  void
+  ClothoidList::sample_stations_ISO(
+    real_type           offs,
+    real_type           tol,
+    vector<real_type> & s
+  ) const {
+    vector<ClothoidCurve>::const_iterator ic = clotoidList.begin();
+    for ( size_t k = 0; ic != clotoidList.end(); ++ic, ++k ) {
+      size_t i0 = s.size();
+      ic->sample_stations_ISO( offs, tol, s );
+      for ( size_t i = i0; i < s.size(); ++i ) s[i] += s0[k];
+    }
+    if ( !s.empty() ) s.back() = s0.back();
+  }
+
   /*\
    |  _                        __
    | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -1110,6 +1275,7 @@ namespace G2lib {
 
   void
   ClothoidList::translate( real_type tx, real_type ty ) {
+    this->resetAABBtree();
     vector<ClothoidCurve>::iterator ic = clotoidList.begin();
     for (; ic != clotoidList.end(); ++ic ) ic->translate( tx, ty );
   }
@@ -1118,6 +1284,7 @@ namespace G2lib {
 
   void
   ClothoidList::rotate( real_type angle, real_type cx, real_type cy ) {
+    this->resetAABBtree();
     vector<ClothoidCurve>::iterator ic = clotoidList.begin();
     for (; ic != clotoidList.end(); ++ic ) ic->rotate( angle, cx, cy );
   }
@@ -1126,6 +1293,7 @@ namespace G2lib {
 
   void
   ClothoidList::scale( real_type sfactor ) {
+    this->resetAABBtree();
     vector<ClothoidCurve>::iterator ic = clotoidList.begin();
     real_type newx0 = ic->xBegin();
     real_type newy0 = ic->yBegin();
@@ -1143,6 +1311,7 @@ namespace G2lib {
 
   void
   ClothoidList::reverse() {
+    this->resetAABBtree();
     std::reverse( clotoidList.begin(), clotoidList.end() );
     vector<ClothoidCurve>::iterator ic = clotoidList.begin();
     ic->reverse();
@@ -1164,6 +1333,7 @@ namespace G2lib {
 
   void
   ClothoidList::changeOrigin( real_type newx0, real_type newy0 ) {
+    this->resetAABBtree();
     vector<ClothoidCurve>::iterator ic = clotoidList.begin();
     for (; ic != clotoidList.end(); ++ic ) {
       ic->changeOrigin( newx0, newy0 );
@@ -1176,6 +1346,7 @@ namespace G2lib {
 
   void
   ClothoidList::trim( real_type s_begin, real_type s_end ) {
+    this->resetAABBtree();
     G2LIB_ASSERT(
       s_begin >= s0.front() && s_end <= s0.back() && s_end > s_begin,
       "ClothoidList::trim( s_begin=" << s_begin << ", s_end=" << s_end <<
@@ -1218,40 +1389,66 @@ namespace G2lib {
   ) const {
 
     if ( aabb_done &&
+         aabb_is_flat == use_flat_AABBtree &&
          isZero( offs-aabb_offs ) &&
          isZero( max_angle-aabb_max_angle ) &&
          isZero( max_size-aabb_max_size ) ) return;
 
-    #ifdef G2LIB_USE_CXX11
-    vector<shared_ptr<BBox const> > bboxes;
-    #else
-    vector<BBox const *> bboxes;
-    #endif
-
+    aabb_tri.clear(); // bbTriangles_ISO append to the list
     bbTriangles_ISO( offs, aabb_tri, max_angle, max_size );
-    bboxes.reserve(aabb_tri.size());
-    vector<Triangle2D>::const_iterator it;
-    int_type ipos = 0;
-    for ( it = aabb_tri.begin(); it != aabb_tri.end(); ++it, ++ipos ) {
-      real_type xmin, ymin, xmax, ymax;
-      it->bbox( xmin, ymin, xmax, ymax );
+    aabb_is_flat = use_flat_AABBtree;
+    if ( aabb_is_flat ) {
+      aabb_tree.clear();
+      aabb_flat.build( aabb_tri );
+    } else {
       #ifdef G2LIB_USE_CXX11
-      bboxes.push_back( make_shared<BBox const>(
-        xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos
-      ) );
+      vector<shared_ptr<BBox const> > bboxes;
       #else
-      bboxes.push_back(
-        new BBox( xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos )
-      );
+      vector<BBox const *> bboxes;
       #endif
+      bboxes.reserve(aabb_tri.size());
+      vector<Triangle2D>::const_iterator it;
+      int_type ipos = 0;
+      for ( it = aabb_tri.begin(); it != aabb_tri.end(); ++it, ++ipos ) {
+        real_type xmin, ymin, xmax, ymax;
+        it->bbox( xmin, ymin, xmax, ymax );
+        #ifdef G2LIB_USE_CXX11
+        bboxes.push_back( make_shared<BBox const>(
+          xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos
+        ) );
+        #else
+        bboxes.push_back(
+          new BBox( xmin, ymin, xmax, ymax, G2LIB_CLOTHOID, ipos )
+        );
+        #endif
+      }
+      aabb_flat.clear();
+      aabb_tree.build(bboxes);
     }
-    aabb_tree.build(bboxes);
     aabb_done      = true;
     aabb_offs      = offs;
     aabb_max_angle = max_angle;
     aabb_max_size  = max_size;
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::prepare_AABBtree_ISO(
+    real_type offs,
+    real_type max_angle,
+    real_type max_size
+  ) {
+    if ( prepared_AABBtree_ISO( offs, max_angle, max_size ) != nullptr ) return;
+    aabb_prepared.push_back( AABBtriangles() );
+    AABBtriangles & P = aabb_prepared.back();
+    P.offs      = offs;
+    P.max_angle = max_angle;
+    P.max_size  = max_size;
+    bbTriangles_ISO( offs, P.tri, max_angle, max_size );
+    P.tree.build( P.tri );
+  }
+
   /*\
    |   _       _                          _
    |  (_)_ __ | |_ ___ _ __ ___  ___  ___| |_
@@ -1264,10 +1461,7 @@ namespace G2lib {
 
   bool
   ClothoidList::collision( ClothoidList const & C ) const {
-    this->build_AABBtree_ISO( 0 );
-    C.build_AABBtree_ISO( 0 );
-    T2D_collision_list_ISO fun( this, 0, &C, 0 );
-    return aabb_tree.collision( C.aabb_tree, fun, false );
+    return collision_ISO( 0, C, 0 );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1276,12 +1470,20 @@ namespace G2lib {
   ClothoidList::collision_ISO(
     real_type            offs,
     ClothoidList const & C,
-    real_type            offs_C
+    real_type            offs_C,
+    int_type             nthreads
   ) const {
+    AABBtriangles const * P1 = this->prepared_AABBtree_ISO( offs );
+    AABBtriangles const * P2 = C.prepared_AABBtree_ISO( offs_C );
+    if ( P1 != nullptr && P2 != nullptr ) {
+      T2D_collision_list_ISO fun( this, &P1->tri, offs, &C, &P2->tri, offs_C );
+      return P1->tree.collision_parallel( P2->tree, fun, nthreads );
+    }
     this->build_AABBtree_ISO( offs );
     C.build_AABBtree_ISO( offs_C );
-    T2D_collision_list_ISO fun( this, offs, &C, offs_C );
-    return aabb_tree.collision( C.aabb_tree, fun, false );
+    T2D_collision_list_ISO fun( this, &aabb_tri, offs, &C, &C.aabb_tri, offs_C );
+    if ( aabb_is_flat ) return aabb_flat.collision_parallel( C.aabb_flat, fun, nthreads );
+    return aabb_tree.collision_parallel( C.aabb_tree, fun, nthreads );
   }
 
   /*\
@@ -1293,42 +1495,116 @@ namespace G2lib {
    |
   \*/
 
+  void
+  ClothoidList::intersect_candidates(
+    AABBtree::VecPairIpos const & iList,
+    vector<Triangle2D>    const & tri1,
+    real_type                     offs,
+    ClothoidList          const & CL,
+    vector<Triangle2D>    const & tri2,
+    real_type                     offs_CL,
+    IntersectList               & ilist,
+    bool                          swap_s_vals,
+    int_type                      nthreads
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    if ( nthreads > 1 && iList.size() > size_t(nthreads) ) {
+      // contiguous chunks, appended in order: the list is the serial one
+      size_t n      = iList.size();
+      size_t nchunk = std::min( n, size_t(4*nthreads) );
+      vector<IntersectList> lists( nchunk );
+      AABBrunTasks( nchunk, nthreads, [&]( size_t k ) {
+        this->intersect_candidates_range(
+          iList, (n*k)/nchunk, (n*(k+1))/nchunk,
+          tri1, offs, CL, tri2, offs_CL, lists[k], swap_s_vals
+        );
+      } );
+      for ( size_t k = 0; k < nchunk; ++k )
+        ilist.insert( ilist.end(), lists[k].begin(), lists[k].end() );
+      return;
+    }
+    #else
+    (void)nthreads;
+    #endif
+    intersect_candidates_range(
+      iList, 0, iList.size(), tri1, offs, CL, tri2, offs_CL, ilist, swap_s_vals
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::intersect_candidates_range(
+    AABBtree::VecPairIpos const & iList,
+    size_t                        ibegin,
+    size_t                        iend,
+    vector<Triangle2D>    const & tri1,
+    real_type                     offs,
+    ClothoidList          const & CL,
+    vector<Triangle2D>    const & tri2,
+    real_type                     offs_CL,
+    IntersectList               & ilist,
+    bool                          swap_s_vals
+  ) const {
+    for ( size_t i = ibegin; i < iend; ++i ) {
+      size_t ipos1 = size_t(iList[i].first);
+      size_t ipos2 = size_t(iList[i].second);
+
+      Triangle2D const & T1 = tri1[ipos1];
+      Triangle2D const & T2 = tri2[ipos2];
+
+      ClothoidCurve const & C1 = clotoidList[T1.Icurve()];
+      ClothoidCurve const & C2 = CL.clotoidList[T2.Icurve()];
+
+      real_type ss1, ss2;
+      bool converged = C1.aabb_intersect_ISO( T1, offs, &C2, T2, offs_CL, ss1, ss2 );
+
+      if ( converged ) {
+        ss1 += s0[T1.Icurve()];
+        ss2 += CL.s0[T2.Icurve()];
+        if ( swap_s_vals ) swap( ss1, ss2 );
+        ilist.push_back( Ipair( ss1, ss2 ) );
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   ClothoidList::intersect_ISO(
     real_type            offs,
     ClothoidList const & CL,
     real_type            offs_CL,
     IntersectList      & ilist,
-    bool                 swap_s_vals
+    bool                 swap_s_vals,
+    int_type             nthreads
   ) const {
     if ( intersect_with_AABBtree ) {
-      this->build_AABBtree_ISO( offs );
-      CL.build_AABBtree_ISO( offs_CL );
-      AABBtree::VecPairPtrBBox iList;
-      aabb_tree.intersect( CL.aabb_tree, iList );
-
-      AABBtree::VecPairPtrBBox::const_iterator ip;
-      for ( ip = iList.begin(); ip != iList.end(); ++ip ) {
-        size_t ipos1 = size_t(ip->first->Ipos());
-        size_t ipos2 = size_t(ip->second->Ipos());
-
-        Triangle2D const & T1 = aabb_tri[ipos1];
-        Triangle2D const & T2 = CL.aabb_tri[ipos2];
-
-        ClothoidCurve const & C1 = clotoidList[T1.Icurve()];
-        ClothoidCurve const & C2 = CL.clotoidList[T2.Icurve()];
-
-        real_type ss1, ss2;
-        bool converged = C1.aabb_intersect_ISO( T1, offs, &C2, T2, offs_CL, ss1, ss2 );
-
-        if ( converged ) {
-          ss1 += s0[T1.Icurve()];
-          ss2 += CL.s0[T2.Icurve()];
-          if ( swap_s_vals ) swap( ss1, ss2 );
-          ilist.push_back( Ipair( ss1, ss2 ) );
-        }
+      AABBtriangles const *      P1 = this->prepared_AABBtree_ISO( offs );
+      AABBtriangles const *      P2 = CL.prepared_AABBtree_ISO( offs_CL );
+      vector<Triangle2D> const * tri1;
+      vector<Triangle2D> const * tri2;
+      AABBtree::VecPairIpos      iList;
+      if ( P1 != nullptr && P2 != nullptr ) {
+        P1->tree.intersect_parallel( P2->tree, iList, nthreads );
+        tri1 = &P1->tri;
+        tri2 = &P2->tri;
+      } else {
+        this->build_AABBtree_ISO( offs );
+        CL.build_AABBtree_ISO( offs_CL );
+        if ( aabb_is_flat ) aabb_flat.intersect_parallel( CL.aabb_flat, iList, nthreads );
+        else                aabb_tree.intersect_parallel( CL.aabb_tree, iList, nthreads );
+        tri1 = &aabb_tri;
+        tri2 = &CL.aabb_tri;
       }
+      intersect_candidates(
+        iList, *tri1, offs, CL, *tri2, offs_CL, ilist, swap_s_vals, nthreads
+      );
     } else {
+      // the triangles are not those of the AABB tree, drop the tree
+      aabb_done = CL.aabb_done = false;
+      aabb_tri.clear();
+      CL.aabb_tri.clear();
       bbTriangles_ISO( offs, aabb_tri, m_pi/18, 1e100 );
       CL.bbTriangles_ISO( offs_CL, CL.aabb_tri, m_pi/18, 1e100 );
       vector<Triangle2D>::const_iterator i1, i2;
@@ -1355,6 +1631,156 @@ namespace G2lib {
     }
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidList::intersect_visit_ISO(
+    real_type            offs,
+    ClothoidList const & CL,
+    real_type            offs_CL,
+    IntersectVisitor   & visitor,
+    bool                 ordered,
+    real_type            tol
+  ) const {
+    IntersectUnique V( visitor, tol );
+
+    // the trees as in `intersect_ISO`
+    AABBtriangles const *      P1 = this->prepared_AABBtree_ISO( offs );
+    AABBtriangles const *      P2 = CL.prepared_AABBtree_ISO( offs_CL );
+    AABBtreeFlat  const *      flat1 = nullptr;
+    AABBtreeFlat  const *      flat2 = nullptr;
+    vector<Triangle2D> const * tri1;
+    vector<Triangle2D> const * tri2;
+    if ( P1 != nullptr && P2 != nullptr ) {
+      flat1 = &P1->tree; tri1 = &P1->tri;
+      flat2 = &P2->tree; tri2 = &P2->tri;
+    } else {
+      this->build_AABBtree_ISO( offs );
+      CL.build_AABBtree_ISO( offs_CL );
+      if ( aabb_is_flat ) { flat1 = &aabb_flat; flat2 = &CL.aabb_flat; }
+      tri1 = &aabb_tri;
+      tri2 = &CL.aabb_tri;
+    }
+
+    if ( !ordered ) {
+      // the traversal stops when the visitor stops
+      T2D_visit_ISO fun( this, tri1, offs, &CL, tri2, offs_CL, &V );
+      if ( flat1 != nullptr ) return flat1->collision( *flat2, fun );
+      return aabb_tree.collision( CL.aabb_tree, fun );
+    }
+
+    AABBtree::VecPairIpos iList;
+    if ( flat1 != nullptr ) flat1->intersect( *flat2, iList );
+    else                    aabb_tree.intersect( CL.aabb_tree, iList );
+
+    // the triangles of a curve cover disjoint intervals of `s`: sorted by
+    // their start the candidates with the same first triangle are
+    // consecutive and their intersections precede those of the next ones
+    vector<pair<real_type,size_t> > order;
+    order.reserve( iList.size() );
+    for ( size_t k = 0; k < iList.size(); ++k ) {
+      Triangle2D const & T1 = (*tri1)[size_t(iList[k].first)];
+      order.push_back(
+        pair<real_type,size_t>( s0[size_t(T1.Icurve())]+T1.S0(), k )
+      );
+    }
+    std::sort( order.begin(), order.end() );
+
+    IntersectList hits;
+    size_t k = 0;
+    while ( k < order.size() ) {
+      int_type ipos1 = iList[order[k].second].first;
+      Triangle2D    const & T1 = (*tri1)[size_t(ipos1)];
+      ClothoidCurve const & C1 = clotoidList[size_t(T1.Icurve())];
+      hits.clear();
+      for ( ; k < order.size() && iList[order[k].second].first == ipos1; ++k ) {
+        Triangle2D    const & T2 = (*tri2)[size_t(iList[order[k].second].second)];
+        ClothoidCurve const & C2 = CL.clotoidList[size_t(T2.Icurve())];
+        real_type ss1, ss2;
+        if ( C1.aabb_intersect_ISO( T1, offs, &C2, T2, offs_CL, ss1, ss2 ) )
+          hits.push_back(
+            Ipair( ss1+s0[size_t(T1.Icurve())], ss2+CL.s0[size_t(T2.Icurve())] )
+          );
+      }
+      std::sort( hits.begin(), hits.end() );
+      IntersectList::const_iterator it;
+      for ( it = hits.begin(); it != hits.end(); ++it )
+        if ( !V.visit( it->first, it->second ) ) return true;
+    }
+    return false;
+  }
+
+  /*\
+   |           _  __
+   |   ___ ___| |/ _|
+   |  / __/ _ \ | |_
+   |  \__ \  __/ |  _|
+   |  |___/\___|_|_|
+  \*/
+
+  void
+  ClothoidList::select_AABBtree_ISO(
+    real_type                    offs,
+    AABBtreeFlat       const * & flat,
+    vector<Triangle2D> const * & tri
+  ) const {
+    AABBtriangles const * P = this->prepared_AABBtree_ISO( offs );
+    if ( P != nullptr ) {
+      flat = &P->tree;
+      tri  = &P->tri;
+    } else {
+      this->build_AABBtree_ISO( offs );
+      flat = aabb_is_flat ? &aabb_flat : nullptr;
+      tri  = &aabb_tri;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidList::ends_meet_ISO( real_type offs ) const {
+    real_type x0, y0, x1, y1;
+    eval_ISO( 0,        offs, x0, y0 );
+    eval_ISO( length(), offs, x1, y1 );
+    return hypot( x1-x0, y1-y0 ) <= machepsi1000*(1+length());
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidList::self_collision_ISO( real_type offs ) const {
+    if ( clotoidList.empty() ) return false;
+    AABBtreeFlat       const * flat;
+    vector<Triangle2D> const * tri;
+    this->select_AABBtree_ISO( offs, flat, tri );
+    T2D_self_ISO fun( this, tri, offs, ends_meet_ISO( offs ), nullptr );
+    if ( flat != nullptr ) return flat->self_collision( fun );
+    return aabb_tree.self_collision( fun );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::self_intersect_ISO(
+    real_type       offs,
+    IntersectList & ilist
+  ) const {
+    if ( clotoidList.empty() ) return;
+    AABBtreeFlat       const * flat;
+    vector<Triangle2D> const * tri;
+    this->select_AABBtree_ISO( offs, flat, tri );
+    IntersectList res;
+    T2D_self_ISO fun( this, tri, offs, ends_meet_ISO( offs ), &res );
+    if ( flat != nullptr ) flat->self_collision( fun );
+    else                   aabb_tree.self_collision( fun );
+    // sorted and without the crossings found twice
+    std::sort( res.begin(), res.end() );
+    IntersectFirstK all( numeric_limits<int_type>::max(), ilist );
+    IntersectUnique V( all, 1e-8 );
+    IntersectList::const_iterator it;
+    for ( it = res.begin(); it != res.end(); ++it ) V.visit( it->first, it->second );
+  }
+
   /*\
    |      _ _     _
    |   __| (_)___| |_ __ _ _ __   ___ ___
@@ -1375,19 +1801,47 @@ namespace G2lib {
     real_type & DST
   ) const {
 
-    this->build_AABBtree_ISO( offs );
+    AABBtriangles const *      P = this->prepared_AABBtree_ISO( offs );
+    vector<Triangle2D> const * tri;
+    AABBtree::VecIpos          candidateList;
+    if ( P != nullptr ) {
+      P->tree.min_distance( qx, qy, candidateList );
+      tri = &P->tri;
+    } else {
+      this->build_AABBtree_ISO( offs );
+      if ( aabb_is_flat ) aabb_flat.min_distance( qx, qy, candidateList );
+      else                aabb_tree.min_distance( qx, qy, candidateList );
+      tri = &aabb_tri;
+    }
+    return closestPoint_candidates(
+      candidateList, *tri, qx, qy, offs, x, y, s, t, DST
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-    AABBtree::VecPtrBBox candidateList;
-    aabb_tree.min_distance( qx, qy, candidateList );
-    AABBtree::VecPtrBBox::const_iterator ic;
+  int_type
+  ClothoidList::closestPoint_candidates(
+    AABBtree::VecIpos  const & candidateList,
+    vector<Triangle2D> const & tri,
+    real_type                  qx,
+    real_type                  qy,
+    real_type                  offs,
+    real_type                & x,
+    real_type                & y,
+    real_type                & s,
+    real_type                & t,
+    real_type                & DST
+  ) const {
+    AABBtree::VecIpos::const_iterator ic;
     G2LIB_ASSERT(
       candidateList.size() > 0, "ClothoidList::closestPoint no candidate"
     )
     int_type icurve = 0;
     DST = numeric_limits<real_type>::infinity();
     for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
-      size_t ipos = size_t((*ic)->Ipos());
-      Triangle2D const & T = aabb_tri[ipos];
+      size_t ipos = size_t(*ic);
+      Triangle2D const & T = tri[ipos];
       real_type dst = T.distMin( qx, qy );
       if ( dst < DST ) {
         // refine distance
@@ -1428,6 +1882,307 @@ namespace G2lib {
     return closestPoint_ISO( qx, qy, 0, x, y, s, t, dst );
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidList::closestPoint_batch_range(
+    AABBtreeFlat       const * flat,
+    vector<Triangle2D> const * tri,
+    int_type                   ibegin,
+    int_type                   iend,
+    real_type          const   qx[],
+    real_type          const   qy[],
+    real_type                  offs,
+    real_type                  s[],
+    real_type                  t[],
+    real_type                  dst[]
+  ) const {
+    AABBtree::VecIpos candidateList;
+    vector<int_type>  stack;
+    candidateList.reserve(32);
+    stack.reserve(64);
+
+    int_type nbad  = 0;
+    int_type iwarm = -1; // triangle of the last projection
+    for ( int_type i = ibegin; i < iend; ++i ) {
+      real_type px = qx[i];
+      real_type py = qy[i];
+      real_type DST = numeric_limits<real_type>::infinity();
+      real_type x = 0, y = 0, ss = 0;
+      int_type  itri = -1;
+      if ( iwarm >= 0 ) {
+        // the triangle of the previous point gives an upper bound
+        Triangle2D const & T = (*tri)[size_t(iwarm)];
+        clotoidList[T.Icurve()].closestPoint_internal_ISO(
+          T.S0(), T.S1(), px, py, offs, x, y, ss, DST
+        );
+        ss   += s0[T.Icurve()];
+        itri  = iwarm;
+      }
+      if ( flat != nullptr )
+        flat->min_distance( px, py, DST*(1+machepsi1000), candidateList, stack );
+      else
+        aabb_tree.min_distance( px, py, candidateList );
+      G2LIB_ASSERT(
+        itri >= 0 || candidateList.size() > 0,
+        "ClothoidList::closestPoint_batch_ISO no candidate"
+      )
+      AABBtree::VecIpos::const_iterator ic;
+      for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
+        if ( *ic == iwarm ) continue;
+        Triangle2D const & T = (*tri)[size_t(*ic)];
+        real_type d = T.distMin( px, py );
+        if ( d < DST ) {
+          // refine distance
+          real_type xx, yy, sss;
+          clotoidList[T.Icurve()].closestPoint_internal_ISO(
+            T.S0(), T.S1(), px, py, offs, xx, yy, sss, d
+          );
+          if ( d < DST ) {
+            DST  = d;
+            ss   = sss + s0[T.Icurve()];
+            x    = xx;
+            y    = yy;
+            itri = *ic;
+          }
+        }
+      }
+      iwarm = itri;
+
+      int_type icurve = (*tri)[size_t(itri)].Icurve();
+      real_type nx, ny;
+      clotoidList[icurve].nor_ISO( ss - s0[icurve], nx, ny );
+      s[i]   = ss;
+      t[i]   = (px-x) * nx + (py-y) * ny - offs;
+      dst[i] = DST;
+      if ( abs( abs(t[i]) - DST ) > DST*machepsi1000 ) ++nbad;
+    }
+    return nbad;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidList::closestPoint_batch_ISO(
+    real_type const qx[],
+    real_type const qy[],
+    int_type        n,
+    real_type       offs,
+    real_type       s[],
+    real_type       t[],
+    real_type       dst[],
+    int_type        nthreads
+  ) const {
+    if ( n <= 0 ) return 0;
+
+    // select (or build) the tree before starting the threads,
+    // then the tree and the triangles are only read
+    AABBtriangles      const * P = this->prepared_AABBtree_ISO( offs );
+    AABBtreeFlat       const * flat;
+    vector<Triangle2D> const * tri;
+    if ( P != nullptr ) {
+      flat = &P->tree;
+      tri  = &P->tri;
+    } else {
+      this->build_AABBtree_ISO( offs );
+      flat = aabb_is_flat ? &aabb_flat : nullptr;
+      tri  = &aabb_tri;
+    }
+
+    #ifdef G2LIB_USE_CXX11
+    if ( nthreads > n ) nthreads = n;
+    if ( nthreads > 1 ) {
+      // contiguous chunks, to keep the coherence of the points
+      size_t nt = size_t(nthreads);
+      vector<int_type>           nbad( nt, 0 );
+      vector<std::exception_ptr> errs( nt );
+      vector<std::thread>        workers;
+      workers.reserve( nt );
+      for ( size_t k = 0; k < nt; ++k ) {
+        int_type ib = int_type( (size_t(n)*k)/nt );
+        int_type ie = int_type( (size_t(n)*(k+1))/nt );
+        int_type           * pbad = &nbad[k];
+        std::exception_ptr * perr = &errs[k];
+        workers.push_back( std::thread( [=] {
+          try {
+            *pbad = this->closestPoint_batch_range(
+              flat, tri, ib, ie, qx, qy, offs, s, t, dst
+            );
+          } catch ( ... ) {
+            *perr = std::current_exception();
+          }
+        } ) );
+      }
+      int_type res = 0;
+      for ( size_t k = 0; k < nt; ++k ) {
+        workers[k].join();
+        res += nbad[k];
+      }
+      for ( size_t k = 0; k < nt; ++k )
+        if ( errs[k] ) std::rethrow_exception( errs[k] );
+      return res;
+    }
+    #else
+    (void)nthreads;
+    #endif
+    return this->closestPoint_batch_range(
+      flat, tri, 0, n, qx, qy, offs, s, t, dst
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::AABBtree_ISO(
+    real_type                    offs,
+    vector<Triangle2D> const * & tri,
+    AABBtreeFlat       const * & flat,
+    AABBtree           const * & tree
+  ) const {
+    AABBtriangles const * P = this->prepared_AABBtree_ISO( offs );
+    if ( P != nullptr ) {
+      tri  = &P->tri;
+      flat = &P->tree;
+      tree = nullptr;
+    } else {
+      this->build_AABBtree_ISO( offs );
+      tri  = &aabb_tri;
+      flat = aabb_is_flat ? &aabb_flat : nullptr;
+      tree = aabb_is_flat ? nullptr : &aabb_tree;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // distance of the piece of segment covered by a triangle,
+  // the segments already found (marked in `found`, if any) are discarded
+  class ClothoidList::PieceDistance {
+    ClothoidList       const * CL;
+    vector<Triangle2D> const * tri;
+    vector<bool>       const * found;
+    real_type                  qx, qy, offs;
+  public:
+    PieceDistance(
+      ClothoidList       const * _CL,
+      vector<Triangle2D> const * _tri,
+      vector<bool>       const * _found,
+      real_type                  _qx,
+      real_type                  _qy,
+      real_type                  _offs
+    )
+    : CL(_CL), tri(_tri), found(_found), qx(_qx), qy(_qy), offs(_offs)
+    {}
+
+    real_type
+    operator () ( int_type ipos ) const {
+      Triangle2D const & T = (*tri)[size_t(ipos)];
+      if ( found != nullptr && (*found)[size_t(T.Icurve())] )
+        return numeric_limits<real_type>::infinity();
+      real_type x, y, s, dst;
+      CL->clotoidList[size_t(T.Icurve())].closestPoint_internal_ISO(
+        T.S0(), T.S1(), qx, qy, offs, x, y, s, dst
+      );
+      return dst;
+    }
+  };
+
+  // the nearest piece of a segment gives the distance of the segment
+  class ClothoidList::SegmentFound {
+    ClothoidList       const * CL;
+    vector<Triangle2D> const * tri;
+    vector<bool>             * found; // one flag per segment
+    vector<int_type>         * iseg;
+    vector<real_type>        * s;
+    vector<real_type>        * dst;
+    size_t                     k;
+    real_type                  qx, qy, offs;
+  public:
+    SegmentFound(
+      ClothoidList       const * _CL,
+      vector<Triangle2D> const * _tri,
+      vector<bool>             * _found,
+      vector<int_type>         * _iseg,
+      vector<real_type>        * _s,
+      vector<real_type>        * _dst,
+      int_type                   _k,
+      real_type                  _qx,
+      real_type                  _qy,
+      real_type                  _offs
+    )
+    : CL(_CL), tri(_tri), found(_found), iseg(_iseg), s(_s), dst(_dst), k(size_t(_k))
+    , qx(_qx), qy(_qy), offs(_offs)
+    {}
+
+    bool
+    operator () ( real_type d, int_type ipos ) const {
+      Triangle2D const & T  = (*tri)[size_t(ipos)];
+      int_type           ic = T.Icurve();
+      if ( (*found)[size_t(ic)] ) return true;
+      (*found)[size_t(ic)] = true;
+      real_type x, y, ss, dd;
+      CL->clotoidList[size_t(ic)].closestPoint_internal_ISO(
+        T.S0(), T.S1(), qx, qy, offs, x, y, ss, dd
+      );
+      iseg->push_back( ic );
+      s->push_back( ss + CL->s0[size_t(ic)] );
+      dst->push_back( d );
+      return iseg->size() < k;
+    }
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::nearestSegments_ISO(
+    real_type           qx,
+    real_type           qy,
+    real_type           offs,
+    int_type            k,
+    real_type           dmax,
+    vector<int_type>  & iseg,
+    vector<real_type> & s,
+    vector<real_type> & dst
+  ) const {
+    iseg.clear();
+    s.clear();
+    dst.clear();
+    if ( k <= 0 ) return;
+    vector<Triangle2D> const * tri;
+    AABBtreeFlat       const * flat;
+    AABBtree           const * tree;
+    this->AABBtree_ISO( offs, tri, flat, tree );
+    vector<bool>  found( clotoidList.size(), false );
+    PieceDistance dfun( this, tri, &found, qx, qy, offs );
+    SegmentFound  ffun( this, tri, &found, &iseg, &s, &dst, k, qx, qy, offs );
+    if ( flat != nullptr ) flat->best_first( qx, qy, dmax, dfun, ffun );
+    else                   tree->best_first( qx, qy, dmax, dfun, ffun );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidList::distanceField_ISO(
+    real_type       offs,
+    int_type        n,
+    real_type const qx[],
+    real_type const qy[],
+    real_type       dmax,
+    real_type       dst[]
+  ) const {
+    vector<Triangle2D> const * tri;
+    AABBtreeFlat       const * flat;
+    AABBtree           const * tree;
+    this->AABBtree_ISO( offs, tri, flat, tree );
+    vector<pair<real_type,int_type> > res;
+    res.reserve(1);
+    for ( int_type i = 0; i < n; ++i ) {
+      PieceDistance dfun( this, tri, nullptr, qx[i], qy[i], offs );
+      if ( flat != nullptr ) flat->nearest( qx[i], qy[i], 1, dmax, dfun, res );
+      else                   tree->nearest( qx[i], qy[i], 1, dmax, dfun, res );
+      dst[i] = res.empty() ? dmax : res.front().first;
+    }
+  }
+
   /*\
    |      _ _     _
    |   __| (_)___| |_ __ _ _ __   ___ ___
@@ -1438,19 +2193,27 @@ namespace G2lib {
 
   int_type
   ClothoidList::closestSegment( real_type qx, real_type qy ) const {
-    this->build_AABBtree_ISO( 0 );
-
-    AABBtree::VecPtrBBox candidateList;
-    aabb_tree.min_distance( qx, qy, candidateList );
-    AABBtree::VecPtrBBox::const_iterator ic;
+    AABBtriangles const *      P = this->prepared_AABBtree_ISO( 0 );
+    vector<Triangle2D> const * tri;
+    AABBtree::VecIpos          candidateList;
+    if ( P != nullptr ) {
+      P->tree.min_distance( qx, qy, candidateList );
+      tri = &P->tri;
+    } else {
+      this->build_AABBtree_ISO( 0 );
+      if ( aabb_is_flat ) aabb_flat.min_distance( qx, qy, candidateList );
+      else                aabb_tree.min_distance( qx, qy, candidateList );
+      tri = &aabb_tri;
+    }
+    AABBtree::VecIpos::const_iterator ic;
     G2LIB_ASSERT(
       candidateList.size() > 0, "ClothoidList::closestSegment no candidate"
     )
     int_type icurve = 0;
     real_type DST = numeric_limits<real_type>::infinity();
     for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
-      size_t ipos = size_t((*ic)->Ipos());
-      Triangle2D const & T = aabb_tri[ipos];
+      size_t ipos = size_t(*ic);
+      Triangle2D const & T = (*tri)[ipos];
       real_type dst = T.distMin( qx, qy );
       if ( dst < DST ) {
         // refine distance
@@ -1707,34 +2470,72 @@ namespace G2lib {
   ) const {
 
     G2LIB_ASSERT( !clotoidList.empty(), "ClothoidList::findST, empty list" )
-    vector<ClothoidCurve>::const_iterator ic = clotoidList.begin();
-    vector<real_type>::const_iterator     is = s0.begin();
 
-    s = t = 0;
-    int_type  ipos = 0;
-    int_type  iseg = 0;
-    real_type S, T;
-    bool ok = ic->findST_ISO( x, y, S, T );
-    if ( ok ) {
-      s    = *is + S;
-      t    = T;
-      iseg = 0;
+    // The result is the segment with orthogonal projection and minimum |t|
+    // (the first one for ties).  A segment cannot beat a projection at
+    // distance |t| if its triangles are farther than |t|, so only the
+    // segments with a triangle in the circle of radius |t| are checked.
+    AABBtriangles      const * P = this->prepared_AABBtree_ISO( 0 );
+    AABBtreeFlat       const * flat;
+    vector<Triangle2D> const * tri;
+    if ( P != nullptr ) {
+      flat = &P->tree;
+      tri  = &P->tri;
+    } else {
+      this->build_AABBtree_ISO( 0 );
+      flat = aabb_is_flat ? &aabb_flat : nullptr;
+      tri  = &aabb_tri;
     }
 
-    for ( ++ic, ++is, ++ipos;
-          ic != clotoidList.end();
-          ++ic, ++is, ++ipos ) {
-      bool ok1 = ic->findST_ISO( x, y, S, T );
-      if ( ok && ok1 ) ok1 = abs(T) < abs(t);
-      if ( ok1 ) {
-        ok   = true;
-        s    = *is + S;
-        t    = T;
-        iseg = ipos;
+    // the segments are projected once, in any order: the ties on |t|
+    // are solved with the index to keep the choice of the linear search
+    vector<bool>      done( clotoidList.size(), false );
+    int_type          ndone  = 0;
+    bool              ok     = false;
+    int_type          ibest  = 0;
+    real_type         dmax   = 0;
+    real_type         radius = 0;
+    bool              last   = false;
+    AABBtree::VecIpos candidateList;
+    s = t = 0;
+
+    // first guess: the segments near to the closest one
+    if ( flat != nullptr ) flat->min_distance( x, y, candidateList );
+    else                   aabb_tree.min_distance( x, y, candidateList );
+
+    while ( true ) {
+      AABBtree::VecIpos::const_iterator ic;
+      for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
+        int_type k = (*tri)[size_t(*ic)].Icurve();
+        if ( done[size_t(k)] ) continue;
+        done[size_t(k)] = true;
+        ++ndone;
+        real_type X, Y, S, T, dst;
+        int_type icode = clotoidList[k].closestPoint_ISO( x, y, X, Y, S, T, dst );
+        dmax = max( dmax, dst );
+        if ( icode < 0 ) continue;
+        if ( ok && ( abs(T) > abs(t) || ( abs(T) == abs(t) && k > ibest ) ) ) continue;
+        ok    = true;
+        s     = s0[k] + S;
+        t     = T;
+        ibest = k;
+      }
+      if ( last ) return ibest;
+
+      if ( ok ) {
+        // all the segments that may have a projection as close as |t|
+        radius = abs(t)*(1+2*machepsi1000);
+        last   = true;
+      } else if ( ndone == this->numSegment() ) {
+        return -1; // no segment has an orthogonal projection
+      } else {
+        // no orthogonal projection near the point: enlarge the circle
+        radius = 2*max( radius, dmax );
+        if ( radius <= 0 ) return this->findST1( 0, this->numSegment()-1, x, y, s, t );
       }
+      if ( flat != nullptr ) flat->within_distance( x, y, radius, candidateList );
+      else                   aabb_tree.within_distance( x, y, radius, candidateList );
     }
-
-    return ok ? iseg : -(1+iseg);
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1794,6 +2595,18 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  ClothoidList::import_table( istream_type & stream, int_type nthreads ) {
+    vector<real_type> c[6]; // x, y, theta0, kappa0, dkappa, L
+    int_type n = read_table( stream, 6, c, nthreads );
+    this->init();
+    this->reserve( n );
+    for ( int_type i = 0; i < n; ++i )
+      this->push_back( c[0][i], c[1][i], c[2][i], c[3][i], c[4][i], c[5][i] );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   ClothoidList::export_ruby( ostream_type & stream ) const {
     stream << "data = {\n";
@@ -1820,6 +2633,237 @@ namespace G2lib {
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  /*\
+   |   __ _  _ _ _ ___ ___ _ _
+   |  / _| || | '_(_-</ _ \ '_|
+   |  \__|\_,_|_| /__/\___/_|
+  \*/
+
+  void
+  ClothoidListCursor::anchor( real_type s ) {
+    real_type ss = s;
+    if ( CL.curve_is_closed ) CL.wrap_in_range( ss );
+    int_type              i = CL.findAtS( ss, idx );
+    ClothoidCurve const & C = CL.clotoidList[size_t(i)];
+    real_type             t = ss - CL.s0[size_t(i)];
+    // the last segment of an open list is extended as in `eval`
+    real_type sb = s-t;
+    real_type se = sb+C.length();
+    if ( !CL.curve_is_closed && i+1 == CL.numSegment() )
+      se = numeric_limits<real_type>::infinity();
+    this->setPiece( sb, se, C.thetaBegin(), C.kappaBegin(), C.dkappa() );
+    real_type x, y;
+    C.eval( t, x, y );
+    this->setState( s, x, y );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  /*\
+   |    ___   __  __          _
+   |   / _ \ / _|/ _|___ ___| |_
+   |  | (_) |  _|  _(_-</ -_)  _|
+   |   \___/|_| |_| /__/\___|\__|
+  \*/
+
+  ClothoidListOffset::ClothoidListOffset(
+    ClothoidList const & _CL,
+    real_type            _offs,
+    real_type            max_angle,
+    real_type            max_size
+  )
+  : CL(_CL)
+  , offs(_offs)
+  , bb_xmin(0)
+  , bb_ymin(0)
+  , bb_xmax(0)
+  , bb_ymax(0)
+  {
+    P.offs      = _offs;
+    P.max_angle = max_angle;
+    P.max_size  = max_size;
+    this->update();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListOffset::update() {
+    G2LIB_ASSERT(
+      CL.numSegment() > 0, "ClothoidListOffset::update, empty list"
+    )
+    size_t ns = CL.clotoidList.size();
+
+    // offset length table
+    so.resize( ns+1 );
+    so[0] = 0;
+    for ( size_t i = 0; i < ns; ++i )
+      so[i+1] = so[i] + CL.clotoidList[i].length_ISO( offs );
+
+    // triangles, tree and bounding boxes from the triangles
+    P.tri.clear();
+    CL.bbTriangles_ISO( offs, P.tri, P.max_angle, P.max_size );
+    P.tree.build( P.tri );
+
+    real_type const inf = numeric_limits<real_type>::infinity();
+    bb.resize( 4*ns );
+    for ( size_t i = 0; i < ns; ++i ) {
+      bb[4*i+0] = bb[4*i+1] = inf;
+      bb[4*i+2] = bb[4*i+3] = -inf;
+    }
+    vector<Triangle2D>::const_iterator it;
+    for ( it = P.tri.begin(); it != P.tri.end(); ++it ) {
+      real_type * b = &bb[4*size_t(it->Icurve())];
+      b[0] = min( b[0], min( it->x1(), min( it->x2(), it->x3() ) ) );
+      b[1] = min( b[1], min( it->y1(), min( it->y2(), it->y3() ) ) );
+      b[2] = max( b[2], max( it->x1(), max( it->x2(), it->x3() ) ) );
+      b[3] = max( b[3], max( it->y1(), max( it->y2(), it->y3() ) ) );
+    }
+    bb_xmin = bb_ymin = inf;
+    bb_xmax = bb_ymax = -inf;
+    for ( size_t i = 0; i < ns; ++i ) {
+      bb_xmin = min( bb_xmin, bb[4*i+0] );
+      bb_ymin = min( bb_ymin, bb[4*i+1] );
+      bb_xmax = max( bb_xmax, bb[4*i+2] );
+      bb_ymax = max( bb_ymax, bb[4*i+3] );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidListOffset::findAtS( real_type & s ) const {
+    if ( CL.curve_is_closed ) CL.wrap_in_range( s );
+    int_type idx = 0;
+    int_type i   = CL.findAtS( s, idx );
+    if      ( i < 0 )                 i = 0;
+    else if ( i >= CL.numSegment() ) i = CL.numSegment()-1;
+    return i;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  ClothoidListOffset::segment_length( int_type nseg ) const {
+    G2LIB_ASSERT(
+      nseg >= 0 && nseg < numSegment(),
+      "ClothoidListOffset::segment_length( " << nseg <<
+      " ) out of range [0," << numSegment()-1 << "]"
+    )
+    return so[size_t(nseg+1)]-so[size_t(nseg)];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListOffset::segment_bbox(
+    int_type    nseg,
+    real_type & xmin,
+    real_type & ymin,
+    real_type & xmax,
+    real_type & ymax
+  ) const {
+    G2LIB_ASSERT(
+      nseg >= 0 && nseg < numSegment(),
+      "ClothoidListOffset::segment_bbox( " << nseg <<
+      " ) out of range [0," << numSegment()-1 << "]"
+    )
+    real_type const * b = &bb[4*size_t(nseg)];
+    xmin = b[0]; ymin = b[1];
+    xmax = b[2]; ymax = b[3];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  ClothoidListOffset::sOffset( real_type s ) const {
+    real_type             ss = s;
+    int_type              i  = findAtS( ss );
+    ClothoidCurve const & C  = CL.clotoidList[size_t(i)];
+    real_type t = max( real_type(0), min( C.length(), ss - CL.s0[size_t(i)] ) );
+    ClothoidData CD;
+    CD.kappa0 = C.kappaBegin();
+    CD.dk     = C.dkappa();
+    return so[size_t(i)] + CD.length_ISO( t, offs );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  ClothoidListOffset::sList( real_type sigma ) const {
+    if ( sigma <= 0 )        return CL.s0.front();
+    if ( sigma >= length() ) return CL.s0.back();
+    size_t i = size_t( upper_bound( so.begin(), so.end(), sigma ) - so.begin() ) - 1;
+    if ( i+1 >= so.size() ) i = so.size()-2;
+    ClothoidCurve const & C = CL.clotoidList[i];
+    ClothoidData CD;
+    CD.kappa0 = C.kappaBegin();
+    CD.dk     = C.dkappa();
+    // the offset length is monotone in t, Newton safeguarded by bisection
+    real_type r  = sigma - so[i];
+    real_type a  = 0;
+    real_type b  = C.length();
+    real_type t  = b*r/max( so[i+1]-so[i], machepsi );
+    real_type tl = 1e-14*max( real_type(1), b );
+    for ( int_type iter = 0; iter < 100 && b-a > tl; ++iter ) {
+      real_type f  = CD.length_ISO( t, offs ) - r;
+      real_type df = abs( 1-offs*CD.kappa( t ) );
+      if ( f > 0 ) b = t; else a = t;
+      real_type tn = df > 0 ? t - f/df : a;
+      if ( !( tn > a && tn < b ) ) tn = 0.5*(a+b);
+      if ( abs( tn-t ) <= tl ) { t = tn; break; }
+      t = tn;
+    }
+    return CL.s0[i] + t;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  ClothoidListOffset::closestPoint(
+    real_type   qx,
+    real_type   qy,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & t,
+    real_type & dst
+  ) const {
+    AABBtree::VecIpos candidateList;
+    P.tree.min_distance( qx, qy, candidateList );
+    return CL.closestPoint_candidates(
+      candidateList, P.tri, qx, qy, offs, x, y, s, t, dst
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  ClothoidListOffset::collision(
+    ClothoidListOffset const & V,
+    int_type                   nthreads
+  ) const {
+    ClothoidList::T2D_collision_list_ISO fun(
+      &CL, &P.tri, offs, &V.CL, &V.P.tri, V.offs
+    );
+    return P.tree.collision_parallel( V.P.tree, fun, nthreads );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidListOffset::intersect(
+    ClothoidListOffset const & V,
+    IntersectList            & ilist,
+    bool                       swap_s_vals,
+    int_type                   nthreads
+  ) const {
+    AABBtree::VecPairIpos iList;
+    P.tree.intersect_parallel( V.P.tree, iList, nthreads );
+    CL.intersect_candidates(
+      iList, P.tri, offs, V.CL, V.P.tri, V.offs, ilist, swap_s_vals, nthreads
+    );
+  }
+
 }
 
 // EOF: ClothoidList.cc
@@ -35,6 +35,46 @@ namespace G2lib {
 
   using std::vector;
 
+  //! outcome of the last `build` of the G2 solvers
+  typedef enum {
+    G2SOLVE_CONVERGED = 0, //!< solution found
+    G2SOLVE_BAD_DATA,      //!< coincident points or not finite data
+    G2SOLVE_GUESS_FAILED,  //!< the G1 guess could not be computed
+    G2SOLVE_SINGULAR,      //!< singular jacobian
+    G2SOLVE_NO_STEP,       //!< no acceptable step of the damped Newton
+    G2SOLVE_MAX_ITERATION, //!< maximum number of iterations reached
+    G2SOLVE_NOT_FINITE,    //!< NaN or infinity in the iterations
+    G2SOLVE_NOT_FEASIBLE,  //!< the solution has not positive lengths
+    G2SOLVE_EXCEPTION      //!< an exception was raised (not in no throw mode)
+  } G2solveStatus;
+
+  /*!
+   *  Diagnostic of the last `build` of the G2 solvers.
+   *
+   *  By default the solvers detect part of the failures by the exceptions
+   *  raised in the computation of the Fresnel integrals and of the G1
+   *  guess, which build the message (with the backtrace) of the exception.
+   *  In no throw mode (`setNoThrow(true)`) the data and the iterates are
+   *  checked before the evaluations: a failure costs the same as a step
+   *  of the iterations, nothing is allocated and no exception is thrown.
+   */
+  class G2solveInfo {
+  public:
+    G2solveStatus status;     //!< outcome
+    int           iterations; //!< Newton iterations done
+    real_type     residual;   //!< norm of the residual at the last iterate
+
+    G2solveInfo()
+    : status(G2SOLVE_CONVERGED)
+    , iterations(0)
+    , residual(0)
+    {}
+
+    void
+    set( G2solveStatus s, int iter, real_type res )
+    { status = s; iterations = iter; residual = res; }
+  };
+
   /*\
    |    ____ ____            _           ____
    |   / ___|___ \ ___  ___ | |_   _____|___ \ __ _ _ __ ___
@@ -68,6 +108,9 @@ namespace G2lib {
 
     ClothoidCurve S0, S1;
 
+    bool        noThrow;
+    G2solveInfo info;
+
     void
     evalA(
       real_type   alpha,
@@ -138,6 +181,7 @@ namespace G2lib {
     , th1(0)
     , k0(0)
     , k1(0)
+    , noThrow(false)
     {}
 
     ~G2solve2arc() {}
@@ -157,6 +201,15 @@ namespace G2lib {
     int
     solve();
 
+    /*!
+     *  With `yes` true the failures are reported by `getInfo()` and
+     *  `build` returns -1 without raising exceptions (see `G2solveInfo`).
+     */
+    void setNoThrow( bool yes ) { noThrow = yes; }
+
+    //! diagnostic of the last `build`
+    G2solveInfo const & getInfo() const { return info; }
+
     ClothoidCurve const & getS0() const { return S0; }
     ClothoidCurve const & getS1() const { return S1; }
 
@@ -192,6 +245,9 @@ namespace G2lib {
 
     ClothoidCurve S0, SM, S1;
 
+    bool        noThrow;
+    G2solveInfo info;
+
     bool
     buildSolution( real_type sM, real_type thM );
 
@@ -216,6 +272,7 @@ namespace G2lib {
     , th1(0)
     , k0(0)
     , k1(0)
+    , noThrow(false)
     {}
 
     ~G2solveCLC() {}
@@ -235,6 +292,15 @@ namespace G2lib {
     int
     solve();
 
+    /*!
+     *  With `yes` true the failures are reported by `getInfo()` and
+     *  `build` returns -1 without raising exceptions (see `G2solveInfo`).
+     */
+    void setNoThrow( bool yes ) { noThrow = yes; }
+
+    //! diagnostic of the last `build`
+    G2solveInfo const & getInfo() const { return info; }
+
     ClothoidCurve const & getS0() const { return S0; }
     ClothoidCurve const & getSM() const { return SM; }
     ClothoidCurve const & getS1() const { return S1; }
@@ -248,6 +314,8 @@ namespace G2lib {
    |  | |_| |/ __/\__ \ (_) | |\ V /  __/___) | (_| | | | (__
    |   \____|_____|___/\___/|_| \_/ \___|____/ \__,_|_|  \___|
   \*/
+  class G2solve3arcTable;
+
   // Clothoid-clothoid-clothoid with G2 continuity
   //! computation of the G2 fitting with 3 clothoid arcs
   class G2solve3arc {
@@ -275,6 +343,25 @@ namespace G2lib {
     // precomputed values
     real_type K0, K1, c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11, c12, c13, c14;
 
+    // optional table of initial guesses
+    G2solve3arcTable const * table;
+
+    bool        noThrow;
+    G2solveInfo info;
+
+    // G1 guess of the scaled problem (length `LG`), false if it fails
+    bool
+    guess_G1( ClothoidData & SG, real_type & LG );
+
+    // scaled problem, lengths s0, s1 and heuristic guess of `build`
+    bool
+    setup(
+      real_type & Dmax,
+      real_type & dmax,
+      real_type & sM_guess,
+      real_type & thM_guess
+    );
+
     void
     evalFJ(
       real_type const vars[2],
@@ -285,7 +372,7 @@ namespace G2lib {
     void
     evalF( real_type const vars[2], real_type F[2] ) const;
 
-    void
+    bool
     buildSolution( real_type sM, real_type thM );
 
     int
@@ -296,6 +383,8 @@ namespace G2lib {
     G2solve3arc()
     : tolerance(1e-10)
     , maxIter(100)
+    , table(nullptr)
+    , noThrow(false)
     {}
 
     ~G2solve3arc() {}
@@ -303,6 +392,24 @@ namespace G2lib {
     void setTolerance( real_type tol );
     void setMaxIter( int miter );
 
+    /*!
+     *  Use the table `T` (which must outlive the solver) for the initial
+     *  guess of `build`, `nullptr` restore the heuristic guess.
+     *  If the table has no guess for the data, the table guess is far
+     *  from the heuristic one or the Newton iterations started from the
+     *  table guess fail the heuristic guess is used.
+     */
+    void setTable( G2solve3arcTable const * T ) { table = T; }
+
+    /*!
+     *  With `yes` true the failures are reported by `getInfo()` and
+     *  `build` returns -1 without raising exceptions (see `G2solveInfo`).
+     */
+    void setNoThrow( bool yes ) { noThrow = yes; }
+
+    //! diagnostic of the last `build`
+    G2solveInfo const & getInfo() const { return info; }
+
     /*!
      *  Compute the 3 arc clothoid spline that fit the data
      *
@@ -566,6 +673,253 @@ namespace G2lib {
     ostream_type &
     operator << ( ostream_type & stream, ClothoidCurve const & c );
 
+    friend class G2solve3arcTable;
+
+  };
+
+  /*!
+   *  Table of the solutions of the scaled 3 arc G2 problem
+   *  (data moved to \f$ (-1,0) \f$, \f$ (1,0) \f$) used as initial guess
+   *  by `G2solve3arc::build`.
+   *
+   *  The scaled problem depends on the angles \f$ \theta_0, \theta_1 \f$
+   *  in \f$ [-\pi,\pi] \f$ and on the scaled curvatures \f$ K_0, K_1 \f$;
+   *  the curvatures are mapped in \f$ (-1,1) \f$ by
+   *  \f$ \frac{2}{\pi}\arctan(K) \f$ so that the regular grid of the table
+   *  covers the whole space.  Each node stores the converged unknowns
+   *  \f$ (s_M,\theta_M) \f$ of the Newton iterations, the guess is the
+   *  multilinear interpolation of the 16 surrounding nodes.
+   *  The lengths of the first and last arc depend on `Dmax` and `dmax`,
+   *  so the table is used only by the calls of `build` with the values
+   *  used to generate it.
+   *
+   *  Where the problem has more than one solution the iterations started
+   *  far from the heuristic guess may converge to another solution, so
+   *  `build` uses the table guess only when it is near the heuristic one
+   *  (\f$ s_M \f$ within a factor 2 and \f$ \theta_M \f$ within
+   *  \f$ \pi/4 \f$).
+   */
+  class G2solve3arcTable {
+    int_type      nth;    // nodes for the angles
+    int_type      nk;     // nodes for the curvatures
+    real_type     Dmax;
+    real_type     dmax;
+    vector<float> data;   // (sM,thM) of the nodes, NaN if not solved
+
+    size_t
+    index( int_type i0, int_type i1, int_type j0, int_type j1 ) const
+    { return 2*(((size_t(i0)*nth+i1)*nk+j0)*nk+j1); }
+
+    void
+    solve_range( int_type ib, int_type ie );
+
+  public:
+
+    G2solve3arcTable()
+    : nth(0)
+    , nk(0)
+    , Dmax(0)
+    , dmax(0)
+    {}
+
+    /*!
+     *  Compute the table using at most `max_bytes` bytes.
+     *  The nodes are solved with the heuristic guess (split among
+     *  `nthreads` threads), the nodes where it fails are solved
+     *  starting from the solution of the neighbour nodes.
+     *
+     *  \param[in] max_bytes memory budget of the table
+     *  \param[in] Dmax      as in `G2solve3arc::build`
+     *  \param[in] dmax      as in `G2solve3arc::build`
+     *  \param[in] nthreads  number of threads
+     */
+    void
+    generate(
+      size_t    max_bytes,
+      real_type Dmax     = 0,
+      real_type dmax     = 0,
+      int_type  nthreads = 1
+    );
+
+    bool
+    empty() const
+    { return data.empty(); }
+
+    //! nodes for each angle
+    int_type numNodesTheta() const { return nth; }
+
+    //! nodes for each curvature
+    int_type numNodesKappa() const { return nk; }
+
+    //! number of nodes without a solution
+    int_type numFailed() const;
+
+    //! memory used by the table (bytes)
+    size_t
+    memory() const
+    { return data.size()*sizeof(float); }
+
+    /*!
+     *  Interpolated guess of the scaled problem, false if the table
+     *  is not computed for `Dmax`, `dmax` or a surrounding node
+     *  has no solution.
+     */
+    bool
+    guess(
+      real_type   Dmax,
+      real_type   dmax,
+      real_type   th0,
+      real_type   th1,
+      real_type   K0,
+      real_type   K1,
+      real_type & sM,
+      real_type & thM
+    ) const;
+
+    //! write the table in binary form
+    void
+    save( ostream_type & stream ) const;
+
+    //! read a table written by `save`, return false if the data are not valid
+    bool
+    load( std::istream & stream );
+  };
+
+  /*\
+   |   _           _       _
+   |  | |__   __ _| |_ ___| |__
+   |  | '_ \ / _` | __/ __| '_ \
+   |  | |_) | (_| | || (__| | | |
+   |  |_.__/ \__,_|\__\___|_| |_|
+  \*/
+
+  /*!
+   *  Solve many 3 arc G2 fitting problems at once.
+   *
+   *  Same problem, guess and Newton iterations of `G2solve3arc::build`,
+   *  but the problems are advanced together: at each step the
+   *  generalized Fresnel integrals of all the active problems are
+   *  computed with one call of the batched kernels
+   *  (`GeneralizedFresnelCS_batch`), converged problems leave the
+   *  active set.  The data and the results are stored as arrays
+   *  (one for each quantity) and the problems can be split
+   *  among threads.
+   */
+  class G2solve3arcBatch {
+  public:
+
+    //! outcome of a problem
+    typedef enum {
+      CONVERGED = 0, //!< Newton converged
+      MAX_ITERATION, //!< maximum number of iterations reached
+      SINGULAR,      //!< singular jacobian
+      NOT_FINITE,    //!< NaN or infinity in the iterations
+      GUESS_FAILED   //!< the G1 guess could not be computed
+    } Status;
+
+    //! data of one of the 3 arcs of all the problems
+    class Arcs {
+    public:
+      vector<real_type> x0;     //!< initial x coordinate
+      vector<real_type> y0;     //!< initial y coordinate
+      vector<real_type> theta0; //!< initial angle
+      vector<real_type> kappa0; //!< initial curvature
+      vector<real_type> dk;     //!< curvature derivative
+      vector<real_type> L;      //!< length
+
+      void resize( size_t n );
+    };
+
+  private:
+
+    real_type tolerance;
+    int       maxIter;
+    int_type  numThreads;
+
+    Arcs             S0, SM, S1;
+    vector<int_type> stat, iters;
+
+    void
+    solve_range(
+      int_type        ib,
+      int_type        ie,
+      real_type const x0[],
+      real_type const y0[],
+      real_type const theta0[],
+      real_type const kappa0[],
+      real_type const x1[],
+      real_type const y1[],
+      real_type const theta1[],
+      real_type const kappa1[],
+      real_type       Dmax,
+      real_type       dmax
+    );
+
+  public:
+
+    G2solve3arcBatch()
+    : tolerance(1e-10)
+    , maxIter(100)
+    , numThreads(1)
+    {}
+
+    ~G2solve3arcBatch() {}
+
+    void setTolerance( real_type tol );
+    void setMaxIter( int miter );
+
+    //! number of threads used by `build` (default 1)
+    void setNumThreads( int_type nt );
+
+    /*!
+     *  Compute the 3 arc clothoid splines that fit the `n` problems
+     *  `(x0[i],y0[i],theta0[i],kappa0[i])` to `(x1[i],y1[i],theta1[i],kappa1[i])`.
+     *
+     *  \param[in] Dmax rough desidered maximum angle variation, if 0 computed automatically
+     *  \param[in] dmax rough desidered maximum angle divergence from guess, if 0 computed automatically
+     *  \return number of converged problems
+     */
+    int_type
+    build(
+      int_type        n,
+      real_type const x0[],
+      real_type const y0[],
+      real_type const theta0[],
+      real_type const kappa0[],
+      real_type const x1[],
+      real_type const y1[],
+      real_type const theta1[],
+      real_type const kappa1[],
+      real_type       Dmax = 0,
+      real_type       dmax = 0
+    );
+
+    //! number of problems of the last `build`
+    int_type numProblems() const { return int_type(stat.size()); }
+
+    //! outcome of the problem `i`
+    Status status( int_type i ) const { return Status(stat[size_t(i)]); }
+
+    //! Newton iterations of the problem `i` (as `G2solve3arc::build` if converged)
+    int_type iterations( int_type i ) const { return iters[size_t(i)]; }
+
+    //! first arcs of the problems
+    Arcs const & getS0() const { return S0; }
+
+    //! middle arcs of the problems
+    Arcs const & getSM() const { return SM; }
+
+    //! last arcs of the problems
+    Arcs const & getS1() const { return S1; }
+
+    //! build the three arcs of the problem `i`
+    void
+    get(
+      int_type        i,
+      ClothoidCurve & C0,
+      ClothoidCurve & CM,
+      ClothoidCurve & C1
+    ) const;
   };
 
   /*\
@@ -579,59 +933,289 @@ namespace G2lib {
   //! \brief Class to manage a list of clothoid curves (not necessarily G2 or G1 connected)
   class ClothoidList : public BaseCurve {
 
+    friend class ClothoidListCursor;
+    friend class ClothoidListOffset;
+    friend class CurveBinary;
+    friend class CurveIndex;
+
     bool                  curve_is_closed;
     vector<real_type>     s0;
     vector<ClothoidCurve> clotoidList;
 
-    #ifdef G2LIB_USE_CXX11
-    mutable std::mutex                         lastInterval_mutex;
-    mutable std::map<std::thread::id,int_type> lastInterval_by_thread;
-    #else
+    #ifndef G2LIB_USE_CXX11
     mutable int_type lastInterval;
     #endif
 
     mutable bool               aabb_done;
+    mutable bool               aabb_is_flat; // aabb_flat used in place of aabb_tree
     mutable AABBtree           aabb_tree;
+    mutable AABBtreeFlat       aabb_flat;
     mutable real_type          aabb_offs;
     mutable real_type          aabb_max_angle;
     mutable real_type          aabb_max_size;
     mutable vector<Triangle2D> aabb_tri;
 
+    // read only AABB trees built by prepare_AABBtree_ISO
+    vector<AABBtriangles> aabb_prepared;
+
     class T2D_collision_list_ISO {
-      ClothoidList const * pList1;
-      real_type    const   offs1;
-      ClothoidList const * pList2;
-      real_type    const   offs2;
+      ClothoidList       const * pList1;
+      vector<Triangle2D> const * pT1;
+      real_type          const   offs1;
+      ClothoidList       const * pList2;
+      vector<Triangle2D> const * pT2;
+      real_type          const   offs2;
     public:
       T2D_collision_list_ISO(
-        ClothoidList const * _pList1,
-        real_type    const   _offs1,
-        ClothoidList const * _pList2,
-        real_type    const   _offs2
+        ClothoidList       const * _pList1,
+        vector<Triangle2D> const * _pT1,
+        real_type          const   _offs1,
+        ClothoidList       const * _pList2,
+        vector<Triangle2D> const * _pT2,
+        real_type          const   _offs2
       )
       : pList1(_pList1)
+      , pT1(_pT1)
       , offs1(_offs1)
       , pList2(_pList2)
+      , pT2(_pT2)
       , offs2(_offs2)
       {}
 
       bool
-      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const {
-        Triangle2D    const & T1 = pList1->aabb_tri[size_t(ptr1->Ipos())];
-        Triangle2D    const & T2 = pList2->aabb_tri[size_t(ptr2->Ipos())];
+      operator () ( int_type ipos1, int_type ipos2 ) const {
+        Triangle2D    const & T1 = (*pT1)[size_t(ipos1)];
+        Triangle2D    const & T2 = (*pT2)[size_t(ipos2)];
         ClothoidCurve const & C1 = pList1->get(T1.Icurve());
         ClothoidCurve const & C2 = pList2->get(T2.Icurve());
         real_type ss1, ss2;
         return C1.aabb_intersect_ISO( T1, offs1, &C2, T2, offs2, ss1, ss2 );
       }
+
+      bool
+      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const
+      { return (*this)( ptr1->Ipos(), ptr2->Ipos() ); }
     };
 
+    // refine a candidate pair of triangles and pass the intersection
+    // to the visitor, as a collision function of the AABB trees:
+    // "collide" (stop the traversal) when the visitor stops
+    class T2D_visit_ISO {
+      ClothoidList       const * pList1;
+      vector<Triangle2D> const * pT1;
+      real_type          const   offs1;
+      ClothoidList       const * pList2;
+      vector<Triangle2D> const * pT2;
+      real_type          const   offs2;
+      IntersectVisitor         * pV;
+    public:
+      T2D_visit_ISO(
+        ClothoidList       const * _pList1,
+        vector<Triangle2D> const * _pT1,
+        real_type          const   _offs1,
+        ClothoidList       const * _pList2,
+        vector<Triangle2D> const * _pT2,
+        real_type          const   _offs2,
+        IntersectVisitor         * _pV
+      )
+      : pList1(_pList1)
+      , pT1(_pT1)
+      , offs1(_offs1)
+      , pList2(_pList2)
+      , pT2(_pT2)
+      , offs2(_offs2)
+      , pV(_pV)
+      {}
+
+      bool
+      operator () ( int_type ipos1, int_type ipos2 ) const {
+        Triangle2D    const & T1 = (*pT1)[size_t(ipos1)];
+        Triangle2D    const & T2 = (*pT2)[size_t(ipos2)];
+        ClothoidCurve const & C1 = pList1->get(T1.Icurve());
+        ClothoidCurve const & C2 = pList2->get(T2.Icurve());
+        real_type ss1, ss2;
+        if ( !C1.aabb_intersect_ISO( T1, offs1, &C2, T2, offs2, ss1, ss2 ) )
+          return false;
+        return !pV->visit(
+          ss1 + pList1->s0[size_t(T1.Icurve())],
+          ss2 + pList2->s0[size_t(T2.Icurve())]
+        );
+      }
+
+      bool
+      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const
+      { return (*this)( ptr1->Ipos(), ptr2->Ipos() ); }
+    };
+
+    // refine a pair of triangles of the same list for `self_collision_ISO`
+    // and `self_intersect_ISO`: adjacent triangles (also the last and the
+    // first one of a curve that ends where it starts) are not a crossing.
+    // The crossings are appended to `pList` if not nullptr, otherwise
+    // the first one stops the traversal
+    class T2D_self_ISO {
+      ClothoidList       const * pList;
+      vector<Triangle2D> const * pT;
+      real_type          const   offs;
+      bool               const   closed;
+      IntersectList            * pRes;
+    public:
+      T2D_self_ISO(
+        ClothoidList       const * _pList,
+        vector<Triangle2D> const * _pT,
+        real_type          const   _offs,
+        bool               const   _closed,
+        IntersectList            * _pRes
+      )
+      : pList(_pList)
+      , pT(_pT)
+      , offs(_offs)
+      , closed(_closed)
+      , pRes(_pRes)
+      {}
+
+      bool
+      operator () ( int_type ipos1, int_type ipos2 ) const {
+        int_type a = std::min( ipos1, ipos2 );
+        int_type b = std::max( ipos1, ipos2 );
+        if ( b-a <= 1 ) return false;
+        if ( closed && a == 0 && b == int_type(pT->size())-1 ) return false;
+        Triangle2D    const & T1 = (*pT)[size_t(a)];
+        Triangle2D    const & T2 = (*pT)[size_t(b)];
+        ClothoidCurve const & C1 = pList->get(T1.Icurve());
+        ClothoidCurve const & C2 = pList->get(T2.Icurve());
+        real_type ss1, ss2;
+        if ( !C1.aabb_intersect_ISO( T1, offs, &C2, T2, offs, ss1, ss2 ) )
+          return false;
+        if ( pRes == nullptr ) return true;
+        pRes->push_back( Ipair(
+          ss1 + pList->s0[size_t(T1.Icurve())],
+          ss2 + pList->s0[size_t(T2.Icurve())]
+        ) );
+        return false;
+      }
+
+      bool
+      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const
+      { return (*this)( ptr1->Ipos(), ptr2->Ipos() ); }
+    };
+
+    // the tree and the triangles at offset `offs` (prepared or built),
+    // `flat` is nullptr when `aabb_tree` is used
+    void
+    select_AABBtree_ISO(
+      real_type                    offs,
+      AABBtreeFlat       const * & flat,
+      vector<Triangle2D> const * & tri
+    ) const;
+
+    // the triangles (first and last) at the ends of a curve that ends
+    // where it starts are adjacent
+    bool
+    ends_meet_ISO( real_type offs ) const;
+
+    // the curve is changed: the AABB trees must be rebuilt
+    void
+    resetAABBtree() {
+      aabb_done = false;
+      aabb_prepared.clear();
+    }
+
     void
     resetLastInterval() {
-      std::lock_guard<std::mutex> lck(lastInterval_mutex);
-      lastInterval_by_thread[std::this_thread::get_id()] = 0;
+      #ifdef G2LIB_USE_CXX11
+      findAtS_thread_hint( this ) = 0;
+      #else
+      lastInterval = 0;
+      #endif
     }
 
+    // single pass evaluation of the (sorted) abscissae `s`,
+    // `nder` is the derivative order, `offs` is used if `ISO` is true
+    void
+    eval_batch_walk(
+      int_type        nder,
+      bool            ISO,
+      real_type       offs,
+      real_type const s[],
+      int_type        n,
+      real_type       x[],
+      real_type       y[]
+    ) const;
+
+    // closest point on the triangles `candidateList` of `tri` at offset `offs`
+    int_type
+    closestPoint_candidates(
+      AABBtree::VecIpos  const & candidateList,
+      vector<Triangle2D> const & tri,
+      real_type                  qx,
+      real_type                  qy,
+      real_type                  offs,
+      real_type                & x,
+      real_type                & y,
+      real_type                & s,
+      real_type                & t,
+      real_type                & DST
+    ) const;
+
+    // intersections of the pairs of triangles `iList` of `tri1` and `tri2`,
+    // with `nthreads > 1` the pairs are split in chunks refined in parallel
+    void
+    intersect_candidates(
+      AABBtree::VecPairIpos const & iList,
+      vector<Triangle2D>    const & tri1,
+      real_type                     offs,
+      ClothoidList          const & CL,
+      vector<Triangle2D>    const & tri2,
+      real_type                     offs_CL,
+      IntersectList               & ilist,
+      bool                          swap_s_vals,
+      int_type                      nthreads = 1
+    ) const;
+
+    // the pairs `iList[ibegin..iend-1]` of `intersect_candidates`
+    void
+    intersect_candidates_range(
+      AABBtree::VecPairIpos const & iList,
+      size_t                        ibegin,
+      size_t                        iend,
+      vector<Triangle2D>    const & tri1,
+      real_type                     offs,
+      ClothoidList          const & CL,
+      vector<Triangle2D>    const & tri2,
+      real_type                     offs_CL,
+      IntersectList               & ilist,
+      bool                          swap_s_vals
+    ) const;
+
+    // projection of the points `ibegin..iend-1` for `closestPoint_batch_ISO`,
+    // `flat` is the tree of the triangles `tri` (nullptr for `aabb_tree`)
+    int_type
+    closestPoint_batch_range(
+      AABBtreeFlat       const * flat,
+      vector<Triangle2D> const * tri,
+      int_type                   ibegin,
+      int_type                   iend,
+      real_type          const   qx[],
+      real_type          const   qy[],
+      real_type                  offs,
+      real_type                  s[],
+      real_type                  t[],
+      real_type                  dst[]
+    ) const;
+
+    // triangles at offset `offs` and their tree, prepared or built
+    // on demand (one of `flat` and `tree` is not `nullptr`)
+    void
+    AABBtree_ISO(
+      real_type                    offs,
+      vector<Triangle2D> const * & tri,
+      AABBtreeFlat       const * & flat,
+      AABBtree           const * & tree
+    ) const;
+
+    class PieceDistance;
+    class SegmentFound;
+
   public:
 
     #include "BaseCurve_using.hxx"
@@ -711,12 +1295,23 @@ namespace G2lib {
       real_type const y[]
     );
 
+    /*!
+     *  Build the list of `n-1` clothoids interpolating the points
+     *  `(x[i],y[i])` with angles `theta[i]`.
+     *
+     *  The Hermite problems of the segments are independent:
+     *  with `nthreads > 1` the segments are split in `nthreads`
+     *  contiguous chunks built concurrently.  The curvilinear
+     *  abscissae are accumulated serially afterwards, so the list
+     *  is identical (bit by bit) to the one built with one thread.
+     */
     bool
     build_G1(
       int_type        n,
       real_type const x[],
       real_type const y[],
-      real_type const theta[]
+      real_type const theta[],
+      int_type        nthreads = 1
     );
 
     bool
@@ -784,13 +1379,24 @@ namespace G2lib {
     int_type
     findAtS( real_type s ) const {
       #ifdef G2LIB_USE_CXX11
-      std::lock_guard<std::mutex> lck(lastInterval_mutex);
-      return ::G2lib::findAtS( s, lastInterval_by_thread[std::this_thread::get_id()], s0 );
+      return this->findAtS( s, findAtS_thread_hint( this ) );
       #else
-      return ::G2lib::findAtS( s, lastInterval, s0 );
+      return this->findAtS( s, lastInterval );
       #endif
     }
 
+    /*!
+     * Find the segment containing `s` starting the search from the
+     * caller owned hint `last_idx` (updated on exit).
+     * No shared state is touched, so a thread or a sweep can keep
+     * its own cursor without any synchronization.
+     */
+    int_type
+    findAtS( real_type s, int_type & last_idx ) const {
+      if ( last_idx < 0 || last_idx >= this->numSegment() ) last_idx = 0;
+      return ::G2lib::findAtS( s, last_idx, s0 );
+    }
+
     // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
 
     virtual
@@ -853,6 +1459,38 @@ namespace G2lib {
       real_type max_size  = 1e100
     ) const;
 
+    /*!
+     * Build once the triangles covering the curve at offset `offs`
+     * and their AABB tree and keep them (several offsets can be
+     * prepared, e.g. one for each lane). `closestPoint_ISO`,
+     * `closestSegment`, `collision_ISO`, `intersect_ISO` and
+     * `self_intersect_ISO` with a prepared offset (on both lists for
+     * the binary ones) only read them: no lazy rebuild, no locking,
+     * safe from many threads.
+     * The prepared trees are dropped when the list is changed.
+     */
+    void
+    prepare_AABBtree_ISO(
+      real_type offs,
+      real_type max_angle = m_pi/6, // 30 degree
+      real_type max_size  = 1e100
+    );
+
+    //! remove all the trees built by `prepare_AABBtree_ISO`
+    void
+    clear_prepared_AABBtree()
+    { aabb_prepared.clear(); }
+
+    //! tree built by `prepare_AABBtree_ISO` for `offs`, `nullptr` if not prepared
+    AABBtriangles const *
+    prepared_AABBtree_ISO(
+      real_type offs,
+      real_type max_angle = m_pi/6, // 30 degree
+      real_type max_size  = 1e100
+    ) const {
+      return AABBtriangles::find( aabb_prepared, offs, max_angle, max_size );
+    }
+
     /*\
      |   _     _
      |  | |__ | |__   _____  __
@@ -1248,6 +1886,115 @@ namespace G2lib {
       real_type & y_DDD
     ) const G2LIB_OVERRIDE;
 
+    /*\
+     |   _           _       _
+     |  | |__   __ _| |_ ___| |__
+     |  | '_ \ / _` | __/ __| '_ \
+     |  | |_) | (_| | || (__| | | |
+     |  |_.__/ \__,_|\__\___|_| |_|
+    \*/
+
+    /*!
+     *  Evaluate the list at the `n` positions `s[0..n-1]`.
+     *  The abscissae are walked in a single pass: consecutive points
+     *  falling in the same segment are passed together to the segment
+     *  kernel and the segment search is done only when the segment
+     *  changes. Unsorted abscissae are allowed but slower.
+     */
+    virtual
+    void
+    eval_batch(
+      real_type const s[],
+      int_type        n,
+      real_type       x[],
+      real_type       y[]
+    ) const G2LIB_OVERRIDE
+    { this->eval_batch_walk( 0, false, 0, s, n, x, y ); }
+
+    virtual
+    void
+    eval_batch_D(
+      real_type const s[],
+      int_type        n,
+      real_type       x_D[],
+      real_type       y_D[]
+    ) const G2LIB_OVERRIDE
+    { this->eval_batch_walk( 1, false, 0, s, n, x_D, y_D ); }
+
+    virtual
+    void
+    eval_batch_DD(
+      real_type const s[],
+      int_type        n,
+      real_type       x_DD[],
+      real_type       y_DD[]
+    ) const G2LIB_OVERRIDE
+    { this->eval_batch_walk( 2, false, 0, s, n, x_DD, y_DD ); }
+
+    virtual
+    void
+    eval_batch_DDD(
+      real_type const s[],
+      int_type        n,
+      real_type       x_DDD[],
+      real_type       y_DDD[]
+    ) const G2LIB_OVERRIDE
+    { this->eval_batch_walk( 3, false, 0, s, n, x_DDD, y_DDD ); }
+
+    virtual
+    void
+    eval_batch_ISO(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x[],
+      real_type       y[]
+    ) const G2LIB_OVERRIDE
+    { this->eval_batch_walk( 0, true, offs, s, n, x, y ); }
+
+    virtual
+    void
+    eval_batch_ISO_D(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_D[],
+      real_type       y_D[]
+    ) const G2LIB_OVERRIDE
+    { this->eval_batch_walk( 1, true, offs, s, n, x_D, y_D ); }
+
+    virtual
+    void
+    eval_batch_ISO_DD(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_DD[],
+      real_type       y_DD[]
+    ) const G2LIB_OVERRIDE
+    { this->eval_batch_walk( 2, true, offs, s, n, x_DD, y_DD ); }
+
+    virtual
+    void
+    eval_batch_ISO_DDD(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_DDD[],
+      real_type       y_DDD[]
+    ) const G2LIB_OVERRIDE
+    { this->eval_batch_walk( 3, true, offs, s, n, x_DDD, y_DDD ); }
+
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    virtual
+    void
+    sample_stations_ISO(
+      real_type           offs,
+      real_type           tol,
+      vector<real_type> & s
+    ) const G2LIB_OVERRIDE;
+
     /*\
      |  _                        __
      | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -1338,6 +2085,115 @@ namespace G2lib {
       real_type & dst
     ) const G2LIB_OVERRIDE;
 
+    /*!
+     *  Project the `n` points `(qx[i],qy[i])` on the curve with offset `offs`,
+     *  same result of `closestPoint_ISO` called point by point.
+     *
+     *  The points are expected to be ordered along a trajectory:
+     *  the segment found for a point is tried first for the next one
+     *  and its distance bounds the search in the AABB tree, so
+     *  coherent points visit few nodes.  The buffers of the search
+     *  are allocated once for the whole batch.
+     *  With `nthreads > 1` the points are split in `nthreads` contiguous
+     *  chunks projected concurrently; the AABB tree is built (if needed)
+     *  before the threads start.
+     *
+     *  \param  qx       x-coordinates of the points
+     *  \param  qy       y-coordinates of the points
+     *  \param  n        number of points
+     *  \param  offs     offset of the curve
+     *  \param  s        parameter on the curve of the projections
+     *  \param  t        curvilinear coordinate of the points
+     *  \param  dst      distance point projected point
+     *  \param  nthreads number of threads used
+     *  \return number of points whose minimum is not an orthogonal
+     *          projection (`closestPoint_ISO` returns -1 for them)
+     */
+    int_type
+    closestPoint_batch_ISO(
+      real_type const qx[],
+      real_type const qy[],
+      int_type        n,
+      real_type       offs,
+      real_type       s[],
+      real_type       t[],
+      real_type       dst[],
+      int_type        nthreads = 1
+    ) const;
+
+    //! as `closestPoint_batch_ISO` with zero offset
+    int_type
+    closestPoint_batch_ISO(
+      real_type const qx[],
+      real_type const qy[],
+      int_type        n,
+      real_type       s[],
+      real_type       t[],
+      real_type       dst[],
+      int_type        nthreads = 1
+    ) const {
+      return closestPoint_batch_ISO( qx, qy, n, 0, s, t, dst, nthreads );
+    }
+
+    /*!
+     *  The (at most) `k` segments of the curve with offset `offs` nearest
+     *  to `(qx,qy)` and not farther than `dmax`, by increasing distance.
+     *  Best first search on the AABB tree: only the triangles nearer than
+     *  the `k`-th segment found are refined.
+     *
+     *  \param  qx    x-coordinate of the point
+     *  \param  qy    y-coordinate of the point
+     *  \param  offs  offset of the curve
+     *  \param  k     maximum number of segments
+     *  \param  dmax  maximum distance
+     *  \param  iseg  index of the segments
+     *  \param  s     parameter on the curve of the closest point of the segments
+     *  \param  dst   distance of the segments
+     */
+    void
+    nearestSegments_ISO(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      int_type            k,
+      real_type           dmax,
+      vector<int_type>  & iseg,
+      vector<real_type> & s,
+      vector<real_type> & dst
+    ) const;
+
+    //! the segments with distance from `(qx,qy)` not greater than `r`, as `nearestSegments_ISO`
+    void
+    segmentsWithin_ISO(
+      real_type           qx,
+      real_type           qy,
+      real_type           offs,
+      real_type           r,
+      vector<int_type>  & iseg,
+      vector<real_type> & s,
+      vector<real_type> & dst
+    ) const {
+      nearestSegments_ISO(
+        qx, qy, offs, std::numeric_limits<int_type>::max(), r, iseg, s, dst
+      );
+    }
+
+    /*!
+     *  Distance field clipped at `dmax` (e.g. a costmap or a clearance check):
+     *  `dst[i]` is the distance of `(qx[i],qy[i])` from the curve with offset
+     *  `offs`, or `dmax` if it is farther.  The search of a point farther
+     *  than `dmax` stops at the top of the AABB tree.
+     */
+    void
+    distanceField_ISO(
+      real_type       offs,
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type       dmax,
+      real_type       dst[]
+    ) const;
+
     /*\
      |      _ _     _
      |   __| (_)___| |_ __ _ _ __   ___ ___
@@ -1523,6 +2379,11 @@ namespace G2lib {
     /*!
      *  \brief Find parametric coordinate.
      *
+     *  The segments are selected with the AABB tree of the list
+     *  (the prepared tree with zero offset if any), only when no
+     *  segment near the point has an orthogonal projection all the
+     *  segments are checked.
+     *
      *  \param  x    x-coordinate point
      *  \param  y    y-coordinate point
      *  \param  s    value \f$ s \f$
@@ -1572,11 +2433,17 @@ namespace G2lib {
     bool
     collision( ClothoidList const & C ) const;
 
+    /*!
+     *  Check collision with `CL`.  With `nthreads > 1` the traversal of
+     *  the two AABB trees is split among `nthreads` threads and the
+     *  first one that finds a collision stops the others.
+     */
     bool
     collision_ISO(
       real_type            offs,
       ClothoidList const & CL,
-      real_type            offs_C
+      real_type            offs_C,
+      int_type             nthreads = 1
     ) const;
 
     /*\
@@ -1596,13 +2463,70 @@ namespace G2lib {
       intersect_ISO( 0, CL, 0, ilist, swap_s_vals );
     }
 
+    /*!
+     *  Intersections with `CL`.  With `nthreads > 1` the traversal of
+     *  the two AABB trees and the Newton refinement of the candidate
+     *  pairs of triangles are split among `nthreads` threads; the list
+     *  `ilist` is the same (and in the same order) of the serial one.
+     */
     void
     intersect_ISO(
       real_type            offs,
       ClothoidList const & CL,
       real_type            offs_obj,
       IntersectList      & ilist,
-      bool                 swap_s_vals
+      bool                 swap_s_vals,
+      int_type             nthreads = 1
+    ) const;
+
+    /*!
+     *  True if the curve at offset `offs` crosses itself.
+     *  A single AABB tree is traversed against itself (see
+     *  `AABBtreeFlat::self_collision`): adjacent triangles along the
+     *  curve are skipped and the search stops at the first crossing.
+     *  A curve that ends where it starts is not a crossing.
+     */
+    bool
+    self_collision_ISO( real_type offs ) const;
+
+    bool
+    self_collision() const
+    { return self_collision_ISO( 0 ); }
+
+    /*!
+     *  Append to `ilist` the points where the curve at offset `offs`
+     *  crosses itself as pairs `(s1,s2)` with `s1 < s2`, sorted by `s1`.
+     *  The same crossing found at the common boundary of two triangles
+     *  is listed once.
+     */
+    void
+    self_intersect_ISO( real_type offs, IntersectList & ilist ) const;
+
+    void
+    self_intersect( IntersectList & ilist ) const
+    { self_intersect_ISO( 0, ilist ); }
+
+    /*!
+     *  Stream the intersections with `CL` to `visitor`, without
+     *  collecting them, stopping as soon as `visit` returns `false`.
+     *  The candidate pairs of triangles are refined while the two AABB
+     *  trees are traversed, so nothing is computed after the stop.
+     *  With `ordered` the candidates are refined by increasing `s1`
+     *  (the trees are traversed first) and the intersections are visited
+     *  by increasing `s1`: the first `k` visited are the first `k`
+     *  along the curve.  The intersections nearer than `tol` (in both
+     *  the abscissa) to one already visited are dropped.
+     *
+     *  \return true if the search was stopped by the visitor
+     */
+    bool
+    intersect_visit_ISO(
+      real_type            offs,
+      ClothoidList const & CL,
+      real_type            offs_CL,
+      IntersectVisitor   & visitor,
+      bool                 ordered = false,
+      real_type            tol     = 1e-8
     ) const;
 
     /*! \brief Save Clothoid list to a stream
@@ -1612,6 +2536,14 @@ namespace G2lib {
     void
     export_table( ostream_type & stream ) const;
 
+    /*! \brief Load Clothoid list from a stream written by `export_table`
+     *
+     * \param stream   stream to read
+     * \param nthreads number of threads parsing the text (see `read_table`)
+     */
+    void
+    import_table( istream_type & stream, int_type nthreads = 1 );
+
     /*! \brief Save Clothoid list to a stream
      *
      * \param stream streamstream to save
@@ -1621,6 +2553,174 @@ namespace G2lib {
 
   };
 
+  //! Forward cursor on a `ClothoidList` (see `CurveCursor`),
+  //! the list must outlive the cursor
+  class ClothoidListCursor : public CurveCursor {
+    ClothoidList const & CL;
+    int_type             idx; // hint of the segment search
+
+    void anchor( real_type s ) G2LIB_OVERRIDE;
+
+  public:
+
+    /*!
+     *  \param[in] _CL  the list
+     *  \param[in] _tol maximum position error
+     *  \param[in] s    initial curvilinear abscissa
+     */
+    ClothoidListCursor(
+      ClothoidList const & _CL,
+      real_type            _tol = 1e-10,
+      real_type            s    = 0
+    )
+    : CurveCursor(_tol)
+    , CL(_CL)
+    , idx(0)
+    { this->anchor( s ); }
+  };
+
+  /*\
+   |    ___   __  __          _
+   |   / _ \ / _|/ _|___ ___| |_
+   |  | (_) |  _|  _(_-</ -_)  _|
+   |   \___/|_| |_| /__/\___|\__|
+  \*/
+
+  /*!
+   *  Offset curve of a `ClothoidList` at a fixed ISO offset.
+   *  The offset length of the segments, their bounding boxes, the
+   *  triangles covering the offset curve and their AABB tree are built
+   *  once by the constructor and then only read: one view for each lane
+   *  boundary can be served from the same list, also from many threads.
+   *  The list is referenced, not copied, call `update` after changing it.
+   *  The curvilinear abscissa `s` is the one of the list, `sOffset`
+   *  and `sList` convert it to and from the arc length of the offset curve.
+   */
+  class ClothoidListOffset {
+    ClothoidList const & CL;
+    real_type            offs;
+    vector<real_type>    so;  // offset length at the start of the segments
+    vector<real_type>    bb;  // xmin, ymin, xmax, ymax of the segments
+    real_type            bb_xmin, bb_ymin, bb_xmax, bb_ymax;
+    AABBtriangles        P;   // triangles of the offset curve and their tree
+
+    ClothoidListOffset const & operator = ( ClothoidListOffset const & );
+
+    // index of the segment containing `s` and `s` inside the list
+    int_type findAtS( real_type & s ) const;
+
+  public:
+
+    /*!
+     *  \param[in] _CL       the list, it must outlive the view
+     *  \param[in] _offs     ISO offset
+     *  \param[in] max_angle maximum angle variation of the covering triangles
+     *  \param[in] max_size  maximum size of the covering triangles
+     */
+    ClothoidListOffset(
+      ClothoidList const & _CL,
+      real_type            _offs,
+      real_type            max_angle = m_pi/6, // 30 degree
+      real_type            max_size  = 1e100
+    );
+
+    //! rebuild the tables after a change of the list
+    void update();
+
+    ClothoidList const & curve()  const { return CL; }
+    real_type            offset() const { return offs; }
+
+    int_type
+    numSegment() const
+    { return int_type(so.size())-1; }
+
+    //! length of the offset curve
+    real_type
+    length() const
+    { return so.back(); }
+
+    //! length of the segment `nseg` of the offset curve
+    real_type
+    segment_length( int_type nseg ) const;
+
+    //! arc length of the offset curve at the abscissa `s` of the list
+    real_type
+    sOffset( real_type s ) const;
+
+    //! abscissa of the list at the arc length `sigma` of the offset curve
+    real_type
+    sList( real_type sigma ) const;
+
+    void
+    bbox(
+      real_type & xmin,
+      real_type & ymin,
+      real_type & xmax,
+      real_type & ymax
+    ) const {
+      xmin = bb_xmin; ymin = bb_ymin;
+      xmax = bb_xmax; ymax = bb_ymax;
+    }
+
+    //! bounding box of the segment `nseg` of the offset curve
+    void
+    segment_bbox(
+      int_type    nseg,
+      real_type & xmin,
+      real_type & ymin,
+      real_type & xmax,
+      real_type & ymax
+    ) const;
+
+    vector<Triangle2D> const & triangles() const { return P.tri; }
+    AABBtreeFlat       const & tree()      const { return P.tree; }
+
+    void
+    eval( real_type s, real_type & x, real_type & y ) const
+    { CL.eval_ISO( s, offs, x, y ); }
+
+    void
+    eval_D( real_type s, real_type & x_D, real_type & y_D ) const
+    { CL.eval_ISO_D( s, offs, x_D, y_D ); }
+
+    void
+    eval_DD( real_type s, real_type & x_DD, real_type & y_DD ) const
+    { CL.eval_ISO_DD( s, offs, x_DD, y_DD ); }
+
+    //! as `ClothoidList::closestPoint_ISO` at the offset of the view
+    int_type
+    closestPoint(
+      real_type   qx,
+      real_type   qy,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & t,
+      real_type & dst
+    ) const;
+
+    real_type
+    distance( real_type qx, real_type qy ) const {
+      real_type x, y, s, t, dst;
+      closestPoint( qx, qy, x, y, s, t, dst );
+      return dst;
+    }
+
+    //! collision with the view `V` (see `ClothoidList::collision_ISO` for `nthreads`)
+    bool
+    collision( ClothoidListOffset const & V, int_type nthreads = 1 ) const;
+
+    //! intersections with the view `V`, `s` values are those of the lists
+    //! (see `ClothoidList::intersect_ISO` for `nthreads`)
+    void
+    intersect(
+      ClothoidListOffset const & V,
+      IntersectList            & ilist,
+      bool                       swap_s_vals = false,
+      int_type                   nthreads    = 1
+    ) const;
+  };
+
   /*\
    |
    |    ___ _     _   _        _    _ ___      _ _           ___ ___
@@ -1647,14 +2747,49 @@ namespace G2lib {
     // work vector
     mutable vector<real_type> k, dk, L, kL, L_1, L_2, k_1, k_2, dk_1, dk_2;
 
+    // statistics of the last `solve`
+    mutable int_type last_iter;  // Newton (P1,P2) or BFGS (P4-P9) iterations
+    mutable int_type last_inner; // total Newton iterations on the constraints
+
     real_type
     diff2pi( real_type in ) const {
       return in-m_2pi*round(in/m_2pi);
     }
 
+    // Newton on the curvature continuity (plus the closure for P2)
+    // with the angles at the extrema fixed (free for P2)
+    bool
+    newton_G2(
+      real_type           theta[],
+      real_type           tol,
+      int_type            max_iter,
+      vector<real_type> & vals
+    ) const;
+
+    // Newton on the constraints and then the target F and its gradient G
+    // with respect to the angles at the extrema
+    bool
+    reduced_G2(
+      real_type           theta[],
+      real_type           tol,
+      int_type            max_iter,
+      vector<real_type> & vals,
+      real_type         & F,
+      real_type           G[2]
+    ) const;
+
+    // minimize the target on the curvature continuity manifold
+    // as a function of the two angles at the extrema
+    bool
+    optimize_G2(
+      real_type theta[],
+      real_type tol,
+      int_type  max_iter
+    ) const;
+
   public:
 
-    ClothoidSplineG2() : tt(P1) {}
+    ClothoidSplineG2() : tt(P1), last_iter(0), last_inner(0) {}
     ~ClothoidSplineG2() {}
 
     void
@@ -1709,6 +2844,50 @@ namespace G2lib {
     bool
     jacobian( real_type const theta[], real_type vals[] ) const;
 
+    /*!
+     *  Solve the interpolation problem with the selected target.
+     *
+     *  P1 and P2 are square nonlinear systems solved with a damped
+     *  Newton method; the Jacobian is tridiagonal (bordered for P2),
+     *  so each iteration is \f$ O(n) \f$.  For P4-P9 the angles
+     *  at the extrema are the free variables: the internal angles
+     *  are found with the Newton method above and the target is
+     *  minimized with BFGS using the gradient of the reduced problem
+     *  (computed with an adjoint tridiagonal solve).  P3 has no
+     *  target and cannot be solved.
+     *
+     *  \param theta    on input the initial guess (e.g. computed by `guess`
+     *                  or a previous solution), on output the solution
+     *  \param tol      tolerance on the curvature jumps (for P4-P9
+     *                  the reduced gradient is checked with sqrt(tol))
+     *  \param max_iter maximum number of (outer) iterations
+     *  \return true if the iterations converged
+     */
+    bool
+    solve(
+      real_type theta[],
+      real_type tol      = 1e-10,
+      int_type  max_iter = 100
+    ) const;
+
+    /*!
+     *  Solve the problem starting from `guess` and build
+     *  the spline in `C`.
+     *  \return true if the iterations converged
+     */
+    bool
+    solve(
+      ClothoidList & C,
+      real_type      tol      = 1e-10,
+      int_type       max_iter = 100
+    ) const;
+
+    //! iterations of the last `solve`
+    int_type numIterations() const { return last_iter; }
+
+    //! Newton iterations on the curvature continuity of the last `solve`
+    int_type numInnerIterations() const { return last_inner; }
+
     void
     info( ostream_type & stream ) const
     { stream << "ClothoidSplineG2\n" << *this << '\n'; }
@@ -0,0 +1,763 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "CurveBinary.hh"
+
+#include <cstring>
+#include <stdint.h>
+
+#ifndef G2LIB_OS_WINDOWS
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wcast-align"
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#endif
+
+namespace G2lib {
+
+  using std::vector;
+  using std::memcpy;
+  using std::upper_bound;
+  using std::numeric_limits;
+  using std::abs;
+  using std::fmod;
+
+  // the int columns are saved as int32
+  typedef char int_type_must_be_32_bits[ sizeof(int_type) == 4 ? 1 : -1 ];
+
+  static char const G2LIB_BINARY_MAGIC[8] = { 'G','2','L','I','B','B','I','N' };
+
+  static
+  bool
+  host_is_little_endian() {
+    uint32_t one = 1;
+    unsigned char c;
+    memcpy( &c, &one, 1 );
+    return c == 1;
+  }
+
+  // `n` values followed by zeros up to a multiple of 8 bytes
+  template <typename T>
+  static
+  void
+  write_column( ostream_type & stream, T const * v, size_t n ) {
+    static char const zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    size_t nb = n*sizeof(T);
+    if ( nb > 0 ) stream.write( reinterpret_cast<char const *>(v), std::streamsize(nb) );
+    stream.write( zeros, std::streamsize( (8-nb%8)%8 ) );
+  }
+
+  template <typename T>
+  static
+  void
+  write_column( ostream_type & stream, vector<T> const & v ) {
+    write_column( stream, v.empty() ? nullptr : &v.front(), v.size() );
+  }
+
+  // column of `n` values at `ptr`, return the start of the next block
+  template <typename T>
+  static
+  char const *
+  read_column( char const * ptr, char const * end, size_t n, T const * & v ) {
+    // `n` is read from the data: check it before `n*sizeof(T)` can overflow
+    G2LIB_ASSERT(
+      n <= size_t(end-ptr)/sizeof(T), "CurveBinaryView: truncated buffer"
+    )
+    size_t nb = n*sizeof(T);
+    nb += (8-nb%8)%8;
+    G2LIB_ASSERT(
+      size_t(end-ptr) >= nb, "CurveBinaryView: truncated buffer"
+    )
+    v = reinterpret_cast<T const *>(ptr);
+    return ptr+nb;
+  }
+
+  template <typename T>
+  static
+  char const *
+  read_column( char const * ptr, char const * end, size_t n, vector<T> & v ) {
+    T const * pv;
+    ptr = read_column( ptr, end, n, pv );
+    v.assign( pv, pv+n );
+    return ptr;
+  }
+
+  /*\
+   |   ___ _
+   |  | _ |_)_ _  __ _ _ _ _  _
+   |  | _ \ | ' \/ _` | '_| || |
+   |  |___/_|_||_\__,_|_|  \_, |
+   |                       |__/
+  \*/
+
+  void
+  CurveBinary::save_pieces(
+    ostream_type                 & stream,
+    CurveType                      type,
+    bool                           closed,
+    vector<real_type>      const   col[6],
+    vector<real_type>      const & s0,
+    real_type                      xe,
+    real_type                      ye,
+    vector<AABBtriangles>  const & trees
+  ) {
+    G2LIB_ASSERT(
+      host_is_little_endian(),
+      "CurveBinary::save, only little endian hosts are supported"
+    )
+    uint32_t ver   = version;
+    uint32_t typ   = uint32_t(type);
+    uint64_t np    = col[0].size();
+    uint64_t ns    = s0.empty() ? 0 : s0.size()-1;
+    uint32_t flags = closed ? 1 : 0;
+    uint32_t ntree = uint32_t(trees.size());
+    char h[64];
+    std::fill( h, h+64, char(0) );
+    memcpy( h,    G2LIB_BINARY_MAGIC, 8 );
+    memcpy( h+8,  &ver,   4 );
+    memcpy( h+12, &typ,   4 );
+    memcpy( h+16, &np,    8 );
+    memcpy( h+24, &ns,    8 );
+    memcpy( h+32, &flags, 4 );
+    memcpy( h+36, &ntree, 4 );
+    memcpy( h+40, &xe,    8 );
+    memcpy( h+48, &ye,    8 );
+    stream.write( h, 64 );
+    for ( int_type k = 0; k < 6; ++k ) write_column( stream, col[k] );
+    write_column( stream, s0 );
+    vector<AABBtriangles>::const_iterator it;
+    for ( it = trees.begin(); it != trees.end(); ++it ) save_tree( stream, *it );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinary::save_tree( ostream_type & stream, AABBtriangles const & P ) {
+    AABBtreeFlat const & T = P.tree;
+    uint64_t ntri  = P.tri.size();
+    uint64_t nnode = T.nd_first.size();
+    uint64_t nbox  = T.bb_ipos.size();
+    uint64_t leaf  = uint64_t(T.leaf_size);
+    char h[64];
+    std::fill( h, h+64, char(0) );
+    memcpy( h,    &ntri,        8 );
+    memcpy( h+8,  &nnode,       8 );
+    memcpy( h+16, &nbox,        8 );
+    memcpy( h+24, &leaf,        8 );
+    memcpy( h+32, &P.offs,      8 );
+    memcpy( h+40, &P.max_angle, 8 );
+    memcpy( h+48, &P.max_size,  8 );
+    stream.write( h, 64 );
+
+    vector<real_type> v( P.tri.size() );
+    vector<int32_t>   iv( P.tri.size() );
+    for ( int_type k = 0; k < 8; ++k ) {
+      for ( size_t i = 0; i < P.tri.size(); ++i ) {
+        Triangle2D const & t = P.tri[i];
+        switch ( k ) {
+          case 0: v[i] = t.x1(); break;
+          case 1: v[i] = t.y1(); break;
+          case 2: v[i] = t.x2(); break;
+          case 3: v[i] = t.y2(); break;
+          case 4: v[i] = t.x3(); break;
+          case 5: v[i] = t.y3(); break;
+          case 6: v[i] = t.S0(); break;
+          case 7: v[i] = t.S1(); break;
+        }
+      }
+      write_column( stream, v );
+    }
+    for ( size_t i = 0; i < P.tri.size(); ++i ) iv[i] = int32_t(P.tri[i].Icurve());
+    write_column( stream, iv );
+
+    write_column( stream, T.nd_xmin );
+    write_column( stream, T.nd_ymin );
+    write_column( stream, T.nd_xmax );
+    write_column( stream, T.nd_ymax );
+    write_column( stream, T.nd_first );
+    write_column( stream, T.nd_num );
+    write_column( stream, T.bb_xmin );
+    write_column( stream, T.bb_ymin );
+    write_column( stream, T.bb_xmax );
+    write_column( stream, T.bb_ymax );
+    write_column( stream, T.bb_ipos );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // the sizes and the indices of a saved tree are checked before use:
+  // a corrupted file must not make the traversals read out of bounds
+  char const *
+  CurveBinary::load_tree(
+    char const    * ptr,
+    char const    * end,
+    int_type        nseg,
+    AABBtriangles & P
+  ) {
+    G2LIB_ASSERT( end-ptr >= 64, "CurveBinaryView: truncated buffer" )
+    uint64_t ntri, nnode, nbox, leaf;
+    memcpy( &ntri,        ptr,    8 );
+    memcpy( &nnode,       ptr+8,  8 );
+    memcpy( &nbox,        ptr+16, 8 );
+    memcpy( &leaf,        ptr+24, 8 );
+    memcpy( &P.offs,      ptr+32, 8 );
+    memcpy( &P.max_angle, ptr+40, 8 );
+    memcpy( &P.max_size,  ptr+48, 8 );
+    ptr += 64;
+    uint64_t const imax = uint64_t(numeric_limits<int_type>::max());
+    G2LIB_ASSERT(
+      ntri <= imax && nnode <= imax && nbox <= imax && leaf >= 1 && leaf <= imax,
+      "CurveBinaryView, bad AABB tree sizes: " << ntri << " triangles, "
+      << nnode << " nodes, " << nbox << " boxes, leaf size " << leaf
+    )
+    G2LIB_ASSERT(
+      nbox == ntri && ( nnode == 0 ) == ( nbox == 0 ),
+      "CurveBinaryView, bad AABB tree: " << nnode << " nodes and "
+      << nbox << " boxes for " << ntri << " triangles"
+    )
+
+    size_t nt = size_t(ntri);
+    real_type const * v[8];
+    int32_t   const * iv;
+    for ( int_type k = 0; k < 8; ++k ) ptr = read_column( ptr, end, nt, v[k] );
+    ptr = read_column( ptr, end, nt, iv );
+    for ( size_t i = 0; i < nt; ++i )
+      G2LIB_ASSERT(
+        iv[i] >= 0 && iv[i] < nseg,
+        "CurveBinaryView, bad AABB tree: triangle " << i
+        << " of the segment " << iv[i] << " of " << nseg
+      )
+    P.tri.clear();
+    P.tri.reserve( nt );
+    for ( size_t i = 0; i < nt; ++i )
+      P.tri.push_back(
+        Triangle2D(
+          v[0][i], v[1][i], v[2][i], v[3][i], v[4][i], v[5][i],
+          v[6][i], v[7][i], int_type(iv[i])
+        )
+      );
+
+    AABBtreeFlat & T = P.tree;
+    size_t nn = size_t(nnode);
+    size_t nb = size_t(nbox);
+    ptr = read_column( ptr, end, nn, T.nd_xmin );
+    ptr = read_column( ptr, end, nn, T.nd_ymin );
+    ptr = read_column( ptr, end, nn, T.nd_xmax );
+    ptr = read_column( ptr, end, nn, T.nd_ymax );
+    ptr = read_column( ptr, end, nn, T.nd_first );
+    ptr = read_column( ptr, end, nn, T.nd_num );
+    ptr = read_column( ptr, end, nb, T.bb_xmin );
+    ptr = read_column( ptr, end, nb, T.bb_ymin );
+    ptr = read_column( ptr, end, nb, T.bb_xmax );
+    ptr = read_column( ptr, end, nb, T.bb_ymax );
+    ptr = read_column( ptr, end, nb, T.bb_ipos );
+    T.leaf_size = int_type(leaf);
+
+    // internal nodes: the children follow the parent (no cycles),
+    // leaves: a range of boxes, boxes: a triangle
+    int_type in = int_type(nn);
+    int_type ib = int_type(nb);
+    for ( int_type i = 0; i < in; ++i ) {
+      int_type f = T.nd_first[size_t(i)];
+      int_type n = T.nd_num[size_t(i)];
+      G2LIB_ASSERT(
+        n > 0 ? f >= 0 && f <= ib-n : n == 0 && f > i && f < in-1,
+        "CurveBinaryView, bad AABB tree: node " << i
+        << " first = " << f << " num = " << n
+      )
+    }
+    for ( int_type i = 0; i < ib; ++i ) {
+      int_type ip = T.bb_ipos[size_t(i)];
+      G2LIB_ASSERT(
+        ip >= 0 && ip < int_type(nt),
+        "CurveBinaryView, bad AABB tree: box " << i << " of the triangle " << ip
+      )
+    }
+    return ptr;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinary::save(
+    ClothoidList const & CL,
+    ostream_type       & stream,
+    bool                 with_AABBtree
+  ) {
+    vector<real_type> col[6];
+    size_t n = CL.clotoidList.size();
+    for ( int_type k = 0; k < 6; ++k ) col[k].reserve( n );
+    vector<ClothoidCurve>::const_iterator ic;
+    for ( ic = CL.clotoidList.begin(); ic != CL.clotoidList.end(); ++ic ) {
+      col[0].push_back( ic->xBegin() );
+      col[1].push_back( ic->yBegin() );
+      col[2].push_back( ic->thetaBegin() );
+      col[3].push_back( ic->kappaBegin() );
+      col[4].push_back( ic->dkappa() );
+      col[5].push_back( ic->length() );
+    }
+    vector<AABBtriangles> trees;
+    if ( with_AABBtree && n > 0 ) {
+      trees = CL.aabb_prepared;
+      if ( trees.empty() ) {
+        trees.push_back( AABBtriangles() );
+        AABBtriangles & P = trees.back();
+        P.offs      = 0;
+        P.max_angle = m_pi/6;
+        P.max_size  = 1e100;
+        CL.bbTriangles_ISO( P.offs, P.tri, P.max_angle, P.max_size );
+        P.tree.build( P.tri );
+      }
+    }
+    real_type xe = n > 0 ? CL.xEnd() : 0;
+    real_type ye = n > 0 ? CL.yEnd() : 0;
+    save_pieces(
+      stream, G2LIB_CLOTHOID_LIST, CL.curve_is_closed,
+      col, CL.s0, xe, ye, trees
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinary::save( BiarcList const & BL, ostream_type & stream ) {
+    vector<real_type> col[6];
+    size_t n = BL.biarcList.size();
+    for ( int_type k = 0; k < 6; ++k ) col[k].reserve( 2*n );
+    vector<Biarc>::const_iterator ib;
+    for ( ib = BL.biarcList.begin(); ib != BL.biarcList.end(); ++ib ) {
+      CircleArc const * C[2] = { &ib->C0, &ib->C1 };
+      for ( int_type j = 0; j < 2; ++j ) {
+        col[0].push_back( C[j]->xBegin() );
+        col[1].push_back( C[j]->yBegin() );
+        col[2].push_back( C[j]->thetaBegin() );
+        col[3].push_back( C[j]->curvature() );
+        col[4].push_back( 0 );
+        col[5].push_back( C[j]->length() );
+      }
+    }
+    real_type xe = n > 0 ? BL.xEnd() : 0;
+    real_type ye = n > 0 ? BL.yEnd() : 0;
+    save_pieces(
+      stream, G2LIB_BIARC_LIST, false, col, BL.s0, xe, ye,
+      vector<AABBtriangles>()
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinary::save( PolyLine const & PL, ostream_type & stream ) {
+    vector<real_type> col[6];
+    size_t n = size_t(PL.numSegment());
+    for ( int_type k = 0; k < 6; ++k ) col[k].reserve( n );
+    for ( size_t i = 0; i < n; ++i ) {
+      real_type dx = PL.xv[i+1]-PL.xv[i];
+      real_type dy = PL.yv[i+1]-PL.yv[i];
+      col[0].push_back( PL.xv[i] );
+      col[1].push_back( PL.yv[i] );
+      col[2].push_back( atan2( dy, dx ) );
+      col[3].push_back( 0 );
+      col[4].push_back( 0 );
+      col[5].push_back( hypot( dx, dy ) );
+    }
+    real_type xe = n > 0 ? PL.xEnd() : 0;
+    real_type ye = n > 0 ? PL.yEnd() : 0;
+    save_pieces(
+      stream, G2LIB_POLYLINE, false, col, PL.s0, xe, ye,
+      vector<AABBtriangles>()
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinary::load( CurveBinaryView const & V, ClothoidList & CL ) {
+    G2LIB_ASSERT(
+      V.type() == G2LIB_CLOTHOID_LIST,
+      "CurveBinary::load, the data are of a " << CurveType_name[V.type()]
+    )
+    size_t n = size_t(V.numSegment());
+    CL.init();
+    CL.reserve( V.numSegment() );
+    for ( size_t i = 0; i < n; ++i )
+      CL.clotoidList.push_back(
+        ClothoidCurve(
+          V.col[0][i], V.col[1][i], V.col[2][i],
+          V.col[3][i], V.col[4][i], V.col[5][i]
+        )
+      );
+    if ( n > 0 ) CL.s0.assign( V.ps0, V.ps0+n+1 );
+    CL.curve_is_closed = V.is_closed();
+    CL.aabb_prepared   = V.trees;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinary::load( CurveBinaryView const & V, BiarcList & BL ) {
+    G2LIB_ASSERT(
+      V.type() == G2LIB_BIARC_LIST,
+      "CurveBinary::load, the data are of a " << CurveType_name[V.type()]
+    )
+    size_t n = size_t(V.numSegment());
+    BL.init();
+    BL.reserve( V.numSegment() );
+    for ( size_t i = 0; i < n; ++i ) {
+      Biarc B;
+      for ( size_t j = 0; j < 2; ++j ) {
+        size_t p = 2*i+j;
+        CircleArc C( V.col[0][p], V.col[1][p], V.col[2][p], V.col[3][p], V.col[5][p] );
+        ( j == 0 ? B.C0 : B.C1 ).copy( C );
+      }
+      BL.biarcList.push_back( B );
+    }
+    if ( n > 0 ) BL.s0.assign( V.ps0, V.ps0+n+1 );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinary::load( CurveBinaryView const & V, PolyLine & PL ) {
+    G2LIB_ASSERT(
+      V.type() == G2LIB_POLYLINE,
+      "CurveBinary::load, the data are of a " << CurveType_name[V.type()]
+    )
+    size_t n = size_t(V.numSegment());
+    if ( n == 0 ) { PL.init( V.xEnd(), V.yEnd() ); return; }
+    // the segments are rebuilt from the vertices as in `push_back`
+    PL.init( V.col[0][0], V.col[1][0] );
+    for ( size_t i = 1; i < n; ++i ) PL.push_back( V.col[0][i], V.col[1][i] );
+    PL.push_back( V.xEnd(), V.yEnd() );
+    PL.s0.assign( V.ps0, V.ps0+n+1 );
+  }
+
+  /*\
+   |   __  __                        _ ___ _ _
+   |  |  \/  |__ _ _ __ _ __  ___ __| | __(_) |___
+   |  | |\/| / _` | '_ \ '_ \/ -_) _` | _|| | / -_)
+   |  |_|  |_\__,_| .__/ .__/\___\__,_|_| |_|_\___|
+   |              |_|  |_|
+  \*/
+
+  MappedFile::MappedFile()
+  : ptr(nullptr)
+  , nbytes(0)
+  #ifdef G2LIB_OS_WINDOWS
+  , hFile(INVALID_HANDLE_VALUE)
+  , hMap(nullptr)
+  #endif
+  {}
+
+  MappedFile::MappedFile( std::string const & fname )
+  : ptr(nullptr)
+  , nbytes(0)
+  #ifdef G2LIB_OS_WINDOWS
+  , hFile(INVALID_HANDLE_VALUE)
+  , hMap(nullptr)
+  #endif
+  { this->open( fname ); }
+
+  MappedFile::~MappedFile()
+  { this->close(); }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  MappedFile::open( std::string const & fname ) {
+    this->close();
+    #ifdef G2LIB_OS_WINDOWS
+    hFile = CreateFileA(
+      fname.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    G2LIB_ASSERT(
+      hFile != INVALID_HANDLE_VALUE,
+      "MappedFile::open, cannot open `" << fname << "`"
+    )
+    LARGE_INTEGER sz;
+    GetFileSizeEx( hFile, &sz );
+    nbytes = size_t(sz.QuadPart);
+    if ( nbytes == 0 ) return;
+    hMap = CreateFileMappingA( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if ( hMap != nullptr ) ptr = MapViewOfFile( hMap, FILE_MAP_READ, 0, 0, 0 );
+    if ( ptr == nullptr ) {
+      this->close();
+      G2LIB_DO_ERROR( "MappedFile::open, cannot map `" << fname << "`" )
+    }
+    #else
+    int fd = ::open( fname.c_str(), O_RDONLY );
+    G2LIB_ASSERT( fd >= 0, "MappedFile::open, cannot open `" << fname << "`" )
+    struct stat st;
+    if ( fstat( fd, &st ) != 0 ) {
+      ::close( fd );
+      G2LIB_DO_ERROR( "MappedFile::open, cannot stat `" << fname << "`" )
+    }
+    nbytes = size_t(st.st_size);
+    if ( nbytes > 0 ) {
+      void * p = mmap( nullptr, nbytes, PROT_READ, MAP_SHARED, fd, 0 );
+      if ( p == MAP_FAILED ) {
+        ::close( fd );
+        nbytes = 0;
+        G2LIB_DO_ERROR( "MappedFile::open, cannot map `" << fname << "`" )
+      }
+      ptr = p;
+    }
+    ::close( fd ); // the mapping stays valid
+    #endif
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  MappedFile::close() {
+    #ifdef G2LIB_OS_WINDOWS
+    if ( ptr != nullptr ) UnmapViewOfFile( ptr );
+    if ( hMap != nullptr ) CloseHandle( hMap );
+    if ( hFile != INVALID_HANDLE_VALUE ) CloseHandle( hFile );
+    hMap  = nullptr;
+    hFile = INVALID_HANDLE_VALUE;
+    #else
+    if ( ptr != nullptr ) munmap( ptr, nbytes );
+    #endif
+    ptr    = nullptr;
+    nbytes = 0;
+  }
+
+  /*\
+   |   __   ___
+   |   \ \ / (_)_____ __ __
+   |    \ V /| / -_) V  V /
+   |     \_/ |_\___|\_/\_/
+  \*/
+
+  CurveBinaryView::CurveBinaryView()
+  : ctype(G2LIB_CLOTHOID_LIST)
+  , closed(false)
+  , npieces(0)
+  , nseg(0)
+  , xe(0)
+  , ye(0)
+  , ps0(nullptr)
+  { std::fill( col, col+6, static_cast<real_type const *>(nullptr) ); }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinaryView::setup( void const * data, size_t nbytes ) {
+    char const * ptr = static_cast<char const *>(data);
+    char const * end = ptr+nbytes;
+    G2LIB_ASSERT(
+      host_is_little_endian(),
+      "CurveBinaryView, only little endian hosts are supported"
+    )
+    G2LIB_ASSERT(
+      ptr != nullptr && nbytes >= 64 &&
+      std::equal( G2LIB_BINARY_MAGIC, G2LIB_BINARY_MAGIC+8, ptr ),
+      "CurveBinaryView, not a G2lib binary curve"
+    )
+    G2LIB_ASSERT(
+      reinterpret_cast<uintptr_t>(ptr) % 8 == 0,
+      "CurveBinaryView, the buffer is not aligned to 8 bytes"
+    )
+    uint32_t ver, typ, flags, ntree;
+    uint64_t np, ns;
+    memcpy( &ver,   ptr+8,  4 );
+    memcpy( &typ,   ptr+12, 4 );
+    memcpy( &np,    ptr+16, 8 );
+    memcpy( &ns,    ptr+24, 8 );
+    memcpy( &flags, ptr+32, 4 );
+    memcpy( &ntree, ptr+36, 4 );
+    memcpy( &xe,    ptr+40, 8 );
+    memcpy( &ye,    ptr+48, 8 );
+    G2LIB_ASSERT(
+      ver >= 1 && ver <= CurveBinary::version,
+      "CurveBinaryView, unsupported version " << ver
+    )
+    G2LIB_ASSERT(
+      typ == G2LIB_CLOTHOID_LIST || typ == G2LIB_BIARC_LIST || typ == G2LIB_POLYLINE,
+      "CurveBinaryView, unsupported curve type " << typ
+    )
+    G2LIB_ASSERT(
+      ns <= uint64_t(numeric_limits<int_type>::max()/2) &&
+      np == ( typ == G2LIB_BIARC_LIST ? 2 : 1 ) * ns,
+      "CurveBinaryView, " << np << " pieces for " << ns << " segments"
+    )
+    ctype   = CurveType(typ);
+    closed  = ( flags & 1 ) != 0;
+    npieces = int_type(np);
+    nseg    = int_type(ns);
+    ptr += 64;
+    for ( int_type k = 0; k < 6; ++k ) ptr = read_column( ptr, end, size_t(np), col[k] );
+    ptr = read_column( ptr, end, ns > 0 ? size_t(ns+1) : 0, ps0 );
+    // each tree has at least its 64 bytes header
+    G2LIB_ASSERT(
+      ntree <= size_t(end-ptr)/64,
+      "CurveBinaryView, " << ntree << " AABB trees in a truncated buffer"
+    )
+    trees.resize( ntree );
+    for ( size_t k = 0; k < ntree; ++k )
+      ptr = CurveBinary::load_tree( ptr, end, nseg, trees[k] );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinaryView::wrap_in_range( real_type & s ) const {
+    real_type L = ps0[nseg]-ps0[0];
+    s = fmod( s-ps0[0], L );
+    if ( s < 0 ) s += L;
+    s += ps0[0];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  CurveBinaryView::findAtS( real_type s ) const {
+    G2LIB_ASSERT( nseg > 0, "CurveBinaryView::findAtS, empty curve" )
+    if ( closed ) wrap_in_range( s );
+    int_type i = int_type( upper_bound( ps0, ps0+nseg+1, s ) - ps0 ) - 1;
+    if      ( i < 0 )     i = 0;
+    else if ( i >= nseg ) i = nseg-1;
+    return i;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  CurveBinaryView::findPiece( real_type & s ) const {
+    if ( closed ) wrap_in_range( s );
+    int_type i = findAtS( s );
+    s -= ps0[i];
+    if ( ctype != G2LIB_BIARC_LIST ) return i;
+    int_type p = 2*i;
+    if ( s >= col[5][p] ) { s -= col[5][p]; ++p; }
+    return p;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinaryView::eval( real_type s, real_type & x, real_type & y ) const {
+    int_type p = findPiece( s );
+    if ( ctype == G2LIB_POLYLINE ) {
+      x = col[0][p] + s*cos(col[2][p]);
+      y = col[1][p] + s*sin(col[2][p]);
+    } else {
+      ClothoidData CD;
+      CD.x0     = col[0][p];
+      CD.y0     = col[1][p];
+      CD.theta0 = col[2][p];
+      CD.kappa0 = col[3][p];
+      CD.dk     = col[4][p];
+      CD.eval( s, x, y );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveBinaryView::evaluate(
+    real_type   s,
+    real_type & theta,
+    real_type & kappa,
+    real_type & x,
+    real_type & y
+  ) const {
+    int_type  p = findPiece( s );
+    ClothoidData CD;
+    CD.x0     = col[0][p];
+    CD.y0     = col[1][p];
+    CD.theta0 = col[2][p];
+    CD.kappa0 = col[3][p];
+    CD.dk     = col[4][p];
+    CD.evaluate( s, theta, kappa, x, y );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  CurveBinaryView::closestPoint_ISO(
+    real_type   qx,
+    real_type   qy,
+    real_type   offs,
+    real_type & x,
+    real_type & y,
+    real_type & s,
+    real_type & t,
+    real_type & DST
+  ) const {
+    // the first tree saved for the offset
+    AABBtriangles const * P = nullptr;
+    vector<AABBtriangles>::const_iterator it;
+    for ( it = trees.begin(); it != trees.end() && P == nullptr; ++it )
+      if ( isZero( it->offs-offs ) ) P = &(*it);
+    G2LIB_ASSERT(
+      P != nullptr,
+      "CurveBinaryView::closestPoint_ISO, no AABB tree saved for offset " << offs
+    )
+    AABBtree::VecIpos candidateList;
+    P->tree.min_distance( qx, qy, candidateList );
+    G2LIB_ASSERT(
+      candidateList.size() > 0, "CurveBinaryView::closestPoint no candidate"
+    )
+    int_type icurve = 0;
+    DST = numeric_limits<real_type>::infinity();
+    AABBtree::VecIpos::const_iterator ic;
+    for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
+      Triangle2D const & T = P->tri[size_t(*ic)];
+      real_type dst = T.distMin( qx, qy );
+      if ( dst < DST ) {
+        int_type i = T.Icurve();
+        ClothoidCurve C(
+          col[0][i], col[1][i], col[2][i], col[3][i], col[4][i], col[5][i]
+        );
+        real_type xx, yy, ss;
+        C.closestPoint_internal_ISO( T.S0(), T.S1(), qx, qy, offs, xx, yy, ss, dst );
+        if ( dst < DST ) {
+          DST    = dst;
+          s      = ss + ps0[i];
+          x      = xx;
+          y      = yy;
+          icurve = i;
+        }
+      }
+    }
+    ClothoidData CD;
+    CD.theta0 = col[2][icurve];
+    CD.kappa0 = col[3][icurve];
+    CD.dk     = col[4][icurve];
+    real_type nx, ny;
+    CD.nor_ISO( s - ps0[icurve], nx, ny );
+    t = (qx-x) * nx + (qy-y) * ny - offs;
+    real_type err = abs( abs(t) - DST );
+    if ( err > DST*machepsi1000 ) return -1;
+    return 1;
+  }
+
+}
+
+///
+/// eof: CurveBinary.cc
+///
@@ -0,0 +1,295 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: CurveBinary.hh
+///
+
+#ifndef CURVE_BINARY_HH
+#define CURVE_BINARY_HH
+
+#include "ClothoidList.hh"
+
+#include <string>
+#include <fstream>
+
+//! Clothoid computations routine
+namespace G2lib {
+
+  /*\
+   |   ___ _
+   |  | _ |_)_ _  __ _ _ _ _  _
+   |  | _ \ | ' \/ _` | '_| || |
+   |  |___/_|_||_\__,_|_|  \_, |
+   |                       |__/
+  \*/
+
+  class CurveBinaryView;
+
+  /*!
+   *  Binary files of `ClothoidList`, `BiarcList` and `PolyLine`.
+   *
+   *  Layout, little endian, every block starts at a multiple of 8 bytes:
+   *
+   *  - header, 64 bytes: magic `G2LIBBIN`, uint32 version, uint32 curve
+   *    type, uint64 number of pieces, uint64 number of segments,
+   *    uint32 flags (1 = closed curve), uint32 number of AABB trees,
+   *    double x and y of the end point of the curve;
+   *  - the columns `x0`, `y0`, `theta0`, `kappa0`, `dkappa`, `L` of the
+   *    pieces and the column `s0` (segments + 1 values) of the abscissae
+   *    at the start of the segments; a segment is a single piece, but
+   *    for `BiarcList` where it is made of two circle arcs;
+   *  - the AABB trees (only for `ClothoidList`), each one with a 64 bytes
+   *    header (uint64 number of triangles, nodes, boxes and leaf size,
+   *    double offset, max angle and max size of the triangles), the
+   *    triangle columns `x1`, `y1`, `x2`, `y2`, `x3`, `y3`, `s0`, `s1`
+   *    and int32 `icurve`, the node columns `xmin`, `ymin`, `xmax`,
+   *    `ymax` and int32 `first`, `num`, the box columns `xmin`, `ymin`,
+   *    `xmax`, `ymax` and int32 `ipos`.
+   *
+   *  Columns of int32 are padded with zeros to a multiple of 8 bytes.
+   */
+  class CurveBinary {
+    CurveBinary();
+
+    static
+    void
+    save_pieces(
+      ostream_type                 & stream,
+      CurveType                      type,
+      bool                           closed,
+      vector<real_type>      const   col[6],
+      vector<real_type>      const & s0,
+      real_type                      xe,
+      real_type                      ye,
+      vector<AABBtriangles>  const & trees
+    );
+
+    static
+    void
+    save_tree( ostream_type & stream, AABBtriangles const & P );
+
+    static
+    char const *
+    load_tree(
+      char const    * ptr,
+      char const    * end,
+      int_type        nseg,
+      AABBtriangles & P
+    );
+
+    friend class CurveBinaryView;
+
+  public:
+
+    static unsigned const version = 1;
+
+    /*!
+     *  Write `CL` to `stream` (opened in binary mode).
+     *  If `with_AABBtree` is true the trees prepared by
+     *  `prepare_AABBtree_ISO` are saved too, if none is prepared
+     *  the one at zero offset with the default parameters is built
+     *  and saved: the list loaded by `load` finds them prepared.
+     */
+    static
+    void
+    save(
+      ClothoidList const & CL,
+      ostream_type       & stream,
+      bool                 with_AABBtree = false
+    );
+
+    static
+    void
+    save( BiarcList const & BL, ostream_type & stream );
+
+    static
+    void
+    save( PolyLine const & PL, ostream_type & stream );
+
+    //! write to the file `fname`
+    template <typename CURVE>
+    static
+    void
+    save_file( CURVE const & C, std::string const & fname );
+
+    //! copy the curve of `V` in `CL`, the saved AABB trees become prepared
+    static
+    void
+    load( CurveBinaryView const & V, ClothoidList & CL );
+
+    static
+    void
+    load( CurveBinaryView const & V, BiarcList & BL );
+
+    static
+    void
+    load( CurveBinaryView const & V, PolyLine & PL );
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  /*!
+   *  Read only memory mapping of a whole file
+   *  (`mmap` on unix, `MapViewOfFile` on windows).
+   */
+  class MappedFile {
+    void * ptr;
+    size_t nbytes;
+    #ifdef G2LIB_OS_WINDOWS
+    HANDLE hFile, hMap;
+    #endif
+
+    MappedFile( MappedFile const & );
+    MappedFile const & operator = ( MappedFile const & );
+
+  public:
+
+    MappedFile();
+
+    explicit
+    MappedFile( std::string const & fname );
+
+    ~MappedFile();
+
+    void open( std::string const & fname );
+    void close();
+
+    bool         is_open() const { return ptr != nullptr; }
+    void const * data()    const { return ptr; }
+    size_t       size()    const { return nbytes; }
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  /*!
+   *  Read only view of a curve saved by `CurveBinary::save`, the columns
+   *  are used in place from the buffer (e.g. a `MappedFile`), which must
+   *  outlive the view; only the AABB trees are copied (no rebuild).
+   *  The buffer must be aligned to 8 bytes.
+   */
+  class CurveBinaryView {
+    friend class CurveBinary;
+
+    CurveType         ctype;
+    bool              closed;
+    int_type          npieces;
+    int_type          nseg;
+    real_type         xe, ye;
+    real_type const * col[6]; // x0, y0, theta0, kappa0, dkappa, L
+    real_type const * ps0;    // abscissa at the start of the segments
+
+    vector<AABBtriangles> trees;
+
+    void wrap_in_range( real_type & s ) const;
+
+    // piece containing `s` and `s` relative to the piece
+    int_type findPiece( real_type & s ) const;
+
+    CurveBinaryView( CurveBinaryView const & );
+    CurveBinaryView const & operator = ( CurveBinaryView const & );
+
+  public:
+
+    CurveBinaryView();
+
+    CurveBinaryView( void const * data, size_t nbytes )
+    { this->setup( data, nbytes ); }
+
+    //! check the buffer (sizes and indices of the AABB trees included)
+    //! and set the view (errors throw as `G2LIB_ASSERT`)
+    void setup( void const * data, size_t nbytes );
+
+    CurveType type()       const { return ctype; }
+    bool      is_closed()  const { return closed; }
+    int_type  numSegment() const { return nseg; }
+    int_type  numPieces()  const { return npieces; }
+
+    real_type const * x0()     const { return col[0]; }
+    real_type const * y0()     const { return col[1]; }
+    real_type const * theta0() const { return col[2]; }
+    real_type const * kappa0() const { return col[3]; }
+    real_type const * dkappa() const { return col[4]; }
+    real_type const * L()      const { return col[5]; }
+    real_type const * s0()     const { return ps0; }
+
+    real_type xEnd() const { return xe; }
+    real_type yEnd() const { return ye; }
+
+    real_type
+    length() const
+    { return ps0[nseg]-ps0[0]; }
+
+    //! the AABB trees saved with the curve
+    vector<AABBtriangles> const & AABBtrees() const { return trees; }
+
+    //! index of the segment containing `s`
+    int_type findAtS( real_type s ) const;
+
+    void eval( real_type s, real_type & x, real_type & y ) const;
+
+    void
+    evaluate(
+      real_type   s,
+      real_type & theta,
+      real_type & kappa,
+      real_type & x,
+      real_type & y
+    ) const;
+
+    /*!
+     *  As `ClothoidList::closestPoint_ISO`, it uses the saved AABB tree
+     *  of the offset `offs`, which must be present.
+     */
+    int_type
+    closestPoint_ISO(
+      real_type   qx,
+      real_type   qy,
+      real_type   offs,
+      real_type & x,
+      real_type & y,
+      real_type & s,
+      real_type & t,
+      real_type & dst
+    ) const;
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  template <typename CURVE>
+  inline
+  void
+  CurveBinary::save_file( CURVE const & C, std::string const & fname ) {
+    std::ofstream file( fname.c_str(), std::ios::binary );
+    G2LIB_ASSERT(
+      file.good(), "CurveBinary::save_file, cannot open `" << fname << "`"
+    )
+    save( C, file );
+    G2LIB_ASSERT(
+      file.good(), "CurveBinary::save_file, failed writing `" << fname << "`"
+    )
+  }
+
+}
+
+#endif
+
+///
+/// eof: CurveBinary.hh
+///
@@ -0,0 +1,467 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "CurveIndex.hh"
+
+#include <algorithm>
+
+namespace G2lib {
+
+  using std::numeric_limits;
+  using std::max;
+  using std::min;
+
+  /*\
+   |    ___                  ___         _
+   |   / __|  _ _ ___ _____|_ _|_ _  __| |_____ __
+   |  | (_| || | '_\ V / -_)| || ' \/ _` / -_) \ /
+   |   \___\_,_|_|  \_/\___|___|_||_\__,_\___/_\_\
+  \*/
+
+  // segment `(x0,y0)-(x1,y1)` overlaps the box (Liang-Barsky clipping)
+  static
+  bool
+  segment_box(
+    real_type x0, real_type y0,
+    real_type x1, real_type y1,
+    real_type xmin, real_type ymin,
+    real_type xmax, real_type ymax
+  ) {
+    real_type dx = x1-x0;
+    real_type dy = y1-y0;
+    real_type p[4] = { -dx, dx, -dy, dy };
+    real_type q[4] = { x0-xmin, xmax-x0, y0-ymin, ymax-y0 };
+    real_type t0 = 0, t1 = 1;
+    for ( int_type k = 0; k < 4; ++k ) {
+      if ( p[k] == 0 ) {
+        if ( q[k] < 0 ) return false;
+      } else {
+        real_type r = q[k]/p[k];
+        if ( p[k] < 0 ) t0 = max( t0, r );
+        else            t1 = min( t1, r );
+        if ( t0 > t1 ) return false;
+      }
+    }
+    return true;
+  }
+
+  // triangle `T` overlaps the box, a degenerate triangle as its sides
+  static
+  bool
+  triangle_box(
+    Triangle2D const & T,
+    real_type xmin, real_type ymin,
+    real_type xmax, real_type ymax
+  ) {
+    if ( T.isCounterClockwise() == 0 )
+      return segment_box( T.x1(), T.y1(), T.x2(), T.y2(), xmin, ymin, xmax, ymax ) ||
+             segment_box( T.x2(), T.y2(), T.x3(), T.y3(), xmin, ymin, xmax, ymax ) ||
+             segment_box( T.x3(), T.y3(), T.x1(), T.y1(), xmin, ymin, xmax, ymax );
+    Triangle2D B1( xmin, ymin, xmax, ymin, xmax, ymax, 0, 0, 0 );
+    Triangle2D B2( xmin, ymin, xmax, ymax, xmin, ymax, 0, 0, 0 );
+    return T.overlap( B1 ) || T.overlap( B2 );
+  }
+
+  // the straight piece `L` at offset `offs` as a degenerate triangle
+  static
+  inline
+  Triangle2D
+  segment_triangle( LineSegment const & L, real_type offs, int_type icurve ) {
+    real_type x0 = L.xBegin_ISO( offs );
+    real_type y0 = L.yBegin_ISO( offs );
+    real_type x1 = L.xEnd_ISO( offs );
+    real_type y1 = L.yEnd_ISO( offs );
+    return Triangle2D( x0, y0, x1, y1, x1, y1, 0, L.length(), icurve );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // exact distance of the curves in the boxes of the top tree
+  class CurveIndex::Nearest {
+    CurveIndex const * idx;
+    real_type          qx, qy;
+    HitList          * found;
+  public:
+    Nearest(
+      CurveIndex const * _idx,
+      real_type          _qx,
+      real_type          _qy,
+      HitList          * _found
+    )
+    : idx(_idx), qx(_qx), qy(_qy), found(_found)
+    {}
+
+    real_type
+    operator () ( int_type ipos ) const {
+      Hit h;
+      idx->closest( idx->top_id[size_t(ipos)], qx, qy, h );
+      found->push_back( h );
+      return h.dst;
+    }
+  };
+
+  static
+  bool
+  hit_id_less( CurveIndex::Hit const & a, CurveIndex::Hit const & b )
+  { return a.id < b.id; }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  CurveIndex::CurveIndex( real_type _max_angle, real_type _max_size )
+  : ncurves(0)
+  , max_angle(_max_angle)
+  , max_size(_max_size)
+  , top_done(true)
+  {}
+
+  CurveIndex::~CurveIndex() {
+    this->clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveIndex::clear() {
+    vector<Entry*>::iterator it;
+    for ( it = entries.begin(); it != entries.end(); ++it ) delete *it;
+    entries.clear();
+    free_ids.clear();
+    top.clear();
+    top_id.clear();
+    ncurves  = 0;
+    top_done = true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveIndex::build_cover(
+    BaseCurve const    & C,
+    real_type            offs,
+    vector<Triangle2D> & tri
+  ) const {
+    switch ( C.type() ) {
+    case G2LIB_LINE:
+      tri.push_back(
+        segment_triangle( static_cast<LineSegment const &>(C), offs, 0 )
+      );
+      break;
+    case G2LIB_POLYLINE:
+      {
+        PolyLine const & PL = static_cast<PolyLine const &>(C);
+        int_type ns = PL.numSegment();
+        tri.reserve( size_t(ns) );
+        for ( int_type i = 0; i < ns; ++i )
+          tri.push_back( segment_triangle( PL.getSegment(i), offs, i ) );
+      }
+      break;
+    case G2LIB_CIRCLE:
+      static_cast<CircleArc const &>(C).bbTriangles_ISO(
+        offs, tri, max_angle, max_size, 0
+      );
+      break;
+    case G2LIB_BIARC:
+      static_cast<Biarc const &>(C).bbTriangles_ISO(
+        offs, tri, max_angle, max_size, 0
+      );
+      break;
+    case G2LIB_CLOTHOID:
+      static_cast<ClothoidCurve const &>(C).bbTriangles_ISO(
+        offs, tri, max_angle, max_size, 0
+      );
+      break;
+    case G2LIB_BIARC_LIST:
+      static_cast<BiarcList const &>(C).bbTriangles_ISO(
+        offs, tri, max_angle, max_size
+      );
+      break;
+    case G2LIB_CLOTHOID_LIST:
+      static_cast<ClothoidList const &>(C).bbTriangles_ISO(
+        offs, tri, max_angle, max_size
+      );
+      break;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveIndex::closest_piece(
+    BaseCurve  const & C,
+    real_type          offs,
+    Triangle2D const & T,
+    real_type          qx,
+    real_type          qy,
+    real_type        & x,
+    real_type        & y,
+    real_type        & s,
+    real_type        & dst
+  ) {
+    real_type t;
+    size_t    ic = size_t(T.Icurve());
+    switch ( C.type() ) {
+    case G2LIB_LINE:
+    case G2LIB_CIRCLE:
+    case G2LIB_BIARC:
+      C.closestPoint_ISO( qx, qy, offs, x, y, s, t, dst );
+      break;
+    case G2LIB_POLYLINE:
+      {
+        PolyLine const & PL = static_cast<PolyLine const &>(C);
+        PL.getSegment( int_type(ic) ).closestPoint_ISO( qx, qy, offs, x, y, s, t, dst );
+        s += PL.s0[ic];
+      }
+      break;
+    case G2LIB_CLOTHOID:
+      static_cast<ClothoidCurve const &>(C).closestPoint_internal_ISO(
+        T.S0(), T.S1(), qx, qy, offs, x, y, s, dst
+      );
+      break;
+    case G2LIB_BIARC_LIST:
+      {
+        BiarcList const & BL = static_cast<BiarcList const &>(C);
+        BL.biarcList[ic].closestPoint_ISO( qx, qy, offs, x, y, s, t, dst );
+        s += BL.s0[ic];
+      }
+      break;
+    case G2LIB_CLOTHOID_LIST:
+      {
+        ClothoidList const & CL = static_cast<ClothoidList const &>(C);
+        CL.clotoidList[ic].closestPoint_internal_ISO(
+          T.S0(), T.S1(), qx, qy, offs, x, y, s, dst
+        );
+        s += CL.s0[ic];
+      }
+      break;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveIndex::closest(
+    int_type  id,
+    real_type qx,
+    real_type qy,
+    Hit     & h
+  ) const {
+    Entry const & E = *entries[size_t(id)];
+    AABBtreeFlat::VecIpos candidateList;
+    E.P.tree.min_distance( qx, qy, candidateList );
+    h.id  = id;
+    h.s   = 0;
+    h.x   = E.curve->xBegin_ISO( E.offs );
+    h.y   = E.curve->yBegin_ISO( E.offs );
+    h.dst = numeric_limits<real_type>::infinity();
+    AABBtreeFlat::VecIpos::const_iterator ic;
+    for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
+      Triangle2D const & T = E.P.tri[size_t(*ic)];
+      if ( T.distMin( qx, qy ) >= h.dst ) continue;
+      real_type x, y, s, dst;
+      closest_piece( *E.curve, E.offs, T, qx, qy, x, y, s, dst );
+      if ( dst < h.dst ) {
+        h.dst = dst;
+        h.s   = s;
+        h.x   = x;
+        h.y   = y;
+      }
+    }
+    real_type xb, yb, nx, ny;
+    E.curve->eval( h.s, xb, yb );
+    E.curve->nor_ISO( h.s, nx, ny );
+    h.t = (qx-xb)*nx + (qy-yb)*ny;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveIndex::build_top() const {
+    vector<real_type> xmin, ymin, xmax, ymax;
+    top_id.clear();
+    top_id.reserve( size_t(ncurves) );
+    xmin.reserve( size_t(ncurves) ); ymin.reserve( size_t(ncurves) );
+    xmax.reserve( size_t(ncurves) ); ymax.reserve( size_t(ncurves) );
+    for ( size_t id = 0; id < entries.size(); ++id ) {
+      if ( entries[id] == nullptr ) continue;
+      real_type x0, y0, x1, y1;
+      entries[id]->P.tree.bbox( x0, y0, x1, y1 );
+      xmin.push_back( x0 ); ymin.push_back( y0 );
+      xmax.push_back( x1 ); ymax.push_back( y1 );
+      top_id.push_back( int_type(id) );
+    }
+    if ( top_id.empty() ) top.clear();
+    else top.build(
+      int_type(top_id.size()),
+      &xmin.front(), &ymin.front(), &xmax.front(), &ymax.front()
+    );
+    top_done = true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  CurveIndex::insert( BaseCurve const & C, real_type offs ) {
+    Entry * E = new Entry;
+    E->curve       = &C;
+    E->offs        = offs;
+    E->P.offs      = offs;
+    E->P.max_angle = max_angle;
+    E->P.max_size  = max_size;
+    try {
+      this->build_cover( C, offs, E->P.tri );
+      G2LIB_ASSERT(
+        !E->P.tri.empty(),
+        "CurveIndex::insert, empty " << CurveType_name[C.type()]
+      )
+      E->P.tree.build( E->P.tri );
+    } catch ( ... ) {
+      delete E;
+      throw;
+    }
+    int_type id;
+    if ( free_ids.empty() ) {
+      id = int_type(entries.size());
+      entries.push_back( E );
+    } else {
+      id = free_ids.back();
+      free_ids.pop_back();
+      entries[size_t(id)] = E;
+    }
+    ++ncurves;
+    top_done = false;
+    return id;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveIndex::remove( int_type id ) {
+    G2LIB_ASSERT( contains( id ), "CurveIndex::remove( " << id << " ) no such curve" )
+    delete entries[size_t(id)];
+    entries[size_t(id)] = nullptr;
+    free_ids.push_back( id );
+    --ncurves;
+    top_done = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  BaseCurve const &
+  CurveIndex::curve( int_type id ) const {
+    G2LIB_ASSERT( contains( id ), "CurveIndex::curve( " << id << " ) no such curve" )
+    return *entries[size_t(id)]->curve;
+  }
+
+  real_type
+  CurveIndex::offset( int_type id ) const {
+    G2LIB_ASSERT( contains( id ), "CurveIndex::offset( " << id << " ) no such curve" )
+    return entries[size_t(id)]->offs;
+  }
+
+  AABBtriangles const &
+  CurveIndex::cover( int_type id ) const {
+    G2LIB_ASSERT( contains( id ), "CurveIndex::cover( " << id << " ) no such curve" )
+    return entries[size_t(id)]->P;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  CurveIndex::closestPoint( real_type qx, real_type qy, Hit & h ) const {
+    HitList hits;
+    this->nearest( qx, qy, 1, hits );
+    if ( hits.empty() ) return false;
+    h = hits.front();
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveIndex::nearest(
+    real_type qx,
+    real_type qy,
+    int_type  k,
+    HitList & hits,
+    real_type dmax
+  ) const {
+    if ( !top_done ) build_top();
+    hits.clear();
+    HitList found;
+    vector<pair<real_type,int_type> > res;
+    top.nearest( qx, qy, k, dmax, Nearest( this, qx, qy, &found ), res );
+    // the curves found, in the order of `res`
+    std::sort( found.begin(), found.end(), hit_id_less );
+    hits.reserve( res.size() );
+    vector<pair<real_type,int_type> >::const_iterator ir;
+    for ( ir = res.begin(); ir != res.end(); ++ir ) {
+      Hit h;
+      h.id = top_id[size_t(ir->second)];
+      hits.push_back(
+        *std::lower_bound( found.begin(), found.end(), h, hit_id_less )
+      );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveIndex::within_distance(
+    real_type qx,
+    real_type qy,
+    real_type r,
+    HitList & hits
+  ) const {
+    this->nearest( qx, qy, numeric_limits<int_type>::max(), hits, r );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CurveIndex::within_box(
+    real_type          xmin,
+    real_type          ymin,
+    real_type          xmax,
+    real_type          ymax,
+    vector<int_type> & ids
+  ) const {
+    if ( !top_done ) build_top();
+    ids.clear();
+    AABBtreeFlat::VecIpos boxes, candidateList;
+    top.within_box( xmin, ymin, xmax, ymax, boxes );
+    AABBtreeFlat::VecIpos::const_iterator ib, ic;
+    for ( ib = boxes.begin(); ib != boxes.end(); ++ib ) {
+      int_type      id = top_id[size_t(*ib)];
+      Entry const & E  = *entries[size_t(id)];
+      E.P.tree.within_box( xmin, ymin, xmax, ymax, candidateList );
+      for ( ic = candidateList.begin(); ic != candidateList.end(); ++ic ) {
+        if ( triangle_box( E.P.tri[size_t(*ic)], xmin, ymin, xmax, ymax ) ) {
+          ids.push_back( id );
+          break;
+        }
+      }
+    }
+    std::sort( ids.begin(), ids.end() );
+  }
+
+}
+
+///
+/// eof: CurveIndex.cc
+///
@@ -0,0 +1,205 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: CurveIndex.hh
+///
+
+#ifndef CURVE_INDEX_HH
+#define CURVE_INDEX_HH
+
+#include "ClothoidList.hh"
+
+//! Clothoid computations routine
+namespace G2lib {
+
+  /*\
+   |    ___                  ___         _
+   |   / __|  _ _ ___ _____|_ _|_ _  __| |_____ __
+   |  | (_| || | '_\ V / -_)| || ' \/ _` / -_) \ /
+   |   \___\_,_|_|  \_/\___|___|_||_\__,_\___/_\_\
+  \*/
+
+  /*!
+   *  Spatial index of many curves (e.g. the lanes of a road network),
+   *  of any type, each one at its own offset.
+   *
+   *  The index is a two level AABB tree: every curve keeps the triangles
+   *  covering it (`bbTriangles_ISO`, a segment for the straight pieces of
+   *  `LineSegment` and `PolyLine`) and their `AABBtreeFlat`, built once by
+   *  `insert`; the top tree is built on the bounding boxes of the curves.
+   *  Inserting or removing a curve only marks the top tree, which is
+   *  rebuilt (on the boxes of the curves, not of the triangles) by
+   *  `update` or by the next query.
+   *
+   *  The curves are not copied: they must outlive the index and must
+   *  not be changed while they are in it.
+   *  Queries are `const` but rebuild the top tree if needed: call `update`
+   *  after the last change to query from many threads.
+   */
+  class CurveIndex {
+  public:
+
+    //! a curve found by a query
+    class Hit {
+    public:
+      int_type  id;  //!< curve id (returned by `insert`)
+      real_type s;   //!< curvilinear abscissa of the closest point
+      real_type t;   //!< lateral coordinate of the query point, `q = P(s) + t*N(s)`
+      real_type dst; //!< distance from the curve (at its offset)
+      real_type x;   //!< closest point
+      real_type y;
+    };
+
+    typedef vector<Hit> HitList;
+
+  private:
+
+    class Entry {
+    public:
+      BaseCurve const * curve;
+      real_type         offs;
+      AABBtriangles     P;
+    };
+
+    vector<Entry*>   entries; // `nullptr` for the removed ids
+    vector<int_type> free_ids;
+    int_type         ncurves;
+    real_type        max_angle;
+    real_type        max_size;
+
+    mutable bool             top_done;
+    mutable AABBtreeFlat     top;
+    mutable vector<int_type> top_id; // curve id of the boxes of `top`
+
+    CurveIndex( CurveIndex const & );
+    CurveIndex const & operator = ( CurveIndex const & );
+
+    void
+    build_cover( BaseCurve const & C, real_type offs, vector<Triangle2D> & tri ) const;
+
+    // closest point to `(qx,qy)` of the piece of `C` covered by `T`
+    static
+    void
+    closest_piece(
+      BaseCurve  const & C,
+      real_type          offs,
+      Triangle2D const & T,
+      real_type          qx,
+      real_type          qy,
+      real_type        & x,
+      real_type        & y,
+      real_type        & s,
+      real_type        & dst
+    );
+
+    // closest point of the curve `id` to `(qx,qy)`
+    void
+    closest( int_type id, real_type qx, real_type qy, Hit & h ) const;
+
+    void build_top() const;
+
+    class Nearest;
+
+  public:
+
+    //! triangles of the curves built with `max_angle` and `max_size` (see `bbTriangles_ISO`)
+    explicit
+    CurveIndex( real_type max_angle = m_pi/6, real_type max_size = 1e100 );
+
+    ~CurveIndex();
+
+    //! remove all the curves
+    void clear();
+
+    /*!
+     *  Add the curve `C` at offset `offs`, return its id.
+     *  The ids of the removed curves are reused.
+     */
+    int_type insert( BaseCurve const & C, real_type offs = 0 );
+
+    //! remove the curve `id`
+    void remove( int_type id );
+
+    //! rebuild the top tree (if changed)
+    void update() { if ( !top_done ) build_top(); }
+
+    //! number of curves in the index
+    int_type numCurves() const { return ncurves; }
+
+    bool
+    contains( int_type id ) const {
+      return id >= 0 && id < int_type(entries.size()) &&
+             entries[size_t(id)] != nullptr;
+    }
+
+    //! curve `id`
+    BaseCurve const & curve( int_type id ) const;
+
+    //! offset of the curve `id`
+    real_type offset( int_type id ) const;
+
+    //! triangles covering the curve `id` and their tree
+    AABBtriangles const & cover( int_type id ) const;
+
+    /*!
+     *  Nearest curve to `(qx,qy)`, false if the index is empty.
+     */
+    bool closestPoint( real_type qx, real_type qy, Hit & h ) const;
+
+    /*!
+     *  The `k` curves nearest to `(qx,qy)` not farther than `dmax`,
+     *  by increasing distance.
+     */
+    void
+    nearest(
+      real_type qx,
+      real_type qy,
+      int_type  k,
+      HitList & hits,
+      real_type dmax = std::numeric_limits<real_type>::infinity()
+    ) const;
+
+    //! the curves with distance from `(qx,qy)` not greater than `r`, by increasing distance
+    void
+    within_distance(
+      real_type qx,
+      real_type qy,
+      real_type r,
+      HitList & hits
+    ) const;
+
+    //! id of the curves whose covering triangles overlap `[xmin,xmax]x[ymin,ymax]`
+    void
+    within_box(
+      real_type          xmin,
+      real_type          ymin,
+      real_type          xmax,
+      real_type          ymax,
+      vector<int_type> & ids
+    ) const;
+  };
+
+}
+
+#endif
+
+///
+/// eof: CurveIndex.hh
+///
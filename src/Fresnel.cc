@@ -45,6 +45,7 @@
 #include <cmath>
 #include <cfloat>
 #include <algorithm>
+#include <cstdint>
 
 namespace G2lib {
 
@@ -597,6 +598,264 @@ namespace G2lib {
     }
   }
 
+  // -------------------------------------------------------------------------
+  // -------------------------------------------------------------------------
+
+  /*\
+   |   _           _       _
+   |  | |__   __ _| |_ ___| |__
+   |  | '_ \ / _` | __/ __| '_ \
+   |  | |_) | (_| | || (__| | | |
+   |  |_.__/ \__,_|\__\___|_| |_|
+  \*/
+
+  static
+  void
+  FresnelCS_batch_scalar(
+    int_type        n,
+    real_type const x[],
+    real_type       C[],
+    real_type       S[]
+  ) {
+    for ( int_type i = 0; i < n; ++i ) FresnelCS( x[i], C[i], S[i] );
+  }
+
+  static
+  void
+  GeneralizedFresnelCS_batch_scalar(
+    int_type        n,
+    real_type const a[],
+    real_type const b[],
+    real_type       c,
+    real_type       intC[],
+    real_type       intS[]
+  ) {
+    real_type cosc = cos(c);
+    real_type sinc = sin(c);
+    for ( int_type i = 0; i < n; ++i ) {
+      real_type xx, yy;
+      if ( abs(a[i]) < A_THRESOLD ) evalXYaSmall( a[i], b[i], A_SERIE_SIZE, xx, yy );
+      else                          evalXYaLarge( a[i], b[i], xx, yy );
+      intC[i] = xx * cosc - yy * sinc;
+      intS[i] = xx * sinc + yy * cosc;
+    }
+  }
+
+  static
+  void
+  GeneralizedFresnelCS_batch_scalar(
+    int_type        nk,
+    int_type        n,
+    real_type const a[],
+    real_type const b[],
+    real_type const c[],
+    real_type       intC[],
+    real_type       intS[]
+  ) {
+    real_type CC[3], SS[3];
+    for ( int_type i = 0; i < n; ++i ) {
+      GeneralizedFresnelCS( nk, a[i], b[i], c[i], CC, SS );
+      for ( int_type j = 0; j < nk; ++j ) {
+        intC[j*n+i] = CC[j];
+        intS[j*n+i] = SS[j];
+      }
+    }
+  }
+
+  // the lane kernels are compiled once for each instruction set,
+  // the AVX2/AVX-512 versions are used only if the running CPU has them
+
+  // lanes are evaluated on finite arguments only, errno is not needed
+  // and would prevent the vectorization of sqrt
+  #if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC push_options
+  #pragma GCC optimize ("no-math-errno")
+  #endif
+  namespace FresnelGeneric {
+    static int_type const W = 4;
+    #include "Fresnel_batch.hxx"
+  }
+  #if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC pop_options
+  #endif
+
+  #if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+  #define G2LIB_FRESNEL_X86_KERNELS
+
+  #ifdef __clang__
+  #pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+  #else
+  #pragma GCC push_options
+  #pragma GCC target ("avx2","fma")
+  #pragma GCC optimize ("no-math-errno")
+  #endif
+  namespace FresnelAVX2 {
+    static int_type const W = 4;
+    #include "Fresnel_batch.hxx"
+  }
+  #ifdef __clang__
+  #pragma clang attribute pop
+  #else
+  #pragma GCC pop_options
+  #endif
+
+  #ifdef __clang__
+  #pragma clang attribute push (__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+  #else
+  #pragma GCC push_options
+  #pragma GCC target ("avx512f","avx2","fma")
+  #pragma GCC optimize ("no-math-errno")
+  #endif
+  namespace FresnelAVX512 {
+    static int_type const W = 8;
+    #include "Fresnel_batch.hxx"
+  }
+  #ifdef __clang__
+  #pragma clang attribute pop
+  #else
+  #pragma GCC pop_options
+  #endif
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  char const *FresnelKernelType_name[] = {
+    "scalar",
+    "generic",
+    "AVX2",
+    "AVX512"
+  };
+
+  bool
+  FresnelCS_batch_kernel_supported( FresnelKernelType k ) {
+    switch ( k ) {
+    case FRESNEL_KERNEL_SCALAR:
+    case FRESNEL_KERNEL_GENERIC:
+      return true;
+    #ifdef G2LIB_FRESNEL_X86_KERNELS
+    case FRESNEL_KERNEL_AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case FRESNEL_KERNEL_AVX512:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx512f") &&
+             __builtin_cpu_supports("avx2")    &&
+             __builtin_cpu_supports("fma");
+    #endif
+    default:
+      return false;
+    }
+  }
+
+  static
+  FresnelKernelType &
+  FresnelCS_batch_kernel_ref() {
+    static FresnelKernelType kernel =
+      FresnelCS_batch_kernel_supported( FRESNEL_KERNEL_AVX512 ) ? FRESNEL_KERNEL_AVX512 :
+      FresnelCS_batch_kernel_supported( FRESNEL_KERNEL_AVX2   ) ? FRESNEL_KERNEL_AVX2 :
+                                                                  FRESNEL_KERNEL_GENERIC;
+    return kernel;
+  }
+
+  FresnelKernelType
+  FresnelCS_batch_kernel()
+  { return FresnelCS_batch_kernel_ref(); }
+
+  bool
+  FresnelCS_batch_kernel_set( FresnelKernelType k ) {
+    if ( !FresnelCS_batch_kernel_supported( k ) ) return false;
+    FresnelCS_batch_kernel_ref() = k;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  FresnelCS_batch(
+    int_type        n,
+    real_type const x[],
+    real_type       C[],
+    real_type       S[]
+  ) {
+    switch ( FresnelCS_batch_kernel_ref() ) {
+    case FRESNEL_KERNEL_SCALAR:
+      FresnelCS_batch_scalar( n, x, C, S );
+      break;
+    #ifdef G2LIB_FRESNEL_X86_KERNELS
+    case FRESNEL_KERNEL_AVX2:
+      FresnelAVX2::FresnelCS_batch( n, x, C, S );
+      break;
+    case FRESNEL_KERNEL_AVX512:
+      FresnelAVX512::FresnelCS_batch( n, x, C, S );
+      break;
+    #endif
+    default:
+      FresnelGeneric::FresnelCS_batch( n, x, C, S );
+      break;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  GeneralizedFresnelCS_batch(
+    int_type        n,
+    real_type const a[],
+    real_type const b[],
+    real_type       c,
+    real_type       intC[],
+    real_type       intS[]
+  ) {
+    switch ( FresnelCS_batch_kernel_ref() ) {
+    case FRESNEL_KERNEL_SCALAR:
+      GeneralizedFresnelCS_batch_scalar( n, a, b, c, intC, intS );
+      break;
+    #ifdef G2LIB_FRESNEL_X86_KERNELS
+    case FRESNEL_KERNEL_AVX2:
+      FresnelAVX2::GeneralizedFresnelCS_batch( n, a, b, c, intC, intS );
+      break;
+    case FRESNEL_KERNEL_AVX512:
+      FresnelAVX512::GeneralizedFresnelCS_batch( n, a, b, c, intC, intS );
+      break;
+    #endif
+    default:
+      FresnelGeneric::GeneralizedFresnelCS_batch( n, a, b, c, intC, intS );
+      break;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  GeneralizedFresnelCS_batch(
+    int_type        nk,
+    int_type        n,
+    real_type const a[],
+    real_type const b[],
+    real_type const c[],
+    real_type       intC[],
+    real_type       intS[]
+  ) {
+    G2LIB_ASSERT( nk > 0 && nk < 4, "nk = " << nk << " must be in 1..3" )
+    switch ( FresnelCS_batch_kernel_ref() ) {
+    case FRESNEL_KERNEL_SCALAR:
+      GeneralizedFresnelCS_batch_scalar( nk, n, a, b, c, intC, intS );
+      break;
+    #ifdef G2LIB_FRESNEL_X86_KERNELS
+    case FRESNEL_KERNEL_AVX2:
+      FresnelAVX2::GeneralizedFresnelCS_batch( nk, n, a, b, c, intC, intS );
+      break;
+    case FRESNEL_KERNEL_AVX512:
+      FresnelAVX512::GeneralizedFresnelCS_batch( nk, n, a, b, c, intC, intS );
+      break;
+    #endif
+    default:
+      FresnelGeneric::GeneralizedFresnelCS_batch( nk, n, a, b, c, intC, intS );
+      break;
+    }
+  }
+
   // -------------------------------------------------------------------------
 
   void
@@ -871,6 +1130,17 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  real_type
+  ClothoidData::length_ISO( real_type s, real_type offs ) const {
+    // the speed is linear in s, it may vanish (cusp of the offset)
+    real_type a = 1-offs*kappa0;
+    real_type b = a-offs*dk*s;
+    if ( a*b >= 0 ) return 0.5*s*abs(a+b);
+    return 0.5*s*(a*a+b*b)/abs(a-b);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   real_type
   ClothoidData::X_ISO( real_type s, real_type offs ) const
   { return X(s) + offs * nor_x_ISO(s); }
@@ -1088,6 +1358,142 @@ namespace G2lib {
     y_DDD = tmp1*S+tmp2*C;
   }
 
+  /*\
+   |   _           _       _
+   |  | |__   __ _| |_ ___| |__
+   |  | '_ \ / _` | __/ __| '_ \
+   |  | |_) | (_| | || (__| | | |
+   |  |_.__/ \__,_|\__\___|_| |_|
+  \*/
+
+  // points are processed in blocks, the arguments of the Fresnel
+  // integrals are collected in contiguous buffers so that the
+  // loops before and after the integral evaluation are vectorizable
+  static int_type const BATCH_BLOCK = 64;
+
+  void
+  ClothoidData::eval_batch(
+    real_type const s[],
+    int_type        n,
+    real_type       x[],
+    real_type       y[]
+  ) const {
+    real_type a[BATCH_BLOCK], b[BATCH_BLOCK], C[BATCH_BLOCK], S[BATCH_BLOCK];
+    for ( int_type i0 = 0; i0 < n; i0 += BATCH_BLOCK ) {
+      int_type          m  = min( n-i0, BATCH_BLOCK );
+      real_type const * ss = s+i0;
+      for ( int_type k = 0; k < m; ++k ) {
+        a[k] = dk*ss[k]*ss[k];
+        b[k] = kappa0*ss[k];
+      }
+      GeneralizedFresnelCS_batch( m, a, b, theta0, C, S );
+      real_type * xx = x+i0;
+      real_type * yy = y+i0;
+      for ( int_type k = 0; k < m; ++k ) {
+        xx[k] = x0 + ss[k]*C[k];
+        yy[k] = y0 + ss[k]*S[k];
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ClothoidData::eval_batch_ISO(
+    real_type const s[],
+    int_type        n,
+    real_type       offs,
+    real_type       x[],
+    real_type       y[]
+  ) const {
+    real_type a[BATCH_BLOCK], b[BATCH_BLOCK], C[BATCH_BLOCK], S[BATCH_BLOCK];
+    for ( int_type i0 = 0; i0 < n; i0 += BATCH_BLOCK ) {
+      int_type          m  = min( n-i0, BATCH_BLOCK );
+      real_type const * ss = s+i0;
+      for ( int_type k = 0; k < m; ++k ) {
+        a[k] = dk*ss[k]*ss[k];
+        b[k] = kappa0*ss[k];
+      }
+      GeneralizedFresnelCS_batch( m, a, b, theta0, C, S );
+      real_type * xx = x+i0;
+      real_type * yy = y+i0;
+      for ( int_type k = 0; k < m; ++k ) {
+        real_type theta = theta0 + ss[k]*(kappa0+0.5*ss[k]*dk);
+        real_type nx    = -sin( theta );
+        real_type ny    = cos( theta );
+        xx[k] = x0 + ss[k]*C[k] + offs * nx;
+        yy[k] = y0 + ss[k]*S[k] + offs * ny;
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // derivatives do not need Fresnel integrals, the scalar kernels
+  // are defined in this unit and are inlined in the loops
+
+  void
+  ClothoidData::eval_batch_D(
+    real_type const s[],
+    int_type        n,
+    real_type       x_D[],
+    real_type       y_D[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) this->eval_D( s[i], x_D[i], y_D[i] );
+  }
+
+  void
+  ClothoidData::eval_batch_DD(
+    real_type const s[],
+    int_type        n,
+    real_type       x_DD[],
+    real_type       y_DD[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) this->eval_DD( s[i], x_DD[i], y_DD[i] );
+  }
+
+  void
+  ClothoidData::eval_batch_DDD(
+    real_type const s[],
+    int_type        n,
+    real_type       x_DDD[],
+    real_type       y_DDD[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) this->eval_DDD( s[i], x_DDD[i], y_DDD[i] );
+  }
+
+  void
+  ClothoidData::eval_batch_ISO_D(
+    real_type const s[],
+    int_type        n,
+    real_type       offs,
+    real_type       x_D[],
+    real_type       y_D[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) this->eval_ISO_D( s[i], offs, x_D[i], y_D[i] );
+  }
+
+  void
+  ClothoidData::eval_batch_ISO_DD(
+    real_type const s[],
+    int_type        n,
+    real_type       offs,
+    real_type       x_DD[],
+    real_type       y_DD[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) this->eval_ISO_DD( s[i], offs, x_DD[i], y_DD[i] );
+  }
+
+  void
+  ClothoidData::eval_batch_ISO_DDD(
+    real_type const s[],
+    int_type        n,
+    real_type       offs,
+    real_type       x_DDD[],
+    real_type       y_DDD[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) this->eval_ISO_DDD( s[i], offs, x_DDD[i], y_DDD[i] );
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
@@ -1279,6 +1685,36 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  // angle of the normalized G1 problem in [-pi,pi]
+  static inline
+  void
+  G1_range( real_type & phi ) {
+    phi -= m_2pi*round(phi/m_2pi);
+    if      ( phi >  m_pi ) phi -= m_2pi;
+    else if ( phi < -m_pi ) phi += m_2pi;
+  }
+
+  // initial guess of the parameter A of the normalized G1 problem
+  static
+  real_type
+  G1_guess( real_type phi0, real_type phi1 ) {
+    static real_type const CF[] = {
+      2.989696028701907,   0.716228953608281,
+      -0.458969738821509, -0.502821153340377,
+      0.261062141752652,  -0.045854475238709
+    };
+    G1guessTable const * T = G1guessTable_get();
+    if ( T != nullptr && !T->empty() ) return T->eval( phi0, phi1 );
+    real_type X  = phi0*m_1_pi;
+    real_type Y  = phi1*m_1_pi;
+    real_type xy = X*Y;
+    Y *= Y; X *= X;
+    return (phi0+phi1) * ( CF[0] + xy*(CF[1] + xy*CF[2]) +
+                           (CF[3]+xy*CF[4])*(X+Y) + CF[5]*(X*X+Y*Y) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   int
   ClothoidData::build_G1(
     real_type   _x0,
@@ -1294,11 +1730,6 @@ namespace G2lib {
     real_type   k_D[2],
     real_type   dk_D[2]
   ) {
-    static real_type const CF[] = {
-      2.989696028701907,   0.716228953608281,
-      -0.458969738821509, -0.502821153340377,
-      0.261062141752652,  -0.045854475238709
-    };
 
     x0     = _x0;
     y0     = _y0;
@@ -1312,23 +1743,13 @@ namespace G2lib {
     real_type phi0 = theta0 - phi;
     real_type phi1 = theta1 - phi;
 
-    phi0 -= m_2pi*round(phi0/m_2pi);
-    phi1 -= m_2pi*round(phi1/m_2pi);
-
-    if      ( phi0 >  m_pi ) phi0 -= m_2pi;
-    else if ( phi0 < -m_pi ) phi0 += m_2pi;
-    if      ( phi1 >  m_pi ) phi1 -= m_2pi;
-    else if ( phi1 < -m_pi ) phi1 += m_2pi;
+    G1_range( phi0 );
+    G1_range( phi1 );
 
     real_type delta = phi1 - phi0;
 
     // punto iniziale
-    real_type X  = phi0*m_1_pi;
-    real_type Y  = phi1*m_1_pi;
-    real_type xy = X*Y;
-    Y *= Y; X *= X;
-    real_type A = (phi0+phi1) * ( CF[0] + xy*(CF[1] + xy*CF[2]) +
-                                  (CF[3]+xy*CF[4])*(X+Y) + CF[5]*(X*X+Y*Y) );
+    real_type A = G1_guess( phi0, phi1 );
     // newton
     real_type g=0, dg, intC[3], intS[3];
     int_type  niter = 0;
@@ -1379,6 +1800,149 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  int
+  ClothoidData::build_G1_nothrow(
+    real_type   _x0,
+    real_type   _y0,
+    real_type   _theta0,
+    real_type   x1,
+    real_type   y1,
+    real_type   theta1,
+    real_type   tol,
+    real_type & L
+  ) {
+    real_type dx = x1 - _x0;
+    real_type dy = y1 - _y0;
+    real_type r  = hypot( dx, dy );
+    // the Fresnel integrals raise an exception for not finite arguments
+    if ( !( r > 0 && std::isfinite( r + _theta0 + theta1 ) ) ) return -1;
+
+    x0     = _x0;
+    y0     = _y0;
+    theta0 = _theta0;
+
+    real_type phi  = atan2( dy, dx );
+    real_type phi0 = theta0 - phi;
+    real_type phi1 = theta1 - phi;
+
+    G1_range( phi0 );
+    G1_range( phi1 );
+
+    real_type delta = phi1 - phi0;
+    real_type A     = G1_guess( phi0, phi1 );
+
+    real_type g=0, dg, intC[3], intS[3];
+    int_type  niter = 0;
+    do {
+      GeneralizedFresnelCS( 3, 2*A, delta-A, phi0, intC, intS );
+      g   = intS[0];
+      dg  = intC[2] - intC[1];
+      A  -= g / dg;
+      if ( !std::isfinite( A ) ) return -1;
+    } while ( ++niter <= 10 && abs(g) > tol );
+    if ( !( abs(g) <= tol ) ) return -1;
+
+    GeneralizedFresnelCS( 2*A, delta-A, phi0, intC[0], intS[0] );
+    L = r/intC[0];
+    if ( !( L > 0 && std::isfinite( L ) ) ) return -1;
+
+    this->kappa0 = (delta-A)/L;
+    this->dk     = 2*A/L/L;
+    return niter;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  static G1guessTable const * G1guess_installed = nullptr;
+
+  void
+  G1guessTable_set( G1guessTable const * T )
+  { G1guess_installed = T; }
+
+  G1guessTable const *
+  G1guessTable_get()
+  { return G1guess_installed; }
+
+  static char const G1guessTable_magic[4] = { 'G', '1', 'G', 'T' };
+
+  void
+  G1guessTable::generate( size_t max_bytes ) {
+    int_type nn = int_type( std::sqrt( real_type(max_bytes/sizeof(float)) ) );
+    G2LIB_ASSERT(
+      nn >= 2,
+      "G1guessTable::generate, max_bytes = " << max_bytes << " too small"
+    )
+    size_t NN = size_t(nn)*size_t(nn);
+    std::vector<float> AA( NN );
+    ClothoidData cd;
+    for ( int_type i0 = 0; i0 < nn; ++i0 ) {
+      real_type phi0 = m_pi*((2*i0+1)/real_type(nn)-1);
+      for ( int_type i1 = 0; i1 < nn; ++i1 ) {
+        real_type phi1 = m_pi*((2*i1+1)/real_type(nn)-1);
+        real_type L;
+        cd.build_G1( -1, 0, phi0, 1, 0, phi1, 1e-12, L );
+        AA[size_t(i0)*nn+i1] = float(cd.dk*L*L/2);
+      }
+    }
+    n = nn;
+    A.swap( AA );
+  }
+
+  real_type
+  G1guessTable::eval( real_type phi0, real_type phi1 ) const {
+    // position in the grid of the cell centers
+    real_type u0 = ((phi0*m_1_pi+1)*n-1)/2;
+    real_type u1 = ((phi1*m_1_pi+1)*n-1)/2;
+    u0 = max( real_type(0), min( real_type(n-1), u0 ) );
+    u1 = max( real_type(0), min( real_type(n-1), u1 ) );
+    int_type  i0 = min( int_type(u0), n-2 );
+    int_type  i1 = min( int_type(u1), n-2 );
+    real_type w0 = u0-i0;
+    real_type w1 = u1-i1;
+    float const * a = &A[size_t(i0)*n+i1];
+    return (1-w0)*((1-w1)*a[0]+w1*a[1]) + w0*((1-w1)*a[n]+w1*a[n+1]);
+  }
+
+  void
+  G1guessTable::save( ostream_type & stream ) const {
+    int32_t nn = int32_t(n);
+    stream.write( G1guessTable_magic, 4 );
+    stream.write( reinterpret_cast<char const*>(&nn), sizeof(nn) );
+    if ( n > 0 )
+      stream.write(
+        reinterpret_cast<char const*>(&A.front()),
+        std::streamsize(A.size()*sizeof(float))
+      );
+  }
+
+  bool
+  G1guessTable::load( std::istream & stream ) {
+    char    magic[4];
+    int32_t nn;
+    stream.read( magic, 4 );
+    stream.read( reinterpret_cast<char*>(&nn), sizeof(nn) );
+    if ( !stream || !std::equal( magic, magic+4, G1guessTable_magic ) ) return false;
+    if ( nn < 0 || nn == 1 ) return false;
+    size_t NN = size_t(nn)*size_t(nn);
+    // a wrong `nn` must fail at the end of the data, not allocate
+    // nn*nn floats before reading them
+    std::vector<float> AA;
+    while ( AA.size() < NN ) {
+      size_t i = AA.size();
+      AA.resize( min( NN, i + (size_t(1)<<20) ) );
+      stream.read(
+        reinterpret_cast<char*>(&AA[i]),
+        std::streamsize((AA.size()-i)*sizeof(float))
+      );
+      if ( !stream ) return false;
+    }
+    n = nn;
+    A.swap( AA );
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   static
   real_type
   kappa_fun( real_type theta0, real_type theta ) {
@@ -114,6 +114,108 @@ namespace G2lib {
     real_type & intS
   );
 
+  /*\
+   |   _           _       _
+   |  | |__   __ _| |_ ___| |__
+   |  | '_ \ / _` | __/ __| '_ \
+   |  | |_) | (_| | || (__| | | |
+   |  |_.__/ \__,_|\__\___|_| |_|
+  \*/
+
+  //! kernels available for the batched Fresnel integrals
+  typedef enum {
+    FRESNEL_KERNEL_SCALAR = 0, //!< loop on the scalar routines
+    FRESNEL_KERNEL_GENERIC,    //!< portable 4 lanes kernel
+    FRESNEL_KERNEL_AVX2,       //!< 4 lanes kernel compiled for AVX2+FMA
+    FRESNEL_KERNEL_AVX512      //!< 8 lanes kernel compiled for AVX-512
+  } FresnelKernelType;
+
+  extern char const *FresnelKernelType_name[];
+
+  //! true if kernel `k` is compiled in and supported by the running CPU
+  bool
+  FresnelCS_batch_kernel_supported( FresnelKernelType k );
+
+  //! kernel used by the batched routines, by default the widest supported
+  FresnelKernelType
+  FresnelCS_batch_kernel();
+
+  /*!
+   * Select the kernel used by the batched routines,
+   * return false (and leave the selection unchanged) if `k` is not supported.
+   * The selection is global, do not change it while other threads
+   * are using the batched routines.
+   */
+  bool
+  FresnelCS_batch_kernel_set( FresnelKernelType k );
+
+  /*! \brief Compute the Fresnel integrals \f$ C(x_i) \f$ and \f$ S(x_i) \f$
+   * for `n` arguments with the selected kernel
+   * \param n number of points
+   * \param x the input abscissae
+   * \param C the values of \f$ C(x_i) \f$
+   * \param S the values of \f$ S(x_i) \f$
+   */
+  void
+  FresnelCS_batch(
+    int_type        n,
+    real_type const x[],
+    real_type       C[],
+    real_type       S[]
+  );
+
+  /*! \brief Compute the Fresnel integrals for `n` pairs \f$ (a_i,b_i) \f$
+   * \f[
+   *   \int_0^1 \cos\left(a_i\frac{t^2}{2} + b_i t + c\right) dt,\qquad
+   *   \int_0^1 \sin\left(a_i\frac{t^2}{2} + b_i t + c\right) dt
+   * \f]
+   * the phase \f$ c \f$ is shared by all the points.
+   * The integrals are computed with the selected kernel.
+   * \param n    number of points
+   * \param a    parameters \f$ a_i \f$
+   * \param b    parameters \f$ b_i \f$
+   * \param c    parameter \f$ c \f$
+   * \param intC cosine integrals, `n` values
+   * \param intS sine integrals, `n` values
+   */
+  void
+  GeneralizedFresnelCS_batch(
+    int_type        n,
+    real_type const a[],
+    real_type const b[],
+    real_type       c,
+    real_type       intC[],
+    real_type       intS[]
+  );
+
+  /*! \brief Compute the generalized Fresnel integrals and their moments
+   * for `n` triples \f$ (a_i,b_i,c_i) \f$
+   * \f[
+   *   \int_0^1 t^j \cos\left(a_i\frac{t^2}{2} + b_i t + c_i\right) dt,\qquad
+   *   \int_0^1 t^j \sin\left(a_i\frac{t^2}{2} + b_i t + c_i\right) dt
+   * \f]
+   * for \f$ j=0,\ldots,nk-1 \f$, same values of
+   * `GeneralizedFresnelCS( nk, a[i], b[i], c[i], ... )`.
+   * The integrals are computed with the selected kernel.
+   * \param nk   number of moments, 1..3
+   * \param n    number of points
+   * \param a    parameters \f$ a_i \f$
+   * \param b    parameters \f$ b_i \f$
+   * \param c    parameters \f$ c_i \f$
+   * \param intC cosine integrals, moment `j` of point `i` in `intC[j*n+i]`
+   * \param intS sine integrals, moment `j` of point `i` in `intS[j*n+i]`
+   */
+  void
+  GeneralizedFresnelCS_batch(
+    int_type        nk,
+    int_type        n,
+    real_type const a[],
+    real_type const b[],
+    real_type const c[],
+    real_type       intC[],
+    real_type       intS[]
+  );
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   //! data storage for clothoid type curve
@@ -172,6 +274,9 @@ namespace G2lib {
     real_type X_ISO_DDD( real_type s, real_type offs ) const;
     real_type Y_ISO_DDD( real_type s, real_type offs ) const;
 
+    //! length of the offset curve from 0 to `s`, the speed is |1-offs*kappa(s)|
+    real_type length_ISO( real_type s, real_type offs ) const;
+
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
     real_type X_SAE    ( real_type s, real_type offs ) const;
@@ -354,6 +459,78 @@ namespace G2lib {
       this->eval_ISO_DDD( s, -offs, x_DDD, y_DDD );
     }
 
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    void
+    eval_batch(
+      real_type const s[],
+      int_type        n,
+      real_type       x[],
+      real_type       y[]
+    ) const;
+
+    void
+    eval_batch_D(
+      real_type const s[],
+      int_type        n,
+      real_type       x_D[],
+      real_type       y_D[]
+    ) const;
+
+    void
+    eval_batch_DD(
+      real_type const s[],
+      int_type        n,
+      real_type       x_DD[],
+      real_type       y_DD[]
+    ) const;
+
+    void
+    eval_batch_DDD(
+      real_type const s[],
+      int_type        n,
+      real_type       x_DDD[],
+      real_type       y_DDD[]
+    ) const;
+
+    void
+    eval_batch_ISO(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x[],
+      real_type       y[]
+    ) const;
+
+    void
+    eval_batch_ISO_D(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_D[],
+      real_type       y_D[]
+    ) const;
+
+    void
+    eval_batch_ISO_DD(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_DD[],
+      real_type       y_DD[]
+    ) const;
+
+    void
+    eval_batch_ISO_DDD(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_DDD[],
+      real_type       y_DDD[]
+    ) const;
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
     void
     eval( real_type s, ClothoidData & C ) const;
 
@@ -425,6 +602,23 @@ namespace G2lib {
       real_type   dk_D[2]       = nullptr
     );
 
+    /*!
+     *  As `build_G1` (without derivatives) but the failures, data
+     *  not finite or coincident points included, are reported
+     *  returning -1 instead of raising an exception.
+     */
+    int
+    build_G1_nothrow(
+      real_type   x0,
+      real_type   y0,
+      real_type   theta0,
+      real_type   x1,
+      real_type   y1,
+      real_type   theta1,
+      real_type   tol,
+      real_type & L
+    );
+
     bool
     build_forward(
       real_type   x0,
@@ -442,6 +636,67 @@ namespace G2lib {
 
   };
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  /*!
+   * Table of the solutions of the normalized G1 Hermite problem,
+   * the parameter \f$ A \f$ of `ClothoidData::build_G1` sampled on a
+   * regular grid of the angles \f$ (\phi_0,\phi_1)\in[-\pi,\pi]^2 \f$.
+   * Once installed with `G1guessTable_set` the bilinear interpolation
+   * of the table replaces the polynomial initial guess of the Newton
+   * iterations of `ClothoidData::build_G1`.
+   */
+  class G1guessTable {
+    int_type           n; // nodes for each angle
+    std::vector<float> A; // A[i0*n+i1], angles at the cell centers
+
+  public:
+
+    G1guessTable() : n(0) {}
+
+    //! compute the table using at most `max_bytes` bytes
+    void
+    generate( size_t max_bytes );
+
+    bool
+    empty() const
+    { return n == 0; }
+
+    int_type
+    numNodes() const
+    { return n; }
+
+    //! memory used by the table (bytes)
+    size_t
+    memory() const
+    { return A.size()*sizeof(float); }
+
+    //! interpolated parameter \f$ A \f$ for the angles `phi0`, `phi1` in \f$ [-\pi,\pi] \f$
+    real_type
+    eval( real_type phi0, real_type phi1 ) const;
+
+    //! write the table in binary form
+    void
+    save( ostream_type & stream ) const;
+
+    //! read a table written by `save`, return false if the data are not valid
+    bool
+    load( std::istream & stream );
+  };
+
+  /*!
+   * Install `T` as initial guess of the following `ClothoidData::build_G1`
+   * (`nullptr` restore the polynomial guess).
+   * The selection is global, the table must live while it is installed
+   * and must not be changed while other threads are building clothoids.
+   */
+  void
+  G1guessTable_set( G1guessTable const * T );
+
+  //! the installed table, `nullptr` if none
+  G1guessTable const *
+  G1guessTable_get();
+
 }
 
 #endif
@@ -0,0 +1,683 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+///
+/// file: Fresnel_batch.hxx
+///
+/// Lane kernels for the batched Fresnel integrals.
+/// This file is included by Fresnel.cc once for each instruction set,
+/// inside a namespace defining the number of lanes `W`.
+/// Every routine works on `W` independent arguments stored in local
+/// arrays with straight loops on the lanes: no calls, no data dependent
+/// branches and only floating point selects inside the loops, so that
+/// the compiler maps each loop to packed instructions.
+/// Branches depend only on the number of lanes in a region.
+///
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// sin and cos with Cody-Waite reduction and the fdlibm kernels,
+// lanes with |x| > SINCOS_MAX are computed with the scalar libm
+static
+inline
+void
+sincos_lanes(
+  real_type const x[W],
+  real_type       s[W],
+  real_type       c[W]
+) {
+  real_type const SINCOS_MAX  = 1e6; // quadrant fits in 20 bits
+  real_type const TWO_OVER_PI = 6.36619772367581382433e-01;
+  real_type const PIO2_1      = 1.57079632673412561417e+00; // first 33 bits of pi/2
+  real_type const PIO2_2      = 6.07710050630396597660e-11; // second 33 bits of pi/2
+  real_type const PIO2_2T     = 2.02226624879595063154e-21; // pi/2 - (PIO2_1+PIO2_2)
+  real_type const ROUND       = 6755399441055744.0;         // 1.5*2^52
+
+  real_type const S1 = -1.66666666666666324348e-01;
+  real_type const S2 =  8.33333333332248946124e-03;
+  real_type const S3 = -1.98412698298579493134e-04;
+  real_type const S4 =  2.75573137070700676789e-06;
+  real_type const S5 = -2.50507602534068634195e-08;
+  real_type const S6 =  1.58969099521155010221e-10;
+
+  real_type const C1 =  4.16666666666666019037e-02;
+  real_type const C2 = -1.38888888888741095749e-03;
+  real_type const C3 =  2.48015872894767294178e-05;
+  real_type const C4 = -2.75573143513906633035e-07;
+  real_type const C5 =  2.08757232129817482790e-09;
+  real_type const C6 = -1.13596475577881948265e-11;
+
+  real_type ss[W], cc[W], nbig = 0;
+  for ( int_type k = 0; k < W; ++k ) {
+    bool      ok = abs(x[k]) <= SINCOS_MAX; // false also for NaN
+    real_type xx = ok ? x[k] : 0;
+    real_type q  = (xx*TWO_OVER_PI + ROUND) - ROUND; // round to nearest
+    real_type r  = ((xx - q*PIO2_1) - q*PIO2_2) - q*PIO2_2T;
+    // quadrant q mod 4 from the fraction of q/4 in {-1/2,-1/4,0,1/4,1/2}
+    real_type q4 = 0.25*q;
+    real_type f4 = q4 - ((q4 + ROUND) - ROUND);
+    real_type z  = r*r;
+    real_type sr = r + r*z*(S1+z*(S2+z*(S3+z*(S4+z*(S5+z*S6)))));
+    real_type hz = 0.5*z;
+    real_type w  = 1-hz;
+    real_type cr = w + (((1-w)-hz) + z*z*(C1+z*(C2+z*(C3+z*(C4+z*(C5+z*C6))))));
+    bool      od = abs(f4) == 0.25;                 // quadrant 1 or 3
+    bool      ns = (f4 == -0.25) | (abs(f4) == 0.5); // quadrant 2 or 3
+    bool      nc = (f4 ==  0.25) | (abs(f4) == 0.5); // quadrant 1 or 2
+    real_type sv = od ? cr : sr;
+    real_type cv = od ? sr : cr;
+    ss[k] = ns ? -sv : sv;
+    cc[k] = nc ? -cv : cv;
+    nbig += ok ? 0 : 1;
+  }
+  if ( nbig > 0 ) {
+    for ( int_type k = 0; k < W; ++k ) {
+      if ( !( abs(x[k]) <= SINCOS_MAX ) ) {
+        ss[k] = sin(x[k]);
+        cc[k] = cos(x[k]);
+      }
+    }
+  }
+  for ( int_type k = 0; k < W; ++k ) { s[k] = ss[k]; c[k] = cc[k]; }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Fresnel integrals C(x), S(x), same three regions of the scalar FresnelCS:
+// power series, rational approximation and asymptotic expansion.
+// If `sinu` is not null sin(pi/2 x^2) and cos(pi/2 x^2) of all the lanes
+// are returned in `sinu` and `cosu` (used by the moments)
+static
+inline
+void
+FresnelCS_lanes(
+  real_type const y[W],
+  real_type       C[W],
+  real_type       S[W],
+  real_type       sinu[W] = nullptr,
+  real_type       cosu[W] = nullptr
+) {
+
+  // coefficients of the power series in (pi/2 x^2)^2
+  // (-1)^k/((2k)!(4k+1)) and (-1)^k/((2k+1)!(4k+3))
+  static real_type const PC[] = {
+    1.0,
+    -1.0/(2.0*5.0),
+    1.0/(24.0*9.0),
+    -1.0/(720.0*13.0),
+    1.0/(40320.0*17.0),
+    -1.0/(3628800.0*21.0),
+    1.0/(479001600.0*25.0),
+    -1.0/(87178291200.0*29.0),
+    1.0/(20922789888000.0*33.0),
+    -1.0/(6402373705728000.0*37.0),
+    1.0/(2432902008176640000.0*41.0),
+    -1.0/(1124000727777607680000.0*45.0),
+    1.0/(620448401733239439360000.0*49.0)
+  };
+  static real_type const PS[] = {
+    1.0/3.0,
+    -1.0/(6.0*7.0),
+    1.0/(120.0*11.0),
+    -1.0/(5040.0*15.0),
+    1.0/(362880.0*19.0),
+    -1.0/(39916800.0*23.0),
+    1.0/(6227020800.0*27.0),
+    -1.0/(1307674368000.0*31.0),
+    1.0/(355687428096000.0*35.0),
+    -1.0/(121645100408832000.0*39.0),
+    1.0/(51090942171709440000.0*43.0),
+    -1.0/(25852016738884976640000.0*47.0),
+    1.0/(15511210043330985984000000.0*51.0)
+  };
+  int_type const NP = 13;
+  int_type const NA = 12; // terms of the asymptotic expansion (x >= 6)
+
+  real_type x[W], CC[W], SS[W];
+  real_type nA = 0, nB = 0, nC = 0;
+  for ( int_type k = 0; k < W; ++k ) {
+    x[k]  = abs(y[k]);
+    CC[k] = SS[k] = 0;
+    nA   += x[k] < 1 ? 1 : 0;
+    nB   += (x[k] >= 1) & (x[k] < 6) ? 1 : 0;
+    nC   += x[k] < 6 ? 0 : 1; // NaN goes here
+  }
+
+  if ( nA > 0 ) {
+    real_type xx[W], u[W], sc[W], sn[W];
+    for ( int_type k = 0; k < W; ++k ) {
+      xx[k] = x[k] < 1 ? x[k] : 0;
+      real_type s = m_pi_2*(xx[k]*xx[k]);
+      u[k]  = s*s;
+      sc[k] = PC[NP-1];
+      sn[k] = PS[NP-1];
+    }
+    for ( int_type j = NP-2; j >= 0; --j ) {
+      for ( int_type k = 0; k < W; ++k ) {
+        sc[k] = PC[j] + u[k]*sc[k];
+        sn[k] = PS[j] + u[k]*sn[k];
+      }
+    }
+    for ( int_type k = 0; k < W; ++k ) {
+      bool in = x[k] < 1;
+      CC[k] = in ? xx[k]*sc[k] : CC[k];
+      SS[k] = in ? m_pi_2*sn[k]*(xx[k]*xx[k]*xx[k]) : SS[k];
+    }
+  }
+
+  if ( nB+nC > 0 || sinu != nullptr ) {
+    real_type U[W], SinU[W], CosU[W];
+    for ( int_type k = 0; k < W; ++k ) U[k] = m_pi_2*(x[k]*x[k]);
+    sincos_lanes( U, SinU, CosU );
+    if ( sinu != nullptr ) {
+      for ( int_type k = 0; k < W; ++k ) { sinu[k] = SinU[k]; cosu[k] = CosU[k]; }
+    }
+
+    if ( nB > 0 ) {
+      real_type xx[W], fsumn[W], fsumd[W], gsumn[W], gsumd[W];
+      for ( int_type k = 0; k < W; ++k ) {
+        xx[k]    = (x[k] >= 1) & (x[k] < 6) ? x[k] : 1;
+        fsumn[k] = gsumn[k] = 0;
+        fsumd[k] = fd[11];
+        gsumd[k] = gd[11];
+      }
+      for ( int_type j = 10; j >= 0; --j ) {
+        for ( int_type k = 0; k < W; ++k ) {
+          fsumn[k] = fn[j] + xx[k]*fsumn[k];
+          fsumd[k] = fd[j] + xx[k]*fsumd[k];
+          gsumn[k] = gn[j] + xx[k]*gsumn[k];
+          gsumd[k] = gd[j] + xx[k]*gsumd[k];
+        }
+      }
+      for ( int_type k = 0; k < W; ++k ) {
+        bool      in = (x[k] >= 1) & (x[k] < 6);
+        real_type f  = fsumn[k]/fsumd[k];
+        real_type g  = gsumn[k]/gsumd[k];
+        CC[k] = in ? 0.5 + f*SinU[k] - g*CosU[k] : CC[k];
+        SS[k] = in ? 0.5 - f*CosU[k] - g*SinU[k] : SS[k];
+      }
+    }
+
+    if ( nC > 0 ) {
+      real_type xx[W], pix[W], t[W], tf[W], sf[W], tg[W], sg[W];
+      for ( int_type k = 0; k < W; ++k ) {
+        xx[k]  = x[k] < 6 ? 6 : x[k];
+        pix[k] = m_pi*xx[k];
+        real_type s = pix[k]*xx[k];
+        t[k]  = -1/(s*s);
+        tf[k] = sf[k] = tg[k] = sg[k] = 1;
+      }
+      real_type num = -1;
+      for ( int_type j = 0; j < NA; ++j ) {
+        num += 4;
+        real_type cf = num*(num-2);
+        real_type cg = num*(num+2);
+        for ( int_type k = 0; k < W; ++k ) {
+          tf[k] *= cf*t[k];
+          tg[k] *= cg*t[k];
+          sf[k] += tf[k];
+          sg[k] += tg[k];
+        }
+      }
+      for ( int_type k = 0; k < W; ++k ) {
+        bool      in = !( x[k] < 6 );
+        real_type f  = sf[k]/pix[k];
+        real_type g  = sg[k]/(pix[k]*pix[k]*xx[k]);
+        CC[k] = in ? 0.5 + f*SinU[k] - g*CosU[k] : CC[k];
+        SS[k] = in ? 0.5 - f*CosU[k] - g*SinU[k] : SS[k];
+      }
+    }
+  }
+
+  for ( int_type k = 0; k < W; ++k ) {
+    C[k] = y[k] < 0 ? -CC[k] : CC[k];
+    S[k] = y[k] < 0 ? -SS[k] : SS[k];
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// same as the scalar evalXYaLarge, all lanes must have a != 0
+static
+inline
+void
+evalXYaLarge_lanes(
+  real_type const a[W],
+  real_type const b[W],
+  real_type       X[W],
+  real_type       Y[W]
+) {
+  real_type sgn[W], z[W], ell[W], ellz[W], g[W], sg[W], cg[W];
+  for ( int_type k = 0; k < W; ++k ) {
+    real_type absa  = abs(a[k]);
+    real_type sabsa = sqrt(absa);
+    sgn[k]  = a[k] > 0 ? 1 : -1;
+    z[k]    = m_1_sqrt_pi*sabsa;
+    ell[k]  = sgn[k]*b[k]*m_1_sqrt_pi/sabsa;
+    ellz[k] = ell[k]+z[k];
+    g[k]    = -0.5*sgn[k]*(b[k]*b[k])/absa;
+  }
+  sincos_lanes( g, sg, cg );
+
+  real_type Cl[W], Sl[W], Cz[W], Sz[W];
+  FresnelCS_lanes( ell,  Cl, Sl );
+  FresnelCS_lanes( ellz, Cz, Sz );
+
+  for ( int_type k = 0; k < W; ++k ) {
+    real_type ccg = cg[k]/z[k];
+    real_type ssg = sg[k]/z[k];
+    real_type dC0 = Cz[k] - Cl[k];
+    real_type dS0 = Sz[k] - Sl[k];
+    X[k] = ccg * dC0 - sgn[k] * ssg * dS0;
+    Y[k] = ssg * dC0 + sgn[k] * ccg * dS0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// small |a| and moderate |b|: double power series
+//
+//   X + iY = sum_n (i a/2)^n/n! M_{2n}(b),
+//   M_k(b) = int_0^1 t^k exp(i b t) dt = sum_j (i b)^j/(j!(k+j+1))
+//
+// the same truncation in `a` of the scalar evalXYaSmall (powers up to a^7),
+// the series in `b` is stopped when the largest lane term is negligible
+static
+inline
+void
+evalXYaSmall_lanes(
+  real_type const a[W],
+  real_type const b[W],
+  real_type       X[W],
+  real_type       Y[W]
+) {
+  int_type const NN = 8; // powers of a: 0..7
+
+  real_type ReM[NN][W], ImM[NN][W], r[W];
+  real_type bmax = 0;
+  for ( int_type k = 0; k < W; ++k ) {
+    r[k] = 1;
+    bmax = max( bmax, abs(b[k]) );
+  }
+  for ( int_type n = 0; n < NN; ++n )
+    for ( int_type k = 0; k < W; ++k )
+      ReM[n][k] = ImM[n][k] = 0;
+
+  // r = b^j/j!, the phase i^j is uniform on the lanes
+  real_type rmax = 1;
+  for ( int_type j = 0; rmax > 1e-20; ++j ) {
+    real_type sgn = (j & 2) == 0 ? 1 : -1;
+    real_type (*M)[W] = (j & 1) == 0 ? ReM : ImM;
+    for ( int_type n = 0; n < NN; ++n ) {
+      real_type coeff = sgn/(2*n+j+1);
+      for ( int_type k = 0; k < W; ++k ) M[n][k] += coeff*r[k];
+    }
+    real_type scale = 1.0/(j+1);
+    for ( int_type k = 0; k < W; ++k ) r[k] *= b[k]*scale;
+    rmax *= bmax*scale;
+  }
+
+  // Horner in (i a/2): P = M_0 + (ia/2)/1 (M_2 + (ia/2)/2 (M_4 + ... ))
+  real_type Px[W], Py[W];
+  for ( int_type k = 0; k < W; ++k ) {
+    Px[k] = ReM[NN-1][k];
+    Py[k] = ImM[NN-1][k];
+  }
+  for ( int_type n = NN-1; n > 0; --n ) {
+    real_type hn = 0.5/n;
+    for ( int_type k = 0; k < W; ++k ) {
+      real_type f   = a[k]*hn;
+      real_type tmp = Px[k];
+      Px[k] = ReM[n-1][k] - f*Py[k];
+      Py[k] = ImM[n-1][k] + f*tmp;
+    }
+  }
+  for ( int_type k = 0; k < W; ++k ) { X[k] = Px[k]; Y[k] = Py[k]; }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// largest |b| accepted by evalXYaSmall_lanes, the other lanes
+// with small |a| use the scalar recurrence/Lommel routine
+static real_type const B_SMALL_MAX = 4;
+
+static
+inline
+void
+evalXY_lanes(
+  real_type const a[W],
+  real_type const b[W],
+  real_type       X[W],
+  real_type       Y[W]
+) {
+  real_type nL = 0, nS = 0;
+  for ( int_type k = 0; k < W; ++k ) {
+    bool L = abs(a[k]) >= A_THRESOLD;
+    bool S = (abs(a[k]) < A_THRESOLD) & (abs(b[k]) <= B_SMALL_MAX);
+    nL += L ? 1 : 0;
+    nS += S ? 1 : 0;
+  }
+
+  if ( nL > 0 ) {
+    real_type aa[W], bb[W], XL[W], YL[W];
+    for ( int_type k = 0; k < W; ++k ) {
+      bool L = abs(a[k]) >= A_THRESOLD;
+      aa[k]  = L ? a[k] : 1;
+      bb[k]  = L ? b[k] : 0;
+    }
+    evalXYaLarge_lanes( aa, bb, XL, YL );
+    for ( int_type k = 0; k < W; ++k ) {
+      bool L = abs(a[k]) >= A_THRESOLD;
+      X[k] = L ? XL[k] : 0;
+      Y[k] = L ? YL[k] : 0;
+    }
+  }
+
+  if ( nS > 0 ) {
+    real_type aa[W], bb[W], XS[W], YS[W];
+    for ( int_type k = 0; k < W; ++k ) {
+      bool S = (abs(a[k]) < A_THRESOLD) & (abs(b[k]) <= B_SMALL_MAX);
+      aa[k]  = S ? a[k] : 0;
+      bb[k]  = S ? b[k] : 0;
+    }
+    evalXYaSmall_lanes( aa, bb, XS, YS );
+    for ( int_type k = 0; k < W; ++k ) {
+      bool S = (abs(a[k]) < A_THRESOLD) & (abs(b[k]) <= B_SMALL_MAX);
+      X[k] = S ? XS[k] : ( nL > 0 ? X[k] : 0 );
+      Y[k] = S ? YS[k] : ( nL > 0 ? Y[k] : 0 );
+    }
+  }
+
+  if ( nL+nS < W ) {
+    for ( int_type k = 0; k < W; ++k ) {
+      if ( abs(a[k]) < A_THRESOLD && !( abs(b[k]) <= B_SMALL_MAX ) )
+        ::G2lib::evalXYaSmall( a[k], b[k], A_SERIE_SIZE, X[k], Y[k] );
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// moments 0,1,2 of the scalar evalXYaLarge (nk = 3),
+// all lanes must have a != 0
+static
+inline
+void
+evalXYaLarge3_lanes(
+  real_type const a[W],
+  real_type const b[W],
+  real_type       X[3][W],
+  real_type       Y[3][W]
+) {
+  real_type sgn[W], z[W], ell[W], ellz[W], g[W], sg[W], cg[W];
+  real_type sl[W], cl[W], sz[W], cz[W];
+  for ( int_type k = 0; k < W; ++k ) {
+    real_type absa  = abs(a[k]);
+    real_type sabsa = sqrt(absa);
+    sgn[k]  = a[k] > 0 ? 1 : -1;
+    z[k]    = m_1_sqrt_pi*sabsa;
+    ell[k]  = sgn[k]*b[k]*m_1_sqrt_pi/sabsa;
+    ellz[k] = ell[k]+z[k];
+    g[k]    = -0.5*sgn[k]*(b[k]*b[k])/absa;
+  }
+  sincos_lanes( g, sg, cg );
+
+  real_type Cl[W], Sl[W], Cz[W], Sz[W];
+  FresnelCS_lanes( ell,  Cl, Sl, sl, cl );
+  FresnelCS_lanes( ellz, Cz, Sz, sz, cz );
+
+  for ( int_type k = 0; k < W; ++k ) {
+    // the moments 1 and 2 of FresnelCS( 3, t, C, S )
+    real_type Cl1 = sl[k]*m_1_pi, Sl1 = (1-cl[k])*m_1_pi;
+    real_type Cz1 = sz[k]*m_1_pi, Sz1 = (1-cz[k])*m_1_pi;
+    real_type Cl2 = (ell[k]*sl[k]-Sl[k])*m_1_pi,  Sl2 = (Cl[k]-ell[k]*cl[k])*m_1_pi;
+    real_type Cz2 = (ellz[k]*sz[k]-Sz[k])*m_1_pi, Sz2 = (Cz[k]-ellz[k]*cz[k])*m_1_pi;
+
+    real_type s   = sgn[k];
+    real_type ccg = cg[k]/z[k];
+    real_type ssg = sg[k]/z[k];
+    real_type dC0 = Cz[k] - Cl[k];
+    real_type dS0 = Sz[k] - Sl[k];
+    X[0][k] = ccg * dC0 - s * ssg * dS0;
+    Y[0][k] = ssg * dC0 + s * ccg * dS0;
+
+    ccg /= z[k];
+    ssg /= z[k];
+    real_type dC1 = Cz1 - Cl1;
+    real_type dS1 = Sz1 - Sl1;
+    real_type DC  = dC1-ell[k]*dC0;
+    real_type DS  = dS1-ell[k]*dS0;
+    X[1][k] = ccg * DC - s * ssg * DS;
+    Y[1][k] = ssg * DC + s * ccg * DS;
+
+    ccg /= z[k];
+    ssg /= z[k];
+    real_type dC2 = Cz2 - Cl2;
+    real_type dS2 = Sz2 - Sl2;
+    DC = dC2+ell[k]*(ell[k]*dC0-2*dC1);
+    DS = dS2+ell[k]*(ell[k]*dS0-2*dS1);
+    X[2][k] = ccg * DC - s * ssg * DS;
+    Y[2][k] = ssg * DC + s * ccg * DS;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// moments 0,1,2 with the double power series of evalXYaSmall_lanes
+//
+//   X_j + iY_j = sum_n (i a/2)^n/n! M_{2n+j}(b)
+static
+inline
+void
+evalXYaSmall3_lanes(
+  real_type const a[W],
+  real_type const b[W],
+  real_type       X[3][W],
+  real_type       Y[3][W]
+) {
+  int_type const NN = 8;      // powers of a: 0..7
+  int_type const NM = 2*NN+1; // moments M_0..M_16
+
+  real_type ReM[NM][W], ImM[NM][W], r[W];
+  real_type bmax = 0;
+  for ( int_type k = 0; k < W; ++k ) {
+    r[k] = 1;
+    bmax = max( bmax, abs(b[k]) );
+  }
+  for ( int_type m = 0; m < NM; ++m )
+    for ( int_type k = 0; k < W; ++k )
+      ReM[m][k] = ImM[m][k] = 0;
+
+  real_type rmax = 1;
+  for ( int_type j = 0; rmax > 1e-20; ++j ) {
+    real_type sgn = (j & 2) == 0 ? 1 : -1;
+    real_type (*M)[W] = (j & 1) == 0 ? ReM : ImM;
+    for ( int_type m = 0; m < NM; ++m ) {
+      real_type coeff = sgn/(m+j+1);
+      for ( int_type k = 0; k < W; ++k ) M[m][k] += coeff*r[k];
+    }
+    real_type scale = 1.0/(j+1);
+    for ( int_type k = 0; k < W; ++k ) r[k] *= b[k]*scale;
+    rmax *= bmax*scale;
+  }
+
+  for ( int_type jm = 0; jm < 3; ++jm ) {
+    real_type Px[W], Py[W];
+    for ( int_type k = 0; k < W; ++k ) {
+      Px[k] = ReM[jm+2*(NN-1)][k];
+      Py[k] = ImM[jm+2*(NN-1)][k];
+    }
+    for ( int_type n = NN-1; n > 0; --n ) {
+      real_type hn = 0.5/n;
+      int_type  m  = jm+2*(n-1);
+      for ( int_type k = 0; k < W; ++k ) {
+        real_type f   = a[k]*hn;
+        real_type tmp = Px[k];
+        Px[k] = ReM[m][k] - f*Py[k];
+        Py[k] = ImM[m][k] + f*tmp;
+      }
+    }
+    for ( int_type k = 0; k < W; ++k ) { X[jm][k] = Px[k]; Y[jm][k] = Py[k]; }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// same regions of evalXY_lanes for the moments 0,1,2
+static
+inline
+void
+evalXY3_lanes(
+  real_type const a[W],
+  real_type const b[W],
+  real_type       X[3][W],
+  real_type       Y[3][W]
+) {
+  real_type nL = 0, nS = 0;
+  for ( int_type k = 0; k < W; ++k ) {
+    bool L = abs(a[k]) >= A_THRESOLD;
+    bool S = (abs(a[k]) < A_THRESOLD) & (abs(b[k]) <= B_SMALL_MAX);
+    nL += L ? 1 : 0;
+    nS += S ? 1 : 0;
+  }
+  for ( int_type j = 0; j < 3; ++j )
+    for ( int_type k = 0; k < W; ++k )
+      X[j][k] = Y[j][k] = 0;
+
+  if ( nL > 0 ) {
+    real_type aa[W], bb[W], XL[3][W], YL[3][W];
+    for ( int_type k = 0; k < W; ++k ) {
+      bool L = abs(a[k]) >= A_THRESOLD;
+      aa[k]  = L ? a[k] : 1;
+      bb[k]  = L ? b[k] : 0;
+    }
+    evalXYaLarge3_lanes( aa, bb, XL, YL );
+    for ( int_type j = 0; j < 3; ++j ) {
+      for ( int_type k = 0; k < W; ++k ) {
+        bool L = abs(a[k]) >= A_THRESOLD;
+        X[j][k] = L ? XL[j][k] : X[j][k];
+        Y[j][k] = L ? YL[j][k] : Y[j][k];
+      }
+    }
+  }
+
+  if ( nS > 0 ) {
+    real_type aa[W], bb[W], XS[3][W], YS[3][W];
+    for ( int_type k = 0; k < W; ++k ) {
+      bool S = (abs(a[k]) < A_THRESOLD) & (abs(b[k]) <= B_SMALL_MAX);
+      aa[k]  = S ? a[k] : 0;
+      bb[k]  = S ? b[k] : 0;
+    }
+    evalXYaSmall3_lanes( aa, bb, XS, YS );
+    for ( int_type j = 0; j < 3; ++j ) {
+      for ( int_type k = 0; k < W; ++k ) {
+        bool S = (abs(a[k]) < A_THRESOLD) & (abs(b[k]) <= B_SMALL_MAX);
+        X[j][k] = S ? XS[j][k] : X[j][k];
+        Y[j][k] = S ? YS[j][k] : Y[j][k];
+      }
+    }
+  }
+
+  if ( nL+nS < W ) {
+    for ( int_type k = 0; k < W; ++k ) {
+      if ( abs(a[k]) < A_THRESOLD && !( abs(b[k]) <= B_SMALL_MAX ) ) {
+        real_type XX[3], YY[3];
+        ::G2lib::evalXYaSmall( 3, a[k], b[k], A_SERIE_SIZE, XX, YY );
+        for ( int_type j = 0; j < 3; ++j ) { X[j][k] = XX[j]; Y[j][k] = YY[j]; }
+      }
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// entry points, the data are copied in local arrays of `W` lanes,
+// the tail is padded with dummy lanes
+
+static
+void
+FresnelCS_batch(
+  int_type        n,
+  real_type const x[],
+  real_type       C[],
+  real_type       S[]
+) {
+  real_type xx[W], CC[W], SS[W];
+  for ( int_type i = 0; i < n; i += W ) {
+    int_type m = min( W, n-i );
+    for ( int_type k = 0; k < W; ++k ) xx[k] = k < m ? x[i+k] : 0;
+    FresnelCS_lanes( xx, CC, SS );
+    for ( int_type k = 0; k < m; ++k ) { C[i+k] = CC[k]; S[i+k] = SS[k]; }
+  }
+}
+
+static
+void
+GeneralizedFresnelCS_batch(
+  int_type        n,
+  real_type const a[],
+  real_type const b[],
+  real_type       c,
+  real_type       intC[],
+  real_type       intS[]
+) {
+  real_type cosc = cos(c);
+  real_type sinc = sin(c);
+  real_type aa[W], bb[W], X[W], Y[W];
+  for ( int_type i = 0; i < n; i += W ) {
+    int_type m = min( W, n-i );
+    for ( int_type k = 0; k < W; ++k ) {
+      aa[k] = k < m ? a[i+k] : 0;
+      bb[k] = k < m ? b[i+k] : 0;
+    }
+    evalXY_lanes( aa, bb, X, Y );
+    for ( int_type k = 0; k < m; ++k ) {
+      intC[i+k] = X[k] * cosc - Y[k] * sinc;
+      intS[i+k] = X[k] * sinc + Y[k] * cosc;
+    }
+  }
+}
+
+// moments 0..nk-1 with a phase for each point,
+// the moment j of the point i is stored in intC[j*n+i], intS[j*n+i]
+static
+void
+GeneralizedFresnelCS_batch(
+  int_type        nk,
+  int_type        n,
+  real_type const a[],
+  real_type const b[],
+  real_type const c[],
+  real_type       intC[],
+  real_type       intS[]
+) {
+  real_type aa[W], bb[W], cc[W], sc[W], csc[W], X[3][W], Y[3][W];
+  for ( int_type i = 0; i < n; i += W ) {
+    int_type m = min( W, n-i );
+    for ( int_type k = 0; k < W; ++k ) {
+      aa[k] = k < m ? a[i+k] : 0;
+      bb[k] = k < m ? b[i+k] : 0;
+      cc[k] = k < m ? c[i+k] : 0;
+    }
+    if ( nk == 1 ) evalXY_lanes( aa, bb, X[0], Y[0] );
+    else           evalXY3_lanes( aa, bb, X, Y );
+    sincos_lanes( cc, sc, csc );
+    for ( int_type j = 0; j < nk; ++j ) {
+      for ( int_type k = 0; k < m; ++k ) {
+        intC[j*n+i+k] = X[j][k] * csc[k] - Y[j][k] * sc[k];
+        intS[j*n+i+k] = X[j][k] * sc[k]  + Y[j][k] * csc[k];
+      }
+    }
+  }
+}
+
+///
+/// eof: Fresnel_batch.hxx
+///
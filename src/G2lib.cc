@@ -21,6 +21,7 @@
 #include "PolynomialRoots.hh"
 
 #include <algorithm>
+#include <cstdint>
 
 #ifdef __clang__
 #pragma clang diagnostic ignored "-Wglobal-constructors"
@@ -89,6 +90,9 @@ namespace G2lib {
   using std::atan;
   using std::asin;
   using std::acos;
+  using std::ceil;
+  using std::min;
+  using std::max;
 
   real_type const machepsi     = numeric_limits<real_type>::epsilon();
   real_type const machepsi10   = 10*machepsi;
@@ -101,6 +105,7 @@ namespace G2lib {
   real_type const m_1_pi       = 0.318309886183790671537767526745; // 1/pi
   real_type const m_1_sqrt_pi  = 0.564189583547756286948079451561; // 1/sqrt(pi)
   bool            intersect_with_AABBtree = true;
+  bool            use_flat_AABBtree       = false;
 
   #ifdef G2LIB_COMPATIBILITY_MODE
   bool use_ISO = true;
@@ -884,6 +889,207 @@ namespace G2lib {
     y_DDD += offs * ny_DDD;
   }
 
+  /*\
+   |   _           _       _
+   |  | |__   __ _| |_ ___| |__
+   |  | '_ \ / _` | __/ __| '_ \
+   |  | |_) | (_| | || (__| | | |
+   |  |_.__/ \__,_|\__\___|_| |_|
+  \*/
+
+  void
+  BaseCurve::eval_batch(
+    real_type const s[],
+    int_type        n,
+    real_type       x[],
+    real_type       y[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) eval( s[i], x[i], y[i] );
+  }
+
+  void
+  BaseCurve::eval_batch_D(
+    real_type const s[],
+    int_type        n,
+    real_type       x_D[],
+    real_type       y_D[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) eval_D( s[i], x_D[i], y_D[i] );
+  }
+
+  void
+  BaseCurve::eval_batch_DD(
+    real_type const s[],
+    int_type        n,
+    real_type       x_DD[],
+    real_type       y_DD[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) eval_DD( s[i], x_DD[i], y_DD[i] );
+  }
+
+  void
+  BaseCurve::eval_batch_DDD(
+    real_type const s[],
+    int_type        n,
+    real_type       x_DDD[],
+    real_type       y_DDD[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) eval_DDD( s[i], x_DDD[i], y_DDD[i] );
+  }
+
+  // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+  void
+  BaseCurve::eval_batch_ISO(
+    real_type const s[],
+    int_type        n,
+    real_type       offs,
+    real_type       x[],
+    real_type       y[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) eval_ISO( s[i], offs, x[i], y[i] );
+  }
+
+  void
+  BaseCurve::eval_batch_ISO_D(
+    real_type const s[],
+    int_type        n,
+    real_type       offs,
+    real_type       x_D[],
+    real_type       y_D[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) eval_ISO_D( s[i], offs, x_D[i], y_D[i] );
+  }
+
+  void
+  BaseCurve::eval_batch_ISO_DD(
+    real_type const s[],
+    int_type        n,
+    real_type       offs,
+    real_type       x_DD[],
+    real_type       y_DD[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) eval_ISO_DD( s[i], offs, x_DD[i], y_DD[i] );
+  }
+
+  void
+  BaseCurve::eval_batch_ISO_DDD(
+    real_type const s[],
+    int_type        n,
+    real_type       offs,
+    real_type       x_DDD[],
+    real_type       y_DDD[]
+  ) const {
+    for ( int_type i = 0; i < n; ++i ) eval_ISO_DDD( s[i], offs, x_DDD[i], y_DDD[i] );
+  }
+
+  /*\
+   |                       _
+   |   ___  __ _ _ __ ___ | |_ __
+   |  / __|/ _` | '_ ` _ \| | '_ \
+   |  \__ \ (_| | | | | | | | |_) |
+   |  |___/\__,_|_| |_| |_|_| .__/
+   |                        |_|
+  \*/
+
+  // The offset curve P(s) = C(s) + offs*N(s) has P'' = k*(1-k*offs)*N - dk*offs*T,
+  // so on a step of length h the distance from the chord is bounded by
+  // (max|k|*max|1-k*offs|+|dk*offs|)*h^2/8 with the maxima taken on the step.
+  // `sample_step` is the longest step admissible for the bounds on [s,s+h].
+  static
+  inline
+  real_type
+  sample_step(
+    real_type tol8,
+    real_type k,
+    real_type dk,
+    real_type offs,
+    real_type h
+  ) {
+    real_type k1 = k+dk*h;
+    real_type K  = max( abs(k), abs(k1) );
+    real_type M  = max( abs(1-k*offs), abs(1-k1*offs) );
+    real_type KM = K*M+abs(dk*offs);
+    return KM > 0 ? sqrt(tol8/KM) : numeric_limits<real_type>::infinity();
+  }
+
+  void
+  BaseCurve::sample_piece_ISO(
+    real_type                s_begin,
+    real_type                L,
+    real_type                kappa0,
+    real_type                dk,
+    real_type                offs,
+    real_type                tol,
+    std::vector<real_type> & s
+  ) {
+    if ( L <= 0 ) return;
+    real_type const tol8  = 8*tol;
+    real_type const s_end = s_begin+L;
+    if ( dk == 0 ) {
+      // constant curvature: uniform steps, as many as the longest steps
+      real_type n = ceil( L/min( L, sample_step( tol8, kappa0, 0, offs, 0 ) ) );
+      G2LIB_ASSERT(
+        n < 100000000,
+        "BaseCurve::sample_ISO is generating too much points (>100000000)\n" <<
+        "tolerance tol = " << tol << " is too small"
+      )
+      int_type nn = int_type(n);
+      for ( int_type i = 1; i < nn; ++i ) s.push_back( s_begin+(L*i)/nn );
+      s.push_back( s_end );
+      return;
+    }
+    real_type ss = s_begin;
+    for ( int_type npts = 0; true; ++npts ) {
+      G2LIB_ASSERT(
+        npts < 100000000,
+        "BaseCurve::sample_ISO is generating too much points (>100000000)\n" <<
+        "tolerance tol = " << tol << " is too small"
+      )
+      real_type k   = kappa0+dk*(ss-s_begin);
+      real_type rem = s_end-ss;
+      // sample_step is decreasing in h, starting from h = rem the odd
+      // iterates are admissible and grow to the longest admissible step
+      real_type h = sample_step( tol8, k, dk, offs, rem );
+      if ( h >= rem ) break;
+      h   = sample_step( tol8, k, dk, offs, h );
+      h   = sample_step( tol8, k, dk, offs, h );
+      ss += h;
+      s.push_back( ss );
+    }
+    s.push_back( s_end );
+  }
+
+  void
+  BaseCurve::sample_ISO(
+    real_type      offs,
+    real_type      tol,
+    CurveSamples & S
+  ) const {
+    G2LIB_ASSERT(
+      tol > 0, "BaseCurve::sample_ISO, tol = " << tol << " must be positive"
+    )
+    S.s.clear();
+    S.s.push_back( 0 );
+    this->sample_stations_ISO( offs, tol, S.s );
+    size_t   n  = S.s.size();
+    int_type nn = int_type(n);
+    S.x.resize( n );
+    S.y.resize( n );
+    S.theta.resize( n );
+    S.kappa.resize( n );
+    real_type const * s = &S.s.front();
+    this->eval_batch_ISO( s, nn, offs, &S.x.front(), &S.y.front() );
+    for ( size_t i = 0; i < n; ++i ) {
+      real_type k = this->theta_D( s[i] );
+      real_type d = 1-k*offs; // zero at a cusp of the offset curve
+      if      ( d >= 0 && d <  machepsi ) d =  machepsi;
+      else if ( d <  0 && d > -machepsi ) d = -machepsi;
+      S.theta[i] = this->theta( s[i] );
+      S.kappa[i] = k/d; // curvature of the offset curve
+    }
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   /*\
@@ -935,6 +1141,23 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  #ifdef G2LIB_USE_CXX11
+
+  int_type &
+  findAtS_thread_hint( void const * pobj ) {
+    struct Hint { void const * pobj; int_type idx; };
+    static int_type const NHINTS = 32; // must be a power of 2
+    static thread_local Hint hints[NHINTS] = {};
+    std::uintptr_t key = reinterpret_cast<std::uintptr_t>(pobj);
+    Hint & H = hints[ ((key>>4)^(key>>9)) & (NHINTS-1) ];
+    if ( H.pobj != pobj ) { H.pobj = pobj; H.idx = 0; }
+    return H.idx;
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   updateInterval(
     int_type      & lastInterval,
@@ -971,6 +1194,29 @@ namespace G2lib {
     }
   }
 
+  /*\
+   |   __ _  _ _ _ ___ ___ _ _
+   |  / _| || | '_(_-</ _ \ '_|
+   |  \__|\_,_|_| /__/\___/_|
+  \*/
+
+  void
+  CurveCursor::setState( real_type s, real_type x, real_type y ) {
+    real_type t = s-p_begin;
+    cs     = s;
+    cx     = x;
+    cy     = y;
+    ck     = p_kappa+p_dk*t;
+    cth    = p_theta+t*(p_kappa+0.5*t*p_dk);
+    cos_th = cos(cth);
+    sin_th = sin(cth);
+    err_p  = err_d = 0;
+    a_s    = s;
+    a_x    = x;
+    a_y    = y;
+    h_ds   = -1;
+  }
+
 }
 
 // EOF: G2lib.cc
@@ -146,6 +146,7 @@ Authors:
 namespace G2lib {
 
   typedef std::basic_ostream<char> ostream_type;
+  typedef std::basic_istream<char> istream_type;
 
   void backtrace( ostream_type & );
 
@@ -163,6 +164,7 @@ namespace G2lib {
   extern real_type const m_1_pi;       //!< \f$ 1/\pi \f$
   extern real_type const m_1_sqrt_pi;  //!< \f$ 1/\sqrt{\pi} \f$
   extern bool            intersect_with_AABBtree;
+  extern bool            use_flat_AABBtree;
 
   #ifdef G2LIB_COMPATIBILITY_MODE
 
@@ -196,6 +198,20 @@ namespace G2lib {
   yesAABBtree()
   { intersect_with_AABBtree = true; }
 
+  //! use `AABBtreeFlat` (contiguous storage) in place of `AABBtree`
+  static
+  inline
+  void
+  yesFlatAABBtree()
+  { use_flat_AABBtree = true; }
+
+  //! use `AABBtree` (one allocation per node) in computation
+  static
+  inline
+  void
+  noFlatAABBtree()
+  { use_flat_AABBtree = false; }
+
   //! check if cloating point number `x` is zero
   static
   inline
@@ -519,6 +535,79 @@ namespace G2lib {
   typedef std::pair<real_type,real_type> Ipair;
   typedef std::vector<Ipair>             IntersectList;
 
+  /*!
+   *  Receives, one at a time, the intersections found by
+   *  `intersect_visit_ISO`: `(s1,s2)` are the curvilinear abscissa
+   *  of the intersection on the two curves.
+   *  `visit` returns `false` to stop the search.
+   */
+  class IntersectVisitor {
+  public:
+    virtual ~IntersectVisitor() {}
+    virtual bool visit( real_type s1, real_type s2 ) = 0;
+  };
+
+  //! append to `ilist` the first `k` intersections visited
+  class IntersectFirstK : public IntersectVisitor {
+    int_type        k;
+    int_type        n;
+    IntersectList & ilist;
+  public:
+    IntersectFirstK( int_type _k, IntersectList & il )
+    : k(_k), n(0), ilist(il)
+    {}
+
+    bool
+    visit( real_type s1, real_type s2 ) G2LIB_OVERRIDE {
+      ilist.push_back( Ipair( s1, s2 ) );
+      return ++n < k;
+    }
+  };
+
+  /*!
+   *  Pass to `V` only the intersections not already visited: those
+   *  nearer than `tol`, in both the abscissa, to a visited one are
+   *  dropped (the same crossing found by two candidates at the common
+   *  boundary of two triangles or segments).
+   */
+  class IntersectUnique : public IntersectVisitor {
+    IntersectVisitor & V;
+    real_type          tol;
+    IntersectList      done; // sorted by `s1`
+  public:
+    IntersectUnique( IntersectVisitor & _V, real_type _tol )
+    : V(_V), tol(_tol)
+    {}
+
+    bool visit( real_type s1, real_type s2 ) G2LIB_OVERRIDE;
+  };
+
+  /*!
+   *  Samples of a curve stored as structure of arrays, filled by
+   *  `BaseCurve::sample_ISO`. The vectors keep their capacity when the
+   *  object is reused, so sampling many curves does not reallocate.
+   */
+  class CurveSamples {
+  public:
+    std::vector<real_type> s;     //!< curvilinear abscissa on the curve
+    std::vector<real_type> x;     //!< x-coordinate of the (offset) curve
+    std::vector<real_type> y;     //!< y-coordinate of the (offset) curve
+    std::vector<real_type> theta; //!< tangent angle
+    std::vector<real_type> kappa; //!< curvature of the (offset) curve
+
+    void
+    clear()
+    { s.clear(); x.clear(); y.clear(); theta.clear(); kappa.clear(); }
+
+    void
+    reserve( size_t n ) {
+      s.reserve(n); x.reserve(n); y.reserve(n);
+      theta.reserve(n); kappa.reserve(n);
+    }
+
+    size_t size() const { return s.size(); }
+  };
+
   /*\
    |   _       _                          _
    |  (_)_ __ | |_ ___ _ __ ___  ___  ___| |_
@@ -659,6 +748,37 @@ namespace G2lib {
     intersect_ISO( C1, -offs_C1, C2, -offs_C2, ilist, swap_s_vals );
   }
 
+  /*!
+   * Stream the intersections of the two curves to `visitor`, stopping
+   * as soon as `visit` returns `false`.  The intersections are not
+   * collected in a list and the same crossing is visited once.
+   *
+   * \param[in]  C1      first curve
+   * \param[in]  offs_C1 offset of the first curve
+   * \param[in]  C2      second curve
+   * \param[in]  offs_C2 offset of the second curve
+   * \param[in]  visitor receives the intersections `(s1,s2)`
+   * \param[in]  ordered if true the intersections are visited by increasing `s1`
+   * \param[in]  tol     intersections nearer than `tol` (in `s1` and `s2`)
+   *                     to a visited one are dropped
+   * \return true if the search was stopped by the visitor
+   *
+   * With two `ClothoidList` the candidate pairs of triangles are refined
+   * while the AABB trees are traversed (or, with `ordered`, by increasing
+   * `s1`) and nothing is computed after the stop; with the other curves
+   * all the intersections are computed and then visited.
+   */
+  bool
+  intersect_visit_ISO(
+    BaseCurve const  & C1,
+    real_type          offs_C1,
+    BaseCurve const  & C2,
+    real_type          offs_C2,
+    IntersectVisitor & visitor,
+    bool               ordered = false,
+    real_type          tol     = 1e-8
+  );
+
   #ifdef G2LIB_COMPATIBILITY_MODE
   /*!
    * collect the intersections of the two curve
@@ -1462,6 +1582,221 @@ namespace G2lib {
     }
     #endif
 
+    /*\
+     |   _           _       _
+     |  | |__   __ _| |_ ___| |__
+     |  | '_ \ / _` | __/ __| '_ \
+     |  | |_) | (_| | || (__| | | |
+     |  |_.__/ \__,_|\__\___|_| |_|
+    \*/
+
+    /*!
+     *  Compute curve at the `n` positions `s[0..n-1]`.
+     *  The default implementation calls `eval` for each point,
+     *  derived classes override it with a faster kernel.
+     *  Performance is best when `s` is sorted in increasing order.
+     *
+     * \param[in]  s  parameters on the curve
+     * \param[in]  n  number of points
+     * \param[out] x  x-coordinates, `n` values
+     * \param[out] y  y-coordinates, `n` values
+     */
+
+    virtual
+    void
+    eval_batch(
+      real_type const s[],
+      int_type        n,
+      real_type       x[],
+      real_type       y[]
+    ) const;
+
+    virtual
+    void
+    eval_batch_D(
+      real_type const s[],
+      int_type        n,
+      real_type       x_D[],
+      real_type       y_D[]
+    ) const;
+
+    virtual
+    void
+    eval_batch_DD(
+      real_type const s[],
+      int_type        n,
+      real_type       x_DD[],
+      real_type       y_DD[]
+    ) const;
+
+    virtual
+    void
+    eval_batch_DDD(
+      real_type const s[],
+      int_type        n,
+      real_type       x_DDD[],
+      real_type       y_DDD[]
+    ) const;
+
+    /*!
+     *  Compute curve at the `n` positions `s[0..n-1]` with offset `offs`
+     *
+     * \param[in]  s     parameters on the curve
+     * \param[in]  n     number of points
+     * \param[in]  offs  offset of the curve
+     * \param[out] x     x-coordinates, `n` values
+     * \param[out] y     y-coordinates, `n` values
+     */
+
+    virtual
+    void
+    eval_batch_ISO(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x[],
+      real_type       y[]
+    ) const;
+
+    virtual
+    void
+    eval_batch_ISO_D(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_D[],
+      real_type       y_D[]
+    ) const;
+
+    virtual
+    void
+    eval_batch_ISO_DD(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_DD[],
+      real_type       y_DD[]
+    ) const;
+
+    virtual
+    void
+    eval_batch_ISO_DDD(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_DDD[],
+      real_type       y_DDD[]
+    ) const;
+
+    void
+    eval_batch_SAE(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x[],
+      real_type       y[]
+    ) const {
+      this->eval_batch_ISO( s, n, -offs, x, y );
+    }
+
+    void
+    eval_batch_SAE_D(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_D[],
+      real_type       y_D[]
+    ) const {
+      this->eval_batch_ISO_D( s, n, -offs, x_D, y_D );
+    }
+
+    void
+    eval_batch_SAE_DD(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_DD[],
+      real_type       y_DD[]
+    ) const {
+      this->eval_batch_ISO_DD( s, n, -offs, x_DD, y_DD );
+    }
+
+    void
+    eval_batch_SAE_DDD(
+      real_type const s[],
+      int_type        n,
+      real_type       offs,
+      real_type       x_DDD[],
+      real_type       y_DDD[]
+    ) const {
+      this->eval_batch_ISO_DDD( s, n, -offs, x_DDD, y_DDD );
+    }
+
+    /*\
+     |                       _
+     |   ___  __ _ _ __ ___ | |_ __
+     |  / __|/ _` | '_ ` _ \| | '_ \
+     |  \__ \ (_| | | | | | | | |_) |
+     |  |___/\__,_|_| |_| |_|_| .__/
+     |                        |_|
+    \*/
+
+    /*!
+     *  Sample the curve with offset `offs` so that the polyline through
+     *  the samples is at distance at most `tol` from the curve.
+     *  The steps are computed in closed form from a bound of the curvature
+     *  on each step, the sampler takes the longest admissible step so the
+     *  number of points is near to the minimum for the tolerance.
+     *  The first and last samples are the end points of the curve.
+     *
+     * \param[in]  offs offset of the curve
+     * \param[in]  tol  maximum distance between the curve and the chords
+     * \param[out] S    samples: `s`, `x`, `y`, `theta` and the curvature
+     *                  `kappa` of the offset curve
+     */
+    void
+    sample_ISO( real_type offs, real_type tol, CurveSamples & S ) const;
+
+    void
+    sample_SAE( real_type offs, real_type tol, CurveSamples & S ) const
+    { this->sample_ISO( -offs, tol, S ); }
+
+    /*!
+     *  Append to `s` the abscissae of the samples of `sample_ISO`
+     *  after the initial point `s = 0`.
+     *
+     * \param[in]  offs offset of the curve
+     * \param[in]  tol  maximum distance between the curve and the chords
+     * \param[out] s    abscissae of the samples
+     */
+    virtual
+    void
+    sample_stations_ISO(
+      real_type                offs,
+      real_type                tol,
+      std::vector<real_type> & s
+    ) const G2LIB_PURE_VIRTUAL;
+
+  protected:
+
+    /*!
+     *  Append to `s` the abscissae sampling a piece in `(s_begin,s_begin+L]`
+     *  with curvature `kappa0 + dk*(s-s_begin)`.
+     */
+    static
+    void
+    sample_piece_ISO(
+      real_type                s_begin,
+      real_type                L,
+      real_type                kappa0,
+      real_type                dk,
+      real_type                offs,
+      real_type                tol,
+      std::vector<real_type> & s
+    );
+
+  public:
+
     /*\
      |  _                        __
      | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -1569,6 +1904,19 @@ namespace G2lib {
       G2lib::intersect_SAE( *this, offs, C, offs_C, ilist, swap_s_vals );
     }
 
+    //! stream the intersections with `C` to `visitor` (see `G2lib::intersect_visit_ISO`)
+    bool
+    intersect_visit_ISO(
+      real_type          offs,
+      BaseCurve const  & C,
+      real_type          offs_C,
+      IntersectVisitor & visitor,
+      bool               ordered = false,
+      real_type          tol     = 1e-8
+    ) const {
+      return G2lib::intersect_visit_ISO( *this, offs, C, offs_C, visitor, ordered, tol );
+    }
+
     #ifdef G2LIB_COMPATIBILITY_MODE
     void
     intersect(
@@ -1882,6 +2230,42 @@ namespace G2lib {
     real_type       len[]
   );
 
+  /*\
+   |   _        _    _
+   |  | |_ __ _| |__| |___
+   |  |  _/ _` | '_ \ / -_)
+   |   \__\__,_|_.__/_\___|
+  \*/
+
+  /*!
+   *  Read a text table of numbers (e.g. written by `export_table`
+   *  or a CSV file) and append the first `ncol` numbers of each row
+   *  to the columns `cols[0]`, ..., `cols[ncol-1]`.
+   *  Numbers are separated by blanks, tabs, commas or semicolons,
+   *  empty rows and rows starting with `#` are skipped, as a first
+   *  row that is not a number (the header).
+   *  The stream is read by large chunks, each chunk is parsed
+   *  by `nthreads` threads.
+   *
+   *  \return the number of rows read
+   */
+  int_type
+  read_table(
+    istream_type           & stream,
+    int_type                 ncol,
+    std::vector<real_type>   cols[],
+    int_type                 nthreads = 1
+  );
+
+  //! read the points of a table with columns `x`, `y` (e.g. for `build_G1`)
+  int_type
+  read_points(
+    istream_type           & stream,
+    std::vector<real_type> & x,
+    std::vector<real_type> & y,
+    int_type                 nthreads = 1
+  );
+
   /*\
    |    __ _           _    _   _   ____
    |   / _(_)_ __   __| |  / \ | |_/ ___|
@@ -1897,6 +2281,179 @@ namespace G2lib {
     std::vector<real_type> const & s0
   );
 
+  #ifdef G2LIB_USE_CXX11
+  /*!
+   * Return the interval hint used by `findAtS` for the object `pobj`
+   * in the calling thread.  Hints live in a small thread local table,
+   * so concurrent searches on the same curve never take a lock.
+   * A stale or evicted entry is reset to 0 and costs only a longer search.
+   */
+  int_type &
+  findAtS_thread_hint( void const * pobj );
+  #endif
+
+  /*\
+   |   __ _  _ _ _ ___ ___ _ _
+   |  / _| || | '_(_-</ _ \ '_|
+   |  \__|\_,_|_| /__/\___/_|
+  \*/
+
+  /*!
+   *  Forward cursor on a curve made of pieces with linear curvature
+   *  (lines, arcs and clothoids).  Between two anchors the state
+   *  `(x,y,theta,kappa)` is advanced with a Taylor expansion of the
+   *  clothoid integral on the step, `theta` and `kappa` are exact.
+   *  A bound of the accumulated position error is kept and the cursor
+   *  is re-anchored to the exact value when the bound would exceed the
+   *  tolerance or a new piece is entered.
+   *  Derived classes locate the pieces of the curve in `anchor`.
+   */
+  class CurveCursor {
+
+    CurveCursor( CurveCursor const & );
+    CurveCursor const & operator = ( CurveCursor const & );
+
+    real_type a_s, a_x, a_y; // state at the last anchor
+
+    // coefficients of the last step, reused on arcs for steps of equal length
+    real_type h_ds, h_IC, h_IS, h_cr, h_sr, h_T4;
+
+    // the step is (x,y) += ds * exp(i*theta) * int_0^1 exp(i*phi(u)) du
+    // with phi(u) = a*u+b*u^2/2, the exponential is expanded to the third
+    // order and the remainder is bounded by T^4/24, T = max |phi|
+    void
+    stepCoeffs( real_type ds ) {
+      real_type a  = ck*ds;
+      real_type b  = p_dk*ds*ds;
+      real_type T  = std::abs(a)+0.5*std::abs(b);
+      real_type T2 = T*T;
+      // moments int_0^1 phi(u)^k du, k = 1,2,3
+      real_type a2 = a*a;
+      real_type b2 = b*b;
+      real_type m1 = 0.5*a+b*(1.0/6);
+      real_type m2 = a2*(1.0/3)+0.25*a*b+0.05*b2;
+      real_type m3 = a*(0.25*a2+0.125*b2)+b*(0.3*a2+b2*(1.0/56));
+      // rotation of the tangent by phi(1)
+      real_type p  = a+0.5*b;
+      real_type p2 = p*p;
+      h_ds = ds;
+      h_T4 = T2*T2*(1.0/24);
+      h_IC = 1-0.5*m2;
+      h_IS = m1-m3*(1.0/6);
+      h_cr = 1-0.5*p2*(1-p2*(1.0/12));
+      h_sr = p*(1-p2*(1.0/6));
+    }
+
+  protected:
+
+    real_type tol;     //!< maximum position error
+    real_type p_begin; //!< curvilinear abscissa of the start of the piece
+    real_type p_end;   //!< curvilinear abscissa of the end of the piece
+    real_type p_theta; //!< angle at the start of the piece
+    real_type p_kappa; //!< curvature at the start of the piece
+    real_type p_dk;    //!< curvature derivative of the piece
+
+    real_type cs, cx, cy, cth, ck; // state
+    real_type cos_th, sin_th;      // cos(cth), sin(cth) by recurrence
+    real_type err_p, err_d;        // bound of position and direction error
+
+    /*!
+     *  Set the piece containing `s`, the state at `s` is computed exactly.
+     *  Implementations call `setPiece` and `setState`.
+     */
+    virtual void anchor( real_type s ) = 0;
+
+    void
+    setPiece(
+      real_type s_begin,
+      real_type s_end,
+      real_type theta0,
+      real_type kappa0,
+      real_type dk
+    ) {
+      p_begin = s_begin;
+      p_end   = s_end;
+      p_theta = theta0;
+      p_kappa = kappa0;
+      p_dk    = dk;
+    }
+
+    void setState( real_type s, real_type x, real_type y );
+
+  public:
+
+    explicit
+    CurveCursor( real_type _tol )
+    : a_s(0), a_x(0), a_y(0)
+    , h_ds(-1), h_IC(1), h_IS(0), h_cr(1), h_sr(0), h_T4(0)
+    , tol(_tol)
+    , p_begin(0)
+    , p_end(0)
+    , p_theta(0)
+    , p_kappa(0)
+    , p_dk(0)
+    , cs(0), cx(0), cy(0), cth(0), ck(0)
+    , cos_th(1), sin_th(0)
+    , err_p(0), err_d(0)
+    {}
+
+    virtual ~CurveCursor() {}
+
+    //! move the cursor forward by `ds`, a negative step re-anchors
+    void
+    advance( real_type ds ) {
+      real_type s1 = cs+ds;
+      if ( ds < 0 || s1 >= p_end ) { this->anchor( s1 ); return; }
+      if ( p_dk == 0 ) {
+        if ( p_kappa == 0 ) {
+          // straight piece, exact from the anchor
+          real_type t = s1-a_s;
+          cs = s1;
+          cx = a_x+t*cos_th;
+          cy = a_y+t*sin_th;
+          return;
+        }
+        if ( ds != h_ds ) this->stepCoeffs( ds );
+      } else {
+        this->stepCoeffs( ds );
+      }
+      real_type ep = err_p + ds*(err_d+h_T4) +
+                     machepsi*(std::abs(cx)+std::abs(cy)+ds);
+      if ( ep > tol ) { this->anchor( s1 ); return; }
+
+      cx += ds*(cos_th*h_IC-sin_th*h_IS);
+      cy += ds*(sin_th*h_IC+cos_th*h_IS);
+      real_type c = cos_th*h_cr-sin_th*h_sr;
+      sin_th = sin_th*h_cr+cos_th*h_sr;
+      cos_th = c;
+      err_d += h_T4+4*machepsi;
+      err_p  = ep;
+
+      real_type t = s1-p_begin;
+      cs  = s1;
+      ck  = p_kappa+p_dk*t;
+      cth = p_theta+t*(p_kappa+0.5*t*p_dk);
+    }
+
+    //! move the cursor to the curvilinear abscissa `s`
+    void moveTo( real_type s ) { this->advance( s - cs ); }
+
+    //! move the cursor to `s` and evaluate the curve exactly
+    void reset( real_type s ) { this->anchor( s ); }
+
+    real_type s()     const { return cs; }  //!< curvilinear abscissa
+    real_type x()     const { return cx; }  //!< x-coordinate
+    real_type y()     const { return cy; }  //!< y-coordinate
+    real_type theta() const { return cth; } //!< tangent angle
+    real_type kappa() const { return ck; }  //!< curvature
+
+    //! bound of the position error of the current state
+    real_type error() const { return err_p; }
+
+    //! maximum position error
+    real_type tolerance() const { return tol; }
+  };
+
 }
 
 #endif
@@ -26,7 +26,6 @@
 #include "BiarcList.hh"
 #include "ClothoidList.hh"
 
-#include <map>
 #include <algorithm>
 
 #ifdef __clang__
@@ -36,9 +35,6 @@
 
 namespace G2lib {
 
-  using std::map;
-  using std::pair;
-
   using std::numeric_limits;
   using std::fpclassify;
   using std::lower_bound;
@@ -53,182 +49,176 @@ namespace G2lib {
    |  |_|_| |_|\__\___|_|  |___/\___|\___|\__|
   \*/
 
-  typedef pair<CurveType,CurveType> Ppair;
-
-  // check if compiler is C++11
-  #ifdef G2LIB_USE_CXX11
-  static map<Ppair,CurveType> const promote_map = {
-    {Ppair( G2LIB_LINE, G2LIB_LINE ),          G2LIB_LINE},
-    {Ppair( G2LIB_LINE, G2LIB_CIRCLE ),        G2LIB_CIRCLE},
-    {Ppair( G2LIB_LINE, G2LIB_CLOTHOID ),      G2LIB_CLOTHOID},
-    {Ppair( G2LIB_LINE, G2LIB_BIARC ),         G2LIB_BIARC_LIST},
-    {Ppair( G2LIB_LINE, G2LIB_BIARC_LIST ),    G2LIB_BIARC_LIST},
-    {Ppair( G2LIB_LINE, G2LIB_CLOTHOID_LIST ), G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_LINE, G2LIB_POLYLINE ),      G2LIB_POLYLINE},
+  // the type used for the computation with two curves: both the curves
+  // are converted to this type (if they are not already of this type),
+  // indexed with `CurveType`
+  static CurveType const promote_table[7][7] = {
+    // LINE, POLYLINE, CIRCLE, BIARC, BIARC_LIST, CLOTHOID, CLOTHOID_LIST
+    { G2LIB_LINE, G2LIB_POLYLINE, G2LIB_CIRCLE, G2LIB_BIARC_LIST,
+      G2LIB_BIARC_LIST, G2LIB_CLOTHOID, G2LIB_CLOTHOID_LIST }, // LINE
+    { G2LIB_POLYLINE, G2LIB_POLYLINE, G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST,
+      G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST }, // POLYLINE
+    { G2LIB_CIRCLE, G2LIB_CLOTHOID_LIST, G2LIB_CIRCLE, G2LIB_BIARC_LIST,
+      G2LIB_BIARC_LIST, G2LIB_CLOTHOID, G2LIB_CLOTHOID_LIST }, // CIRCLE
+    { G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST, G2LIB_BIARC,
+      G2LIB_BIARC_LIST, G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST }, // BIARC
+    { G2LIB_BIARC_LIST, G2LIB_CLOTHOID_LIST, G2LIB_BIARC_LIST, G2LIB_BIARC_LIST,
+      G2LIB_BIARC_LIST, G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST }, // BIARC_LIST
+    { G2LIB_CLOTHOID, G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID, G2LIB_CLOTHOID_LIST,
+      G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID, G2LIB_CLOTHOID_LIST }, // CLOTHOID
+    { G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST,
+      G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST } // CLOTHOID_LIST
+  };
 
-    {Ppair( G2LIB_CIRCLE, G2LIB_LINE ),          G2LIB_CIRCLE},
-    {Ppair( G2LIB_CIRCLE, G2LIB_CIRCLE ),        G2LIB_CIRCLE},
-    {Ppair( G2LIB_CIRCLE, G2LIB_CLOTHOID ),      G2LIB_CLOTHOID},
-    {Ppair( G2LIB_CIRCLE, G2LIB_BIARC ),         G2LIB_BIARC_LIST},
-    {Ppair( G2LIB_CIRCLE, G2LIB_BIARC_LIST ),    G2LIB_BIARC_LIST},
-    {Ppair( G2LIB_CIRCLE, G2LIB_CLOTHOID_LIST ), G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_CIRCLE, G2LIB_POLYLINE ),      G2LIB_CLOTHOID_LIST},
+  static
+  inline
+  CurveType
+  promote( BaseCurve const & obj1, BaseCurve const & obj2 ) {
+    #ifdef DEBUG
+    std::cout
+      << CurveType_name[obj1.type()]
+      << " with " << CurveType_name[obj2.type()]
+      << " using " << CurveType_name[promote_table[obj1.type()][obj2.type()]]
+      << '\n';
+    #endif
+    return promote_table[obj1.type()][obj2.type()];
+  }
 
-    {Ppair( G2LIB_BIARC, G2LIB_LINE ),          G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_BIARC, G2LIB_CIRCLE ),        G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_BIARC, G2LIB_CLOTHOID ),      G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_BIARC, G2LIB_BIARC ),         G2LIB_BIARC},
-    {Ppair( G2LIB_BIARC, G2LIB_BIARC_LIST ),    G2LIB_BIARC_LIST},
-    {Ppair( G2LIB_BIARC, G2LIB_CLOTHOID_LIST ), G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_BIARC, G2LIB_POLYLINE ),      G2LIB_CLOTHOID_LIST},
+  // Call `op( C1, C2 )` with the two curves as `CURVE`.
+  // A curve already of type `CURVE` is passed as it is (no copy, its
+  // AABB trees are used and kept), only the other one is converted.
+  template <typename CURVE, typename OP>
+  static
+  inline
+  void
+  dispatch(
+    CurveType         type,
+    BaseCurve const & obj1,
+    BaseCurve const & obj2,
+    OP              & op
+  ) {
+    if ( obj1.type() == type ) {
+      CURVE const & C1 = static_cast<CURVE const &>(obj1);
+      if ( obj2.type() == type ) {
+        op( C1, static_cast<CURVE const &>(obj2) );
+      } else {
+        CURVE C2( obj2 );
+        op( C1, C2 );
+      }
+    } else {
+      CURVE C1( obj1 );
+      if ( obj2.type() == type ) {
+        op( C1, static_cast<CURVE const &>(obj2) );
+      } else {
+        CURVE C2( obj2 );
+        op( C1, C2 );
+      }
+    }
+  }
 
-    {Ppair( G2LIB_CLOTHOID, G2LIB_LINE ),          G2LIB_CLOTHOID},
-    {Ppair( G2LIB_CLOTHOID, G2LIB_CIRCLE ),        G2LIB_CLOTHOID},
-    {Ppair( G2LIB_CLOTHOID, G2LIB_CLOTHOID ),      G2LIB_CLOTHOID},
-    {Ppair( G2LIB_CLOTHOID, G2LIB_BIARC ),         G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_CLOTHOID, G2LIB_BIARC_LIST ),    G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_CLOTHOID, G2LIB_CLOTHOID_LIST ), G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_CLOTHOID, G2LIB_POLYLINE ),      G2LIB_CLOTHOID_LIST},
+  template <typename OP>
+  static
+  void
+  dispatch( BaseCurve const & obj1, BaseCurve const & obj2, OP & op ) {
+    CurveType type = promote( obj1, obj2 );
+    switch ( type ) {
+    case G2LIB_LINE:          dispatch<LineSegment>( type, obj1, obj2, op );   break;
+    case G2LIB_CIRCLE:        dispatch<CircleArc>( type, obj1, obj2, op );     break;
+    case G2LIB_CLOTHOID:      dispatch<ClothoidCurve>( type, obj1, obj2, op ); break;
+    case G2LIB_BIARC:         dispatch<Biarc>( type, obj1, obj2, op );         break;
+    case G2LIB_BIARC_LIST:    dispatch<BiarcList>( type, obj1, obj2, op );     break;
+    case G2LIB_CLOTHOID_LIST: dispatch<ClothoidList>( type, obj1, obj2, op );  break;
+    case G2LIB_POLYLINE:      dispatch<PolyLine>( type, obj1, obj2, op );      break;
+    }
+  }
 
-    {Ppair( G2LIB_CLOTHOID_LIST, G2LIB_LINE ),          G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_CLOTHOID_LIST, G2LIB_CIRCLE ),        G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID ),      G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_CLOTHOID_LIST, G2LIB_BIARC ),         G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_CLOTHOID_LIST, G2LIB_BIARC_LIST ),    G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST ), G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_CLOTHOID_LIST, G2LIB_POLYLINE ),      G2LIB_CLOTHOID_LIST},
+  // the operations on the promoted curves
 
-    {Ppair( G2LIB_POLYLINE, G2LIB_LINE ),          G2LIB_POLYLINE},
-    {Ppair( G2LIB_POLYLINE, G2LIB_CIRCLE ),        G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_POLYLINE, G2LIB_CLOTHOID ),      G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_POLYLINE, G2LIB_BIARC ),         G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_POLYLINE, G2LIB_BIARC_LIST ),    G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_POLYLINE, G2LIB_CLOTHOID_LIST ), G2LIB_CLOTHOID_LIST},
-    {Ppair( G2LIB_POLYLINE, G2LIB_POLYLINE ),      G2LIB_POLYLINE}
-  };
-  #else
-    static map<Ppair,CurveType> promote_map;
-    static
+  class op_collision {
+  public:
+    bool ok;
+    op_collision() : ok(false) {}
+    template <typename CURVE>
     void
-    init_promote_map() {
-      static bool done = false;
-      if ( done ) return;
-      promote_map[ Ppair( G2LIB_LINE, G2LIB_LINE ) ]          = G2LIB_LINE;
-      promote_map[ Ppair( G2LIB_LINE, G2LIB_CIRCLE ) ]        = G2LIB_CIRCLE;
-      promote_map[ Ppair( G2LIB_LINE, G2LIB_CLOTHOID ) ]      = G2LIB_CLOTHOID;
-      promote_map[ Ppair( G2LIB_LINE, G2LIB_BIARC ) ]         = G2LIB_BIARC_LIST;
-      promote_map[ Ppair( G2LIB_LINE, G2LIB_BIARC_LIST ) ]    = G2LIB_BIARC_LIST;
-      promote_map[ Ppair( G2LIB_LINE, G2LIB_CLOTHOID_LIST ) ] = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_LINE, G2LIB_POLYLINE ) ]      = G2LIB_POLYLINE;
-
-      promote_map[ Ppair( G2LIB_CIRCLE, G2LIB_LINE ) ]          = G2LIB_CIRCLE;
-      promote_map[ Ppair( G2LIB_CIRCLE, G2LIB_CIRCLE ) ]        = G2LIB_CIRCLE;
-      promote_map[ Ppair( G2LIB_CIRCLE, G2LIB_CLOTHOID ) ]      = G2LIB_CLOTHOID;
-      promote_map[ Ppair( G2LIB_CIRCLE, G2LIB_BIARC ) ]         = G2LIB_BIARC_LIST;
-      promote_map[ Ppair( G2LIB_CIRCLE, G2LIB_BIARC_LIST ) ]    = G2LIB_BIARC_LIST;
-      promote_map[ Ppair( G2LIB_CIRCLE, G2LIB_CLOTHOID_LIST ) ] = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_CIRCLE, G2LIB_POLYLINE ) ]      = G2LIB_CLOTHOID_LIST;
+    operator () ( CURVE const & C1, CURVE const & C2 )
+    { ok = C1.collision( C2 ); }
+  };
 
-      promote_map[ Ppair( G2LIB_BIARC, G2LIB_LINE ) ]          = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_BIARC, G2LIB_CIRCLE ) ]        = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_BIARC, G2LIB_CLOTHOID ) ]      = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_BIARC, G2LIB_BIARC ) ]         = G2LIB_BIARC;
-      promote_map[ Ppair( G2LIB_BIARC, G2LIB_BIARC_LIST ) ]    = G2LIB_BIARC_LIST;
-      promote_map[ Ppair( G2LIB_BIARC, G2LIB_CLOTHOID_LIST ) ] = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_BIARC, G2LIB_POLYLINE ) ]      = G2LIB_CLOTHOID_LIST;
+  class op_collision_ISO {
+    real_type offs1, offs2;
+  public:
+    bool ok;
+    op_collision_ISO( real_type o1, real_type o2 )
+    : offs1(o1), offs2(o2), ok(false) {}
+    template <typename CURVE>
+    void
+    operator () ( CURVE const & C1, CURVE const & C2 )
+    { ok = C1.collision_ISO( offs1, C2, offs2 ); }
+  };
 
-      promote_map[ Ppair( G2LIB_CLOTHOID, G2LIB_LINE ) ]          = G2LIB_CLOTHOID;
-      promote_map[ Ppair( G2LIB_CLOTHOID, G2LIB_CIRCLE ) ]        = G2LIB_CLOTHOID;
-      promote_map[ Ppair( G2LIB_CLOTHOID, G2LIB_CLOTHOID ) ]      = G2LIB_CLOTHOID;
-      promote_map[ Ppair( G2LIB_CLOTHOID, G2LIB_BIARC ) ]         = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_CLOTHOID, G2LIB_BIARC_LIST ) ]    = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_CLOTHOID, G2LIB_CLOTHOID_LIST ) ] = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_CLOTHOID, G2LIB_POLYLINE ) ]      = G2LIB_CLOTHOID_LIST;
+  class op_intersect {
+    IntersectList & ilist;
+    bool            swap_s_vals;
+  public:
+    op_intersect( IntersectList & il, bool sw )
+    : ilist(il), swap_s_vals(sw) {}
+    template <typename CURVE>
+    void
+    operator () ( CURVE const & C1, CURVE const & C2 )
+    { C1.intersect( C2, ilist, swap_s_vals ); }
+  };
 
-      promote_map[ Ppair( G2LIB_CLOTHOID_LIST, G2LIB_LINE ) ]          = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_CLOTHOID_LIST, G2LIB_CIRCLE ) ]        = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID ) ]      = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_CLOTHOID_LIST, G2LIB_BIARC ) ]         = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_CLOTHOID_LIST, G2LIB_BIARC_LIST ) ]    = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_CLOTHOID_LIST, G2LIB_CLOTHOID_LIST ) ] = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_CLOTHOID_LIST, G2LIB_POLYLINE ) ]      = G2LIB_CLOTHOID_LIST;
+  class op_intersect_ISO {
+    real_type       offs1, offs2;
+    IntersectList & ilist;
+    bool            swap_s_vals;
+  public:
+    op_intersect_ISO( real_type o1, real_type o2, IntersectList & il, bool sw )
+    : offs1(o1), offs2(o2), ilist(il), swap_s_vals(sw) {}
+    template <typename CURVE>
+    void
+    operator () ( CURVE const & C1, CURVE const & C2 )
+    { C1.intersect_ISO( offs1, C2, offs2, ilist, swap_s_vals ); }
+  };
 
-      promote_map[ Ppair( G2LIB_POLYLINE, G2LIB_LINE ) ]          = G2LIB_POLYLINE;
-      promote_map[ Ppair( G2LIB_POLYLINE, G2LIB_CIRCLE ) ]        = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_POLYLINE, G2LIB_CLOTHOID ) ]      = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_POLYLINE, G2LIB_BIARC ) ]         = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_POLYLINE, G2LIB_BIARC_LIST ) ]    = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_POLYLINE, G2LIB_CLOTHOID_LIST ) ] = G2LIB_CLOTHOID_LIST;
-      promote_map[ Ppair( G2LIB_POLYLINE, G2LIB_POLYLINE ) ]      = G2LIB_POLYLINE;
-      done = true;
+  class op_intersect_visit_ISO {
+    real_type          offs1, offs2;
+    IntersectVisitor & visitor;
+    bool               ordered;
+    real_type          tol;
+  public:
+    bool stopped;
+    op_intersect_visit_ISO(
+      real_type o1, real_type o2, IntersectVisitor & v, bool ord, real_type t
+    )
+    : offs1(o1), offs2(o2), visitor(v), ordered(ord), tol(t), stopped(false) {}
+
+    // the intersections are computed, then visited
+    template <typename CURVE>
+    void
+    operator () ( CURVE const & C1, CURVE const & C2 ) {
+      IntersectList ilist;
+      C1.intersect_ISO( offs1, C2, offs2, ilist, false );
+      if ( ordered ) std::sort( ilist.begin(), ilist.end() );
+      IntersectUnique V( visitor, tol );
+      IntersectList::const_iterator it;
+      for ( it = ilist.begin(); it != ilist.end() && !stopped; ++it )
+        stopped = !V.visit( it->first, it->second );
     }
-  #endif
+
+    // streamed while the AABB trees are traversed
+    void
+    operator () ( ClothoidList const & C1, ClothoidList const & C2 )
+    { stopped = C1.intersect_visit_ISO( offs1, C2, offs2, visitor, ordered, tol ); }
+  };
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   bool
   collision( BaseCurve const & obj1, BaseCurve const & obj2 ) {
-    #ifdef DEBUG
-    std::cout
-      << "collision " << CurveType_name[obj1.type()]
-      << " with " << CurveType_name[obj2.type()]
-      << " using " << CurveType_name[promote_map.at(Ppair(obj1.type(),obj2.type()))]
-      << '\n';
-    #endif
-
-    bool ok = false;
-    switch ( promote_map.at(Ppair(obj1.type(),obj2.type())) ) {
-    case G2LIB_LINE:
-      {
-        LineSegment L1( obj1 );
-        LineSegment L2( obj2 );
-        ok = L1.collision( L2 );
-      }
-      break;
-    case G2LIB_CIRCLE:
-      {
-        CircleArc C1( obj1 );
-        CircleArc C2( obj2 );
-        ok = C1.collision( C2 );
-      }
-      break;
-    case G2LIB_CLOTHOID:
-      {
-        ClothoidCurve C1( obj1 );
-        ClothoidCurve C2( obj2 );
-        ok = C1.collision( C2 );
-      }
-      break;
-    case G2LIB_BIARC:
-      {
-        Biarc B1( obj1 );
-        Biarc B2( obj2 );
-        ok = B1.collision( B2 );
-      }
-      break;
-    case G2LIB_BIARC_LIST:
-      {
-        BiarcList BL1( obj1 );
-        BiarcList BL2( obj2 );
-        ok = BL1.collision( BL2 );
-      }
-      break;
-    case G2LIB_CLOTHOID_LIST:
-      {
-        ClothoidList CL1( obj1 );
-        ClothoidList CL2( obj2 );
-        ok = CL1.collision( CL2 );
-      }
-      break;
-    case G2LIB_POLYLINE:
-      {
-        PolyLine PL1( obj1 );
-        PolyLine PL2( obj2 );
-        ok = PL1.collision( PL2 );
-      }
-      break;
-    }
-    return ok;
+    op_collision op;
+    dispatch( obj1, obj2, op );
+    return op.ok;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -240,70 +230,9 @@ namespace G2lib {
     BaseCurve const & obj2,
     real_type         offs2
   ) {
-    #ifndef G2LIB_USE_CXX11
-    init_promote_map();
-    #endif
-
-    #ifdef DEBUG
-    std::cout
-      << "collision (offs) " << CurveType_name[obj1.type()]
-      << " with " << CurveType_name[obj2.type()]
-      << " using " << CurveType_name[promote_map.at(Ppair(obj1.type(),obj2.type()))]
-      << '\n';
-    #endif
-
-    bool ok = false;
-    switch ( promote_map.at(Ppair(obj1.type(),obj2.type())) ) {
-    case G2LIB_LINE:
-      {
-        LineSegment L1( obj1 );
-        LineSegment L2( obj2 );
-        ok = L1.collision_ISO( offs1, L2, offs2 );
-      }
-      break;
-    case G2LIB_CIRCLE:
-      {
-        CircleArc C1( obj1 );
-        CircleArc C2( obj2 );
-        ok = C1.collision_ISO( offs1, C2, offs2 );
-      }
-      break;
-    case G2LIB_CLOTHOID:
-      {
-        ClothoidCurve C1( obj1 );
-        ClothoidCurve C2( obj2 );
-        ok = C1.collision_ISO( offs1, C2, offs2 );
-      }
-      break;
-    case G2LIB_BIARC:
-      {
-        Biarc B1( obj1 );
-        Biarc B2( obj2 );
-        ok = B1.collision_ISO( offs1, B2, offs2 );
-      }
-      break;
-    case G2LIB_BIARC_LIST:
-      {
-        BiarcList BL1( obj1 );
-        BiarcList BL2( obj2 );
-        ok = BL1.collision_ISO( offs1, BL2, offs2 );
-      }
-      break;
-    case G2LIB_CLOTHOID_LIST:
-      {
-        ClothoidList CL1( obj1 );
-        ClothoidList CL2( obj2 );
-        ok = CL1.collision_ISO( offs1, CL2, offs2 );
-      }
-      break;
-    case G2LIB_POLYLINE:
-      {
-        PolyLine PL1( obj1 );
-        PolyLine PL2( obj2 );
-        ok = PL1.collision_ISO( offs1, PL2, offs2 );
-      }
-    }
-    return ok;
+    op_collision_ISO op( offs1, offs2 );
+    dispatch( obj1, obj2, op );
+    return op.ok;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -315,69 +244,8 @@ namespace G2lib {
     IntersectList   & ilist,
     bool              swap_s_vals
   ) {
-    #ifndef G2LIB_USE_CXX11
-    init_promote_map();
-    #endif
-
-    #ifdef DEBUG
-    std::cout
-      << "intersect " << CurveType_name[obj1.type()]
-      << " with " << CurveType_name[obj2.type()]
-      << " using " << CurveType_name[promote_map.at(Ppair(obj1.type(),obj2.type()))]
-      << '\n';
-    #endif
-
-    switch ( promote_map.at(Ppair(obj1.type(),obj2.type())) ) {
-    case G2LIB_LINE:
-      {
-        LineSegment L1( obj1 );
-        LineSegment L2( obj2 );
-        L1.intersect( L2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_CIRCLE:
-      {
-        CircleArc C1( obj1 );
-        CircleArc C2( obj2 );
-        C1.intersect( C2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_CLOTHOID:
-      {
-        ClothoidCurve C1( obj1 );
-        ClothoidCurve C2( obj2 );
-        C1.intersect( C2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_BIARC:
-      {
-        Biarc B1( obj1 );
-        Biarc B2( obj2 );
-        B1.intersect( B2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_BIARC_LIST:
-      {
-        BiarcList BL1( obj1 );
-        BiarcList BL2( obj2 );
-        BL1.intersect( BL2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_CLOTHOID_LIST:
-      {
-        ClothoidList CL1( obj1 );
-        ClothoidList CL2( obj2 );
-        CL1.intersect( CL2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_POLYLINE:
-      {
-        PolyLine PL1( obj1 );
-        PolyLine PL2( obj2 );
-        PL1.intersect( PL2, ilist, swap_s_vals );
-      }
-      break;
-    }
+    op_intersect op( ilist, swap_s_vals );
+    dispatch( obj1, obj2, op );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -391,69 +259,38 @@ namespace G2lib {
     IntersectList   & ilist,
     bool              swap_s_vals
   ) {
-    #ifndef G2LIB_USE_CXX11
-    init_promote_map();
-    #endif
+    op_intersect_ISO op( offs1, offs2, ilist, swap_s_vals );
+    dispatch( obj1, obj2, op );
+  }
 
-    #ifdef DEBUG
-    std::cout
-      << "intersect (offs) " << CurveType_name[obj1.type()]
-      << " with " << CurveType_name[obj2.type()]
-      << " using " << CurveType_name[promote_map.at(Ppair(obj1.type(),obj2.type()))]
-      << '\n';
-    #endif
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-    switch ( promote_map.at(Ppair(obj1.type(),obj2.type())) ) {
-    case G2LIB_LINE:
-      {
-        LineSegment L1( obj1 );
-        LineSegment L2( obj2 );
-        L1.intersect_ISO( offs1, L2, offs2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_CIRCLE:
-      {
-        CircleArc C1( obj1 );
-        CircleArc C2( obj2 );
-        C1.intersect_ISO( offs1, C2, offs2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_CLOTHOID:
-      {
-        ClothoidCurve C1( obj1 );
-        ClothoidCurve C2( obj2 );
-        C1.intersect_ISO( offs1, C2, offs2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_BIARC:
-      {
-        Biarc B1( obj1 );
-        Biarc B2( obj2 );
-        B1.intersect_ISO( offs1, B2, offs2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_BIARC_LIST:
-      {
-        BiarcList BL1( obj1 );
-        BiarcList BL2( obj2 );
-        BL1.intersect_ISO( offs1, BL2, offs2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_CLOTHOID_LIST:
-      {
-        ClothoidList CL1( obj1 );
-        ClothoidList CL2( obj2 );
-        CL1.intersect_ISO( offs1, CL2, offs2, ilist, swap_s_vals );
-      }
-      break;
-    case G2LIB_POLYLINE:
-      {
-        PolyLine PL1( obj1 );
-        PolyLine PL2( obj2 );
-        PL1.intersect_ISO( offs1, PL2, offs2, ilist, swap_s_vals );
-      }
-      break;
-    }
+  bool
+  intersect_visit_ISO(
+    BaseCurve const  & obj1,
+    real_type          offs1,
+    BaseCurve const  & obj2,
+    real_type          offs2,
+    IntersectVisitor & visitor,
+    bool               ordered,
+    real_type          tol
+  ) {
+    op_intersect_visit_ISO op( offs1, offs2, visitor, ordered, tol );
+    dispatch( obj1, obj2, op );
+    return op.stopped;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  IntersectUnique::visit( real_type s1, real_type s2 ) {
+    IntersectList::iterator it = lower_bound(
+      done.begin(), done.end(), Ipair( s1-tol, -numeric_limits<real_type>::infinity() )
+    );
+    for ( IntersectList::const_iterator jt = it; jt != done.end() && jt->first <= s1+tol; ++jt )
+      if ( abs( jt->second-s2 ) <= tol ) return true; // already visited
+    done.insert( lower_bound( it, done.end(), Ipair( s1, s2 ) ), Ipair( s1, s2 ) );
+    return V.visit( s1, s2 );
   }
 }
 
@@ -0,0 +1,328 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "G2lib.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+
+namespace G2lib {
+
+  using std::vector;
+  using std::strtod;
+
+  /*\
+   |   _        _    _
+   |  | |_ __ _| |__| |___
+   |  |  _/ _` | '_ \ / -_)
+   |   \__\__,_|_.__/_\___|
+  \*/
+
+  // powers of ten exactly representable as double
+  static real_type const exact_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+
+  static
+  inline
+  bool
+  is_blank( char c )
+  { return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r'; }
+
+  static
+  inline
+  bool
+  is_digit( char c )
+  { return c >= '0' && c <= '9'; }
+
+  /*
+   *  Parse the number at `p`, return the first character after it
+   *  (`p` if there is no number).  The text must be terminated by a
+   *  character that is not part of a number (a newline or a zero).
+   *  Numbers with at most 19 significant digits, mantissa up to 2^53
+   *  and exponent in [-22,22] are converted exactly by a single
+   *  multiplication or division (Clinger fast path), e.g. all the
+   *  numbers written with the default precision of the streams;
+   *  the others are converted by `strtod`.
+   */
+  static
+  char const *
+  parse_real( char const * p, real_type & v ) {
+    char const * p0  = p;
+    bool         neg = false;
+    if      ( *p == '-' ) { neg = true; ++p; }
+    else if ( *p == '+' ) ++p;
+
+    uint64_t m       = 0;
+    int_type nd      = 0;     // significant digits in `m`
+    int_type e10     = 0;
+    bool     digits  = false;
+    bool     dropped = false; // significant digits not in `m`
+    for (; is_digit(*p); ++p ) {
+      digits = true;
+      if ( nd < 19 ) {
+        m = 10*m + uint64_t(*p-'0');
+        if ( m > 0 ) ++nd;
+      } else {
+        ++e10;
+        dropped = dropped || *p != '0';
+      }
+    }
+    if ( *p == '.' ) {
+      for ( ++p; is_digit(*p); ++p ) {
+        digits = true;
+        if ( nd < 19 ) {
+          m = 10*m + uint64_t(*p-'0');
+          if ( m > 0 ) ++nd;
+          --e10;
+        } else {
+          dropped = dropped || *p != '0';
+        }
+      }
+    }
+    if ( digits && ( *p == 'e' || *p == 'E' ) ) {
+      char const * q    = p+1;
+      bool         eneg = false;
+      if      ( *q == '-' ) { eneg = true; ++q; }
+      else if ( *q == '+' ) ++q;
+      if ( is_digit(*q) ) {
+        int_type ee = 0;
+        for (; is_digit(*q); ++q ) if ( ee < 100000 ) ee = 10*ee + (*q-'0');
+        e10 += eneg ? -ee : ee;
+        p = q;
+      }
+    }
+    if ( digits && !dropped &&
+         m <= (uint64_t(1)<<53) && e10 >= -22 && e10 <= 22 ) {
+      real_type d = real_type(m);
+      if ( e10 < 0 ) d /= exact_pow10[-e10];
+      else           d *= exact_pow10[e10];
+      v = neg ? -d : d;
+      return p;
+    }
+    // long mantissa, large exponent, inf or nan; `strtod` skips the
+    // leading white spaces (also a newline), call it only on a token
+    char c = *p0;
+    if ( !( c == '-' || c == '+' || c == '.' || is_digit(c) ||
+            c == 'i' || c == 'I' || c == 'n' || c == 'N' ) ) return p0;
+    char * q;
+    v = strtod( p0, &q );
+    return q;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  /*
+   *  Parse the rows of [p,end), `end` is after a newline or at the end
+   *  of the text (where a zero is stored), append the first `ncol`
+   *  numbers of the rows to `cols`.  If `header` is true the first row
+   *  can be a header.
+   */
+  static
+  void
+  parse_rows(
+    char const        * p,
+    char const        * end,
+    int_type            ncol,
+    vector<real_type>   cols[],
+    bool                header
+  ) {
+    size_t nrow = size_t( std::count( p, end, '\n' ) ) + 1;
+    for ( int_type k = 0; k < ncol; ++k ) cols[k].reserve( cols[k].size() + nrow );
+    real_type row[64];
+    while ( p < end ) {
+      while ( p < end && is_blank(*p) ) ++p;
+      if ( p == end ) break;
+      if ( *p == '\n' ) { ++p; continue; }
+      char const * line = p;
+      bool ok = *p != '#';
+      for ( int_type k = 0; ok && k < ncol; ++k ) {
+        while ( is_blank(*p) ) ++p;
+        // short row: do not run into the next one
+        if ( *p == '\n' || *p == '\0' ) { ok = false; break; }
+        char const * q = parse_real( p, row[k] );
+        ok = q != p && ( is_blank(*q) || *q == '\n' || *q == '\0' );
+        p  = q;
+      }
+      // skip the rest of the row
+      p = static_cast<char const *>( std::memchr( p, '\n', size_t(end-p) ) );
+      p = p == nullptr ? end : p+1;
+      if ( ok ) {
+        for ( int_type k = 0; k < ncol; ++k ) cols[k].push_back( row[k] );
+      } else if ( !( header || *line == '#' ) ) {
+        char const * le = std::min( p, line+80 );
+        while ( le > line && ( le[-1] == '\n' || le[-1] == '\r' ) ) --le;
+        std::string bad( line, le );
+        G2LIB_DO_ERROR(
+          "read_table, expected " << ncol << " numbers in row `" << bad << "`"
+        )
+      }
+      header = false;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // parse [b,e) splitting it in `nthreads` parts
+  static
+  void
+  parse_chunk(
+    char const        * b,
+    char const        * e,
+    int_type            ncol,
+    vector<real_type>   cols[],
+    bool                header,
+    int_type            nthreads
+  ) {
+    #ifdef G2LIB_USE_CXX11
+    size_t len = size_t(e-b);
+    if ( nthreads > 1 && len > (size_t(1)<<16) ) {
+      size_t nt = size_t(nthreads);
+      // the parts start after a newline
+      vector<char const *> pos( nt+1 );
+      pos[0]  = b;
+      pos[nt] = e;
+      for ( size_t k = 1; k < nt; ++k ) {
+        char const * q = b + (len*k)/nt;
+        if ( q < pos[k-1] ) q = pos[k-1];
+        q = static_cast<char const *>( std::memchr( q, '\n', size_t(e-q) ) );
+        pos[k] = q == nullptr ? e : q+1;
+      }
+      vector<vector<real_type> > local( nt*size_t(ncol) );
+      vector<std::exception_ptr> errs( nt );
+      vector<std::thread>        workers;
+      workers.reserve( nt );
+      for ( size_t k = 0; k < nt; ++k ) {
+        char const        * pb   = pos[k];
+        char const        * pe   = pos[k+1];
+        vector<real_type> * lc   = &local[k*size_t(ncol)];
+        bool                hdr  = header && k == 0;
+        std::exception_ptr* perr = &errs[k];
+        workers.push_back( std::thread( [=] {
+          try {
+            parse_rows( pb, pe, ncol, lc, hdr );
+          } catch ( ... ) {
+            *perr = std::current_exception();
+          }
+        } ) );
+      }
+      for ( size_t k = 0; k < nt; ++k ) workers[k].join();
+      for ( size_t k = 0; k < nt; ++k )
+        if ( errs[k] ) std::rethrow_exception( errs[k] );
+      for ( int_type c = 0; c < ncol; ++c ) {
+        size_t n = cols[c].size();
+        for ( size_t k = 0; k < nt; ++k ) n += local[k*size_t(ncol)+size_t(c)].size();
+        cols[c].reserve( n );
+        for ( size_t k = 0; k < nt; ++k ) {
+          vector<real_type> const & lc = local[k*size_t(ncol)+size_t(c)];
+          cols[c].insert( cols[c].end(), lc.begin(), lc.end() );
+        }
+      }
+      return;
+    }
+    #else
+    (void)nthreads;
+    #endif
+    parse_rows( b, e, ncol, cols, header );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  read_table(
+    istream_type      & stream,
+    int_type            ncol,
+    vector<real_type>   cols[],
+    int_type            nthreads
+  ) {
+    G2LIB_ASSERT(
+      ncol > 0 && ncol <= 64, "read_table, ncol = " << ncol << " must be in [1,64]"
+    )
+    size_t n0 = cols[0].size();
+
+    size_t       chunk = size_t(1) << 24; // 16MB
+    vector<char> buf( chunk+1 );
+    size_t       keep   = 0;     // partial row from the previous chunk
+    bool         header = true;
+    while ( true ) {
+      stream.read( &buf[keep], std::streamsize(chunk-keep) );
+      size_t nr  = size_t( stream.gcount() );
+      size_t n   = keep+nr;
+      bool   eof = nr < chunk-keep;
+      // parse the complete rows, keep the last partial one
+      size_t last = n;
+      if ( !eof ) while ( last > 0 && buf[last-1] != '\n' ) --last;
+      if ( last == 0 && !eof ) {
+        // a row longer than the chunk
+        keep   = n;
+        chunk *= 2;
+        buf.resize( chunk+1 );
+        continue;
+      }
+      char save = buf[last];
+      buf[last] = '\0';
+      try {
+        parse_chunk( &buf.front(), &buf.front()+last, ncol, cols, header, nthreads );
+      } catch ( ... ) {
+        for ( int_type k = 0; k < ncol; ++k ) cols[k].resize( n0 );
+        throw;
+      }
+      buf[last] = save;
+      header = header && cols[0].size() == n0;
+      keep = n-last;
+      if ( keep > 0 ) std::memmove( &buf.front(), &buf.front()+last, keep );
+      if ( eof ) break;
+    }
+    return int_type( cols[0].size()-n0 );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  read_points(
+    istream_type      & stream,
+    vector<real_type> & x,
+    vector<real_type> & y,
+    int_type            nthreads
+  ) {
+    vector<real_type> cols[2];
+    cols[0].swap( x );
+    cols[1].swap( y );
+    int_type n = 0;
+    try {
+      n = read_table( stream, 2, cols, nthreads );
+    } catch ( ... ) {
+      x.swap( cols[0] );
+      y.swap( cols[1] );
+      throw;
+    }
+    x.swap( cols[0] );
+    y.swap( cols[1] );
+    return n;
+  }
+
+}
+
+///
+/// eof: G2lib_table.cc
+///
@@ -40,6 +40,7 @@ namespace G2lib {
   using std::max;
   using std::min;
   using std::swap;
+  using std::abs;
 
   LineSegment::LineSegment( BaseCurve const & C )
   : BaseCurve(G2LIB_LINE)
@@ -219,6 +220,69 @@ namespace G2lib {
     return false; // Doesn't fall in any of the above cases
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  static
+  inline
+  void
+  L_build(
+    real_type  x0,
+    real_type  y0,
+    real_type  x1,
+    real_type  y1,
+    L_struct & LS
+  ) {
+    real_type dx = x1-x0;
+    real_type dy = y1-y0;
+    LS.p[0] = x0; LS.p[1] = y0;
+    LS.q[0] = x1; LS.q[1] = y1;
+    LS.L    = hypot( dx, dy );
+    if ( LS.L > 0 ) {
+      LS.c = dx / LS.L;
+      LS.s = dy / LS.L;
+    } else {
+      LS.c = LS.s = 0;
+    }
+  }
+
+  bool
+  segmentIntersect(
+    real_type   x0,
+    real_type   y0,
+    real_type   x1,
+    real_type   y1,
+    real_type   X0,
+    real_type   Y0,
+    real_type   X1,
+    real_type   Y1,
+    real_type & s1,
+    real_type & s2
+  ) {
+    L_struct L1, L2;
+    L_build( x0, y0, x1, y1, L1 );
+    L_build( X0, Y0, X1, Y1, L2 );
+    real_type const epsi = max(L1.L,L2.L)*machepsi100;
+    return intersect( epsi, L1, L2, s1, s2 );
+  }
+
+  bool
+  segmentCollision(
+    real_type x0,
+    real_type y0,
+    real_type x1,
+    real_type y1,
+    real_type X0,
+    real_type Y0,
+    real_type X1,
+    real_type Y1
+  ) {
+    L_struct L1, L2;
+    L_build( x0, y0, x1, y1, L1 );
+    L_build( X0, Y0, X1, Y1, L2 );
+    real_type const epsi = max(L1.L,L2.L)*machepsi100;
+    return collision( epsi, L1, L2 );
+  }
+
   /*\
    |   _     _
    |  | |   (_)_ __   ___
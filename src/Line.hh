@@ -469,6 +469,17 @@ namespace G2lib {
       x_DDD = y_DDD = 0;
     }
 
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    virtual
+    void
+    sample_stations_ISO(
+      real_type,
+      real_type,
+      std::vector<real_type> & s
+    ) const G2LIB_OVERRIDE
+    { s.push_back( L ); }
+
     /*\
      |  _                        __
      | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -684,6 +695,39 @@ namespace G2lib {
 
   };
 
+  /*!
+   *  Intersection of the segments `(x0,y0)-(x1,y1)` and `(X0,Y0)-(X1,Y1)`
+   *  given by their end points, as `LineSegment::intersect`:
+   *  `s1` and `s2` are the curvilinear abscissa of the intersection
+   *  on the two segments.
+   */
+  bool
+  segmentIntersect(
+    real_type   x0,
+    real_type   y0,
+    real_type   x1,
+    real_type   y1,
+    real_type   X0,
+    real_type   Y0,
+    real_type   X1,
+    real_type   Y1,
+    real_type & s1,
+    real_type & s2
+  );
+
+  //! true if the segments given by their end points intersect, as `LineSegment::collision`
+  bool
+  segmentCollision(
+    real_type x0,
+    real_type y0,
+    real_type x1,
+    real_type y1,
+    real_type X0,
+    real_type Y0,
+    real_type X1,
+    real_type Y1
+  );
+
 }
 
 #endif
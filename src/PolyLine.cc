@@ -42,8 +42,170 @@ namespace G2lib {
   using std::cout;
   using std::vector;
   using std::ceil;
+  using std::numeric_limits;
 
-  typedef vector<LineSegment>::difference_type LS_dist_type;
+  /*
+   *  Kernels on the vertex arrays: plain loops on contiguous data, with
+   *  no branches and no virtual calls, that the compiler can vectorize.
+   */
+
+  // squared distance of `(qx,qy)` from the segment `(x0,y0)-(x1,y1)`
+  static
+  inline
+  real_type
+  segment_distance2(
+    real_type x0,
+    real_type y0,
+    real_type x1,
+    real_type y1,
+    real_type qx,
+    real_type qy
+  ) {
+    real_type dx = x1-x0;
+    real_type dy = y1-y0;
+    real_type px = qx-x0;
+    real_type py = qy-y0;
+    real_type l2 = dx*dx+dy*dy;
+    real_type u  = px*dx+py*dy;
+    u = l2 > 0 ? u/l2 : 0;
+    u = min( max( u, real_type(0) ), real_type(1) );
+    real_type ex = px-u*dx;
+    real_type ey = py-u*dy;
+    return ex*ex+ey*ey;
+  }
+
+  // bounding boxes of the `n` segments of the vertices `x[0..n]`, `y[0..n]`
+  static
+  void
+  segment_bbox(
+    size_t          n,
+    real_type const x[],
+    real_type const y[],
+    real_type       xmin[],
+    real_type       ymin[],
+    real_type       xmax[],
+    real_type       ymax[]
+  ) {
+    for ( size_t i = 0; i < n; ++i ) {
+      xmin[i] = min( x[i], x[i+1] );
+      xmax[i] = max( x[i], x[i+1] );
+    }
+    for ( size_t i = 0; i < n; ++i ) {
+      ymin[i] = min( y[i], y[i+1] );
+      ymax[i] = max( y[i], y[i+1] );
+    }
+  }
+
+  // 1 if the orientation test of `segmentIntersect` on the determinant
+  // `u-v` may give zero (collinear points), else 0: the tolerance `tol`
+  // is larger than the one of the test and the rounding of the products
+  // is added, so a sure nonzero determinant here is nonzero also there
+  static
+  inline
+  real_type
+  orientation_near_zero( real_type u, real_type v, real_type tol ) {
+    return abs(u-v) < tol + 4*machepsi*(abs(u)+abs(v)) ? 1 : 0;
+  }
+
+  // 1 if the determinant `u-v` is positive, else 0
+  static
+  inline
+  real_type
+  orientation_side( real_type u, real_type v ) {
+    return u > v ? 1 : 0;
+  }
+
+  /*
+   *  Orientation tests of `n` pairs of segments `(a0,a1)`, `(b0,b1)` given
+   *  by the coordinates of the end points: `hit[k]` is 0 when no end point
+   *  is collinear with the other segment and the end points of one segment
+   *  are on the same side of the other, the pairs where `segmentIntersect`
+   *  surely returns false, else 1.  The flags are doubles combined by
+   *  `max` and products, so the loop has only selects (no branches) and
+   *  the compiler vectorizes it (e.g. g++ -O3).
+   */
+  static
+  void
+  segment_cross_kernel(
+    size_t          n,
+    real_type const a0x[],
+    real_type const a0y[],
+    real_type const a1x[],
+    real_type const a1y[],
+    real_type const b0x[],
+    real_type const b0y[],
+    real_type const b1x[],
+    real_type const b1y[],
+    real_type       hit[]
+  ) {
+    for ( size_t k = 0; k < n; ++k ) {
+      real_type ax  = a1x[k]-a0x[k], ay = a1y[k]-a0y[k];
+      real_type bx  = b1x[k]-b0x[k], by = b1y[k]-b0y[k];
+      // 3*max(|components|) bounds 2*max(lengths) with no sqrt
+      real_type tol = 3*machepsi100*max( max( abs(ax), abs(ay) ), max( abs(bx), abs(by) ) );
+      // orientation of the end points of `b` from `a` and vice versa,
+      // the determinants u-v as in `orientation` of Line.cc
+      real_type u1 = ay*(b0x[k]-a1x[k]), v1 = ax*(b0y[k]-a1y[k]);
+      real_type u2 = ay*(b1x[k]-a1x[k]), v2 = ax*(b1y[k]-a1y[k]);
+      real_type u3 = by*(a0x[k]-b1x[k]), v3 = bx*(a0y[k]-b1y[k]);
+      real_type u4 = by*(a1x[k]-b1x[k]), v4 = bx*(a1y[k]-b1y[k]);
+      real_type z  = max(
+        max( orientation_near_zero( u1, v1, tol ), orientation_near_zero( u2, v2, tol ) ),
+        max( orientation_near_zero( u3, v3, tol ), orientation_near_zero( u4, v4, tol ) )
+      );
+      real_type c = abs( orientation_side( u1, v1 ) - orientation_side( u2, v2 ) ) *
+                    abs( orientation_side( u3, v3 ) - orientation_side( u4, v4 ) );
+      hit[k] = max( z, c );
+    }
+  }
+
+  // positions in `pairs` of the pairs `(i,j)` that pass
+  // `segment_cross_kernel`, segment `i` of the vertices `xa`, `ya` and
+  // segment `j` of `xb`, `yb`: the end points are copied in blocks that
+  // stay in the cache
+  static
+  void
+  segment_cross_candidates(
+    AABBtree::VecPairIpos const & pairs,
+    real_type const               xa[],
+    real_type const               ya[],
+    real_type const               xb[],
+    real_type const               yb[],
+    vector<size_t>              & cand
+  ) {
+    size_t const NB = 256;
+    real_type    P[8][NB], hit[NB];
+    size_t       n = pairs.size();
+    cand.clear();
+    for ( size_t kb = 0; kb < n; kb += NB ) {
+      size_t nb = min( NB, n-kb );
+      for ( size_t k = 0; k < nb; ++k ) {
+        size_t i = size_t(pairs[kb+k].first);
+        size_t j = size_t(pairs[kb+k].second);
+        P[0][k] = xa[i]; P[1][k] = ya[i]; P[2][k] = xa[i+1]; P[3][k] = ya[i+1];
+        P[4][k] = xb[j]; P[5][k] = yb[j]; P[6][k] = xb[j+1]; P[7][k] = yb[j+1];
+      }
+      segment_cross_kernel(
+        nb, P[0], P[1], P[2], P[3], P[4], P[5], P[6], P[7], hit
+      );
+      for ( size_t k = 0; k < nb; ++k )
+        if ( hit[k] > 0 ) cand.push_back( kb+k );
+    }
+  }
+
+  // minimum and maximum of `v[0..n-1]`
+  static
+  void
+  range( size_t n, real_type const v[], real_type & vmin, real_type & vmax ) {
+    real_type mi = v[0];
+    real_type ma = v[0];
+    for ( size_t i = 1; i < n; ++i ) {
+      mi = min( mi, v[i] );
+      ma = max( ma, v[i] );
+    }
+    vmin = mi;
+    vmax = ma;
+  }
 
   /*\
    |  ____       _       _     _
@@ -59,8 +221,10 @@ namespace G2lib {
   PolyLine::PolyLine( BaseCurve const & C )
   : BaseCurve(G2LIB_POLYLINE)
   , aabb_done(false)
+  , aabb_is_flat(false)
+  , aabb_prepared(false)
   {
-    this->resetLastInterval(); 
+    this->resetLastInterval();
     switch ( C.type() ) {
     case G2LIB_LINE:
       build( *static_cast<LineSegment const *>(&C) );
@@ -85,9 +249,11 @@ namespace G2lib {
   PolyLine::PolyLine( LineSegment const & LS )
   : BaseCurve(G2LIB_POLYLINE)
   , aabb_done(false)
+  , aabb_is_flat(false)
+  , aabb_prepared(false)
   {
     this->resetLastInterval();
-    this->init( LS.xBegin(), LS.xBegin() );
+    this->init( LS.xBegin(), LS.yBegin() );
     this->push_back( LS );
   }
 
@@ -96,9 +262,11 @@ namespace G2lib {
   PolyLine::PolyLine( CircleArc const & C, real_type tol )
   : BaseCurve(G2LIB_POLYLINE)
   , aabb_done(false)
+  , aabb_is_flat(false)
+  , aabb_prepared(false)
   {
     this->resetLastInterval();
-    this->init( C.xBegin(), C.xBegin() );
+    this->init( C.xBegin(), C.yBegin() );
     this->push_back( C, tol );
   }
 
@@ -107,9 +275,11 @@ namespace G2lib {
   PolyLine::PolyLine( Biarc const & B, real_type tol )
   : BaseCurve(G2LIB_POLYLINE)
   , aabb_done(false)
+  , aabb_is_flat(false)
+  , aabb_prepared(false)
   {
     this->resetLastInterval();
-    this->init( B.xBegin(), B.xBegin() );
+    this->init( B.xBegin(), B.yBegin() );
     this->push_back( B, tol );
   }
 
@@ -118,9 +288,11 @@ namespace G2lib {
   PolyLine::PolyLine( ClothoidCurve const & C, real_type tol )
   : BaseCurve(G2LIB_POLYLINE)
   , aabb_done(false)
+  , aabb_is_flat(false)
+  , aabb_prepared(false)
   {
     this->resetLastInterval();
-    this->init( C.xBegin(), C.xBegin() );
+    this->init( C.xBegin(), C.yBegin() );
     this->push_back( C, tol );
   }
 
@@ -129,9 +301,11 @@ namespace G2lib {
   PolyLine::PolyLine( ClothoidList const & PL, real_type tol )
   : BaseCurve(G2LIB_POLYLINE)
   , aabb_done(false)
+  , aabb_is_flat(false)
+  , aabb_prepared(false)
   {
     this->resetLastInterval();
-    this->init( PL.xBegin(), PL.xBegin() );
+    this->init( PL.xBegin(), PL.yBegin() );
     this->push_back( PL, tol );
   }
 
@@ -139,46 +313,50 @@ namespace G2lib {
 
   void
   PolyLine::copy( PolyLine const & PL ) {
-    polylineList.clear();
-    polylineList.reserve( PL.polylineList.size() );
-    std::copy(
-      PL.polylineList.begin(),
-      PL.polylineList.end(),
-      back_inserter(polylineList)
-    );
-    s0.clear();
-    s0.reserve( PL.s0.size() );
-    std::copy( PL.s0.begin(), PL.s0.end(), back_inserter(s0) );
-    aabb_done = false;
+    xv = PL.xv;
+    yv = PL.yv;
+    s0 = PL.s0;
+    aabb_done     = false;
+    aabb_prepared = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  PolyLine::build_s0() {
+    size_t n = xv.size();
+    s0.resize( n );
+    if ( n == 0 ) return;
+    s0[0] = 0;
+    for ( size_t i = 1; i < n; ++i )
+      s0[i] = s0[i-1] + hypot( xv[i]-xv[i-1], yv[i]-yv[i-1] );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-  LineSegment const &
+  LineSegment
   PolyLine::getSegment( int_type n ) const {
     G2LIB_ASSERT(
-      !polylineList.empty(),
+      numSegment() > 0,
       "PolyLine::getSegment(...) empty PolyLine"
     )
     G2LIB_ASSERT(
-      n >= 0 && n < int_type(polylineList.size()),
+      n >= 0 && n < numSegment(),
       "PolyLine::getSegment( " << n <<
-      " ) out of range [0," << polylineList.size()-1 << "]"
+      " ) out of range [0," << numSegment()-1 << "]"
     )
-    return polylineList[size_t(n)];
+    size_t    i = size_t(n);
+    LineSegment LS;
+    LS.build_2P( xv[i], yv[i], xv[i+1], yv[i+1] );
+    return LS;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
   PolyLine::polygon( real_type x[], real_type y[]) const {
-    int_type n = int_type(polylineList.size());
-    for ( int_type k = 0; k < n; ++k ) {
-      x[size_t(k)] = polylineList[size_t(k)].xBegin();
-      y[size_t(k)] = polylineList[size_t(k)].yBegin();
-    }
-    x[size_t(n)] = polylineList[size_t(n-1)].xEnd();
-    y[size_t(n)] = polylineList[size_t(n-1)].yEnd();
+    std::copy( xv.begin(), xv.end(), x );
+    std::copy( yv.begin(), yv.end(), y );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -191,29 +369,15 @@ namespace G2lib {
     real_type & ymax
   ) const {
 
-    G2LIB_ASSERT( !polylineList.empty(), "PolyLine::bbox, empty list" )
+    G2LIB_ASSERT( numSegment() > 0, "PolyLine::bbox, empty list" )
 
-    if ( aabb_done ) {
+    if ( aabb_done && aabb_is_flat ) {
+      aabb_flat.bbox( xmin, ymin, xmax, ymax );
+    } else if ( aabb_done ) {
       aabb_tree.bbox( xmin, ymin, xmax, ymax );
     } else {
-      vector<LineSegment>::const_iterator ic = polylineList.begin();
-      xmin = xmax = ic->xBegin();
-      ymin = ymax = ic->yBegin();
-      for ( ++ic; ic != polylineList.end(); ++ic ) {
-        real_type x = ic->xBegin();
-        real_type y = ic->yBegin();
-        if      ( x < xmin ) xmin = x;
-        else if ( x > xmax ) xmax = x;
-        if      ( y < ymin ) ymin = y;
-        else if ( y > ymax ) ymax = y;
-      }
-      --ic;
-      real_type x = ic->xEnd();
-      real_type y = ic->yEnd();
-      if      ( x < xmin ) xmin = x;
-      else if ( x > xmax ) xmax = x;
-      if      ( y < ymin ) ymin = y;
-      else if ( y > ymax ) ymax = y;
+      range( xv.size(), &xv.front(), xmin, xmax );
+      range( yv.size(), &yv.front(), ymin, ymax );
     }
   }
 
@@ -221,7 +385,8 @@ namespace G2lib {
 
   real_type
   PolyLine::theta( real_type s ) const {
-    return polylineList[size_t(this->findAtS( s ))].theta0;
+    size_t i = size_t(this->findAtS( s ));
+    return atan2( yv[i+1]-yv[i], xv[i+1]-xv[i] );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -242,6 +407,20 @@ namespace G2lib {
   PolyLine::theta_DDD( real_type ) const
   { return 0; }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  PolyLine::sample_stations_ISO(
+    real_type,
+    real_type,
+    vector<real_type> & s
+  ) const {
+    // the polyline is sampled exactly by its vertices
+    s.insert( s.end(), s0.begin()+1, s0.end() );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   /*\
    |  _                        __
    | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -252,52 +431,62 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  PolyLine::translate( real_type tx, real_type ty ) {
+    for ( size_t i = 0; i < xv.size(); ++i ) xv[i] += tx;
+    for ( size_t i = 0; i < yv.size(); ++i ) yv[i] += ty;
+    aabb_done     = false;
+    aabb_prepared = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  PolyLine::rotate( real_type angle, real_type cx, real_type cy ) {
+    real_type C = cos(angle);
+    real_type S = sin(angle);
+    for ( size_t i = 0; i < xv.size(); ++i ) {
+      real_type dx = xv[i] - cx;
+      real_type dy = yv[i] - cy;
+      xv[i] = cx + C*dx - S*dy;
+      yv[i] = cy + C*dy + S*dx;
+    }
+    aabb_done     = false;
+    aabb_prepared = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   PolyLine::scale( real_type sfactor ) {
-    vector<LineSegment>::iterator ic = polylineList.begin();
-    real_type newx0 = ic->xBegin();
-    real_type newy0 = ic->yBegin();
-    s0[0] = 0;
-    for ( size_t k=0; ic != polylineList.end(); ++ic, ++k ) {
-      ic->scale( sfactor );
-      ic->changeOrigin( newx0, newy0 );
-      newx0 = ic->xEnd();
-      newy0 = ic->yEnd();
-      s0[k+1] = s0[k] + ic->length();
+    real_type x0 = xv.front();
+    real_type y0 = yv.front();
+    for ( size_t i = 1; i < xv.size(); ++i ) {
+      xv[i] = x0 + sfactor*(xv[i]-x0);
+      yv[i] = y0 + sfactor*(yv[i]-y0);
     }
+    this->build_s0();
+    aabb_done     = false;
+    aabb_prepared = false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
   PolyLine::reverse() {
-    std::reverse( polylineList.begin(), polylineList.end() );
-    vector<LineSegment>::iterator ic = polylineList.begin();
-    ic->reverse();
-    real_type newx0 = ic->xEnd();
-    real_type newy0 = ic->yEnd();
-    s0[0] = 0;
-    s0[1] = ic->length();
-    size_t k = 1;
-    for ( ++ic; ic != polylineList.end(); ++ic, ++k ) {
-      ic->reverse();
-      ic->changeOrigin( newx0, newy0 );
-      newx0   = ic->xEnd();
-      newy0   = ic->yEnd();
-      s0[k+1] = s0[k] + ic->length();
-    }
+    std::reverse( xv.begin(), xv.end() );
+    std::reverse( yv.begin(), yv.end() );
+    this->build_s0();
+    aabb_done     = false;
+    aabb_prepared = false;
+    this->resetLastInterval();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
   PolyLine::changeOrigin( real_type newx0, real_type newy0 ) {
-    vector<LineSegment>::iterator ic = polylineList.begin();
-    for (; ic != polylineList.end(); ++ic ) {
-      ic->changeOrigin( newx0, newy0 );
-      newx0 = ic->xEnd();
-      newy0 = ic->yEnd();
-    }
+    this->translate( newx0-xv.front(), newy0-yv.front() );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -312,17 +501,23 @@ namespace G2lib {
 
     size_t i_begin = size_t(findAtS(s_begin));
     size_t i_end   = size_t(findAtS(s_end));
-    polylineList[i_begin].trim( s_begin-s0[i_begin], s0[i_begin+1] );
-    polylineList[i_end].trim( s0[i_end], s_end-s0[i_end] );
-    polylineList.erase( polylineList.begin()+LS_dist_type(i_end+1), polylineList.end() );
-    polylineList.erase( polylineList.begin(), polylineList.begin()+LS_dist_type(i_begin) );
-    vector<LineSegment>::iterator ic = polylineList.begin();
-    s0[0] = 0;
-    size_t k = 0;
-    for (; ic != polylineList.end(); ++ic, ++k )
-      s0[k+1] = s0[k] + ic->length();
+    real_type xb, yb, xe, ye;
+    this->eval( s_begin, xb, yb );
+    this->eval( s_end,   xe, ye );
+    // vertices `i_begin+1 .. i_end` are kept
+    xv.erase( xv.begin()+std::ptrdiff_t(i_end+1), xv.end() );
+    yv.erase( yv.begin()+std::ptrdiff_t(i_end+1), yv.end() );
+    xv.erase( xv.begin(), xv.begin()+std::ptrdiff_t(i_begin) );
+    yv.erase( yv.begin(), yv.begin()+std::ptrdiff_t(i_begin) );
+    xv.front() = xb; yv.front() = yb;
+    xv.push_back( xe );
+    yv.push_back( ye );
+    this->build_s0();
+    aabb_done     = false;
+    aabb_prepared = false;
     this->resetLastInterval();
   }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
@@ -332,18 +527,19 @@ namespace G2lib {
     #else
     vector<BBox const *> bboxes;
     #endif
-    bboxes.reserve(polylineList.size());
-    vector<LineSegment>::const_iterator it;
-    int_type ipos = 0;
-    for ( it = polylineList.begin(); it != polylineList.end(); ++it, ++ipos ) {
-      real_type xmin, ymin, xmax, ymax;
-      it->bbox( xmin, ymin, xmax, ymax );
+    size_t ns = size_t(numSegment());
+    bboxes.reserve( ns );
+    for ( size_t i = 0; i < ns; ++i ) {
+      real_type xmin = min( xv[i], xv[i+1] );
+      real_type ymin = min( yv[i], yv[i+1] );
+      real_type xmax = max( xv[i], xv[i+1] );
+      real_type ymax = max( yv[i], yv[i+1] );
       #ifdef G2LIB_USE_CXX11
       bboxes.push_back( make_shared<BBox const>(
-        xmin, ymin, xmax, ymax, G2LIB_LINE, ipos
+        xmin, ymin, xmax, ymax, G2LIB_LINE, int_type(i)
       ) );
       #else
-      bboxes.push_back( new BBox( xmin, ymin, xmax, ymax, G2LIB_LINE, ipos ) );
+      bboxes.push_back( new BBox( xmin, ymin, xmax, ymax, G2LIB_LINE, int_type(i) ) );
       #endif
     }
     aabbtree.build(bboxes);
@@ -351,42 +547,78 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  PolyLine::build_AABBtree( AABBtreeFlat & aabb ) const {
+    size_t ns = size_t(numSegment());
+    if ( ns == 0 ) { aabb.clear(); return; }
+    vector<real_type> box( 4*ns );
+    real_type * xmin = &box.front();
+    real_type * ymin = xmin+ns;
+    real_type * xmax = ymin+ns;
+    real_type * ymax = xmax+ns;
+    segment_bbox( ns, &xv.front(), &yv.front(), xmin, ymin, xmax, ymax );
+    aabb.build( int_type(ns), xmin, ymin, xmax, ymax );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  PolyLine::build_AABBtree() const {
+    if ( aabb_done && ( aabb_prepared || aabb_is_flat == use_flat_AABBtree ) )
+      return;
+    #ifdef G2LIB_USE_CXX11
+    std::lock_guard<std::mutex> lock( aabb_mutex );
+    // built by another thread while waiting
+    if ( aabb_done && ( aabb_prepared || aabb_is_flat == use_flat_AABBtree ) )
+      return;
+    #endif
+    aabb_done    = false;
+    aabb_is_flat = use_flat_AABBtree;
+    if ( aabb_is_flat ) {
+      aabb_tree.clear();
+      this->build_AABBtree( aabb_flat );
+    } else {
+      aabb_flat.clear();
+      this->build_AABBtree( aabb_tree );
+    }
+    aabb_prepared = false;
+    aabb_done     = true; // last: the lock free check reads the tree after it
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   PolyLine::init( real_type x0, real_type y0 ) {
-    xe = x0;
-    ye = y0;
-    polylineList.clear();
-    s0.clear();
-    s0.push_back(0);
-    aabb_done = false;
+    xv.assign( 1, x0 );
+    yv.assign( 1, y0 );
+    s0.assign( 1, 0 );
+    aabb_done     = false;
+    aabb_prepared = false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
   PolyLine::push_back( real_type x, real_type y ) {
-    LineSegment s;
-    s.build_2P( xe, ye, x, y );
-    polylineList.push_back( s );
-    real_type slast = s0.back() + s.length();
+    real_type slast = s0.back() + hypot( x-xv.back(), y-yv.back() );
     s0.push_back( slast );
-    xe = x;
-    ye = y;
-    aabb_done = false;
+    xv.push_back( x );
+    yv.push_back( y );
+    aabb_done     = false;
+    aabb_prepared = false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
   PolyLine::push_back( LineSegment const & C ) {
-    polylineList.push_back( C );
-    LineSegment & S = polylineList.back();
-    S.changeOrigin( xe, ye );
-    real_type slast = s0.back() + S.length();
+    real_type L     = C.length();
+    real_type slast = s0.back() + L;
     s0.push_back( slast );
-    xe = S.xEnd();
-    ye = S.yEnd();
-    aabb_done = false;
+    xv.push_back( xv.back() + L*C.tx_Begin() );
+    yv.push_back( yv.back() + L*C.ty_Begin() );
+    aabb_done     = false;
+    aabb_prepared = false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -395,16 +627,13 @@ namespace G2lib {
   PolyLine::push_back( CircleArc const & C, real_type tol ) {
     real_type L  = C.length();
     int_type  ns = int_type(ceil( L / C.lenTolerance( tol ) ));
-    real_type tx = xe - C.xBegin();
-    real_type ty = ye - C.yBegin();
+    real_type tx = xv.back() - C.xBegin();
+    real_type ty = yv.back() - C.yBegin();
     for ( int_type i = 1; i < ns; ++i ) {
       real_type s = (i*L)/ns;
       push_back( tx + C.X(s), ty + C.Y(s) );
     }
     push_back( tx + C.xEnd(), ty + C.yEnd() );
-    xe = tx + C.xEnd();
-    ye = ty + C.yEnd();
-    aabb_done = false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -418,8 +647,8 @@ namespace G2lib {
     int_type  ns0 = int_type(ceil( L0 / C0.lenTolerance( tol ) ));
     int_type  ns1 = int_type(ceil( L1 / C1.lenTolerance( tol ) ));
 
-    real_type tx = xe - C0.xBegin();
-    real_type ty = ye - C0.yBegin();
+    real_type tx = xv.back() - C0.xBegin();
+    real_type ty = yv.back() - C0.yBegin();
 
     for ( int_type i = 1; i < ns0; ++i ) {
       real_type s = (i*L0)/ns0;
@@ -431,9 +660,6 @@ namespace G2lib {
       push_back( tx + C1.X(s), ty + C1.Y(s) );
     }
     push_back( tx + C1.xEnd(), ty + C1.yEnd() );
-    xe = tx + C1.xEnd();
-    ye = ty + C1.yEnd();
-    aabb_done = false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -447,17 +673,14 @@ namespace G2lib {
     int_type ns = 1;
     if ( tmp > -1 ) ns = int_type( ceil( L*absk/(2*(m_pi-acos(tmp))) ) );
 
-    real_type tx = xe - C.xBegin();
-    real_type ty = ye - C.yBegin();
+    real_type tx = xv.back() - C.xBegin();
+    real_type ty = yv.back() - C.yBegin();
     for ( int_type i = 1; i < ns; ++i ) {
       real_type s = (i*L)/ns;
       push_back( tx + C.X(s), ty + C.Y(s) );
     }
 
     push_back( tx + C.xEnd(), ty + C.yEnd() );
-    xe = tx + C.xEnd();
-    ye = ty + C.yEnd();
-    aabb_done = false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -469,7 +692,6 @@ namespace G2lib {
       ClothoidCurve const & C = L.get( idx );
       push_back( C, tol );
     }
-    // aabb_done = false;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -481,6 +703,9 @@ namespace G2lib {
     int_type        npts
   ) {
     init( x[0], y[0] );
+    xv.reserve( size_t(npts) );
+    yv.reserve( size_t(npts) );
+    s0.reserve( size_t(npts) );
     for ( int_type k = 1; k < npts; ++k )
       push_back( x[k], y[k] );
   }
@@ -527,6 +752,94 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  int_type
+  PolyLine::closestPoint_segment(
+    size_t      i,
+    real_type   qx,
+    real_type   qy,
+    real_type & X,
+    real_type & Y,
+    real_type & S,
+    real_type & T,
+    real_type & DST
+  ) const {
+    real_type dx = xv[i+1]-xv[i];
+    real_type dy = yv[i+1]-yv[i];
+    real_type L  = hypot( dx, dy );
+    real_type tx = L > 0 ? dx/L : 0;
+    real_type ty = L > 0 ? dy/L : 0;
+    dx = qx - xv[i];
+    dy = qy - yv[i];
+    S  = dx * tx + dy * ty;
+    T  = dy * tx - dx * ty;
+    if ( S < 0 || L == 0 ) {
+      S = 0;
+      X = xv[i];
+      Y = yv[i];
+    } else if ( S > L ) {
+      S = L;
+      X = xv[i+1];
+      Y = yv[i+1];
+    } else {
+      DST = abs(T);
+      X   = xv[i] + S*tx;
+      Y   = yv[i] + S*ty;
+      return 1;
+    }
+    dx  = qx-X;
+    dy  = qy-Y;
+    T   = dy * tx - dx * ty;
+    DST = hypot( dx, dy );
+    return -1;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  PolyLine::closestSegment(
+    real_type   qx,
+    real_type   qy,
+    int_type    ibegin,
+    int_type    iend,
+    real_type & dst
+  ) const {
+    G2LIB_ASSERT(
+      ibegin >= 0 && ibegin < iend && iend <= numSegment(),
+      "PolyLine::closestSegment, bad range [" << ibegin << "," << iend << ")"
+    )
+    real_type const * x = &xv.front();
+    real_type const * y = &yv.front();
+    real_type d2min = numeric_limits<real_type>::infinity();
+    int_type  imin  = ibegin;
+    for ( int_type i = ibegin; i < iend; ++i ) {
+      real_type d2 = segment_distance2( x[i], y[i], x[i+1], y[i+1], qx, qy );
+      if ( d2 < d2min ) { d2min = d2; imin = i; }
+    }
+    dst = sqrt( d2min );
+    return imin;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  class PolyLine::SegmentDistance {
+    PolyLine const * PL;
+    real_type        qx, qy;
+  public:
+    SegmentDistance( PolyLine const * _PL, real_type _qx, real_type _qy )
+    : PL(_PL), qx(_qx), qy(_qy)
+    {}
+
+    real_type
+    operator () ( int_type ipos ) const {
+      size_t i = size_t(ipos);
+      return sqrt( segment_distance2(
+        PL->xv[i], PL->yv[i], PL->xv[i+1], PL->yv[i+1], qx, qy
+      ) );
+    }
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   int_type
   PolyLine::closestPoint_ISO(
     real_type   x,
@@ -536,35 +849,112 @@ namespace G2lib {
     real_type & S,
     real_type & T,
     real_type & DST
-  ) const{
+  ) const {
+    #ifdef G2LIB_USE_CXX11
+    return this->closestPoint_ISO( x, y, X, Y, S, T, DST, findAtS_thread_hint( this ) );
+    #else
+    return this->closestPoint_ISO( x, y, X, Y, S, T, DST, lastInterval );
+    #endif
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  int_type
+  PolyLine::closestPoint_ISO(
+    real_type   x,
+    real_type   y,
+    real_type & X,
+    real_type & Y,
+    real_type & S,
+    real_type & T,
+    real_type & DST,
+    int_type  & iseg
+  ) const {
     G2LIB_ASSERT(
-      !polylineList.empty(),
+      numSegment() > 0,
       "PolyLine::closestPoint, empty list"
     )
-    vector<LineSegment>::const_iterator ic = polylineList.begin();
-    vector<real_type>::const_iterator   is = s0.begin();
-    ic->closestPoint_ISO( x, y, X, Y, S, T, DST );
-    size_t ipos = 0;
-    for ( ++ic, ++is; ic != polylineList.end(); ++ic, ++is ) {
-      real_type X1, Y1, S1, T1, DST1;
-      ic->closestPoint_ISO( x, y, X1, Y1, S1, T1, DST1 );
-      if ( DST1 < DST ) {
-        DST  = DST1;
-        X    = X1;
-        Y    = Y1;
-        S    = *is + S1;
-        T    = T1;
-        ipos = size_t(ic-polylineList.begin());
-      }
+    int_type ns = this->numSegment();
+    if ( iseg < 0 || iseg >= ns ) iseg = 0;
+    // the hint and its neighbours bound the distance
+    // (all the segments of a short polyline)
+    int_type ib = ns > 3 ? max( iseg-1, 0 )  : 0;
+    int_type ie = ns > 3 ? min( iseg+2, ns ) : ns;
+    iseg = this->closestSegment( x, y, ib, ie, DST );
+    if ( ns > 3 ) {
+      // only the segments nearer than the bound are visited
+      this->build_AABBtree();
+      vector<pair<real_type,int_type> > res;
+      SegmentDistance dfun( this, x, y );
+      if ( aabb_is_flat ) aabb_flat.nearest( x, y, 1, DST, dfun, res );
+      else                aabb_tree.nearest( x, y, 1, DST, dfun, res );
+      if ( !res.empty() && res.front().first < DST ) iseg = res.front().second;
     }
 
-    real_type xx, yy;
-    polylineList[ipos].eval_ISO( S - s0[ipos], T, xx, yy );
+    size_t ipos = size_t(iseg);
+    this->closestPoint_segment( ipos, x, y, X, Y, S, T, DST );
+
+    real_type tx, ty;
+    this->tangent( ipos, tx, ty );
+    real_type xx  = xv[ipos] + S*tx - T*ty;
+    real_type yy  = yv[ipos] + S*ty + T*tx;
     real_type err = hypot( x - xx, y - yy );
+    S += s0[ipos];
     if ( err > DST*machepsi1000 ) return -1;
     return 1;
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  PolyLine::nearestSegments(
+    real_type           qx,
+    real_type           qy,
+    int_type            k,
+    real_type           dmax,
+    vector<int_type>  & iseg,
+    vector<real_type> & s,
+    vector<real_type> & dst
+  ) const {
+    this->build_AABBtree();
+    vector<pair<real_type,int_type> > res;
+    SegmentDistance dfun( this, qx, qy );
+    if ( aabb_is_flat ) aabb_flat.nearest( qx, qy, k, dmax, dfun, res );
+    else                aabb_tree.nearest( qx, qy, k, dmax, dfun, res );
+    iseg.resize( res.size() );
+    s.resize( res.size() );
+    dst.resize( res.size() );
+    for ( size_t i = 0; i < res.size(); ++i ) {
+      size_t    ic = size_t(res[i].second);
+      real_type x, y, ss, t, d;
+      this->closestPoint_segment( ic, qx, qy, x, y, ss, t, d );
+      iseg[i] = res[i].second;
+      s[i]    = ss + s0[ic];
+      dst[i]  = res[i].first;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  PolyLine::distanceField(
+    int_type        n,
+    real_type const qx[],
+    real_type const qy[],
+    real_type       dmax,
+    real_type       dst[]
+  ) const {
+    this->build_AABBtree();
+    vector<pair<real_type,int_type> > res;
+    res.reserve(1);
+    for ( int_type i = 0; i < n; ++i ) {
+      SegmentDistance dfun( this, qx[i], qy[i] );
+      if ( aabb_is_flat ) aabb_flat.nearest( qx[i], qy[i], 1, dmax, dfun, res );
+      else                aabb_tree.nearest( qx[i], qy[i], 1, dmax, dfun, res );
+      dst[i] = res.empty() ? dmax : res.front().first;
+    }
+  }
+
   /*\
    |             _ _ _     _
    |    ___ ___ | | (_)___(_) ___  _ __
@@ -578,9 +968,31 @@ namespace G2lib {
     this->build_AABBtree();
     C.build_AABBtree();
     Collision_list fun( this, &C );
+    if ( aabb_is_flat != C.aabb_is_flat ) {
+      // only one of the two is prepared (flat): compare two flat trees
+      AABBtreeFlat tmp;
+      if ( aabb_is_flat ) {
+        C.build_AABBtree( tmp );
+        return aabb_flat.collision( tmp, fun );
+      }
+      this->build_AABBtree( tmp );
+      return tmp.collision( C.aabb_flat, fun );
+    }
+    if ( aabb_is_flat ) return aabb_flat.collision( C.aabb_flat, fun );
     return aabb_tree.collision( C.aabb_tree, fun, false );
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  PolyLine::self_collision() const {
+    if ( numSegment() < 3 ) return false;
+    this->build_AABBtree();
+    Self_list fun( this, ends_meet(), nullptr );
+    if ( aabb_is_flat ) return aabb_flat.self_collision( fun );
+    return aabb_tree.self_collision( fun );
+  }
+
   /*\
    |   _       _                          _
    |  (_)_ __ | |_ ___ _ __ ___  ___  ___| |_
@@ -596,33 +1008,56 @@ namespace G2lib {
     vector<real_type> & ss1
   ) const {
     G2LIB_ASSERT(
-      !polylineList.empty(),
+      numSegment() > 0,
       "PolyLine::intersect, empty list"
     )
     G2LIB_ASSERT(
-      !pl.polylineList.empty(),
+      pl.numSegment() > 0,
       "PolyLine::intersect, empty secondary list"
     )
 
 #if 1
     build_AABBtree();
     pl.build_AABBtree();
-    AABBtree::VecPairPtrBBox intersectionList;
-    aabb_tree.intersect( pl.aabb_tree, intersectionList );
-    AABBtree::VecPairPtrBBox::const_iterator ip;
-    for ( ip = intersectionList.begin(); ip != intersectionList.end(); ++ip ) {
-      size_t ipos0 = size_t(ip->first->Ipos());
-      size_t ipos1 = size_t(ip->second->Ipos());
+    AABBtree::VecPairIpos intersectionList;
+    if ( aabb_is_flat != pl.aabb_is_flat ) {
+      // only one of the two is prepared (flat): compare two flat trees
+      AABBtreeFlat tmp;
+      if ( aabb_is_flat ) {
+        pl.build_AABBtree( tmp );
+        aabb_flat.intersect( tmp, intersectionList );
+      } else {
+        this->build_AABBtree( tmp );
+        tmp.intersect( pl.aabb_flat, intersectionList );
+      }
+    } else if ( aabb_is_flat ) {
+      aabb_flat.intersect( pl.aabb_flat, intersectionList );
+    } else {
+      aabb_tree.intersect( pl.aabb_tree, intersectionList );
+    }
+    // only the pairs not excluded by the orientation tests are solved
+    vector<size_t> cand;
+    segment_cross_candidates(
+      intersectionList, &xv.front(), &yv.front(), &pl.xv.front(), &pl.yv.front(), cand
+    );
+    vector<size_t>::const_iterator ic;
+    for ( ic = cand.begin(); ic != cand.end(); ++ic ) {
+      size_t ipos0 = size_t(intersectionList[*ic].first);
+      size_t ipos1 = size_t(intersectionList[*ic].second);
       G2LIB_ASSERT(
-        ipos0 < polylineList.size(),
+        ipos0 < size_t(numSegment()),
         "Bad ipos0 = " << ipos0
       )
       G2LIB_ASSERT(
-        ipos1 < pl.polylineList.size(),
+        ipos1 < size_t(pl.numSegment()),
         "Bad ipos1 = " << ipos1
       )
       real_type sss0, sss1;
-      bool ok = polylineList[ipos0].intersect(pl.polylineList[ipos1],sss0,sss1);
+      bool ok = segmentIntersect(
+        xv[ipos0],    yv[ipos0],    xv[ipos0+1],    yv[ipos0+1],
+        pl.xv[ipos1], pl.yv[ipos1], pl.xv[ipos1+1], pl.yv[ipos1+1],
+        sss0, sss1
+      );
       if ( ok ) {
         ss0.push_back(sss0+s0[ipos0]);
         ss1.push_back(sss1+pl.s0[ipos1]);
@@ -632,23 +1067,21 @@ namespace G2lib {
 #else
     ss0.clear();
     ss1.clear();
-    vector<LineSegment>::const_iterator ic0 = lvec.begin();
-    vector<real_type>::const_iterator   is0 = s0.begin();
-    while ( ic0 != lvec.end() ) {
-      vector<LineSegment>::const_iterator ic1 = pl.lvec.begin();
-      vector<real_type>::const_iterator   is1 = pl.s0.begin();
-      while ( ic1 != pl.lvec.end() ) {
+    size_t ns0 = xv.size()-1;
+    size_t ns1 = pl.xv.size()-1;
+    for ( size_t i0 = 0; i0 < ns0; ++i0 ) {
+      for ( size_t i1 = 0; i1 < ns1; ++i1 ) {
         real_type a0, a1;
-        bool ok = ic0->intersect( *ic1, a0, a1 );
+        bool ok = segmentIntersect(
+          xv[i0],    yv[i0],    xv[i0+1],    yv[i0+1],
+          pl.xv[i1], pl.yv[i1], pl.xv[i1+1], pl.yv[i1+1],
+          a0, a1
+        );
         if ( ok ) {
-          ss0.push_back( (*is0) + a0 );
-          ss1.push_back( (*is1) + a1 );
+          ss0.push_back( s0[i0] + a0 );
+          ss1.push_back( pl.s0[i1] + a1 );
         }
-        ++ic1;
-        ++is1;
       }
-      ++ic0;
-      ++is0;
     }
 #endif
 
@@ -673,6 +1106,24 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  PolyLine::self_intersect( IntersectList & ilist ) const {
+    if ( numSegment() < 3 ) return;
+    this->build_AABBtree();
+    IntersectList res;
+    Self_list fun( this, ends_meet(), &res );
+    if ( aabb_is_flat ) aabb_flat.self_collision( fun );
+    else                aabb_tree.self_collision( fun );
+    // sorted and without the crossings at a vertex found twice
+    std::sort( res.begin(), res.end() );
+    IntersectFirstK all( numeric_limits<int_type>::max(), ilist );
+    IntersectUnique V( all, 1e-8 );
+    IntersectList::const_iterator it;
+    for ( it = res.begin(); it != res.end(); ++it ) V.visit( it->first, it->second );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   ostream_type &
   operator << ( ostream_type & stream, PolyLine const & P ) {
     stream
@@ -688,6 +1139,28 @@ namespace G2lib {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  /*\
+   |   __ _  _ _ _ ___ ___ _ _
+   |  / _| || | '_(_-</ _ \ '_|
+   |  \__|\_,_|_| /__/\___/_|
+  \*/
+
+  void
+  PolyLineCursor::anchor( real_type s ) {
+    int_type    i = PL.findAtS( s, idx );
+    LineSegment C = PL.getSegment( i );
+    real_type   t = s - PL.s0[size_t(i)];
+    // the last segment is extended as in `eval`
+    real_type sb = s-t;
+    real_type se = sb+C.length();
+    if ( i+1 == PL.numSegment() )
+      se = numeric_limits<real_type>::infinity();
+    this->setPiece( sb, se, C.thetaBegin(), 0, 0 );
+    real_type x, y;
+    C.eval( t, x, y );
+    this->setState( s, x, y );
+  }
+
 }
 
 // EOF: PolyLine.cc
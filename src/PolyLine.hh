@@ -48,20 +48,31 @@ namespace G2lib {
   class PolyLine : public BaseCurve {
     friend class ClothoidList;
     friend class BiarcList;
+    friend class PolyLineCursor;
+    friend class CurveBinary;
+    friend class CurveIndex;
   private:
-    vector<LineSegment> polylineList;
-    vector<real_type>   s0;
-    real_type           xe, ye;
+    // vertices and their curvilinear abscissa (structure of arrays),
+    // the segment `i` joins the vertices `i` and `i+1`
+    vector<real_type> xv, yv;
+    vector<real_type> s0;
+
+    #ifndef G2LIB_USE_CXX11
+    mutable int_type lastInterval;
+    #endif
 
     #ifdef G2LIB_USE_CXX11
-    mutable std::mutex                         lastInterval_mutex;
-    mutable std::map<std::thread::id,int_type> lastInterval_by_thread;
+    mutable std::atomic<bool> aabb_done; // set after the tree is built
+    mutable std::mutex   aabb_mutex; // serializes the lazy build of the tree
     #else
-    mutable int_type lastInterval;
+    mutable bool         aabb_done;
     #endif
+    mutable bool         aabb_is_flat; // aabb_flat used in place of aabb_tree
+    mutable bool         aabb_prepared; // built by prepare_AABBtree, no lazy rebuild
+    mutable AABBtree     aabb_tree;
+    mutable AABBtreeFlat aabb_flat;
 
-    mutable bool     aabb_done;
-    mutable AABBtree aabb_tree;
+    class SegmentDistance;
 
     class Collision_list {
       PolyLine const * pPL1;
@@ -73,17 +84,103 @@ namespace G2lib {
       {}
 
       bool
-      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const {
-        LineSegment const & LS1 = pPL1->polylineList[size_t(ptr1->Ipos())];
-        LineSegment const & LS2 = pPL2->polylineList[size_t(ptr2->Ipos())];
-        return LS1.collision( LS2 );
+      operator () ( int_type ipos1, int_type ipos2 ) const {
+        size_t i = size_t(ipos1);
+        size_t j = size_t(ipos2);
+        return segmentCollision(
+          pPL1->xv[i], pPL1->yv[i], pPL1->xv[i+1], pPL1->yv[i+1],
+          pPL2->xv[j], pPL2->yv[j], pPL2->xv[j+1], pPL2->yv[j+1]
+        );
+      }
+
+      bool
+      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const
+      { return (*this)( ptr1->Ipos(), ptr2->Ipos() ); }
+    };
+
+    // a pair of segments of the same polyline for `self_collision` and
+    // `self_intersect`: consecutive segments (also the last and the first
+    // one of a closed polyline) are not a crossing. The crossings are
+    // appended to `pRes` if not nullptr, otherwise the first one stops
+    // the traversal
+    class Self_list {
+      PolyLine const * pPL;
+      bool     const   closed;
+      IntersectList  * pRes;
+    public:
+      Self_list( PolyLine const * _pPL, bool _closed, IntersectList * _pRes )
+      : pPL(_pPL)
+      , closed(_closed)
+      , pRes(_pRes)
+      {}
+
+      bool
+      operator () ( int_type ipos1, int_type ipos2 ) const {
+        size_t i = size_t(std::min( ipos1, ipos2 ));
+        size_t j = size_t(std::max( ipos1, ipos2 ));
+        if ( j-i <= 1 ) return false;
+        if ( closed && i == 0 && j+2 == pPL->xv.size() ) return false;
+        vector<real_type> const & xv = pPL->xv;
+        vector<real_type> const & yv = pPL->yv;
+        if ( pRes == nullptr )
+          return segmentCollision(
+            xv[i], yv[i], xv[i+1], yv[i+1], xv[j], yv[j], xv[j+1], yv[j+1]
+          );
+        real_type si, sj;
+        if ( segmentIntersect(
+               xv[i], yv[i], xv[i+1], yv[i+1], xv[j], yv[j], xv[j+1], yv[j+1],
+               si, sj
+             ) )
+          pRes->push_back( Ipair( si + pPL->s0[i], sj + pPL->s0[j] ) );
+        return false;
       }
+
+      bool
+      operator () ( BBox::PtrBBox ptr1, BBox::PtrBBox ptr2 ) const
+      { return (*this)( ptr1->Ipos(), ptr2->Ipos() ); }
     };
 
+    // the last vertex is the first one: the first and the last segment
+    // are consecutive
+    bool
+    ends_meet() const {
+      return hypot( xv.back()-xv.front(), yv.back()-yv.front() ) <=
+             machepsi1000*(1+s0.back());
+    }
+
+    // unit tangent of the segment `i` (zero if degenerate)
+    void
+    tangent( size_t i, real_type & tx, real_type & ty ) const {
+      real_type dx = xv[i+1]-xv[i];
+      real_type dy = yv[i+1]-yv[i];
+      real_type L  = hypot( dx, dy );
+      if ( L > 0 ) { tx = dx/L; ty = dy/L; }
+      else         { tx = ty = 0; }
+    }
+
+    // closest point of the segment `i`, as `LineSegment::closestPoint_ISO`
+    int_type
+    closestPoint_segment(
+      size_t      i,
+      real_type   qx,
+      real_type   qy,
+      real_type & X,
+      real_type & Y,
+      real_type & S,
+      real_type & T,
+      real_type & DST
+    ) const;
+
+    // curvilinear abscissa from the vertices
+    void build_s0();
+
     void
     resetLastInterval() {
-      std::lock_guard<std::mutex> lck(lastInterval_mutex);
-      lastInterval_by_thread[std::this_thread::get_id()] = 0;
+      #ifdef G2LIB_USE_CXX11
+      findAtS_thread_hint( this ) = 0;
+      #else
+      lastInterval = 0;
+      #endif
     }
 
   public:
@@ -92,6 +189,8 @@ namespace G2lib {
     PolyLine()
     : BaseCurve(G2LIB_POLYLINE)
     , aabb_done(false)
+    , aabb_is_flat(false)
+    , aabb_prepared(false)
     { this->resetLastInterval(); }
 
     void
@@ -101,18 +200,31 @@ namespace G2lib {
     PolyLine( PolyLine const & PL )
     : BaseCurve(G2LIB_POLYLINE)
     , aabb_done(false)
+    , aabb_is_flat(false)
+    , aabb_prepared(false)
     { this->resetLastInterval(); copy(PL); }
 
     int_type
     findAtS( real_type s ) const {
       #ifdef G2LIB_USE_CXX11
-      std::lock_guard<std::mutex> lck(lastInterval_mutex);
-      return ::G2lib::findAtS( s, lastInterval_by_thread[std::this_thread::get_id()], s0 );
+      return this->findAtS( s, findAtS_thread_hint( this ) );
       #else
-      return ::G2lib::findAtS( s, lastInterval, s0 );
+      return this->findAtS( s, lastInterval );
       #endif
     }
 
+    /*!
+     * Find the segment containing `s` starting the search from the
+     * caller owned hint `last_idx` (updated on exit).
+     * No shared state is touched, so a thread or a sweep can keep
+     * its own cursor without any synchronization.
+     */
+    int_type
+    findAtS( real_type s, int_type & last_idx ) const {
+      if ( last_idx < 0 || last_idx >= this->numSegment() ) last_idx = 0;
+      return ::G2lib::findAtS( s, last_idx, s0 );
+    }
+
     explicit PolyLine( LineSegment const & LS );
     explicit PolyLine( CircleArc const & C, real_type tol );
     explicit PolyLine( Biarc const & B, real_type tol );
@@ -123,16 +235,26 @@ namespace G2lib {
     PolyLine const & operator = ( PolyLine const & s )
     { copy(s); return *this; }
 
-    LineSegment const &
+    //! the segment `n` (built from its vertices)
+    LineSegment
     getSegment( int_type n ) const;
 
     int_type
     numSegment() const
-    { return int_type(polylineList.size()); }
+    { return xv.empty() ? 0 : int_type(xv.size()-1); }
 
     int_type
     numPoints() const
-    { return int_type(s0.size()); }
+    { return int_type(xv.size()); }
+
+    //! x-coordinates of the vertices
+    real_type const * xVertices() const { return xv.empty() ? 0 : &xv.front(); }
+
+    //! y-coordinates of the vertices
+    real_type const * yVertices() const { return yv.empty() ? 0 : &yv.front(); }
+
+    //! curvilinear abscissa of the vertices
+    real_type const * sVertices() const { return s0.empty() ? 0 : &s0.front(); }
 
     void polygon( real_type x[], real_type y[]) const;
     void init( real_type x0, real_type y0 );
@@ -192,35 +314,37 @@ namespace G2lib {
     virtual
     real_type
     xBegin() const G2LIB_OVERRIDE
-    { return polylineList.front().xBegin(); }
+    { return xv.front(); }
 
     virtual
     real_type
     yBegin() const G2LIB_OVERRIDE
-    { return polylineList.front().yBegin(); }
+    { return yv.front(); }
 
     virtual
     real_type
     xEnd() const G2LIB_OVERRIDE
-    { return polylineList.back().xEnd(); }
+    { return xv.back(); }
 
     virtual
     real_type
     yEnd() const G2LIB_OVERRIDE
-    { return polylineList.back().yEnd(); }
+    { return yv.back(); }
 
     virtual
     real_type
     X( real_type s ) const G2LIB_OVERRIDE {
-      int_type idx = this->findAtS( s );
-      real_type ss = s0[size_t(idx)];
-      return polylineList[size_t(idx)].X(s-ss);
+      real_type x, y;
+      this->eval( s, x, y );
+      return x;
     }
 
     virtual
     real_type
     X_D( real_type s ) const G2LIB_OVERRIDE {
-      return polylineList[size_t(this->findAtS( s ))].c0;
+      real_type tx, ty;
+      this->tangent( size_t(this->findAtS( s )), tx, ty );
+      return tx;
     }
 
     virtual
@@ -236,15 +360,17 @@ namespace G2lib {
     virtual
     real_type
     Y( real_type s ) const G2LIB_OVERRIDE {
-      int_type idx = this->findAtS( s );
-      real_type ss = s0[size_t(idx)];
-      return polylineList[size_t(idx)].Y(s-ss);
+      real_type x, y;
+      this->eval( s, x, y );
+      return y;
     }
 
     virtual
     real_type
     Y_D( real_type s ) const G2LIB_OVERRIDE {
-      return polylineList[size_t(this->findAtS( s ))].s0;
+      real_type tx, ty;
+      this->tangent( size_t(this->findAtS( s )), tx, ty );
+      return ty;
     }
 
     virtual
@@ -280,9 +406,7 @@ namespace G2lib {
       real_type & x,
       real_type & y
     ) const G2LIB_OVERRIDE {
-      int_type idx = this->findAtS( s );
-      real_type ss = s0[size_t(idx)];
-      polylineList[size_t(idx)].eval( s-ss, x, y );
+      this->eval_ISO( s, 0, x, y );
     }
 
     virtual
@@ -292,9 +416,7 @@ namespace G2lib {
       real_type & x_D,
       real_type & y_D
     ) const G2LIB_OVERRIDE {
-      int_type idx = this->findAtS( s );
-      real_type ss = s0[size_t(idx)];
-      polylineList[size_t(idx)].eval_D( s-ss, x_D, y_D );
+      this->tangent( size_t(this->findAtS( s )), x_D, y_D );
     }
 
     virtual
@@ -325,22 +447,23 @@ namespace G2lib {
       real_type & x,
       real_type & y
     ) const G2LIB_OVERRIDE {
-      int_type idx = this->findAtS( s );
-      real_type ss = s0[size_t(idx)];
-      polylineList[size_t(idx)].eval_ISO( s-ss, offs, x, y );
+      size_t    idx = size_t(this->findAtS( s ));
+      real_type ss  = s-s0[idx];
+      real_type tx, ty;
+      this->tangent( idx, tx, ty );
+      x = xv[idx] + ss*tx - offs*ty;
+      y = yv[idx] + ss*ty + offs*tx;
     }
 
     virtual
     void
     eval_ISO_D(
       real_type   s,
-      real_type   offs,
+      real_type,
       real_type & x_D,
       real_type & y_D
     ) const G2LIB_OVERRIDE {
-      int_type idx = this->findAtS( s );
-      real_type ss = s0[size_t(idx)];
-      polylineList[size_t(idx)].eval_ISO_D( s-ss, offs, x_D, y_D );
+      this->tangent( size_t(this->findAtS( s )), x_D, y_D );
     }
 
     virtual
@@ -363,6 +486,16 @@ namespace G2lib {
     ) const G2LIB_OVERRIDE
     { x_DDD = y_DDD = 0; }
 
+    // . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . . .
+
+    virtual
+    void
+    sample_stations_ISO(
+      real_type                offs,
+      real_type                tol,
+      std::vector<real_type> & s
+    ) const G2LIB_OVERRIDE;
+
     /*\
      |  _                        __
      | | |_ _ __ __ _ _ __  ___ / _| ___  _ __ _ __ ___
@@ -373,11 +506,7 @@ namespace G2lib {
 
     virtual
     void
-    translate( real_type tx, real_type ty ) G2LIB_OVERRIDE {
-      std::vector<LineSegment>::iterator il;
-      for ( il = polylineList.begin(); il != polylineList.end(); ++il )
-        il->translate( tx, ty );
-    }
+    translate( real_type tx, real_type ty ) G2LIB_OVERRIDE;
 
     virtual
     void
@@ -385,11 +514,7 @@ namespace G2lib {
       real_type angle,
       real_type cx,
       real_type cy
-    ) G2LIB_OVERRIDE {
-      std::vector<LineSegment>::iterator il;
-      for ( il = polylineList.begin(); il != polylineList.end(); ++il )
-        il->rotate( angle, cx, cy );
-    }
+    ) G2LIB_OVERRIDE;
 
     virtual
     void
@@ -408,7 +533,15 @@ namespace G2lib {
     trim( real_type s_begin, real_type s_end ) G2LIB_OVERRIDE;
 
     /*!
-     * \brief compute the point at minimum distance from a point `[x,y]` and the line segment
+     * \brief compute the point at minimum distance from a point `[x,y]` and the polyline
+     *
+     * The segments are searched on the AABB tree starting from the
+     * segment found by the previous call of the thread, so consecutive
+     * points along a path are projected in (almost) constant time.
+     * The tree is the one of `prepare_AABBtree` or it is built by the
+     * first call under a lock: concurrent calls (also of `distance`,
+     * `findST_ISO`, `nearestSegments` and `distanceField`) on the same
+     * polyline are safe, with a prepared tree they take no lock.
      *
      * \param x x-coordinate
      * \param y y-coordinate
@@ -429,6 +562,36 @@ namespace G2lib {
       real_type & DST
     ) const G2LIB_OVERRIDE;
 
+    /*!
+     * As `closestPoint_ISO` with the caller owned hint `iseg`: the search
+     * starts from the segment `iseg` (and its neighbours), on exit `iseg`
+     * is the segment of the closest point.
+     */
+    int_type
+    closestPoint_ISO(
+      real_type   x,
+      real_type   y,
+      real_type & X,
+      real_type & Y,
+      real_type & S,
+      real_type & T,
+      real_type & DST,
+      int_type  & iseg
+    ) const;
+
+    /*!
+     * The segment of `[ibegin,iend)` nearest to `(qx,qy)` and its
+     * distance `dst`, by a linear scan of the vertices (no AABB tree).
+     */
+    int_type
+    closestSegment(
+      real_type   qx,
+      real_type   qy,
+      int_type    ibegin,
+      int_type    iend,
+      real_type & dst
+    ) const;
+
     virtual
     int_type
     closestPoint_ISO(
@@ -444,6 +607,58 @@ namespace G2lib {
       G2LIB_DO_ERROR( "PolyLine::closestPoint( ... offs ... ) not available!" )
     }
 
+    /*!
+     *  The (at most) `k` segments nearest to `(qx,qy)` and not farther
+     *  than `dmax`, by increasing distance (best first search on the
+     *  AABB tree).
+     *
+     *  \param  qx    x-coordinate of the point
+     *  \param  qy    y-coordinate of the point
+     *  \param  k     maximum number of segments
+     *  \param  dmax  maximum distance
+     *  \param  iseg  index of the segments
+     *  \param  s     parameter on the polyline of the closest point of the segments
+     *  \param  dst   distance of the segments
+     */
+    void
+    nearestSegments(
+      real_type           qx,
+      real_type           qy,
+      int_type            k,
+      real_type           dmax,
+      vector<int_type>  & iseg,
+      vector<real_type> & s,
+      vector<real_type> & dst
+    ) const;
+
+    //! the segments with distance from `(qx,qy)` not greater than `r`, as `nearestSegments`
+    void
+    segmentsWithin(
+      real_type           qx,
+      real_type           qy,
+      real_type           r,
+      vector<int_type>  & iseg,
+      vector<real_type> & s,
+      vector<real_type> & dst
+    ) const {
+      nearestSegments(
+        qx, qy, std::numeric_limits<int_type>::max(), r, iseg, s, dst
+      );
+    }
+
+    /*!
+     *  Distance field clipped at `dmax`: `dst[i]` is the distance of
+     *  `(qx[i],qy[i])` from the polyline, or `dmax` if it is farther.
+     */
+    void
+    distanceField(
+      int_type        n,
+      real_type const qx[],
+      real_type const qy[],
+      real_type       dmax,
+      real_type       dst[]
+    ) const;
+
     /*\
      |             _ _ _     _
      |    ___ ___ | | (_)___(_) ___  _ __
@@ -468,6 +683,14 @@ namespace G2lib {
       return this->collision( CL );
     }
 
+    /*!
+     *  True if the polyline crosses itself: the AABB tree is traversed
+     *  against itself, consecutive segments are skipped and the search
+     *  stops at the first crossing. A closed polyline is not a crossing.
+     */
+    bool
+    self_collision() const;
+
     /*\
      |   _       _                          _
      |  (_)_ __ | |_ ___ _ __ ___  ___  ___| |_
@@ -497,7 +720,7 @@ namespace G2lib {
       real_type        offs_pl,
       IntersectList  & ilist,
       bool             swap_s_vals
-    ) {
+    ) const {
       G2LIB_ASSERT(
         isZero(offs) && isZero(offs_pl),
         "PolyLine::intersect( offs ... ) not available!"
@@ -505,6 +728,14 @@ namespace G2lib {
       this->intersect( pl, ilist, swap_s_vals );
     }
 
+    /*!
+     *  Append to `ilist` the points where the polyline crosses itself
+     *  as pairs `(s1,s2)` with `s1 < s2`, sorted by `s1`.
+     *  A crossing at a vertex is listed once.
+     */
+    void
+    self_intersect( IntersectList & ilist ) const;
+
     virtual
     void
     info( ostream_type & stream ) const G2LIB_OVERRIDE
@@ -518,15 +749,62 @@ namespace G2lib {
     build_AABBtree( AABBtree & aabb ) const;
 
     void
-    build_AABBtree() const {
-      if ( !aabb_done ) {
-        this->build_AABBtree( aabb_tree );
-        aabb_done = true;
-      }
+    build_AABBtree( AABBtreeFlat & aabb ) const;
+
+    /*!
+     * Build the AABB tree used by the queries if it is missing, or if it
+     * is not prepared and `use_flat_AABBtree` has changed.
+     * When the tree is there the check takes no lock. Otherwise the build
+     * is serialized on a mutex of the polyline, so concurrent queries on
+     * a shared polyline are safe. Changing `use_flat_AABBtree` while
+     * other threads query the polyline is not.
+     */
+    void
+    build_AABBtree() const;
+
+    /*!
+     * Build the AABB tree (an `AABBtreeFlat`) once: until the polyline
+     * is changed `collision`, `intersect` and `closestPoint_ISO` only
+     * read it, so they can run concurrently from many threads without locking.
+     */
+    void
+    prepare_AABBtree() {
+      if ( aabb_done && aabb_prepared ) return;
+      aabb_is_flat = true;
+      aabb_tree.clear();
+      this->build_AABBtree( aabb_flat );
+      aabb_done     = true;
+      aabb_prepared = true;
     }
 
   };
 
+  //! Forward cursor on a `PolyLine` (see `CurveCursor`),
+  //! the polyline must outlive the cursor
+  class PolyLineCursor : public CurveCursor {
+    PolyLine const & PL;
+    int_type         idx; // hint of the segment search
+
+    void anchor( real_type s ) G2LIB_OVERRIDE;
+
+  public:
+
+    /*!
+     *  \param[in] _PL  the polyline
+     *  \param[in] _tol maximum position error
+     *  \param[in] s    initial curvilinear abscissa
+     */
+    PolyLineCursor(
+      PolyLine const & _PL,
+      real_type        _tol = 1e-10,
+      real_type        s    = 0
+    )
+    : CurveCursor(_tol)
+    , PL(_PL)
+    , idx(0)
+    { this->anchor( s ); }
+  };
+
 }
 
 #endif
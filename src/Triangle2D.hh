@@ -25,6 +25,7 @@
 #define TRIANGLE2D_HH
 
 #include "G2lib.hh"
+#include "AABBtree.hh"
 #include <vector>
 
 //! Clothoid computations routine
@@ -228,6 +229,54 @@ namespace G2lib {
 
   };
 
+  /*\
+   |     _        _    ____  ____  _        _                   _
+   |    / \      / \  | __ )| __ )| |_ _ __(_) __ _ _ __   __ _| | ___  ___
+   |   / _ \    / _ \ |  _ \|  _ \| __| '__| |/ _` | '_ \ / _` | |/ _ \/ __|
+   |  / ___ \  / ___ \| |_) | |_) | |_| |  | | (_| | | | | (_| | |  __/\__ \
+   | /_/   \_\/_/   \_\____/|____/ \__|_|  |_|\__,_|_| |_|\__, |_|\___||___/
+   |                                                      |___/
+  \*/
+  /*!
+   * Triangles covering a curve at offset `offs` and their AABB tree.
+   * Built once by the `prepare_AABBtree_ISO` method of the curves
+   * and then only read, so it can be shared by many threads.
+   */
+  class AABBtriangles {
+  public:
+    real_type          offs;
+    real_type          max_angle;
+    real_type          max_size;
+    vector<Triangle2D> tri;
+    AABBtreeFlat       tree;
+
+    bool
+    match(
+      real_type _offs,
+      real_type _max_angle,
+      real_type _max_size
+    ) const {
+      return isZero( offs-_offs ) &&
+             isZero( max_angle-_max_angle ) &&
+             isZero( max_size-_max_size );
+    }
+
+    //! entry of `vec` built with `(offs,max_angle,max_size)`, `nullptr` if none
+    static
+    AABBtriangles const *
+    find(
+      vector<AABBtriangles> const & vec,
+      real_type                     offs,
+      real_type                     max_angle,
+      real_type                     max_size
+    ) {
+      vector<AABBtriangles>::const_iterator it;
+      for ( it = vec.begin(); it != vec.end(); ++it )
+        if ( it->match( offs, max_angle, max_size ) ) return &(*it);
+      return nullptr;
+    }
+  };
+
 }
 
 #endif
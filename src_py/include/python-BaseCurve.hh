@@ -162,6 +162,11 @@ namespace G2lib {
         PYBIND11_OVERLOAD_PURE(int_type, G2lib::BaseCurve, closestPoint_ISO, qx, qy, offs, x, y, s, t, dst);
       }
 
+      void
+      sample_stations_ISO(real_type offs, real_type tol, std::vector<real_type> & s) const override {
+        PYBIND11_OVERLOAD_PURE(void, G2lib::BaseCurve, sample_stations_ISO, offs, tol, s);
+      }
+
       void
       info(ostream_type & stream) const override {
         PYBIND11_OVERLOAD_PURE(void, G2lib::BaseCurve, info, stream);
@@ -0,0 +1,162 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "PolyLine.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <thread>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static real_type const offsets[] = { -1.75, 0, 1.75 }; // one for each lane
+
+// closest point to pseudo random points, lane by lane
+// (only the lane `only` if it is not negative)
+static
+void
+query(
+  G2lib::ClothoidList const * pCL,
+  unsigned                    seed,
+  int_type                    nq,
+  int_type                    only,
+  real_type                 * res
+) {
+  real_type L = pCL->length();
+  for ( int_type i = 0; i < nq; ++i ) {
+    seed = seed*1664525u + 1013904223u;
+    real_type s = L*real_type(seed>>8)/real_type(1u<<24);
+    seed = seed*1664525u + 1013904223u;
+    real_type d = 8*real_type(seed>>8)/real_type(1u<<24) - 4;
+    real_type qx, qy;
+    pCL->eval_ISO( s, d, qx, qy );
+    if ( only >= 0 && i%3 != only ) continue;
+    real_type x, y, ss, t, dst;
+    pCL->closestPoint_ISO( qx, qy, offsets[i%3], x, y, ss, t, dst );
+    res[i] = ss;
+  }
+}
+
+// intersections of the lanes of two lists and of two polylines
+static
+void
+cross(
+  G2lib::ClothoidList const * pCL1,
+  G2lib::ClothoidList const * pCL2,
+  G2lib::PolyLine     const * pPL1,
+  G2lib::PolyLine     const * pPL2,
+  int_type                    nrep,
+  int_type                  * res
+) {
+  int_type n = 0;
+  for ( int_type k = 0; k < nrep; ++k ) {
+    G2lib::IntersectList ilist;
+    pCL1->intersect_ISO( offsets[k%3], *pCL2, offsets[(k+1)%3], ilist, false );
+    n += int_type(ilist.size());
+    if ( pCL1->collision_ISO( offsets[k%3], *pCL2, offsets[(k+1)%3] ) ) ++n;
+    vector<real_type> s1, s2;
+    pPL1->intersect( *pPL2, s1, s2 );
+    n += int_type(s1.size());
+  }
+  *res = n;
+}
+
+int
+main() {
+
+  int_type const NSEG = 5000;
+  int_type const NQ   = 20000;
+  int_type const NREP = 30;
+
+  vector<real_type> x1(NSEG+1), y1(NSEG+1), x2(NSEG+1), y2(NSEG+1);
+  for ( int_type i = 0; i <= NSEG; ++i ) {
+    real_type t = i*0.01;
+    x1[i] = 10*t;
+    y1[i] = 5*sin(t) + 0.5*sin(7*t);
+    x2[i] = 10*t + 0.3;
+    y2[i] = 5*cos(1.1*t);
+  }
+  G2lib::ClothoidList CL1, CL2;
+  CL1.build_G1( NSEG+1, &x1.front(), &y1.front() );
+  CL2.build_G1( NSEG+1, &x2.front(), &y2.front() );
+  G2lib::PolyLine PL1, PL2;
+  PL1.build( &x1.front(), &y1.front(), NSEG+1 );
+  PL2.build( &x2.front(), &y2.front(), NSEG+1 );
+
+  unsigned const NT = max( 4u, thread::hardware_concurrency() );
+
+  // reference results computed serially with the lazy cache,
+  // one lane at a time to not rebuild the cache at each query
+  vector<real_type> ref(NT*NQ);
+  vector<int_type>  iref(NT);
+  for ( int_type lane = 0; lane < 3; ++lane )
+    for ( unsigned k = 0; k < NT; ++k )
+      query( &CL1, 1234u+k, NQ, lane, &ref[k*NQ] );
+
+  // alternating the lanes the lazy cache is rebuilt at each query
+  int_type const NLAZY = 60;
+  TicToc tictoc;
+  tictoc.tic();
+  query( &CL1, 1234u, NLAZY, -1, &ref.front() );
+  tictoc.toc();
+  real_type t_lazy = tictoc.elapsed_ms()/NLAZY;
+  for ( unsigned k = 0; k < NT; ++k )
+    cross( &CL1, &CL2, &PL1, &PL2, NREP, &iref[k] );
+
+  // freeze the acceleration structures, then share the lists
+  tictoc.tic();
+  for ( int i = 0; i < 3; ++i ) {
+    CL1.prepare_AABBtree_ISO( offsets[i] );
+    CL2.prepare_AABBtree_ISO( offsets[i] );
+  }
+  PL1.prepare_AABBtree();
+  PL2.prepare_AABBtree();
+  tictoc.toc();
+  cout << "prepare (3 offsets, 2 lists) " << tictoc.elapsed_ms() << " [ms]\n";
+
+  vector<real_type> res(NT*NQ);
+  vector<int_type>  ires(NT);
+  vector<thread>    workers;
+  tictoc.tic();
+  for ( unsigned k = 0; k < NT; ++k )
+    workers.push_back( thread( query, &CL1, 1234u+k, NQ, -1, &res[k*NQ] ) );
+  for ( unsigned k = 0; k < NT; ++k ) workers[k].join();
+  tictoc.toc();
+  real_type t_prep = tictoc.elapsed_ms()/(NT*NQ);
+
+  workers.clear();
+  for ( unsigned k = 0; k < NT; ++k )
+    workers.push_back( thread( cross, &CL1, &CL2, &PL1, &PL2, NREP, &ires[k] ) );
+  for ( unsigned k = 0; k < NT; ++k ) workers[k].join();
+
+  int_type nbad = 0;
+  for ( size_t i = 0; i < res.size(); ++i )
+    if ( abs(res[i]-ref[i]) > 1e-8 ) ++nbad;
+  bool same_i = iref == ires;
+
+  cout
+    << NT << " threads, " << NT*NQ << " closestPoint alternating 3 offsets\n"
+    << "serial, lazy cache (rebuilt at each query) "
+    << setw(10) << 1000*t_lazy << " [us/query]\n"
+    << "threads, prepared                          "
+    << setw(10) << 1000*t_prep << " [us/query]\n"
+    << "closestPoint mismatch = " << nbad << '\n'
+    << "intersections " << iref[0] << " per thread (same = " << same_i << ")\n";
+
+  // a change of the list drops the prepared trees
+  CL1.translate( 1, 0 );
+  bool dropped = CL1.prepared_AABBtree_ISO( 0 ) == nullptr &&
+                 CL2.prepared_AABBtree_ISO( 0 ) != nullptr;
+  cout << "prepared trees dropped on change = " << dropped << '\n';
+
+  if ( nbad > 0 || !same_i || !dropped ) {
+    cout << "\n\nPREPARED AABB TREE FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
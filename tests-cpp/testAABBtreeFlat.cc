@@ -0,0 +1,199 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "PolyLine.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+typedef G2lib::AABBtree::VecPairIpos VecPairIpos;
+typedef G2lib::AABBtree::VecIpos     VecIpos;
+
+static unsigned seed = 1234u;
+
+static
+real_type
+rnd() {
+  seed = seed*1664525u + 1013904223u;
+  return real_type(seed>>8)/real_type(1u<<24);
+}
+
+// the two trees must select exactly the same boxes
+static
+bool
+check_boxes( int_type n ) {
+  vector<real_type> xmin(n), ymin(n), xmax(n), ymax(n);
+  #ifdef G2LIB_USE_CXX11
+  vector<shared_ptr<G2lib::BBox const> > bboxes;
+  #else
+  vector<G2lib::BBox const *> bboxes;
+  #endif
+  for ( int_type i = 0; i < n; ++i ) {
+    real_type x = 100*rnd(), y = 100*rnd();
+    xmin[i] = x; xmax[i] = x + 2*rnd();
+    ymin[i] = y; ymax[i] = y + (i%10 == 0 ? 0 : 2*rnd()); // some flat box
+    #ifdef G2LIB_USE_CXX11
+    bboxes.push_back( make_shared<G2lib::BBox const>(
+      xmin[i], ymin[i], xmax[i], ymax[i], 0, i
+    ) );
+    #else
+    bboxes.push_back( new G2lib::BBox( xmin[i], ymin[i], xmax[i], ymax[i], 0, i ) );
+    #endif
+  }
+  G2lib::AABBtree     T;
+  G2lib::AABBtreeFlat F;
+  TicToc tictoc;
+
+  tictoc.tic();
+  T.build( bboxes );
+  tictoc.toc();
+  real_type t_tree = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  F.build( n, &xmin.front(), &ymin.front(), &xmax.front(), &ymax.front() );
+  tictoc.toc();
+  real_type t_flat = tictoc.elapsed_ms();
+
+  cout << "build from " << n << " boxes: AABBtree " << t_tree
+       << " [ms], AABBtreeFlat " << t_flat << " [ms] ("
+       << F.num_nodes() << " nodes)\n";
+
+  VecPairIpos iT, iF;
+  T.intersect( T, iT );
+  F.intersect( F, iF );
+  sort( iT.begin(), iT.end() );
+  sort( iF.begin(), iF.end() );
+  bool ok = iT == iF;
+  cout << "boxes " << n << " overlapping pairs " << iT.size()
+       << ( ok ? " OK\n" : " MISMATCH\n" );
+
+  int_type nbad = 0;
+  for ( int_type k = 0; k < 1000; ++k ) {
+    real_type x = 120*rnd()-10, y = 120*rnd()-10;
+    VecIpos cT, cF;
+    T.min_distance( x, y, cT );
+    F.min_distance( x, y, cF );
+    sort( cT.begin(), cT.end() );
+    sort( cF.begin(), cF.end() );
+    if ( cT != cF ) ++nbad;
+  }
+  cout << "min_distance candidate mismatch " << nbad << "/1000\n";
+  return ok && nbad == 0;
+}
+
+int
+main() {
+
+  bool ok = check_boxes( 2000 ) && check_boxes( 100000 );
+
+  // a long wavy road and a second one crossing it many times
+  int_type const NSEG = 50000;
+  vector<real_type> x1(NSEG+1), y1(NSEG+1), x2(NSEG+1), y2(NSEG+1);
+  for ( int_type i = 0; i <= NSEG; ++i ) {
+    real_type t = i*0.01;
+    x1[i] = 10*t;
+    y1[i] = 5*sin(t) + 0.5*sin(7*t);
+    x2[i] = 10*t + 0.3;
+    y2[i] = 5*cos(1.1*t);
+  }
+  G2lib::ClothoidList CL1, CL2;
+  CL1.build_G1( NSEG+1, &x1.front(), &y1.front() );
+  CL2.build_G1( NSEG+1, &x2.front(), &y2.front() );
+  G2lib::PolyLine PL1, PL2;
+  PL1.build( &x1.front(), &y1.front(), NSEG+1 );
+  PL2.build( &x2.front(), &y2.front(), NSEG+1 );
+
+  int_type const NQ = 2000;
+  vector<real_type> qx(NQ), qy(NQ);
+  for ( int_type i = 0; i < NQ; ++i ) {
+    qx[i] = 10*NSEG*0.01*rnd();
+    qy[i] = 20*rnd()-10;
+  }
+
+  G2lib::IntersectList ilist[2];
+  vector<real_type>    s0[2], s1[2], dst[2];
+  bool                 coll[2];
+  real_type            t_build[2], t_inter[2], t_coll[2], t_dist[2];
+  real_type            t_pbuild[2], t_pinter[2];
+  TicToc tictoc;
+
+  for ( int k = 0; k < 2; ++k ) {
+    if ( k == 0 ) G2lib::noFlatAABBtree();
+    else          G2lib::yesFlatAABBtree();
+
+    tictoc.tic();
+    CL1.build_AABBtree_ISO( 0 );
+    CL2.build_AABBtree_ISO( 0 );
+    tictoc.toc();
+    t_build[k] = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    CL1.intersect( CL2, ilist[k], false );
+    tictoc.toc();
+    t_inter[k] = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    coll[k] = CL1.collision( CL2 );
+    tictoc.toc();
+    t_coll[k] = tictoc.elapsed_ms();
+
+    dst[k].resize(NQ);
+    tictoc.tic();
+    for ( int_type i = 0; i < NQ; ++i ) {
+      real_type x, y, s, t;
+      CL1.closestPoint_ISO( qx[i], qy[i], x, y, s, t, dst[k][i] );
+    }
+    tictoc.toc();
+    t_dist[k] = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    PL1.build_AABBtree();
+    PL2.build_AABBtree();
+    tictoc.toc();
+    t_pbuild[k] = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    PL1.intersect( PL2, s0[k], s1[k] );
+    tictoc.toc();
+    t_pinter[k] = tictoc.elapsed_ms();
+
+    sort( ilist[k].begin(), ilist[k].end() );
+    sort( s0[k].begin(), s0[k].end() );
+    sort( s1[k].begin(), s1[k].end() );
+  }
+
+  bool same_i = ilist[0] == ilist[1];
+  bool same_p = s0[0] == s0[1] && s1[0] == s1[1];
+  real_type err = 0;
+  for ( int_type i = 0; i < NQ; ++i ) err = max( err, abs(dst[0][i]-dst[1][i]) );
+
+  cout
+    << "\nClothoidList " << NSEG << " segments, "
+    << ilist[0].size() << " intersections (same = " << same_i << ")\n"
+    << "PolyLine " << NSEG << " segments, "
+    << s0[0].size() << " intersections (same = " << same_p << ")\n"
+    << "collision " << coll[0] << " " << coll[1] << "\n"
+    << "closestPoint max difference " << err << "\n\n"
+    << "                         AABBtree    AABBtreeFlat [ms]\n"
+    << "ClothoidList build   " << setw(12) << t_build[0]  << setw(12) << t_build[1]  << '\n'
+    << "ClothoidList inter.  " << setw(12) << t_inter[0]  << setw(12) << t_inter[1]  << '\n'
+    << "ClothoidList coll.   " << setw(12) << t_coll[0]   << setw(12) << t_coll[1]   << '\n'
+    << "closestPoint x" << NQ << setw(12) << t_dist[0] << setw(12) << t_dist[1] << '\n'
+    << "PolyLine build       " << setw(12) << t_pbuild[0] << setw(12) << t_pbuild[1] << '\n'
+    << "PolyLine inter.      " << setw(12) << t_pinter[0] << setw(12) << t_pinter[1] << '\n';
+
+  G2lib::noFlatAABBtree();
+
+  if ( !ok || !same_i || !same_p || coll[0] != coll[1] || err > 1e-10 ) {
+    cout << "\n\nAABBtreeFlat FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
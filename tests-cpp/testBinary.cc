@@ -0,0 +1,257 @@
+//#define _USE_MATH_DEFINES
+#include "CurveBinary.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// maximum distance between two curves (and between the view and the curve)
+template <typename CURVE>
+static
+real_type
+compare(
+  CURVE                  const & A,
+  CURVE                  const & B,
+  G2lib::CurveBinaryView const & V,
+  int_type                       n
+) {
+  real_type err = abs( A.length()-B.length() );
+  for ( int_type i = 0; i <= n; ++i ) {
+    real_type s = (i*A.length())/n;
+    real_type xa, ya, xb, yb, xv, yv;
+    A.eval( s, xa, ya );
+    B.eval( s, xb, yb );
+    V.eval( s, xv, yv );
+    err = max( err, max( hypot( xa-xb, ya-yb ), hypot( xa-xv, ya-yv ) ) );
+  }
+  return err;
+}
+
+// the text export of `ClothoidList::export_table` read back
+static
+void
+read_table( istream & stream, G2lib::ClothoidList & CL ) {
+  string line;
+  getline( stream, line ); // header
+  CL.init();
+  real_type x0, y0, th0, k0, dk, L;
+  while ( stream >> x0 >> y0 >> th0 >> k0 >> dk >> L )
+    CL.push_back( x0, y0, th0, k0, dk, L );
+}
+
+int
+main() {
+
+  char const * fname = "testBinary.g2b";
+  bool ok = true;
+
+  int_type const NP = 200001;
+  vector<real_type> xp(NP), yp(NP);
+  for ( int_type i = 0; i < NP; ++i ) {
+    real_type t = i*0.01;
+    xp[i] = 10*t;
+    yp[i] = 5*sin(t) + 0.5*sin(7*t);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( NP, &xp.front(), &yp.front() );
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // round trip of the three curve types
+  {
+    int_type const NS = 2001;
+    G2lib::BiarcList BL;
+    BL.build_G1( NS, &xp.front(), &yp.front() );
+    G2lib::PolyLine PL;
+    PL.build( &xp.front(), &yp.front(), NS );
+    G2lib::ClothoidList CC;
+    real_type xc[] = { 0, 10, 10, 0, 0 };
+    real_type yc[] = { 0, 0, 10, 10, 0 };
+    CC.build_G1( 5, xc, yc );
+    CC.make_closed();
+
+    ostringstream sb, sp, sc;
+    G2lib::CurveBinary::save( BL, sb );
+    G2lib::CurveBinary::save( PL, sp );
+    G2lib::CurveBinary::save( CC, sc );
+    // an 8 bytes aligned copy of the data
+    string db = sb.str(), dp = sp.str(), dc = sc.str();
+    vector<real_type> bb( db.size()/8 ), bp( dp.size()/8 ), bc( dc.size()/8 );
+    copy( db.begin(), db.end(), reinterpret_cast<char*>(&bb.front()) );
+    copy( dp.begin(), dp.end(), reinterpret_cast<char*>(&bp.front()) );
+    copy( dc.begin(), dc.end(), reinterpret_cast<char*>(&bc.front()) );
+
+    G2lib::CurveBinaryView VB( &bb.front(), db.size() );
+    G2lib::CurveBinaryView VP( &bp.front(), dp.size() );
+    G2lib::CurveBinaryView VC( &bc.front(), dc.size() );
+    G2lib::BiarcList    BL2;
+    G2lib::PolyLine     PL2;
+    G2lib::ClothoidList CC2;
+    G2lib::CurveBinary::load( VB, BL2 );
+    G2lib::CurveBinary::load( VP, PL2 );
+    G2lib::CurveBinary::load( VC, CC2 );
+    real_type eb = compare( BL, BL2, VB, 10000 );
+    real_type ep = compare( PL, PL2, VP, 10000 );
+    real_type ec = compare( CC, CC2, VC, 1000 );
+    // closed curve: the view wraps as `eval`
+    real_type xa, ya, xv, yv;
+    CC.eval( 2.5*CC.length(), xa, ya );
+    VC.eval( 2.5*CC.length(), xv, yv );
+    ec = max( ec, hypot( xa-xv, ya-yv ) );
+    bool okk = eb < 1e-12 && ep < 1e-12 && ec < 1e-12 &&
+               CC2.is_closed() && VC.is_closed() &&
+               BL2.numSegment() == BL.numSegment() &&
+               PL2.numSegment() == PL.numSegment();
+    cout
+      << "round trip, max difference: BiarcList " << eb
+      << ", PolyLine " << ep << ", closed ClothoidList " << ec
+      << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+
+    // bad data are detected
+    int_type nerr = 0;
+    try { G2lib::CurveBinaryView V( &bb.front(), db.size()/2 ); }
+    catch ( exception const & ) { ++nerr; }
+    bb[0] = 0;
+    try { G2lib::CurveBinaryView V( &bb.front(), db.size() ); }
+    catch ( exception const & ) { ++nerr; }
+
+    // corrupted sizes and indices of the saved tree
+    ostringstream st;
+    G2lib::CurveBinary::save( CC, st, true );
+    string dt = st.str();
+    size_t const pad = 7;
+    size_t ns = size_t(CC.numSegment());
+    size_t ot = 64 + 6*((8*ns+pad)&~pad) + ((8*(ns+1)+pad)&~pad); // tree header
+    uint64_t nt, nn;
+    memcpy( &nt, dt.data()+ot,   8 );
+    memcpy( &nn, dt.data()+ot+8, 8 );
+    size_t oic = ot + 64 + 8*((8*nt+pad)&~pad);     // icurve
+    size_t onf = oic + ((4*nt+pad)&~pad) + 4*((8*nn+pad)&~pad); // node first
+    size_t obp = onf + 2*((4*nn+pad)&~pad) + 4*((8*nt+pad)&~pad); // box ipos
+    uint64_t const huge = uint64_t(1) << 61;
+    int32_t  const bad  = 1000000;
+    size_t   const where[] = { 16, 24, 36, ot, oic, onf, obp };
+    size_t   const nbyte[] = { 8, 8, 4, 8, 4, 4, 4 };
+    int_type nbad = 0;
+    for ( int_type k = 0; k < 7; ++k ) {
+      string d = dt;
+      void const * v = nbyte[k] == 8 ? static_cast<void const *>(&huge) : &bad;
+      memcpy( &d[where[k]], v, nbyte[k] );
+      if ( k == 0 ) memcpy( &d[24], &huge, 8 ); // np == ns, both huge
+      vector<real_type> bt( d.size()/8 );
+      copy( d.begin(), d.end(), reinterpret_cast<char*>(&bt.front()) );
+      try { G2lib::CurveBinaryView V( &bt.front(), d.size() ); }
+      catch ( exception const & ) { ++nbad; }
+    }
+    // the untouched data with the tree are accepted
+    vector<real_type> bt( dt.size()/8 );
+    copy( dt.begin(), dt.end(), reinterpret_cast<char*>(&bt.front()) );
+    G2lib::CurveBinaryView VT( &bt.front(), dt.size() );
+    nerr += nbad;
+    cout << "truncated and corrupted data, " << nerr << " errors of 9\n";
+    ok = ok && nerr == 9 && VT.numSegment() == CC.numSegment();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // text versus binary for a large list
+  cout << "\nClothoidList, " << CL.numSegment() << " segments\n";
+  TicToc tictoc;
+
+  tictoc.tic();
+  ostringstream text;
+  text.precision(17);
+  CL.export_table( text );
+  string stext = text.str();
+  tictoc.toc();
+  real_type t_text_save = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  istringstream itext( stext );
+  G2lib::ClothoidList CLt;
+  read_table( itext, CLt );
+  tictoc.toc();
+  real_type t_text_load = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  G2lib::CurveBinary::save_file( CL, fname );
+  tictoc.toc();
+  real_type t_bin_save = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  G2lib::MappedFile      F( fname );
+  G2lib::CurveBinaryView V( F.data(), F.size() );
+  tictoc.toc();
+  real_type t_map = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  G2lib::ClothoidList CL2;
+  G2lib::CurveBinary::load( V, CL2 );
+  tictoc.toc();
+  real_type t_bin_load = tictoc.elapsed_ms();
+
+  real_type el = compare( CL, CL2, V, 100000 );
+  cout
+    << "text:   " << setw(10) << stext.size() << " bytes, save "
+    << t_text_save << " [ms], parse and push_back " << t_text_load << " [ms]\n"
+    << "binary: " << setw(10) << F.size() << " bytes, save "
+    << t_bin_save << " [ms], mmap and view " << t_map
+    << " [ms], copy to ClothoidList " << t_bin_load << " [ms]\n"
+    << "max difference after the round trip " << el << '\n';
+  ok = ok && el < 1e-12 && CL2.numSegment() == CL.numSegment();
+  F.close();
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // persisted AABB tree: the first query does not build the tree
+  {
+    ofstream file( fname, ios::binary );
+    G2lib::CurveBinary::save( CL, file, true );
+  }
+  G2lib::MappedFile      FT( fname );
+  G2lib::CurveBinaryView VT( FT.data(), FT.size() );
+  G2lib::ClothoidList    CL3;
+  G2lib::CurveBinary::load( VT, CL3 );
+  ok = ok && CL3.prepared_AABBtree_ISO( 0 ) != nullptr;
+
+  real_type qx = 1000.3, qy = 2.1, x, y, s, t, d1, d2, d3;
+  tictoc.tic();
+  CL.closestPoint_ISO( qx, qy, 0, x, y, s, t, d1 ); // builds the tree
+  tictoc.toc();
+  real_type t_first = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  CL3.closestPoint_ISO( qx, qy, 0, x, y, s, t, d2 );
+  tictoc.toc();
+  real_type t_first_saved = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  VT.closestPoint_ISO( qx, qy, 0, x, y, s, t, d3 );
+  tictoc.toc();
+  real_type t_first_view = tictoc.elapsed_ms();
+
+  cout
+    << "\nwith the AABB tree, " << FT.size() << " bytes\n"
+    << "first closestPoint_ISO: built tree " << t_first
+    << " [ms], saved tree " << t_first_saved
+    << " [ms], on the view " << t_first_view << " [ms]\n";
+  ok = ok && abs( d1-d2 ) < 1e-12 && abs( d1-d3 ) < 1e-12;
+
+  FT.close();
+  remove( fname );
+
+  if ( !ok ) {
+    cout << "\n\nBINARY FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,90 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// the lists must be identical, not only close
+static
+bool
+same( G2lib::ClothoidList const & A, G2lib::ClothoidList const & B ) {
+  int_type ns = A.numSegment();
+  if ( ns != B.numSegment() ) return false;
+  for ( int_type i = 0; i < ns; ++i ) {
+    G2lib::ClothoidCurve const & a = A.get(i);
+    G2lib::ClothoidCurve const & b = B.get(i);
+    if ( a.xBegin()     != b.xBegin()     ||
+         a.yBegin()     != b.yBegin()     ||
+         a.thetaBegin() != b.thetaBegin() ||
+         a.kappaBegin() != b.kappaBegin() ||
+         a.dkappa()     != b.dkappa()     ||
+         a.length()     != b.length() ) return false;
+  }
+  vector<real_type> sA, tA, kA, sB, tB, kB;
+  A.getSTK( sA, tA, kA );
+  B.getSTK( sB, tB, kB );
+  if ( sA != sB || A.length() != B.length() ) return false;
+  // the evaluation uses the stored abscissae of the segments
+  real_type L = A.length();
+  for ( int_type i = 0; i <= 1000; ++i ) {
+    real_type xa, ya, xb, yb;
+    A.eval( (i*L)/1000, xa, ya );
+    B.eval( (i*L)/1000, xb, yb );
+    if ( xa != xb || ya != yb ) return false;
+  }
+  return true;
+}
+
+int
+main() {
+
+  // a 200 km lane sampled every meter
+  int_type const N = 200001;
+  vector<real_type> x(N), y(N), theta(N);
+  for ( int_type i = 0; i < N; ++i ) {
+    real_type s = i;
+    x[i]     = s + 3*sin(s*0.001);
+    y[i]     = 200*sin(s*0.0005) + 2*sin(s*0.02);
+    theta[i] = atan2( 0.1*cos(s*0.0005) + 0.04*cos(s*0.02), 1 + 0.003*cos(s*0.001) );
+  }
+
+  TicToc tictoc;
+  G2lib::ClothoidList ref;
+  tictoc.tic();
+  ref.build_G1( N, &x.front(), &y.front(), &theta.front() );
+  tictoc.toc();
+  cout << N-1 << " segments\n"
+       << "serial       " << setw(10) << tictoc.elapsed_ms() << " [ms]\n";
+
+  bool ok = true;
+  int_type const threads[] = { 1, 2, 4, 8 };
+  for ( int k = 0; k < 4; ++k ) {
+    G2lib::ClothoidList CL;
+    tictoc.tic();
+    CL.build_G1( N, &x.front(), &y.front(), &theta.front(), threads[k] );
+    tictoc.toc();
+    bool eq = same( ref, CL );
+    cout << setw(2) << threads[k] << " threads   " << setw(10)
+         << tictoc.elapsed_ms() << " [ms] identical = " << eq << '\n';
+    if ( !eq ) ok = false;
+  }
+
+  // more threads than segments
+  G2lib::ClothoidList A, B;
+  A.build_G1( 3, &x.front(), &y.front(), &theta.front() );
+  B.build_G1( 3, &x.front(), &y.front(), &theta.front(), 16 );
+  if ( !same( A, B ) ) ok = false;
+
+  if ( !ok ) {
+    cout << "\n\nPARALLEL build_G1 FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
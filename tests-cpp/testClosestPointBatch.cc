@@ -0,0 +1,152 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static
+real_type
+maxdiff(
+  vector<real_type> const & a,
+  vector<real_type> const & b
+) {
+  real_type err = 0;
+  for ( size_t i = 0; i < a.size(); ++i ) err = max( err, abs(a[i]-b[i]) );
+  return err;
+}
+
+// point by point projection, the reference
+// (returns the number of not orthogonal projections)
+static
+int_type
+scalar(
+  G2lib::ClothoidList const & CL,
+  vector<real_type>   const & qx,
+  vector<real_type>   const & qy,
+  real_type                   offs,
+  vector<real_type>         & s,
+  vector<real_type>         & t,
+  vector<real_type>         & dst
+) {
+  int_type nbad = 0;
+  for ( size_t i = 0; i < qx.size(); ++i ) {
+    real_type x, y;
+    if ( CL.closestPoint_ISO( qx[i], qy[i], offs, x, y, s[i], t[i], dst[i] ) < 0 )
+      ++nbad;
+  }
+  return nbad;
+}
+
+int
+main() {
+
+  // a 10 km road made of 1 m segments
+  int_type const NSEG = 10000;
+  int_type const NQ   = 20000;
+
+  vector<real_type> xr(NSEG+1), yr(NSEG+1);
+  for ( int_type i = 0; i <= NSEG; ++i ) {
+    xr[i] = i;
+    yr[i] = 50*sin(i*0.002) + 5*sin(i*0.03);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( NSEG+1, &xr.front(), &yr.front() );
+  real_type L = CL.length();
+
+  // a vehicle trajectory along the road (coherent points)
+  // and the same points shuffled
+  vector<real_type> qx(NQ), qy(NQ), rx(NQ), ry(NQ);
+  unsigned seed = 1234u;
+  for ( int_type i = 0; i < NQ; ++i ) {
+    seed = seed*1664525u + 1013904223u;
+    real_type d = 6*real_type(seed>>8)/real_type(1u<<24) - 3;
+    CL.eval_ISO( (i*L)/NQ, d + sin(i*0.01), qx[i], qy[i] );
+  }
+  vector<int_type> perm(NQ);
+  for ( int_type i = 0; i < NQ; ++i ) perm[i] = i;
+  for ( int_type i = NQ-1; i > 0; --i ) {
+    seed = seed*1664525u + 1013904223u;
+    swap( perm[i], perm[(seed>>8)%unsigned(i+1)] );
+  }
+  for ( int_type i = 0; i < NQ; ++i ) { rx[i] = qx[perm[i]]; ry[i] = qy[perm[i]]; }
+
+  vector<real_type> s0(NQ), t0(NQ), d0(NQ), s1(NQ), t1(NQ), d1(NQ);
+  real_type err = 0;
+  int_type  nbad = 0, nbad_ref = 0;
+  TicToc    tictoc;
+
+  real_type const offsets[] = { 0, 1.75 };
+  for ( int k = 0; k < 2; ++k ) {
+    real_type offs = offsets[k];
+
+    tictoc.tic();
+    nbad_ref += 3*scalar( CL, qx, qy, offs, s0, t0, d0 );
+    tictoc.toc();
+    real_type t_scalar = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    nbad += CL.closestPoint_batch_ISO( &qx.front(), &qy.front(), NQ, offs,
+                                       &s1.front(), &t1.front(), &d1.front() );
+    tictoc.toc();
+    real_type t_batch = tictoc.elapsed_ms();
+    err = max( err, max( maxdiff( s0, s1 ), maxdiff( d0, d1 ) ) );
+    err = max( err, maxdiff( t0, t1 ) );
+
+    // the prepared flat tree uses the bound of the previous segment
+    CL.prepare_AABBtree_ISO( offs );
+    tictoc.tic();
+    scalar( CL, qx, qy, offs, s1, t1, d1 );
+    tictoc.toc();
+    real_type t_sprep = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    nbad += CL.closestPoint_batch_ISO( &qx.front(), &qy.front(), NQ, offs,
+                                       &s1.front(), &t1.front(), &d1.front() );
+    tictoc.toc();
+    real_type t_prep = tictoc.elapsed_ms();
+    err = max( err, max( maxdiff( s0, s1 ), maxdiff( d0, d1 ) ) );
+
+    tictoc.tic();
+    nbad += CL.closestPoint_batch_ISO( &qx.front(), &qy.front(), NQ, offs,
+                                       &s1.front(), &t1.front(), &d1.front(), 4 );
+    tictoc.toc();
+    real_type t_thread = tictoc.elapsed_ms();
+    err = max( err, max( maxdiff( s0, s1 ), maxdiff( d0, d1 ) ) );
+
+    // no coherence: the warm start does not help but must not hurt
+    nbad_ref += scalar( CL, rx, ry, offs, s0, t0, d0 );
+    tictoc.tic();
+    nbad += CL.closestPoint_batch_ISO( &rx.front(), &ry.front(), NQ, offs,
+                                       &s1.front(), &t1.front(), &d1.front() );
+    tictoc.toc();
+    real_type t_rand = tictoc.elapsed_ms();
+    err = max( err, max( maxdiff( s0, s1 ), maxdiff( d0, d1 ) ) );
+    CL.clear_prepared_AABBtree();
+
+    cout
+      << "offset " << offs << ", " << NQ << " points on " << NSEG << " segments\n"
+      << "closestPoint_ISO loop         " << setw(10) << 1000*t_scalar/NQ << " [us/point]\n"
+      << "batch, lazy tree              " << setw(10) << 1000*t_batch/NQ  << " [us/point]\n"
+      << "closestPoint_ISO loop, prep.  " << setw(10) << 1000*t_sprep/NQ  << " [us/point]\n"
+      << "batch, prepared tree          " << setw(10) << 1000*t_prep/NQ   << " [us/point]\n"
+      << "batch, prepared tree, 4 thr.  " << setw(10) << 1000*t_thread/NQ << " [us/point]\n"
+      << "batch, prepared, shuffled     " << setw(10) << 1000*t_rand/NQ   << " [us/point]\n\n";
+  }
+  cout << "max difference batch vs scalar = " << err << '\n'
+       << "not orthogonal projections = " << nbad
+       << " (scalar " << nbad_ref << ")\n";
+
+  if ( err > 1e-8 || nbad != nbad_ref ) {
+    cout << "\n\nBATCH CLOSEST POINT FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,108 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "BiarcList.hh"
+#include "PolyLine.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// the old dispatch: both the curves copied in the promoted type
+template <typename CURVE>
+static
+bool
+collision_copy( G2lib::BaseCurve const & a, G2lib::BaseCurve const & b ) {
+  CURVE A( a ), B( b );
+  return A.collision( B );
+}
+
+int
+main() {
+
+  int_type const NSEG = 1000;
+  int_type const NREP = 200;
+
+  vector<real_type> x(NSEG+1), y(NSEG+1);
+  for ( int_type i = 0; i <= NSEG; ++i ) {
+    real_type t = i*0.01;
+    x[i] = 10*t;
+    y[i] = 5*sin(t) + 0.5*sin(7*t);
+  }
+  G2lib::ClothoidList CL;
+  G2lib::BiarcList    BL;
+  G2lib::PolyLine     PL;
+  CL.build_G1( NSEG+1, &x.front(), &y.front() );
+  BL.build_G1( NSEG+1, &x.front(), &y.front() );
+  PL.build( &x.front(), &y.front(), NSEG+1 );
+
+  // small curves crossing (or not) the long ones
+  vector<G2lib::LineSegment>   lines;
+  vector<G2lib::ClothoidCurve> clots;
+  vector<G2lib::Biarc>         biarcs;
+  for ( int_type i = 0; i < 20; ++i ) {
+    real_type xx = 5*i, yy = i%2 == 0 ? -10 : 10;
+    lines.push_back( G2lib::LineSegment( xx, yy, G2lib::m_pi/2, 4+i%3 ) );
+    clots.push_back( G2lib::ClothoidCurve( xx, yy, 1, 0.01, 0.001, 4+i%5 ) );
+    biarcs.push_back( G2lib::Biarc( xx, yy, 0, xx+2, yy+6+i%4, 1 ) );
+  }
+
+  // the three long curves against the small ones, both orders
+  int_type nhit = 0, nhit_copy = 0, ncheck = 0;
+  TicToc tictoc;
+
+  tictoc.tic();
+  for ( int_type k = 0; k < NREP; ++k ) {
+    for ( size_t i = 0; i < lines.size(); ++i ) {
+      if ( G2lib::collision( CL, lines[i] ) )  ++nhit;
+      if ( G2lib::collision( clots[i], CL ) )  ++nhit;
+      if ( G2lib::collision( CL, biarcs[i] ) ) ++nhit;
+      if ( G2lib::collision( PL, lines[i] ) )  ++nhit;
+      if ( G2lib::collision( BL, lines[i] ) )  ++nhit;
+      if ( G2lib::collision( biarcs[i], BL ) ) ++nhit;
+      ncheck += 6;
+    }
+  }
+  tictoc.toc();
+  real_type t_dispatch = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  for ( int_type k = 0; k < NREP; ++k ) {
+    for ( size_t i = 0; i < lines.size(); ++i ) {
+      if ( collision_copy<G2lib::ClothoidList>( CL, lines[i] ) )  ++nhit_copy;
+      if ( collision_copy<G2lib::ClothoidList>( clots[i], CL ) )  ++nhit_copy;
+      if ( collision_copy<G2lib::ClothoidList>( CL, biarcs[i] ) ) ++nhit_copy;
+      if ( collision_copy<G2lib::PolyLine>( PL, lines[i] ) )      ++nhit_copy;
+      if ( collision_copy<G2lib::BiarcList>( BL, lines[i] ) )     ++nhit_copy;
+      if ( collision_copy<G2lib::BiarcList>( biarcs[i], BL ) )    ++nhit_copy;
+    }
+  }
+  tictoc.toc();
+  real_type t_copy = tictoc.elapsed_ms();
+
+  // intersections must not change
+  G2lib::IntersectList il1, il2;
+  G2lib::intersect( CL, clots[3], il1, false );
+  G2lib::ClothoidList A( CL ), B( clots[3] );
+  A.intersect( B, il2, false );
+  bool same_i = il1 == il2;
+
+  cout
+    << ncheck << " mixed collision checks (" << NSEG << " segments lists), "
+    << nhit << " hits\n"
+    << "copy in promoted type " << setw(12) << 1000*ncheck/t_copy     << " [checks/s]\n"
+    << "dispatch, no copy     " << setw(12) << 1000*ncheck/t_dispatch << " [checks/s]\n"
+    << "same collisions = " << (nhit == nhit_copy)
+    << ", same intersections = " << same_i << '\n';
+
+  if ( nhit != nhit_copy || !same_i ) {
+    cout << "\n\nCOLLISION DISPATCH FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
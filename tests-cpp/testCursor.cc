@@ -0,0 +1,176 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "BiarcList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// sweep the curve with the cursor and compare with the exact evaluation,
+// return the maximum position error
+template <typename CURVE, typename CURSOR>
+static
+real_type
+sweep_error(
+  CURVE             const & C,
+  vector<real_type> const & s,
+  real_type                 tol,
+  real_type               & err_theta,
+  real_type               & err_kappa
+) {
+  CURSOR    cur( C, tol, s.front() );
+  real_type err = 0;
+  err_theta = err_kappa = 0;
+  for ( size_t i = 0; i < s.size(); ++i ) {
+    cur.moveTo( s[i] );
+    real_type th, k, x, y;
+    C.evaluate( s[i], th, k, x, y );
+    err       = max( err, hypot( x-cur.x(), y-cur.y() ) );
+    err_theta = max( err_theta, abs( th-cur.theta() ) );
+    err_kappa = max( err_kappa, abs( k-cur.kappa() ) );
+  }
+  return err;
+}
+
+template <typename CURVE, typename CURSOR>
+static
+bool
+test(
+  char              const * name,
+  CURVE             const & C,
+  vector<real_type> const & s_uniform,
+  vector<real_type> const & s_random
+) {
+  bool ok = true;
+  cout << '\n' << name << ", " << C.numSegment() << " segments\n";
+  real_type tols[] = { 1e-6, 1e-10 };
+  for ( int_type it = 0; it < 2; ++it ) {
+    real_type tol = tols[it];
+    real_type eth, ek;
+    real_type e1 = sweep_error<CURVE,CURSOR>( C, s_uniform, tol, eth, ek );
+    bool ok1 = e1 <= tol && eth < 1e-10 && ek < 1e-10;
+    real_type e2 = sweep_error<CURVE,CURSOR>( C, s_random, tol, eth, ek );
+    bool ok2 = e2 <= tol && eth < 1e-10 && ek < 1e-10;
+    cout
+      << "tol = " << setw(6) << tol
+      << "  max error: uniform steps " << setw(12) << e1
+      << ", random steps " << setw(12) << e2
+      << ( ok1 && ok2 ? "" : "  FAILED" ) << '\n';
+    ok = ok && ok1 && ok2;
+  }
+
+  // timing of a uniform sweep computing x, y, theta and kappa
+  size_t nn = s_uniform.size();
+  real_type xs = 0;
+  TicToc tictoc;
+
+  tictoc.tic();
+  for ( size_t i = 0; i < nn; ++i ) {
+    real_type th, k, x, y;
+    C.evaluate( s_uniform[i], th, k, x, y );
+    xs += x+y+th+k;
+  }
+  tictoc.toc();
+  real_type t_eval = tictoc.elapsed_ms();
+
+  real_type t_cur[2];
+  for ( int_type it = 0; it < 2; ++it ) {
+    tictoc.tic();
+    CURSOR cur( C, tols[it] );
+    real_type ds = s_uniform[1]-s_uniform[0];
+    for ( size_t i = 0; i < nn; ++i ) {
+      xs += cur.x()+cur.y()+cur.theta()+cur.kappa();
+      cur.advance( ds );
+    }
+    tictoc.toc();
+    t_cur[it] = tictoc.elapsed_ms();
+  }
+  cout
+    << "evaluate " << 1e6*t_eval/nn << " [ns/point]"
+    << ", cursor (tol 1e-6) " << 1e6*t_cur[0]/nn << " [ns/point]"
+    << ", cursor (tol 1e-10) " << 1e6*t_cur[1]/nn << " [ns/point]"
+    << ( xs == 0 ? " " : "" ) << '\n';
+  return ok;
+}
+
+int
+main() {
+
+  int_type const NSEG = 2000;
+  int_type const NPTS = 400000;
+
+  vector<real_type> x(NSEG+1), y(NSEG+1);
+  for ( int_type i = 0; i <= NSEG; ++i ) {
+    real_type t = i*0.01;
+    x[i] = 10*t;
+    y[i] = 5*sin(t) + 0.5*sin(7*t);
+  }
+
+  G2lib::ClothoidList CL;
+  CL.build_G1( NSEG+1, &x.front(), &y.front() );
+  G2lib::BiarcList BL;
+  BL.build_G1( NSEG+1, &x.front(), &y.front() );
+  G2lib::PolyLine PL;
+  PL.build( &x.front(), &y.front(), NSEG+1 );
+
+  bool ok = true;
+  G2lib::BaseCurve const * curves[] = { &CL, &BL, &PL };
+  for ( int_type ic = 0; ic < 3; ++ic ) {
+    // uniform stations and random steps covering the curve
+    real_type L = curves[ic]->length();
+    vector<real_type> s_uniform(NPTS), s_random(NPTS);
+    unsigned seed = 1234u;
+    real_type ss = 0;
+    for ( int_type i = 0; i < NPTS; ++i ) {
+      s_uniform[i] = (i*L)/NPTS;
+      s_random[i]  = ss;
+      seed = seed*1664525u + 1013904223u;
+      ss  += 2*L/NPTS*real_type(seed>>8)/real_type(1u<<24);
+    }
+    switch ( ic ) {
+    case 0:
+      ok = test<G2lib::ClothoidList,G2lib::ClothoidListCursor>(
+        "ClothoidList", CL, s_uniform, s_random
+      ) && ok;
+      break;
+    case 1:
+      ok = test<G2lib::BiarcList,G2lib::BiarcListCursor>(
+        "BiarcList", BL, s_uniform, s_random
+      ) && ok;
+      break;
+    case 2:
+      ok = test<G2lib::PolyLine,G2lib::PolyLineCursor>(
+        "PolyLine", PL, s_uniform, s_random
+      ) && ok;
+      break;
+    }
+  }
+
+  // closed curve: three laps, the abscissa wraps as in `eval`
+  G2lib::ClothoidList CC;
+  real_type xc[] = { 0, 10, 10, 0, 0 };
+  real_type yc[] = { 0, 0, 10, 10, 0 };
+  CC.build_G1( 5, xc, yc );
+  CC.make_closed();
+  vector<real_type> s_laps(30000);
+  for ( size_t i = 0; i < s_laps.size(); ++i )
+    s_laps[i] = (i*3*CC.length())/s_laps.size();
+  real_type eth, ek;
+  real_type ec = sweep_error<G2lib::ClothoidList,G2lib::ClothoidListCursor>(
+    CC, s_laps, 1e-9, eth, ek
+  );
+  cout << "\nclosed ClothoidList, three laps, max error " << ec << '\n';
+  ok = ok && ec <= 1e-9 && eth < 1e-10 && ek < 1e-10;
+
+  if ( !ok ) {
+    cout << "\n\nCURSOR FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,242 @@
+//#define _USE_MATH_DEFINES
+#include "CurveIndex.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static unsigned seed = 1234u;
+
+static
+real_type
+rnd() {
+  seed = seed*1664525u + 1013904223u;
+  return real_type(seed>>8)/real_type(1u<<24);
+}
+
+// distance of the curve `id` (`PolyLine` has no offset version)
+static
+real_type
+curve_distance( G2lib::CurveIndex const & I, int_type id, real_type qx, real_type qy ) {
+  real_type x, y, s, t, d;
+  if ( I.offset( id ) == 0 )
+    I.curve( id ).closestPoint_ISO( qx, qy, x, y, s, t, d );
+  else
+    I.curve( id ).closestPoint_ISO( qx, qy, I.offset( id ), x, y, s, t, d );
+  return d;
+}
+
+// all the curves of the index by increasing distance (brute force)
+static
+void
+brute_force(
+  G2lib::CurveIndex const & I,
+  int_type                  nid,
+  real_type                 qx,
+  real_type                 qy,
+  vector<pair<real_type,int_type> > & res
+) {
+  res.clear();
+  for ( int_type id = 0; id < nid; ++id ) {
+    if ( !I.contains( id ) ) continue;
+    res.push_back( pair<real_type,int_type>( curve_distance( I, id, qx, qy ), id ) );
+  }
+  sort( res.begin(), res.end() );
+}
+
+int
+main() {
+
+  bool ok = true;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // a road network: wavy roads of 4 lanes in a 10km x 10km area
+  int_type const NR = 250;
+  int_type const NP = 31;
+  real_type lanes[] = { -5.25, -1.75, 1.75, 5.25 };
+  vector<G2lib::ClothoidList> roads( NR );
+  for ( int_type r = 0; r < NR; ++r ) {
+    real_type x0 = 10000*rnd(), y0 = 10000*rnd(), th = 2*G2lib::m_pi*rnd();
+    real_type a  = 5+20*rnd(), w = 0.005+0.01*rnd();
+    vector<real_type> xp(NP), yp(NP);
+    for ( int_type i = 0; i < NP; ++i ) {
+      real_type u = 20*i, v = a*sin(w*u);
+      xp[i] = x0 + cos(th)*u - sin(th)*v;
+      yp[i] = y0 + sin(th)*u + cos(th)*v;
+    }
+    roads[r].build_G1( NP, &xp.front(), &yp.front() );
+    // the loop on the curves below does not rebuild the trees
+    for ( int_type k = 0; k < 4; ++k ) roads[r].prepare_AABBtree_ISO( lanes[k] );
+  }
+  // and a few curves of the other types
+  G2lib::LineSegment   L;  L.build_2P( 100, 100, 300, 250 );
+  G2lib::CircleArc     C;  C.build( 500, 500, 0.3, 0.01, 200 );
+  G2lib::Biarc         B;  B.build( 800, 800, 0, 1000, 900, 1.2 );
+  G2lib::ClothoidCurve K;  K.build( 1200, 1200, 0.1, 0.001, 0.0001, 300 );
+  real_type xs[] = { 1500, 1600, 1700, 1650, 1800 };
+  real_type ys[] = { 100, 150, 120, 250, 300 };
+  G2lib::PolyLine      PL; PL.build( xs, ys, 5 );
+  G2lib::BiarcList     BL; BL.build_G1( 5, xs, ys );
+  BL.translate( 0, 500 );
+
+  G2lib::CurveIndex I;
+  TicToc tictoc;
+  tictoc.tic();
+  for ( int_type r = 0; r < NR; ++r )
+    for ( int_type k = 0; k < 4; ++k )
+      I.insert( roads[r], lanes[k] );
+  I.insert( L, 2 );
+  I.insert( C, -1 );
+  I.insert( B );
+  I.insert( K, 1 );
+  I.insert( PL );
+  I.insert( BL );
+  I.update();
+  tictoc.toc();
+  int_type nid = I.numCurves();
+  cout
+    << "index of " << nid << " curves, built in "
+    << tictoc.elapsed_ms() << " [ms]\n";
+
+  // query points near the curves and far from them
+  int_type const NQ = 400;
+  vector<real_type> qx(NQ), qy(NQ);
+  for ( int_type i = 0; i < NQ; ++i ) {
+    if ( i % 4 == 0 ) {
+      qx[i] = 10000*rnd(); qy[i] = 10000*rnd();
+    } else {
+      G2lib::BaseCurve const & c = I.curve( int_type( nid*rnd() ) );
+      real_type x, y;
+      c.eval_ISO( c.length()*rnd(), 20*rnd()-10, x, y );
+      qx[i] = x; qy[i] = y;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // nearest, k nearest and radius queries against the brute force
+  {
+    int_type  nbad = 0;
+    real_type et   = 0;
+    vector<pair<real_type,int_type> > bf;
+    G2lib::CurveIndex::HitList hits;
+    for ( int_type i = 0; i < NQ; ++i ) {
+      brute_force( I, nid, qx[i], qy[i], bf );
+      G2lib::CurveIndex::Hit h;
+      I.closestPoint( qx[i], qy[i], h );
+      if ( abs( h.dst - bf[0].first ) > 1e-8 ) ++nbad;
+      // the closest point and the lateral coordinate give back the query
+      G2lib::BaseCurve const & c = I.curve( h.id );
+      real_type x, y, nx, ny;
+      c.eval_ISO( h.s, I.offset( h.id ), x, y );
+      et = max( et, hypot( x-h.x, y-h.y ) );
+      if ( h.s > 1e-6 && h.s < c.length()-1e-6 ) {
+        c.eval( h.s, x, y );
+        c.nor_ISO( h.s, nx, ny );
+        et = max( et, hypot( x+h.t*nx-qx[i], y+h.t*ny-qy[i] ) );
+      }
+      I.nearest( qx[i], qy[i], 8, hits );
+      if ( hits.size() != 8 ) ++nbad;
+      for ( size_t j = 0; j < hits.size(); ++j )
+        if ( abs( hits[j].dst - bf[j].first ) > 1e-8 ) ++nbad;
+      I.within_distance( qx[i], qy[i], 15, hits );
+      size_t nin = 0;
+      while ( nin < bf.size() && bf[nin].first <= 15 ) ++nin;
+      if ( hits.size() != nin ) ++nbad;
+    }
+    cout
+      << "nearest, k nearest and within distance: " << nbad
+      << " differences from the brute force, closest point error " << et << '\n';
+    ok = ok && nbad == 0 && et < 1e-8;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // box query: the curves with a point in the box are found
+  {
+    int_type nbad = 0, nfound = 0;
+    vector<int_type> ids;
+    for ( int_type i = 0; i < 100; ++i ) {
+      real_type x0 = qx[i]-50, y0 = qy[i]-30, x1 = qx[i]+50, y1 = qy[i]+30;
+      I.within_box( x0, y0, x1, y1, ids );
+      nfound += int_type(ids.size());
+      for ( int_type id = 0; id < nid; ++id ) {
+        G2lib::BaseCurve const & c = I.curve( id );
+        bool in = false;
+        for ( int_type j = 0; !in && j <= 200; ++j ) {
+          real_type x, y;
+          c.eval_ISO( (j*c.length())/200, I.offset( id ), x, y );
+          in = x >= x0 && x <= x1 && y >= y0 && y <= y1;
+        }
+        if ( in && !binary_search( ids.begin(), ids.end(), id ) ) ++nbad;
+      }
+    }
+    cout << "within box: " << nfound << " curves found, " << nbad << " missed\n";
+    ok = ok && nbad == 0 && nfound > 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // remove a lane of each road and insert it again
+  {
+    for ( int_type r = 0; r < NR; ++r ) I.remove( 4*r+1 );
+    int_type nbad = 0;
+    vector<pair<real_type,int_type> > bf;
+    G2lib::CurveIndex::HitList hits;
+    for ( int_type i = 0; i < NQ; i += 4 ) {
+      brute_force( I, nid, qx[i], qy[i], bf );
+      I.nearest( qx[i], qy[i], 3, hits );
+      for ( size_t j = 0; j < hits.size(); ++j )
+        if ( ( hits[j].id < 4*NR && hits[j].id % 4 == 1 ) ||
+             abs( hits[j].dst - bf[j].first ) > 1e-8 ) ++nbad;
+    }
+    bool okk = nbad == 0 && I.numCurves() == nid-NR;
+    for ( int_type r = 0; r < NR; ++r ) {
+      int_type id = I.insert( roads[r], lanes[1] );
+      okk = okk && id % 4 == 1; // the free ids are reused
+    }
+    okk = okk && I.numCurves() == nid;
+    cout << "remove and insert" << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // which lane is this point on? index versus loop on the curves
+  {
+    I.update();
+    real_type sum1 = 0, sum2 = 0;
+    tictoc.tic();
+    for ( int_type i = 0; i < NQ; ++i ) {
+      real_type dmin = 1e100;
+      for ( int_type id = 0; id < nid; ++id )
+        dmin = min( dmin, curve_distance( I, id, qx[i], qy[i] ) );
+      sum1 += dmin;
+    }
+    tictoc.toc();
+    real_type t_loop = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    for ( int_type i = 0; i < NQ; ++i ) {
+      G2lib::CurveIndex::Hit h;
+      I.closestPoint( qx[i], qy[i], h );
+      sum2 += h.dst;
+    }
+    tictoc.toc();
+    real_type t_index = tictoc.elapsed_ms();
+    cout
+      << "\nclosest curve of " << nid << ": loop on closestPoint_ISO "
+      << 1000*t_loop/NQ << " [us/query], CurveIndex "
+      << 1000*t_index/NQ << " [us/query]\n";
+    ok = ok && abs( sum1-sum2 ) < 1e-6;
+  }
+
+  if ( !ok ) {
+    cout << "\n\nCURVE INDEX FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
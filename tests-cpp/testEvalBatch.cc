@@ -0,0 +1,171 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static
+real_type
+maxdiff(
+  vector<real_type> const & a,
+  vector<real_type> const & b
+) {
+  real_type err = 0;
+  for ( size_t i = 0; i < a.size(); ++i ) err = max( err, abs(a[i]-b[i]) );
+  return err;
+}
+
+// compare batch and point by point evaluation for derivative `nder`
+static
+real_type
+check(
+  G2lib::BaseCurve  const & C,
+  vector<real_type> const & s,
+  int_type                  nder,
+  bool                      ISO,
+  real_type                 offs
+) {
+  int_type n = int_type(s.size());
+  vector<real_type> x(s.size()), y(s.size()), xb(s.size()), yb(s.size());
+  for ( int_type i = 0; i < n; ++i ) {
+    if ( ISO ) {
+      switch ( nder ) {
+      case 0: C.eval_ISO( s[i], offs, x[i], y[i] );     break;
+      case 1: C.eval_ISO_D( s[i], offs, x[i], y[i] );   break;
+      case 2: C.eval_ISO_DD( s[i], offs, x[i], y[i] );  break;
+      case 3: C.eval_ISO_DDD( s[i], offs, x[i], y[i] ); break;
+      }
+    } else {
+      switch ( nder ) {
+      case 0: C.eval( s[i], x[i], y[i] );     break;
+      case 1: C.eval_D( s[i], x[i], y[i] );   break;
+      case 2: C.eval_DD( s[i], x[i], y[i] );  break;
+      case 3: C.eval_DDD( s[i], x[i], y[i] ); break;
+      }
+    }
+  }
+  if ( ISO ) {
+    switch ( nder ) {
+    case 0: C.eval_batch_ISO( &s.front(), n, offs, &xb.front(), &yb.front() );     break;
+    case 1: C.eval_batch_ISO_D( &s.front(), n, offs, &xb.front(), &yb.front() );   break;
+    case 2: C.eval_batch_ISO_DD( &s.front(), n, offs, &xb.front(), &yb.front() );  break;
+    case 3: C.eval_batch_ISO_DDD( &s.front(), n, offs, &xb.front(), &yb.front() ); break;
+    }
+  } else {
+    switch ( nder ) {
+    case 0: C.eval_batch( &s.front(), n, &xb.front(), &yb.front() );     break;
+    case 1: C.eval_batch_D( &s.front(), n, &xb.front(), &yb.front() );   break;
+    case 2: C.eval_batch_DD( &s.front(), n, &xb.front(), &yb.front() );  break;
+    case 3: C.eval_batch_DDD( &s.front(), n, &xb.front(), &yb.front() ); break;
+    }
+  }
+  return max( maxdiff( x, xb ), maxdiff( y, yb ) );
+}
+
+int
+main() {
+
+  int_type const NSEG = 2000;
+  int_type const NPTS = 200000;
+
+  vector<real_type> x(NSEG+1), y(NSEG+1);
+  for ( int_type i = 0; i <= NSEG; ++i ) {
+    real_type t = i*0.01;
+    x[i] = 10*t;
+    y[i] = 5*sin(t) + 0.5*sin(7*t);
+  }
+
+  G2lib::ClothoidList CL;
+  CL.build_G1( NSEG+1, &x.front(), &y.front() );
+
+  real_type L = CL.length();
+
+  // sorted stations, stations outside the range and unsorted stations
+  vector<real_type> s_sorted(NPTS), s_out(NPTS), s_rand(NPTS);
+  unsigned seed = 1234u;
+  for ( int_type i = 0; i < NPTS; ++i ) {
+    s_sorted[i] = (i*L)/(NPTS-1);
+    s_out[i]    = (i*1.1*L)/(NPTS-1);
+    seed        = seed*1664525u + 1013904223u;
+    s_rand[i]   = L*real_type(seed>>8)/real_type(1u<<24);
+  }
+
+  real_type err = 0;
+  for ( int_type nder = 0; nder <= 3; ++nder ) {
+    err = max( err, check( CL, s_sorted, nder, false, 0 ) );
+    err = max( err, check( CL, s_sorted, nder, true, 0.5 ) );
+    err = max( err, check( CL, s_out, nder, true, -0.3 ) );
+    err = max( err, check( CL, s_rand, nder, false, 0 ) );
+    err = max( err, check( CL.get(10), s_sorted, nder, true, 0.2 ) );
+  }
+  cout << "max difference batch vs scalar = " << err << '\n';
+
+  // closed curve, stations wrap around
+  G2lib::ClothoidList CC;
+  real_type xc[] = { 0, 10, 10, 0, 0 };
+  real_type yc[] = { 0, 0, 10, 10, 0 };
+  CC.build_G1( 5, xc, yc );
+  CC.make_closed();
+  vector<real_type> s_wrap(1000);
+  for ( int_type i = 0; i < 1000; ++i ) s_wrap[i] = (i*3*CC.length())/999;
+  real_type errc = 0;
+  for ( int_type nder = 0; nder <= 3; ++nder )
+    errc = max( errc, check( CC, s_wrap, nder, true, 1 ) );
+  cout << "max difference batch vs scalar (closed) = " << errc << '\n';
+
+  // timing
+  vector<real_type> xx(NPTS), yy(NPTS);
+  TicToc tictoc;
+
+  tictoc.tic();
+  for ( int_type i = 0; i < NPTS; ++i ) CL.eval( s_sorted[i], xx[i], yy[i] );
+  tictoc.toc();
+  real_type t_scalar = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  CL.eval_batch( &s_sorted.front(), NPTS, &xx.front(), &yy.front() );
+  tictoc.toc();
+  real_type t_batch = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  for ( int_type i = 0; i < NPTS; ++i ) CL.eval_ISO( s_sorted[i], 1, xx[i], yy[i] );
+  tictoc.toc();
+  real_type t_scalar_ISO = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  CL.eval_batch_ISO( &s_sorted.front(), NPTS, 1, &xx.front(), &yy.front() );
+  tictoc.toc();
+  real_type t_batch_ISO = tictoc.elapsed_ms();
+
+  cout
+    << "eval           " << setw(10) << 1e6*t_scalar/NPTS     << " [ns/point]\n"
+    << "eval_batch     " << setw(10) << 1e6*t_batch/NPTS      << " [ns/point]\n"
+    << "eval_ISO       " << setw(10) << 1e6*t_scalar_ISO/NPTS << " [ns/point]\n"
+    << "eval_batch_ISO " << setw(10) << 1e6*t_batch_ISO/NPTS  << " [ns/point]\n";
+
+  // with the scalar Fresnel kernel the batch results are the scalar ones
+  G2lib::FresnelKernelType kernel = G2lib::FresnelCS_batch_kernel();
+  G2lib::FresnelCS_batch_kernel_set( G2lib::FRESNEL_KERNEL_SCALAR );
+  real_type err0 = 0;
+  for ( int_type nder = 0; nder <= 3; ++nder ) {
+    err0 = max( err0, check( CL, s_sorted, nder, false, 0 ) );
+    err0 = max( err0, check( CL, s_out, nder, true, -0.3 ) );
+    err0 = max( err0, check( CL, s_rand, nder, false, 0 ) );
+    err0 = max( err0, check( CC, s_wrap, nder, true, 1 ) );
+  }
+  G2lib::FresnelCS_batch_kernel_set( kernel );
+  cout << "max difference batch vs scalar (scalar Fresnel kernel) = " << err0 << '\n';
+
+  if ( err > 1e-10 || errc > 1e-10 || err0 != 0 ) {
+    cout << "\n\nBATCH EVALUATION FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,99 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// evaluate the reference path at pseudo random stations (same sequence
+// for the same seed) and accumulate a checksum
+static
+void
+sweep(
+  G2lib::ClothoidList const * pCL,
+  unsigned                    seed,
+  int_type                    neval,
+  real_type                 * xy
+) {
+  real_type L  = pCL->length();
+  real_type s  = 0;
+  real_type sx = 0, sy = 0;
+  for ( int_type i = 0; i < neval; ++i ) {
+    seed = seed*1664525u + 1013904223u;
+    // mostly small forward steps, sometimes a jump
+    if ( (seed >> 28) == 0 ) s = L*real_type(seed>>8)/real_type(1u<<24);
+    else                     s += L*1e-5;
+    if ( s > L ) s -= L;
+    real_type x, y;
+    pCL->eval( s, x, y );
+    sx += x; sy += y;
+  }
+  xy[0] = sx;
+  xy[1] = sy;
+}
+
+int
+main() {
+
+  int_type const NSEG  = 10000;
+  int_type const NEVAL = 400000;
+
+  vector<real_type> x(NSEG+1), y(NSEG+1);
+  for ( int_type i = 0; i <= NSEG; ++i ) {
+    real_type t = i*0.01;
+    x[i] = 10*t;
+    y[i] = 5*sin(t) + 0.5*sin(7*t);
+  }
+
+  G2lib::ClothoidList CL;
+  CL.build_G1( NSEG+1, &x.front(), &y.front() );
+  cout << "segments = " << CL.numSegment()
+       << " length = " << CL.length() << '\n';
+
+  // reference results computed serially
+  unsigned const NTMAX = max( 8u, thread::hardware_concurrency() );
+  vector<real_type> ref(2*NTMAX);
+  for ( unsigned k = 0; k < NTMAX; ++k )
+    sweep( &CL, 1234u+k, NEVAL, &ref[2*k] );
+
+  // caller owned hint must give the same segment of the thread local one
+  int_type hint = 0, nbad = 0;
+  for ( int_type i = 0; i <= 1000; ++i ) {
+    real_type s = (i*CL.length())/1000;
+    if ( CL.findAtS( s, hint ) != CL.findAtS( s ) ) ++nbad;
+  }
+  cout << "caller owned hint mismatch = " << nbad << '\n';
+
+  TicToc    tictoc;
+  real_type t1 = 0;
+  for ( unsigned nt = 1; nt <= NTMAX; nt *= 2 ) {
+    vector<real_type> res(2*nt);
+    vector<thread>    workers;
+    tictoc.tic();
+    for ( unsigned k = 0; k < nt; ++k )
+      workers.push_back( thread( sweep, &CL, 1234u+k, NEVAL, &res[2*k] ) );
+    for ( unsigned k = 0; k < nt; ++k ) workers[k].join();
+    tictoc.toc();
+
+    bool ok = true;
+    for ( unsigned k = 0; k < 2*nt; ++k ) ok = ok && res[k] == ref[k];
+
+    real_type elapsed = tictoc.elapsed_s();
+    if ( nt == 1 ) t1 = elapsed;
+    cout
+      << "threads = "    << setw(3)  << nt
+      << " elapsed = "   << setw(10) << elapsed << "[s]"
+      << " Meval/s = "   << setw(10) << (nt*NEVAL)/elapsed/1e6
+      << " efficiency = " << setw(6) << 100*t1/elapsed << "%"
+      << ( ok ? "" : "  RESULTS DIFFER" ) << '\n';
+  }
+
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,130 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+int
+main() {
+
+  // a 10 km road made of 1 m segments
+  int_type const NSEG = 10000;
+  int_type const NQ   = 200;   // points checked against the linear search
+  int_type const NQT  = 20000; // points used for the timing of findST1
+
+  vector<real_type> xr(NSEG+1), yr(NSEG+1);
+  for ( int_type i = 0; i <= NSEG; ++i ) {
+    xr[i] = i;
+    yr[i] = 50*sin(i*0.002) + 5*sin(i*0.03);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( NSEG+1, &xr.front(), &yr.front() );
+  real_type L = CL.length();
+
+  // points near the road, some of them before the start
+  // and after the end (no orthogonal projection there)
+  vector<real_type> qx(NQT), qy(NQT);
+  unsigned seed = 1234u;
+  for ( int_type i = 0; i < NQT; ++i ) {
+    seed = seed*1664525u + 1013904223u;
+    real_type ss = 1.02*L*real_type(seed>>8)/real_type(1u<<24) - 0.01*L;
+    seed = seed*1664525u + 1013904223u;
+    real_type d = 20*real_type(seed>>8)/real_type(1u<<24) - 10;
+    if ( ss < 0 ) {
+      qx[i] = ss;     qy[i] = d;
+    } else if ( ss > L ) {
+      qx[i] = xr.back() + ss - L; qy[i] = yr.back() + d;
+    } else {
+      CL.eval_ISO( ss, d, qx[i], qy[i] );
+    }
+  }
+
+  TicToc tictoc;
+
+  // linear search on all the segments
+  vector<real_type> s0(NQ), t0(NQ);
+  vector<int_type>  i0(NQ);
+  tictoc.tic();
+  for ( int_type i = 0; i < NQ; ++i )
+    i0[i] = CL.findST1( 0, NSEG-1, qx[i], qy[i], s0[i], t0[i] );
+  tictoc.toc();
+  real_type t_linear = tictoc.elapsed_ms()/NQ;
+
+  int_type  nbad = 0, nout = 0;
+  real_type err  = 0;
+  for ( int_type i = 0; i < NQ; ++i ) {
+    real_type s, t;
+    int_type idx = CL.findST1( qx[i], qy[i], s, t );
+    if ( idx != i0[i] ) ++nbad;
+    if ( idx < 0 ) ++nout;
+    err = max( err, max( abs(s-s0[i]), abs(t-t0[i]) ) );
+  }
+
+  // the points without orthogonal projection visit all the segments
+  vector<real_type> px, py;
+  for ( int_type i = 0; i < NQT; ++i ) {
+    real_type s, t;
+    if ( CL.findST1( qx[i], qy[i], s, t ) >= 0 ) {
+      px.push_back( qx[i] );
+      py.push_back( qy[i] );
+    }
+  }
+  int_type np = int_type(px.size());
+
+  tictoc.tic();
+  for ( int_type i = 0; i < np; ++i ) {
+    real_type s, t;
+    CL.findST1( px[i], py[i], s, t );
+  }
+  tictoc.toc();
+  real_type t_tree = tictoc.elapsed_ms()/np;
+
+  tictoc.tic();
+  for ( int_type i = 0; i < NQT; ++i ) {
+    real_type s, t;
+    CL.findST1( qx[i], qy[i], s, t );
+  }
+  tictoc.toc();
+  real_type t_all = tictoc.elapsed_ms()/NQT;
+
+  // with the prepared flat tree
+  CL.prepare_AABBtree_ISO( 0 );
+  tictoc.tic();
+  for ( int_type i = 0; i < np; ++i ) {
+    real_type s, t;
+    CL.findST1( px[i], py[i], s, t );
+  }
+  tictoc.toc();
+  real_type t_prep = tictoc.elapsed_ms()/np;
+  for ( int_type i = 0; i < NQ; ++i ) {
+    real_type s, t;
+    int_type idx = CL.findST1( qx[i], qy[i], s, t );
+    if ( idx != i0[i] ) ++nbad;
+    err = max( err, max( abs(s-s0[i]), abs(t-t0[i]) ) );
+  }
+
+  cout
+    << NSEG << " segments, " << NQ << " points (" << nout << " not projected)\n"
+    << "segment mismatch = " << nbad << ", max difference = " << err << '\n'
+    << "findST1, linear search " << setw(12) << 1000*t_linear << " [us/point]\n"
+    << "findST1, AABB tree     " << setw(12) << 1000*t_tree   << " [us/point] ("
+    << np << " projected points)\n"
+    << "findST1, AABB tree     " << setw(12) << 1000*t_all    << " [us/point] (all "
+    << NQT << " points)\n"
+    << "findST1, prepared tree " << setw(12) << 1000*t_prep   << " [us/point] ("
+    << np << " projected points)\n";
+
+  if ( nbad > 0 || err > 1e-10 ) {
+    cout << "\n\nfindST1 FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
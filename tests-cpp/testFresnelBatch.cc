@@ -0,0 +1,183 @@
+//#define _USE_MATH_DEFINES
+#include "Fresnel.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// uniform pseudo random numbers in [lo,hi]
+static
+void
+fill(
+  vector<real_type> & v,
+  real_type           lo,
+  real_type           hi,
+  unsigned          & seed
+) {
+  for ( size_t i = 0; i < v.size(); ++i ) {
+    seed = seed*1664525u + 1013904223u;
+    v[i] = lo + (hi-lo)*real_type(seed>>8)/real_type(1u<<24);
+  }
+}
+
+static
+real_type
+maxdiff(
+  vector<real_type> const & a,
+  vector<real_type> const & b
+) {
+  real_type err = 0;
+  for ( size_t i = 0; i < a.size(); ++i ) err = max( err, abs(a[i]-b[i]) );
+  return err;
+}
+
+// difference of the moments 0,1,2 (stored as v[j*n+i]);
+// for |a| >= 0.01 the formula (scalar and lanes) cancels terms
+// of size (b/a)^j, the difference is scaled accordingly
+static
+real_type
+maxdiff3(
+  vector<real_type> const & a,
+  vector<real_type> const & b,
+  vector<real_type> const & v,
+  vector<real_type> const & v0
+) {
+  size_t    n   = a.size();
+  real_type err = 0;
+  for ( size_t i = 0; i < n; ++i ) {
+    real_type r = abs(a[i]) >= 0.01 ? 1+abs(b[i]/a[i]) : 1;
+    real_type w = 1;
+    for ( size_t j = 0; j < 3; ++j ) {
+      err = max( err, abs(v[j*n+i]-v0[j*n+i])/w );
+      w  *= r;
+    }
+  }
+  return err;
+}
+
+int
+main() {
+
+  int_type const N     = 200000;
+  int_type const NREP  = 5;
+  bool           ok    = true;
+  unsigned       seed  = 1234u;
+  TicToc         tictoc;
+
+  G2lib::FresnelKernelType kernels[] = {
+    G2lib::FRESNEL_KERNEL_SCALAR,
+    G2lib::FRESNEL_KERNEL_GENERIC,
+    G2lib::FRESNEL_KERNEL_AVX2,
+    G2lib::FRESNEL_KERNEL_AVX512
+  };
+
+  G2lib::FresnelKernelType kdefault = G2lib::FresnelCS_batch_kernel();
+  cout << "default kernel: " << G2lib::FresnelKernelType_name[kdefault] << '\n';
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // FresnelCS on the three regions
+  vector<real_type> x(N), C0(N), S0(N), C(N), S(N);
+  fill( x, -20, 20, seed );
+  for ( int_type i = 0; i < N; i += 97 ) x[i] *= 1000; // some large arguments
+
+  for ( int_type i = 0; i < N; ++i ) G2lib::FresnelCS( x[i], C0[i], S0[i] );
+
+  cout << "\nFresnelCS, x in [-20,20]\n";
+  for ( int_type ik = 0; ik < 4; ++ik ) {
+    if ( !G2lib::FresnelCS_batch_kernel_set( kernels[ik] ) ) continue;
+    tictoc.tic();
+    for ( int_type r = 0; r < NREP; ++r )
+      G2lib::FresnelCS_batch( N, &x.front(), &C.front(), &S.front() );
+    tictoc.toc();
+    real_type err = max( maxdiff( C, C0 ), maxdiff( S, S0 ) );
+    ok = ok && err < 1e-13;
+    cout
+      << setw(8) << G2lib::FresnelKernelType_name[kernels[ik]]
+      << setw(10) << 1e6*tictoc.elapsed_ms()/(NREP*N) << " [ns/point]"
+      << "  max err = " << err << '\n';
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // GeneralizedFresnelCS on the different (a,b) regimes
+  struct Regime { char const * name; real_type a0, a1, b0, b1; };
+  Regime regimes[] = {
+    { "|a|>=0.01        ", -30,     30,     -20,  20 },
+    { "|a|<0.01 |b|<=1  ", -0.0099, 0.0099, -1,   1 },
+    { "|a|<0.01 |b|<=4  ", -0.0099, 0.0099, -4,   4 },
+    { "|a|<0.01 |b|>4   ", -0.0099, 0.0099, 4,    40 },
+    { "clothoid segments", -1e-4,   1e-4,   -0.2, 0.2 }
+  };
+
+  vector<real_type> a(N), b(N);
+  for ( int_type ir = 0; ir < 5; ++ir ) {
+    Regime const & R = regimes[ir];
+    fill( a, R.a0, R.a1, seed );
+    fill( b, R.b0, R.b1, seed );
+    real_type c = 0.3;
+    for ( int_type i = 0; i < N; ++i )
+      G2lib::GeneralizedFresnelCS( a[i], b[i], c, C0[i], S0[i] );
+
+    cout << "\nGeneralizedFresnelCS, " << R.name << '\n';
+    for ( int_type ik = 0; ik < 4; ++ik ) {
+      if ( !G2lib::FresnelCS_batch_kernel_set( kernels[ik] ) ) continue;
+      tictoc.tic();
+      for ( int_type r = 0; r < NREP; ++r )
+        G2lib::GeneralizedFresnelCS_batch(
+          N, &a.front(), &b.front(), c, &C.front(), &S.front()
+        );
+      tictoc.toc();
+      real_type err = max( maxdiff( C, C0 ), maxdiff( S, S0 ) );
+      ok = ok && err < 1e-13;
+      cout
+        << setw(8) << G2lib::FresnelKernelType_name[kernels[ik]]
+        << setw(10) << 1e6*tictoc.elapsed_ms()/(NREP*N) << " [ns/point]"
+        << "  max err = " << err << '\n';
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // moments 0,1,2 with a phase for each point (as in the G2 solvers)
+  vector<real_type> c(N), C3(3*N), S3(3*N), C30(3*N), S30(3*N);
+  for ( int_type ir = 0; ir < 5; ++ir ) {
+    Regime const & R = regimes[ir];
+    fill( a, R.a0, R.a1, seed );
+    fill( b, R.b0, R.b1, seed );
+    fill( c, -4, 4, seed );
+    for ( int_type i = 0; i < N; ++i ) {
+      real_type CC[3], SS[3];
+      G2lib::GeneralizedFresnelCS( 3, a[i], b[i], c[i], CC, SS );
+      for ( int_type j = 0; j < 3; ++j ) { C30[j*N+i] = CC[j]; S30[j*N+i] = SS[j]; }
+    }
+
+    cout << "\nGeneralizedFresnelCS 3 moments, " << R.name << '\n';
+    for ( int_type ik = 0; ik < 4; ++ik ) {
+      if ( !G2lib::FresnelCS_batch_kernel_set( kernels[ik] ) ) continue;
+      tictoc.tic();
+      for ( int_type r = 0; r < NREP; ++r )
+        G2lib::GeneralizedFresnelCS_batch(
+          3, N, &a.front(), &b.front(), &c.front(), &C3.front(), &S3.front()
+        );
+      tictoc.toc();
+      real_type err = max( maxdiff3( a, b, C3, C30 ), maxdiff3( a, b, S3, S30 ) );
+      ok = ok && err < 1e-13;
+      cout
+        << setw(8) << G2lib::FresnelKernelType_name[kernels[ik]]
+        << setw(10) << 1e6*tictoc.elapsed_ms()/(NREP*N) << " [ns/point]"
+        << "  max err = " << err << '\n';
+    }
+  }
+
+  G2lib::FresnelCS_batch_kernel_set( kdefault );
+
+  if ( !ok ) {
+    cout << "\n\nBATCHED FRESNEL KERNELS FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,140 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <limits>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// a G2 problem from (0,0)
+struct Problem { real_type th0, k0, x1, y1, th1, k1; };
+
+// uniform pseudo random numbers in [lo,hi]
+static
+real_type
+rnd( real_type lo, real_type hi, unsigned & seed ) {
+  seed = seed*1664525u + 1013904223u;
+  return lo + (hi-lo)*real_type(seed>>8)/real_type(1u<<24);
+}
+
+static char const * status_name[] = {
+  "converged", "bad data", "guess failed", "singular", "no step",
+  "max iteration", "not finite", "not feasible", "exception"
+};
+
+// solve the problems `idx`, return the number of exceptions escaping `build`
+template <typename SOLVER>
+static
+int_type
+solve_all(
+  SOLVER                 & g,
+  vector<Problem>  const & P,
+  vector<size_t>   const & idx,
+  vector<int>            & iter,
+  vector<real_type>      & len
+) {
+  int_type nexc = 0;
+  for ( size_t k = 0; k < idx.size(); ++k ) {
+    Problem const & p = P[idx[k]];
+    int it = -1;
+    try {
+      it = g.build( 0, 0, p.th0, p.k0, p.x1, p.y1, p.th1, p.k1 );
+    } catch ( ... ) {
+      ++nexc;
+    }
+    iter[k] = it;
+    len[k]  = it >= 0 ? g.getS0().length() + g.getS1().length() : 0;
+  }
+  return nexc;
+}
+
+// the problems are grouped by the outcome in no throw mode and each group
+// is solved in the default and in the no throw mode
+template <typename SOLVER>
+static
+bool
+compare( char const * name, vector<Problem> const & P ) {
+  SOLVER g;
+  g.setNoThrow( true );
+  vector<size_t> group[9];
+  for ( size_t i = 0; i < P.size(); ++i ) {
+    Problem const & p = P[i];
+    g.build( 0, 0, p.th0, p.k0, p.x1, p.y1, p.th1, p.k1 );
+    group[g.getInfo().status].push_back( i );
+  }
+
+  bool   ok = group[G2lib::G2SOLVE_EXCEPTION].empty();
+  TicToc tictoc;
+  cout << '\n' << name << ", " << P.size() << " problems\n"
+       << "  outcome          problems  default [us]  no throw [us]  exceptions (default)\n";
+  for ( int s = 0; s < 9; ++s ) {
+    vector<size_t> const & idx = group[s];
+    if ( idx.empty() ) continue;
+    size_t nn = idx.size();
+    vector<int>       it0( nn ), it1( nn );
+    vector<real_type> len0( nn ), len1( nn );
+    real_type ms[2];
+    int_type  nexc[2];
+    for ( int mode = 0; mode < 2; ++mode ) {
+      g.setNoThrow( mode == 1 );
+      tictoc.tic();
+      nexc[mode] = solve_all( g, P, idx, mode == 0 ? it0 : it1, mode == 0 ? len0 : len1 );
+      tictoc.toc();
+      ms[mode] = tictoc.elapsed_ms();
+    }
+    // same outcome and same solutions, no exception in no throw mode
+    for ( size_t k = 0; k < nn; ++k )
+      ok = ok && it0[k] == it1[k] && len0[k] == len1[k];
+    ok = ok && nexc[1] == 0;
+    cout
+      << "  " << setw(14) << left << status_name[s] << right
+      << setw(10) << nn
+      << setw(14) << 1000*ms[0]/nn
+      << setw(15) << 1000*ms[1]/nn
+      << setw(12) << nexc[0] << '\n';
+  }
+  return ok;
+}
+
+int
+main() {
+
+  real_type const m_pi = G2lib::m_pi;
+  real_type const NaN  = numeric_limits<real_type>::quiet_NaN();
+
+  // data of a sampling planner: random states, curvatures over
+  // 6 orders of magnitude, some coincident points and not finite data
+  vector<Problem> P;
+  unsigned seed = 1234u;
+  for ( int i = 0; i < 50000; ++i ) {
+    Problem p;
+    real_type d   = rnd( 0.1, 10, seed );
+    real_type phi = rnd( -m_pi, m_pi, seed );
+    p.x1  = d*cos(phi);
+    p.y1  = d*sin(phi);
+    p.th0 = rnd( -m_pi, m_pi, seed );
+    p.th1 = rnd( -m_pi, m_pi, seed );
+    p.k0  = pow( 10, rnd( -3, 3, seed ) ) * ( rnd( 0, 1, seed ) < 0.5 ? -1 : 1 );
+    p.k1  = pow( 10, rnd( -3, 3, seed ) ) * ( rnd( 0, 1, seed ) < 0.5 ? -1 : 1 );
+    if ( i % 20 == 0 ) p.x1 = p.y1 = 0;
+    if ( i % 500 == 1 ) p.k1 = NaN;
+    P.push_back( p );
+  }
+
+  bool ok = true;
+  ok = compare<G2lib::G2solve2arc>( "G2solve2arc", P ) && ok;
+  ok = compare<G2lib::G2solveCLC>( "G2solveCLC", P ) && ok;
+  ok = compare<G2lib::G2solve3arc>( "G2solve3arc", P ) && ok;
+
+  if ( !ok ) {
+    cout << "\n\nNO THROW MODE FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
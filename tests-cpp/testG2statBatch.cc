@@ -0,0 +1,151 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <map>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// largest difference of the data of two arcs
+static
+real_type
+arcdiff( G2lib::ClothoidCurve const & a, G2lib::ClothoidCurve const & b ) {
+  real_type err = abs(a.xBegin()-b.xBegin());
+  err = max( err, abs(a.yBegin()-b.yBegin()) );
+  err = max( err, abs(a.thetaBegin()-b.thetaBegin()) );
+  err = max( err, abs(a.kappaBegin()-b.kappaBegin()) );
+  err = max( err, abs(a.dkappa()-b.dkappa())/(1+abs(a.dkappa())) );
+  err = max( err, abs(a.length()-b.length()) );
+  return err;
+}
+
+int
+main() {
+
+  static const real_type m_pi = 3.14159265358979323846264338328;
+
+  // the same problems of testG2stat
+  int NMAX = 128/8;
+  int nkur = 64/8;
+
+  real_type thmin = -m_pi*0.999;
+  real_type thmax =  m_pi*0.999;
+
+  real_type kur[1000], kmax = 10;
+  real_type a = exp( 2*log(kmax)/(nkur-1) );
+  nkur = 2*nkur+1;
+  real_type k0 = 1/kmax;
+  kur[0] = 0;
+  for ( int ii = 1; ii < nkur; ii += 2 ) {
+    kur[ii]   = k0;
+    kur[ii+1] = -kur[ii];
+    k0 *= a;
+  }
+
+  vector<real_type> x0, y0, th0, kk0, x1, y1, th1, kk1;
+  for ( int ii = 0; ii < nkur; ++ii ) {
+    for ( int jj = 0; jj < nkur; ++jj ) {
+      for ( int i = 0; i < NMAX; ++i ) {
+        for ( int j = 0; j < NMAX; ++j ) {
+          x0.push_back( 0 );  y0.push_back( 0 );
+          x1.push_back( 1 );  y1.push_back( 0 );
+          th0.push_back( thmin + ((thmax-thmin)*i)/(NMAX-1) );
+          th1.push_back( thmin + ((thmax-thmin)*j)/(NMAX-1) );
+          kk0.push_back( kur[ii] );
+          kk1.push_back( kur[jj] );
+        }
+      }
+    }
+  }
+  // the same problems moved and rotated
+  int_type n0 = int_type(x0.size());
+  for ( int_type i = 0; i < n0; ++i ) {
+    real_type r = 0.1+i%7, ang = i*0.37, c = cos(ang), s = sin(ang);
+    x0.push_back( 3*i%11 );  y0.push_back( -2*(i%5) );
+    x1.push_back( x0.back() + r*c );
+    y1.push_back( y0.back() + r*s );
+    th0.push_back( th0[i] + ang );
+    th1.push_back( th1[i] + ang );
+    kk0.push_back( kk0[i]/r );
+    kk1.push_back( kk1[i]/r );
+  }
+  int_type N  = int_type(x0.size());
+  size_t   NN = x0.size();
+
+  // one problem at a time
+  G2lib::G2solve3arc g2solve3arc;
+  vector<int>        iter_ref( NN );
+  vector<G2lib::ClothoidCurve> R0( NN ), RM( NN ), R1( NN );
+  map<int,int>       stats;
+  TicToc             tictoc;
+  tictoc.tic();
+  for ( int_type i = 0; i < N; ++i ) {
+    iter_ref[i] = g2solve3arc.build( x0[i], y0[i], th0[i], kk0[i],
+                                     x1[i], y1[i], th1[i], kk1[i] );
+    if ( iter_ref[i] >= 0 ) {
+      R0[i] = g2solve3arc.getS0();
+      RM[i] = g2solve3arc.getSM();
+      R1[i] = g2solve3arc.getS1();
+    }
+    stats[iter_ref[i]]++;
+  }
+  tictoc.toc();
+  real_type t_scalar = tictoc.elapsed_ms();
+
+  cout << N << " problems\nstats (G2solve3arc)\n";
+  for ( map<int,int>::const_iterator is = stats.begin(); is != stats.end(); ++is )
+    cout << "iter = " << is->first << " -- " << is->second << '\n';
+
+  cout << "\nG2solve3arc::build loop " << setw(10) << 1000*t_scalar/N << " [us/problem]\n";
+
+  bool ok = true;
+  int_type const threads[] = { 1, 2, 4 };
+  for ( int k = 0; k < 3; ++k ) {
+    G2lib::G2solve3arcBatch batch;
+    batch.setNumThreads( threads[k] );
+    tictoc.tic();
+    int_type nconv = batch.build( N, &x0.front(), &y0.front(), &th0.front(), &kk0.front(),
+                                     &x1.front(), &y1.front(), &th1.front(), &kk1.front() );
+    tictoc.toc();
+    real_type t_batch = tictoc.elapsed_ms();
+
+    // same outcome and iterations of the scalar solver, same arcs
+    int_type  nstat = 0, niter = 0;
+    real_type err   = 0, gap = 0;
+    for ( int_type i = 0; i < N; ++i ) {
+      bool conv = batch.status(i) == G2lib::G2solve3arcBatch::CONVERGED;
+      if ( conv != (iter_ref[i] >= 0) ) { ++nstat; continue; }
+      if ( !conv ) continue;
+      if ( batch.iterations(i) != iter_ref[i] ) ++niter;
+      G2lib::ClothoidCurve C0, CM, C1;
+      batch.get( i, C0, CM, C1 );
+      err = max( err, arcdiff( C0, R0[i] ) );
+      err = max( err, arcdiff( CM, RM[i] ) );
+      err = max( err, arcdiff( C1, R1[i] ) );
+      // G2 junctions and end point
+      gap = max( gap, hypot( C0.xEnd()-CM.xBegin(), C0.yEnd()-CM.yBegin() ) );
+      gap = max( gap, hypot( CM.xEnd()-C1.xBegin(), CM.yEnd()-C1.yBegin() ) );
+      gap = max( gap, hypot( C1.xEnd()-x1[i], C1.yEnd()-y1[i] ) );
+      gap = max( gap, abs( CM.kappaEnd()-C1.kappaBegin() ) );
+    }
+    cout
+      << "G2solve3arcBatch, " << threads[k] << " thr. " << setw(9) << 1000*t_batch/N
+      << " [us/problem] converged " << nconv
+      << ", status mismatch " << nstat << ", iterations mismatch " << niter
+      << "\n    max difference " << err << ", max G2 gap " << gap << '\n';
+    // a different rounding of the integrals may move some iteration counts
+    if ( nstat > N/1000 || niter > N/100 || err > 1e-6 || gap > 1e-8 ) ok = false;
+  }
+
+  if ( !ok ) {
+    cout << "\n\nG2solve3arcBatch FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
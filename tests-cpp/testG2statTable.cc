@@ -0,0 +1,234 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <stdint.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// a G2 problem from (0,0) to (x1,y1)
+struct Problem { real_type th0, k0, x1, y1, th1, k1; };
+
+// uniform pseudo random numbers in [lo,hi]
+static
+real_type
+rnd( real_type lo, real_type hi, unsigned & seed ) {
+  seed = seed*1664525u + 1013904223u;
+  return lo + (hi-lo)*real_type(seed>>8)/real_type(1u<<24);
+}
+
+struct Stats {
+  map<int,int> hist;
+  int_type     nfail;
+  long         niter;
+  real_type    ms;
+};
+
+static
+Stats
+run(
+  G2lib::G2solve3arc    & g,
+  vector<Problem> const & P,
+  vector<real_type>     & len
+) {
+  Stats   st;
+  TicToc  tictoc;
+  st.nfail = 0;
+  st.niter = 0;
+  len.resize( P.size() );
+  tictoc.tic();
+  for ( size_t i = 0; i < P.size(); ++i ) {
+    Problem const & p = P[i];
+    int iter = g.build( 0, 0, p.th0, p.k0, p.x1, p.y1, p.th1, p.k1 );
+    st.hist[iter]++;
+    if ( iter < 0 ) { ++st.nfail; len[i] = 0; }
+    else            { st.niter += iter; len[i] = g.totalLength(); }
+  }
+  tictoc.toc();
+  st.ms = tictoc.elapsed_ms();
+  return st;
+}
+
+int
+main() {
+
+  real_type const m_pi = G2lib::m_pi;
+  bool            ok   = true;
+  TicToc          tictoc;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // generator: the tables are computed and written to file
+  G2lib::G1guessTable     TG1;
+  G2lib::G2solve3arcTable TG2;
+
+  tictoc.tic();
+  TG1.generate( 1 << 20 );
+  tictoc.toc();
+  cout << "G1 table:  " << TG1.numNodes() << "^2 nodes, "
+       << TG1.memory()/1024 << " [KB], " << tictoc.elapsed_ms() << " [ms]\n";
+
+  tictoc.tic();
+  TG2.generate( 4 << 20, 0, 0, 4 );
+  tictoc.toc();
+  cout << "G2 table:  " << TG2.numNodesTheta() << "^2 x " << TG2.numNodesKappa()
+       << "^2 nodes, " << TG2.memory()/1024 << " [KB], "
+       << TG2.numFailed() << " nodes without solution, "
+       << tictoc.elapsed_s() << " [s]\n";
+
+  {
+    ofstream file( "G2guess.bin", ios::binary );
+    TG1.save( file );
+    TG2.save( file );
+  }
+
+  // serialization round trip
+  G2lib::G1guessTable     TG1r;
+  G2lib::G2solve3arcTable TG2r;
+  {
+    ifstream file( "G2guess.bin", ios::binary );
+    bool okload = TG1r.load( file ) && TG2r.load( file );
+    ostringstream a, b;
+    TG1.save( a );  TG2.save( a );
+    TG1r.save( b ); TG2r.save( b );
+    bool same = okload && a.str() == b.str();
+    cout << "save/load: " << ( same ? "ok" : "FAILED" ) << '\n';
+    ok = ok && same;
+    istringstream bad( "not a table" );
+    ok = ok && !TG1r.load( bad );
+    // huge sizes in the header of a short file
+    string h1( "G1GT" ), h2( "G23T" );
+    int32_t big[2] = { 2000000000, 2000000000 };
+    h1.append( reinterpret_cast<char const*>(big), 4 ).append( 64, '\0' );
+    h2.append( reinterpret_cast<char const*>(big), 8 ).append( 64, '\0' );
+    istringstream b1( h1 ), b2( h2 );
+    G2lib::G1guessTable     TG1b;
+    G2lib::G2solve3arcTable TG2b;
+    bool okbad = !TG1b.load( b1 ) && !TG2b.load( b2 ) && TG1b.empty() && TG2b.empty();
+    cout << "bad sizes: " << ( okbad ? "rejected" : "FAILED" ) << '\n';
+    ok = ok && okbad;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // iterations of build_G1 with the polynomial and the table guess
+  {
+    unsigned seed = 4321u;
+    int_type const NG1 = 200000;
+    vector<real_type> phi0(NG1), phi1(NG1);
+    for ( int_type i = 0; i < NG1; ++i ) {
+      phi0[i] = rnd( -m_pi, m_pi, seed );
+      phi1[i] = rnd( -m_pi, m_pi, seed );
+    }
+    G2lib::ClothoidData cd;
+    real_type L;
+    for ( int_type pass = 0; pass < 2; ++pass ) {
+      G2lib::G1guessTable_set( pass == 0 ? nullptr : &TG1r );
+      map<int,int> hist;
+      long nit = 0;
+      tictoc.tic();
+      for ( int_type i = 0; i < NG1; ++i ) {
+        int it = cd.build_G1( -1, 0, phi0[i], 1, 0, phi1[i], 1e-12, L );
+        hist[it]++;
+        nit += it;
+      }
+      tictoc.toc();
+      cout << "\nbuild_G1, " << ( pass == 0 ? "polynomial guess" : "table guess" )
+           << ", average iterations " << real_type(nit)/NG1
+           << ", " << 1000*tictoc.elapsed_ms()/NG1 << " [us]\n";
+      for ( map<int,int>::const_iterator it = hist.begin(); it != hist.end(); ++it )
+        cout << "iter = " << it->first << " -- " << it->second << '\n';
+    }
+    G2lib::G1guessTable_set( nullptr );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // problems: the grid of testG2stat and random data with a wider
+  // range of curvatures
+  vector<Problem> P;
+  {
+    int NMAX = 16, nkur = 8;
+    real_type thmin = -m_pi*0.999, thmax = m_pi*0.999;
+    real_type kur[17], kmax = 10;
+    real_type a  = exp( 2*log(kmax)/(nkur-1) );
+    real_type k0 = 1/kmax;
+    nkur = 2*nkur+1;
+    kur[0] = 0;
+    for ( int ii = 1; ii < nkur; ii += 2 ) {
+      kur[ii] = k0; kur[ii+1] = -k0; k0 *= a;
+    }
+    for ( int ii = 0; ii < nkur; ++ii )
+      for ( int jj = 0; jj < nkur; ++jj )
+        for ( int i = 0; i < NMAX; ++i )
+          for ( int j = 0; j < NMAX; ++j ) {
+            Problem p;
+            p.th0 = thmin + ((thmax-thmin)*i)/(NMAX-1);
+            p.th1 = thmin + ((thmax-thmin)*j)/(NMAX-1);
+            p.k0  = kur[ii];
+            p.k1  = kur[jj];
+            p.x1  = 1;
+            p.y1  = 0;
+            P.push_back( p );
+          }
+    unsigned seed = 1234u;
+    for ( int i = 0; i < 100000; ++i ) {
+      Problem p;
+      real_type d   = rnd( 0.1, 10, seed );
+      real_type phi = rnd( -m_pi, m_pi, seed );
+      p.x1  = d*cos(phi);
+      p.y1  = d*sin(phi);
+      p.th0 = phi + rnd( -m_pi, m_pi, seed );
+      p.th1 = phi + rnd( -m_pi, m_pi, seed );
+      p.k0  = rnd( -40, 40, seed )/d;
+      p.k1  = rnd( -40, 40, seed )/d;
+      P.push_back( p );
+    }
+  }
+
+  G2lib::G2solve3arc g;
+  vector<real_type>  len0, len1;
+
+  Stats s0 = run( g, P, len0 );
+  G2lib::G1guessTable_set( &TG1r );
+  g.setTable( &TG2r );
+  Stats s1 = run( g, P, len1 );
+  G2lib::G1guessTable_set( nullptr );
+
+  int_type ndiff = 0;
+  for ( size_t i = 0; i < P.size(); ++i )
+    if ( len0[i] > 0 && len1[i] > 0 && abs(len0[i]-len1[i]) > 1e-6*len0[i] ) ++ndiff;
+
+  Stats const * S[2] = { &s0, &s1 };
+  char const * names[2] = { "heuristic guess", "table guess" };
+  for ( int k = 0; k < 2; ++k ) {
+    cout << "\nG2solve3arc, " << names[k] << '\n';
+    for ( map<int,int>::const_iterator it = S[k]->hist.begin();
+          it != S[k]->hist.end(); ++it )
+      cout << "iter = " << it->first << " -- " << it->second << '\n';
+    cout << "failed  = " << S[k]->nfail << '\n'
+         << "average = " << real_type(S[k]->niter)/(P.size()-S[k]->nfail)
+         << " iterations, " << 1000*S[k]->ms/P.size() << " [us]\n";
+  }
+  cout << "\n" << ndiff << " of " << P.size()
+       << " problems converged to a different solution\n";
+
+  // the table guess is used only in the branch of the heuristic one:
+  // same solutions and no more iterations in the worst case
+  ok = ok && s1.nfail <= s0.nfail && ndiff == 0 &&
+       s1.hist.rbegin()->first <= s0.hist.rbegin()->first &&
+       real_type(s1.niter)/(P.size()-s1.nfail) < real_type(s0.niter)/(P.size()-s0.nfail);
+
+  if ( !ok ) {
+    cout << "\n\nG2 GUESS TABLES FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
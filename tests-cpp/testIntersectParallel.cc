@@ -0,0 +1,155 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static real_type const lanes[] = { -5.25, -1.75, 1.75, 5.25 };
+
+// overlap of a candidate pair of triangles, counting the calls
+class CountedOverlap {
+  vector<G2lib::Triangle2D> const * T1;
+  vector<G2lib::Triangle2D> const * T2;
+  atomic<int_type>                * ncall;
+public:
+  CountedOverlap(
+    vector<G2lib::Triangle2D> const * _T1,
+    vector<G2lib::Triangle2D> const * _T2,
+    atomic<int_type>                * _ncall
+  )
+  : T1(_T1), T2(_T2), ncall(_ncall)
+  {}
+
+  bool
+  operator () ( int_type i, int_type j ) const {
+    ++*ncall;
+    return (*T1)[size_t(i)].overlap( (*T2)[size_t(j)] );
+  }
+};
+
+// all the intersections of the lanes of the two networks
+static
+size_t
+cross_lanes(
+  G2lib::ClothoidList const & A,
+  G2lib::ClothoidList const & B,
+  int_type                    nthreads,
+  vector<G2lib::IntersectList> & res
+) {
+  size_t n = 0;
+  res.resize(16);
+  for ( int_type k = 0; k < 16; ++k ) {
+    res[size_t(k)].clear();
+    A.intersect_ISO( lanes[k/4], B, lanes[k%4], res[size_t(k)], false, nthreads );
+    n += res[size_t(k)].size();
+  }
+  return n;
+}
+
+int
+main() {
+
+  bool ok = true;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // two 20 km roads of 4 lanes: the second weaves across the first
+  int_type const NP = 2001;
+  vector<real_type> xa(NP), ya(NP), xb(NP), yb(NP);
+  for ( int_type i = 0; i < NP; ++i ) {
+    real_type x = 10*i;
+    xa[i] = x; ya[i] = 30*sin(x/300);
+    xb[i] = x; yb[i] = 30*sin(x/300) + 8*sin(x/40);
+  }
+  G2lib::ClothoidList A, B, F;
+  A.build_G1( NP, &xa.front(), &ya.front() );
+  B.build_G1( NP, &xb.front(), &yb.front() );
+  F = B;
+  F.translate( 0, 1000 ); // far away
+
+  TicToc tictoc;
+  int_type const nthreads[] = { 2, 4, 8 };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // the same intersections, in the same order, with any number of threads
+  for ( int_type flat = 0; flat < 2; ++flat ) {
+    if ( flat == 0 ) G2lib::noFlatAABBtree();
+    else             G2lib::yesFlatAABBtree();
+    vector<G2lib::IntersectList> r1, rn;
+    tictoc.tic();
+    size_t n1 = cross_lanes( A, B, 1, r1 );
+    tictoc.toc();
+    cout
+      << ( flat == 0 ? "AABBtree" : "AABBtreeFlat" ) << ", "
+      << n1 << " intersections of the lanes\n"
+      << "  1 thread  " << setw(10) << tictoc.elapsed_ms() << " [ms]\n";
+    for ( int_type k = 0; k < 3; ++k ) {
+      tictoc.tic();
+      size_t nn = cross_lanes( A, B, nthreads[k], rn );
+      tictoc.toc();
+      bool same = nn == n1 && rn == r1;
+      cout
+        << "  " << nthreads[k] << " threads " << setw(10) << tictoc.elapsed_ms()
+        << " [ms]" << ( same ? "" : "  FAILED" ) << '\n';
+      ok = ok && same;
+    }
+    bool okc = A.collision_ISO( 1.75, B, -1.75, 4 ) &&
+               !A.collision_ISO( 1.75, F, -1.75, 4 );
+    vector<G2lib::IntersectList> rf;
+    okc = okc && cross_lanes( A, F, 4, rf ) == 0;
+    cout << "  collision" << ( okc ? "" : "  FAILED" ) << '\n';
+    ok = ok && okc && n1 > 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // the trees alone: candidate pairs and early stop of the collision
+  {
+    vector<G2lib::Triangle2D> ta, tb;
+    A.bbTriangles_ISO( 0, ta, G2lib::m_pi/18, 2 );
+    B.bbTriangles_ISO( 0, tb, G2lib::m_pi/18, 2 );
+    G2lib::AABBtreeFlat TA, TB;
+    TA.build( ta );
+    TB.build( tb );
+
+    G2lib::AABBtree::VecPairIpos l1, ln;
+    tictoc.tic();
+    TA.intersect( TB, l1 );
+    tictoc.toc();
+    cout
+      << "\ntrees of " << ta.size() << " and " << tb.size() << " triangles, "
+      << l1.size() << " candidate pairs\n"
+      << "  intersect           " << setw(10) << tictoc.elapsed_ms() << " [ms]\n";
+    for ( int_type k = 0; k < 3; ++k ) {
+      ln.clear();
+      tictoc.tic();
+      TA.intersect_parallel( TB, ln, nthreads[k] );
+      tictoc.toc();
+      bool same = ln == l1;
+      cout
+        << "  intersect_parallel  " << setw(10) << tictoc.elapsed_ms()
+        << " [ms] " << nthreads[k] << " threads" << ( same ? "" : "  FAILED" ) << '\n';
+      ok = ok && same;
+    }
+
+    atomic<int_type> nc1(0), ncn(0);
+    bool c1 = TA.collision( TB, CountedOverlap( &ta, &tb, &nc1 ) );
+    bool cn = TA.collision_parallel( TB, CountedOverlap( &ta, &tb, &ncn ), 4 );
+    cout
+      << "  collision: " << nc1 << " candidates checked with 1 thread, "
+      << ncn << " with 4 threads (of " << l1.size() << ")\n";
+    ok = ok && c1 && cn && size_t(ncn) < l1.size();
+  }
+
+  if ( !ok ) {
+    cout << "\n\nINTERSECT PARALLEL FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
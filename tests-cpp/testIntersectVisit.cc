@@ -0,0 +1,195 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "Biarc.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// collect all the intersections visited, counting the calls
+class CollectAll : public G2lib::IntersectVisitor {
+public:
+  G2lib::IntersectList ilist;
+  bool
+  visit( real_type s1, real_type s2 ) G2LIB_OVERRIDE {
+    ilist.push_back( G2lib::Ipair( s1, s2 ) );
+    return true;
+  }
+};
+
+// stop at the first intersection
+class First : public G2lib::IntersectVisitor {
+public:
+  real_type s1, s2;
+  First() : s1(0), s2(0) {}
+  bool
+  visit( real_type _s1, real_type _s2 ) G2LIB_OVERRIDE {
+    s1 = _s1; s2 = _s2;
+    return false;
+  }
+};
+
+// the sorted list without the entries nearer than `tol` to a previous one
+static
+void
+unique_sorted( G2lib::IntersectList & il, real_type tol ) {
+  sort( il.begin(), il.end() );
+  G2lib::IntersectList res;
+  for ( size_t i = 0; i < il.size(); ++i ) {
+    bool dup = false;
+    for ( size_t j = 0; j < res.size() && !dup; ++j )
+      dup = abs( res[j].first-il[i].first ) <= tol &&
+            abs( res[j].second-il[i].second ) <= tol;
+    if ( !dup ) res.push_back( il[i] );
+  }
+  il.swap( res );
+}
+
+static
+bool
+same( G2lib::IntersectList const & a, G2lib::IntersectList const & b ) {
+  if ( a.size() != b.size() ) return false;
+  for ( size_t i = 0; i < a.size(); ++i )
+    if ( abs( a[i].first-b[i].first ) > 1e-8 ||
+         abs( a[i].second-b[i].second ) > 1e-8 ) return false;
+  return true;
+}
+
+int
+main() {
+
+  bool ok = true;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // a planned path weaving across a 20 km road
+  int_type const NP = 2001;
+  vector<real_type> xa(NP), ya(NP), xb(NP), yb(NP);
+  for ( int_type i = 0; i < NP; ++i ) {
+    real_type x = 10*i;
+    xa[i] = x; ya[i] = 30*sin(x/300);
+    xb[i] = x; yb[i] = 30*sin(x/300) + 8*sin(x/40);
+  }
+  G2lib::ClothoidList A, B;
+  A.build_G1( NP, &xa.front(), &ya.front() );
+  B.build_G1( NP, &xb.front(), &yb.front() );
+
+  TicToc tictoc;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // all the intersections: the list of intersect_ISO without duplicates
+  for ( int_type flat = 0; flat < 2; ++flat ) {
+    if ( flat == 0 ) G2lib::noFlatAABBtree();
+    else             G2lib::yesFlatAABBtree();
+    for ( int_type k = 0; k < 3; ++k ) {
+      real_type o1 = 1.75*(k-1), o2 = -1.75*(k-1);
+      G2lib::IntersectList il;
+      A.intersect_ISO( o1, B, o2, il, false );
+      unique_sorted( il, 1e-8 );
+
+      CollectAll any, ord;
+      bool s1 = A.intersect_visit_ISO( o1, B, o2, any );
+      bool s2 = A.intersect_visit_ISO( o1, B, o2, ord, true );
+      sort( any.ilist.begin(), any.ilist.end() );
+      bool okk = !s1 && !s2 && !il.empty() &&
+                 same( any.ilist, il ) && same( ord.ilist, il );
+
+      // the first 5 along the path
+      G2lib::IntersectList first5;
+      G2lib::IntersectFirstK K5( 5, first5 );
+      okk = okk && A.intersect_visit_ISO( o1, B, o2, K5, true ) &&
+            same( first5, G2lib::IntersectList( il.begin(), il.begin()+5 ) );
+      if ( !okk ) cout << "offsets " << o1 << ", " << o2 << "  FAILED\n";
+      ok = ok && okk;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // the first crossing along the path
+  {
+    int_type const NR = 20;
+    G2lib::IntersectList il;
+    tictoc.tic();
+    for ( int_type r = 0; r < NR; ++r ) {
+      il.clear();
+      A.intersect_ISO( 1.75, B, 0, il, false );
+    }
+    tictoc.toc();
+    real_type t_all = tictoc.elapsed_ms()/NR;
+    real_type smin = 1e100;
+    for ( size_t i = 0; i < il.size(); ++i ) smin = min( smin, il[i].first );
+
+    First f;
+    tictoc.tic();
+    for ( int_type r = 0; r < NR; ++r ) A.intersect_visit_ISO( 1.75, B, 0, f, true );
+    tictoc.toc();
+    real_type t_ord = tictoc.elapsed_ms()/NR;
+    bool okk = abs( f.s1-smin ) < 1e-8;
+
+    tictoc.tic();
+    for ( int_type r = 0; r < NR; ++r ) A.intersect_visit_ISO( 1.75, B, 0, f );
+    tictoc.toc();
+    real_type t_any = tictoc.elapsed_ms()/NR;
+
+    cout
+      << il.size() << " intersections\n"
+      << "  intersect_ISO, all                 " << setw(10) << t_all << " [ms]\n"
+      << "  intersect_visit_ISO, first along s " << setw(10) << t_ord << " [ms]"
+      << ( okk ? "" : "  FAILED" ) << '\n'
+      << "  intersect_visit_ISO, any           " << setw(10) << t_any << " [ms]\n";
+    ok = ok && okk;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // a crossing at the joint of two segments is visited once
+  {
+    real_type x[] = { 0, 1, 2 }, y[] = { 0, 0, 0 };
+    G2lib::ClothoidList H, V;
+    H.build_G1( 3, x, y );
+    V.push_back_G1( 1, -1, G2lib::m_pi/2, 1, 1, G2lib::m_pi/2 );
+    G2lib::IntersectList il;
+    H.intersect_ISO( 0, V, 0, il, false );
+    CollectAll c1, c2;
+    H.intersect_visit_ISO( 0, V, 0, c1 );
+    H.intersect_visit_ISO( 0, V, 0, c2, true );
+    bool okk = c1.ilist.size() == 1 && c2.ilist.size() == 1 &&
+               abs( c1.ilist[0].first-1 ) < 1e-8 && abs( c1.ilist[0].second-1 ) < 1e-8;
+    cout
+      << "crossing at a joint: " << il.size() << " by intersect_ISO, "
+      << c1.ilist.size() << " visited" << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // the other curves through G2lib::intersect_visit_ISO
+  {
+    G2lib::Biarc B1( 0, 0, 0.5, 10, 0, -0.5 );
+    G2lib::Biarc B2( 0, 1, -0.5, 10, -1, 0.5 );
+    G2lib::IntersectList il;
+    B1.intersect_ISO( 0, B2, 0, il, false );
+    unique_sorted( il, 1e-8 );
+    CollectAll c;
+    G2lib::intersect_visit_ISO( B1, 0, B2, 0, c, true );
+    G2lib::IntersectList one;
+    G2lib::IntersectFirstK K1( 1, one );
+    bool stopped = B1.intersect_visit_ISO( 0, B2, 0, K1, true );
+    bool okk = !il.empty() && same( c.ilist, il ) && stopped &&
+               one.size() == 1 && same( one, G2lib::IntersectList( 1, il.front() ) );
+    cout
+      << "two biarcs: " << c.ilist.size() << " intersections visited"
+      << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  if ( !ok ) {
+    cout << "\n\nINTERSECT VISIT FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,270 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static unsigned seed = 4321u;
+
+static
+real_type
+rnd() {
+  seed = seed*1664525u + 1013904223u;
+  return real_type(seed>>8)/real_type(1u<<24);
+}
+
+// the segments by increasing distance (brute force)
+static
+void
+brute_force(
+  G2lib::ClothoidList const & CL,
+  real_type                   qx,
+  real_type                   qy,
+  real_type                   offs,
+  vector<pair<real_type,int_type> > & res
+) {
+  res.clear();
+  for ( int_type i = 0; i < CL.numSegment(); ++i ) {
+    real_type x, y, s, t, d;
+    CL.get(i).closestPoint_ISO( qx, qy, offs, x, y, s, t, d );
+    res.push_back( pair<real_type,int_type>( d, i ) );
+  }
+  sort( res.begin(), res.end() );
+}
+
+static
+void
+brute_force(
+  G2lib::PolyLine const & PL,
+  real_type               qx,
+  real_type               qy,
+  vector<pair<real_type,int_type> > & res
+) {
+  res.clear();
+  for ( int_type i = 0; i < PL.numSegment(); ++i ) {
+    real_type x, y, s, t, d;
+    PL.getSegment(i).closestPoint_ISO( qx, qy, x, y, s, t, d );
+    res.push_back( pair<real_type,int_type>( d, i ) );
+  }
+  sort( res.begin(), res.end() );
+}
+
+// k nearest and radius queries against the brute force
+static
+int_type
+check(
+  G2lib::ClothoidList const & CL,
+  real_type                   offs,
+  vector<real_type>   const & qx,
+  vector<real_type>   const & qy
+) {
+  int_type nbad = 0;
+  vector<pair<real_type,int_type> > bf;
+  vector<int_type>  iseg;
+  vector<real_type> s, dst;
+  for ( size_t i = 0; i < qx.size(); ++i ) {
+    brute_force( CL, qx[i], qy[i], offs, bf );
+    CL.nearestSegments_ISO( qx[i], qy[i], offs, 5, 1e100, iseg, s, dst );
+    if ( iseg.size() != 5 ) ++nbad;
+    for ( size_t j = 0; j < iseg.size(); ++j ) {
+      if ( abs( dst[j] - bf[j].first ) > 1e-8 ) ++nbad;
+      // the abscissa is on the segment (or at its ends) at the right
+      // distance, up to the tolerance of the projection on the offset curve
+      real_type x, y;
+      CL.eval_ISO( s[j], offs, x, y );
+      if ( abs( hypot( x-qx[i], y-qy[i] ) - dst[j] ) > 1e-5 ||
+           abs( CL.findAtS( s[j] ) - iseg[j] ) > 1 ) ++nbad;
+    }
+    CL.segmentsWithin_ISO( qx[i], qy[i], offs, 20, iseg, s, dst );
+    size_t nin = 0;
+    while ( nin < bf.size() && bf[nin].first <= 20 ) ++nin;
+    if ( iseg.size() != nin ) ++nbad;
+    real_type d;
+    CL.distanceField_ISO( offs, 1, &qx[i], &qy[i], 20, &d );
+    if ( abs( d - min( bf[0].first, real_type(20) ) ) > 1e-8 ) ++nbad;
+  }
+  return nbad;
+}
+
+int
+main() {
+
+  bool ok = true;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // a winding road (offsets below the radius of curvature)
+  int_type const NP = 401;
+  vector<real_type> xp(NP), yp(NP);
+  for ( int_type i = 0; i < NP; ++i ) {
+    real_type t = i*0.1;
+    xp[i] = 10*t + 10*sin(0.4*t);
+    yp[i] = 40*sin(0.3*t) + 10*cos(1.1*t);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( NP, &xp.front(), &yp.front() );
+  G2lib::PolyLine PL;
+  PL.build( CL, 0.01 );
+
+  real_type xmin, ymin, xmax, ymax;
+  CL.bbox( xmin, ymin, xmax, ymax );
+  int_type const NQ = 300;
+  vector<real_type> qx(NQ), qy(NQ);
+  for ( int_type i = 0; i < NQ; ++i ) {
+    qx[i] = xmin - 20 + (xmax-xmin+40)*rnd();
+    qy[i] = ymin - 20 + (ymax-ymin+40)*rnd();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  {
+    int_type nbad = 0;
+    G2lib::noFlatAABBtree();
+    nbad += check( CL, 0, qx, qy );
+    nbad += check( CL, 2, qx, qy );
+    G2lib::yesFlatAABBtree();
+    nbad += check( CL, 0, qx, qy );
+    nbad += check( CL, -2, qx, qy );
+    CL.prepare_AABBtree_ISO( 1.5 );
+    nbad += check( CL, 1.5, qx, qy );
+    cout << "ClothoidList, " << CL.numSegment() << " segments: "
+         << nbad << " differences from the brute force\n";
+    ok = ok && nbad == 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  {
+    int_type nbad = 0;
+    vector<pair<real_type,int_type> > bf;
+    vector<int_type>  iseg;
+    vector<real_type> s, dst;
+    for ( int_type flat = 0; flat < 2; ++flat ) {
+      if ( flat == 0 ) G2lib::noFlatAABBtree();
+      else             G2lib::yesFlatAABBtree();
+      G2lib::PolyLine P( PL );
+      for ( int_type i = 0; i < NQ; ++i ) {
+        brute_force( P, qx[i], qy[i], bf );
+        P.nearestSegments( qx[i], qy[i], 5, 1e100, iseg, s, dst );
+        if ( iseg.size() != 5 ) ++nbad;
+        for ( size_t j = 0; j < iseg.size(); ++j ) {
+          real_type x, y;
+          P.eval( s[j], x, y );
+          if ( abs( dst[j] - bf[j].first ) > 1e-8 ||
+               abs( hypot( x-qx[i], y-qy[i] ) - dst[j] ) > 1e-8 ) ++nbad;
+        }
+        P.segmentsWithin( qx[i], qy[i], 20, iseg, s, dst );
+        size_t nin = 0;
+        while ( nin < bf.size() && bf[nin].first <= 20 ) ++nin;
+        if ( iseg.size() != nin ) ++nbad;
+        real_type d;
+        P.distanceField( 1, &qx[i], &qy[i], 20, &d );
+        if ( abs( d - min( bf[0].first, real_type(20) ) ) > 1e-8 ) ++nbad;
+      }
+    }
+    cout << "PolyLine, " << PL.numSegment() << " segments: "
+         << nbad << " differences from the brute force\n";
+    ok = ok && nbad == 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // costmap: distance clipped at 5 on a grid of 0.5 covering the road
+  {
+    real_type const h = 0.5, dmax = 5;
+    int_type nx = int_type( (xmax-xmin+20)/h );
+    int_type ny = int_type( (ymax-ymin+20)/h );
+    vector<real_type> gx, gy;
+    gx.reserve( size_t(nx*ny) );
+    gy.reserve( size_t(nx*ny) );
+    for ( int_type j = 0; j < ny; ++j ) {
+      for ( int_type i = 0; i < nx; ++i ) {
+        gx.push_back( xmin-10+i*h );
+        gy.push_back( ymin-10+j*h );
+      }
+    }
+    int_type n = int_type(gx.size());
+    vector<real_type> d0( gx.size() ), d1( gx.size() ), d2( gx.size() ), d3( gx.size() );
+    TicToc tictoc;
+
+    tictoc.tic();
+    for ( int_type i = 0; i < n; ++i ) {
+      real_type x, y, s, t, d;
+      CL.closestPoint_ISO( gx[i], gy[i], x, y, s, t, d );
+      d0[i] = min( d, dmax );
+    }
+    tictoc.toc();
+    real_type t_cp = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    CL.distanceField_ISO( 0, n, &gx.front(), &gy.front(), dmax, &d1.front() );
+    tictoc.toc();
+    real_type t_df = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    for ( int_type i = 0; i < n; ++i ) {
+      real_type x, y, s, t, d;
+      PL.closestPoint_ISO( gx[i], gy[i], x, y, s, t, d );
+      d2[i] = min( d, dmax );
+    }
+    tictoc.toc();
+    real_type t_pcp = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    PL.distanceField( n, &gx.front(), &gy.front(), dmax, &d3.front() );
+    tictoc.toc();
+    real_type t_pdf = tictoc.elapsed_ms();
+
+    real_type e1 = 0, e2 = 0;
+    for ( int_type i = 0; i < n; ++i ) {
+      e1 = max( e1, abs( d0[i]-d1[i] ) );
+      e2 = max( e2, abs( d2[i]-d3[i] ) );
+    }
+    cout
+      << "\ncostmap " << nx << " x " << ny << ", distance clipped at " << dmax << '\n'
+      << "  ClothoidList closestPoint_ISO " << setw(10) << t_cp  << " [ms]\n"
+      << "  ClothoidList distanceField_ISO" << setw(10) << t_df  << " [ms]"
+      << "  max difference " << e1 << '\n'
+      << "  PolyLine     closestPoint_ISO " << setw(10) << t_pcp << " [ms]\n"
+      << "  PolyLine     distanceField    " << setw(10) << t_pdf << " [ms]"
+      << "  max difference " << e2 << '\n';
+    ok = ok && e1 < 1e-8 && e2 < 1e-8;
+
+    // radius query: segments of the road within 10 of the points
+    vector<int_type>  iseg;
+    vector<real_type> s, dst;
+    size_t nf1 = 0, nf2 = 0;
+    tictoc.tic();
+    for ( int_type i = 0; i < n; i += 97 ) {
+      for ( int_type k = 0; k < CL.numSegment(); ++k ) {
+        real_type x, y, ss, t, d;
+        CL.get(k).closestPoint_ISO( gx[i], gy[i], x, y, ss, t, d );
+        if ( d <= 10 ) ++nf1;
+      }
+    }
+    tictoc.toc();
+    real_type t_bf = tictoc.elapsed_ms();
+    tictoc.tic();
+    for ( int_type i = 0; i < n; i += 97 ) {
+      CL.segmentsWithin_ISO( gx[i], gy[i], 0, 10, iseg, s, dst );
+      nf2 += iseg.size();
+    }
+    tictoc.toc();
+    real_type t_sw = tictoc.elapsed_ms();
+    cout
+      << "  segments within 10, loop on the segments " << setw(10) << t_bf << " [ms]\n"
+      << "  segments within 10, segmentsWithin_ISO   " << setw(10) << t_sw << " [ms]"
+      << ( nf1 == nf2 ? "" : "  FAILED" ) << '\n';
+    ok = ok && nf1 == nf2;
+  }
+
+  if ( !ok ) {
+    cout << "\n\nNEAREST FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,169 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// length of the offset curve by a fine polygon
+static
+real_type
+polygon_length( G2lib::ClothoidList const & CL, real_type offs, int_type n ) {
+  real_type L = 0, x0, y0, x1, y1;
+  CL.eval_ISO( 0, offs, x0, y0 );
+  for ( int_type i = 1; i <= n; ++i ) {
+    CL.eval_ISO( (i*CL.length())/n, offs, x1, y1 );
+    L += hypot( x1-x0, y1-y0 );
+    x0 = x1; y0 = y1;
+  }
+  return L;
+}
+
+int
+main() {
+
+  // a road centerline and its lane boundaries
+  int_type const NP = 401;
+  vector<real_type> xp(NP), yp(NP);
+  for ( int_type i = 0; i < NP; ++i ) {
+    real_type t = i*0.05;
+    xp[i] = 20*t;
+    yp[i] = 30*sin(0.3*t) + 3*sin(1.1*t);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( NP, &xp.front(), &yp.front() );
+
+  int_type const NL = 4;
+  real_type lanes[NL] = { -5.25, -1.75, 1.75, 5.25 };
+  vector<G2lib::ClothoidListOffset*> V(NL);
+  for ( int_type k = 0; k < NL; ++k )
+    V[k] = new G2lib::ClothoidListOffset( CL, lanes[k] );
+
+  bool ok = true;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // offset length and conversion of the abscissae
+  cout << "ClothoidList, " << CL.numSegment() << " segments, length " << CL.length() << '\n';
+  for ( int_type k = 0; k < NL; ++k ) {
+    G2lib::ClothoidListOffset const & W = *V[k];
+    real_type Lp = polygon_length( CL, lanes[k], 200000 );
+    real_type el = abs( W.length()-Lp )/Lp;
+    real_type es = 0;
+    for ( int_type i = 0; i <= 1000; ++i ) {
+      real_type s = (i*CL.length())/1000;
+      es = max( es, abs( W.sList( W.sOffset( s ) ) - s ) );
+    }
+    // the bounding box contains the offset curve (up to rounding)
+    real_type xmin, ymin, xmax, ymax;
+    W.bbox( xmin, ymin, xmax, ymax );
+    xmin -= 1e-9; ymin -= 1e-9; xmax += 1e-9; ymax += 1e-9;
+    bool inside = true;
+    for ( int_type i = 0; i <= 1000; ++i ) {
+      real_type x, y;
+      W.eval( (i*CL.length())/1000, x, y );
+      inside = inside && x >= xmin && x <= xmax && y >= ymin && y <= ymax;
+    }
+    bool okk = el < 1e-8 && es < 1e-9 && inside &&
+               abs( W.length()-CL.length_ISO( lanes[k] ) ) < 1e-9;
+    cout
+      << "offs = " << setw(5) << lanes[k]
+      << "  length " << setw(10) << W.length()
+      << " (polygon " << Lp << ")"
+      << "  sList(sOffset(s)) error " << es
+      << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // closest point: same result of ClothoidList::closestPoint_ISO
+  int_type const NQ = 20000;
+  vector<real_type> qx(NQ), qy(NQ);
+  unsigned seed = 1234u;
+  for ( int_type i = 0; i < NQ; ++i ) {
+    seed = seed*1664525u + 1013904223u;
+    real_type s = CL.length()*real_type(seed>>8)/real_type(1u<<24);
+    seed = seed*1664525u + 1013904223u;
+    real_type d = 16*real_type(seed>>8)/real_type(1u<<24)-8;
+    real_type x, y;
+    CL.eval_ISO( s, d, x, y );
+    qx[i] = x; qy[i] = y;
+  }
+  real_type ed = 0;
+  for ( int_type i = 0; i < NQ; i += 10 ) {
+    for ( int_type k = 0; k < NL; ++k ) {
+      real_type x1, y1, s1, t1, d1, x2, y2, s2, t2, d2;
+      CL.closestPoint_ISO( qx[i], qy[i], lanes[k], x1, y1, s1, t1, d1 );
+      V[k]->closestPoint( qx[i], qy[i], x2, y2, s2, t2, d2 );
+      ed = max( ed, abs( d1-d2 ) );
+    }
+  }
+  cout << "\nclosestPoint, max difference from closestPoint_ISO " << ed << '\n';
+  ok = ok && ed < 1e-10;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // intersections with a crossing road
+  G2lib::ClothoidList CR;
+  real_type xr[] = { 100, 130, 160, 190 };
+  real_type yr[] = { -60, -10, 30, 80 };
+  CR.build_G1( 4, xr, yr );
+  G2lib::ClothoidListOffset VR( CR, 1.75 );
+  int_type ni = 0;
+  for ( int_type k = 0; k < NL; ++k ) {
+    G2lib::IntersectList il1, il2;
+    CL.intersect_ISO( lanes[k], CR, 1.75, il1, false );
+    V[k]->intersect( VR, il2 );
+    bool okk = il1.size() == il2.size() && V[k]->collision( VR ) == !il2.empty();
+    for ( size_t j = 0; okk && j < il1.size(); ++j )
+      okk = abs( il1[j].first-il2[j].first ) < 1e-10 &&
+            abs( il1[j].second-il2[j].second ) < 1e-10;
+    ni += int_type(il2.size());
+    ok = ok && okk;
+  }
+  cout << "intersect with a crossing road, " << ni << " intersections\n";
+  ok = ok && ni > 0;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // distance of each query point from the four lane boundaries
+  TicToc    tictoc;
+  real_type sum1 = 0, sum2 = 0;
+  int_type  const NT = 2000;
+
+  tictoc.tic();
+  for ( int_type i = 0; i < NT; ++i ) {
+    for ( int_type k = 0; k < NL; ++k ) {
+      real_type x, y, s, t, d;
+      CL.closestPoint_ISO( qx[i], qy[i], lanes[k], x, y, s, t, d );
+      sum1 += d;
+    }
+  }
+  tictoc.toc();
+  real_type t_list = tictoc.elapsed_ms();
+
+  tictoc.tic();
+  for ( int_type i = 0; i < NT; ++i )
+    for ( int_type k = 0; k < NL; ++k )
+      sum2 += V[k]->distance( qx[i], qy[i] );
+  tictoc.toc();
+  real_type t_view = tictoc.elapsed_ms();
+
+  cout
+    << "\n" << NL << " lane boundaries, " << NT << " query points\n"
+    << "ClothoidList::closestPoint_ISO " << 1000*t_list/(NT*NL) << " [us/query]"
+    << ", ClothoidListOffset::closestPoint " << 1000*t_view/(NT*NL) << " [us/query]\n";
+  ok = ok && abs( sum1-sum2 ) <= 1e-8*sum1;
+
+  for ( int_type k = 0; k < NL; ++k ) delete V[k];
+
+  if ( !ok ) {
+    cout << "\n\nOFFSET VIEW FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
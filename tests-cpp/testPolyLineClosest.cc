@@ -0,0 +1,225 @@
+//#define _USE_MATH_DEFINES
+#include "PolyLine.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static unsigned seed = 2718u;
+
+static
+real_type
+rnd() {
+  seed = seed*1664525u + 1013904223u;
+  return real_type(seed>>8)/real_type(1u<<24);
+}
+
+// the closest point by a loop on all the segments
+static
+real_type
+linear_scan( G2lib::PolyLine const & PL, real_type qx, real_type qy, real_type & s ) {
+  real_type dmin = 1e100;
+  real_type s0   = 0;
+  for ( int_type i = 0; i < PL.numSegment(); ++i ) {
+    G2lib::LineSegment const & L = PL.getSegment(i);
+    real_type x, y, ss, t, d;
+    L.closestPoint_ISO( qx, qy, x, y, ss, t, d );
+    if ( d < dmin ) { dmin = d; s = s0 + ss; }
+    s0 += L.length();
+  }
+  return dmin;
+}
+
+int
+main() {
+
+  bool ok = true;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // a lane border extracted from a lidar scan: 200k noisy points, 10cm apart
+  int_type const NP = 200001;
+  vector<real_type> xp(NP), yp(NP);
+  real_type x = 0, y = 0;
+  for ( int_type i = 0; i < NP; ++i ) {
+    real_type th = 0.6*sin(i*2e-5) + 0.1*sin(i*3.1e-3);
+    x    += 0.1*cos(th);
+    y    += 0.1*sin(th);
+    xp[i] = x + 0.005*(rnd()-0.5);
+    yp[i] = y + 0.005*(rnd()-0.5);
+  }
+  G2lib::PolyLine PL;
+  PL.build( &xp.front(), &yp.front(), NP );
+  real_type xmin, ymin, xmax, ymax;
+  PL.bbox( xmin, ymin, xmax, ymax );
+  cout << "PolyLine, " << PL.numSegment() << " segments\n";
+
+  TicToc tictoc;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // random points (no coherence) in the box of the polyline
+  {
+    int_type const NQ = 200;
+    vector<real_type> qx(NQ), qy(NQ), d0(NQ), d1(NQ), s0(NQ), s1(NQ);
+    for ( int_type i = 0; i < NQ; ++i ) {
+      qx[i] = xmin + (xmax-xmin)*rnd();
+      qy[i] = ymin + (ymax-ymin)*rnd();
+    }
+    tictoc.tic();
+    for ( int_type i = 0; i < NQ; ++i ) d0[i] = linear_scan( PL, qx[i], qy[i], s0[i] );
+    tictoc.toc();
+    real_type t_scan = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    PL.prepare_AABBtree();
+    tictoc.toc();
+    real_type t_build = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    for ( int_type i = 0; i < NQ; ++i ) {
+      real_type xx, yy, t;
+      PL.closestPoint_ISO( qx[i], qy[i], xx, yy, s1[i], t, d1[i] );
+    }
+    tictoc.toc();
+    real_type t_tree = tictoc.elapsed_ms();
+
+    real_type err = 0;
+    for ( int_type i = 0; i < NQ; ++i ) err = max( err, abs( d0[i]-d1[i] ) );
+    cout
+      << "random points, tree built in " << t_build << " [ms]\n"
+      << "  linear scan      " << setw(10) << 1000*t_scan/NQ << " [us/query]\n"
+      << "  closestPoint_ISO " << setw(10) << 1000*t_tree/NQ << " [us/query]"
+      << "  max difference " << err << '\n';
+    ok = ok && err < 1e-12;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // a vehicle driving along the lane: consecutive points are near
+  {
+    int_type const NQ = 20000;
+    real_type L = PL.length();
+    vector<real_type> qx(NQ), qy(NQ);
+    for ( int_type i = 0; i < NQ; ++i ) {
+      real_type s = (L*i)/NQ;
+      PL.eval_ISO( s, 1.75 + 0.3*sin(s*0.05), qx[i], qy[i] );
+    }
+    int_type const NS = 50; // linear scan on a few of them
+    vector<real_type> d0(NS);
+    tictoc.tic();
+    for ( int_type j = 0; j < NS; ++j ) {
+      real_type s;
+      d0[j] = linear_scan( PL, qx[j*(NQ/NS)], qy[j*(NQ/NS)], s );
+    }
+    tictoc.toc();
+    real_type t_scan = tictoc.elapsed_ms();
+
+    // thread hint
+    vector<real_type> d1(NQ), s1(NQ);
+    tictoc.tic();
+    for ( int_type i = 0; i < NQ; ++i ) {
+      real_type xx, yy, t;
+      PL.closestPoint_ISO( qx[i], qy[i], xx, yy, s1[i], t, d1[i] );
+    }
+    tictoc.toc();
+    real_type t_tree = tictoc.elapsed_ms();
+
+    real_type err = 0, smax = 0;
+    for ( int_type j = 0; j < NS; ++j ) err = max( err, abs( d0[j]-d1[j*(NQ/NS)] ) );
+
+    // caller owned hint, findST_ISO and distance
+    int_type  iseg = 0;
+    real_type e2   = 0;
+    for ( int_type i = 0; i < NQ; ++i ) {
+      real_type xx, yy, s, t, d, s2, t2;
+      PL.closestPoint_ISO( qx[i], qy[i], xx, yy, s, t, d, iseg );
+      PL.findST_ISO( qx[i], qy[i], s2, t2 );
+      e2   = max( e2, abs( d-d1[i] ) + abs( s-s1[i] ) + abs( s2-s1[i] ) );
+      e2   = max( e2, abs( PL.distance( qx[i], qy[i] ) - d1[i] ) );
+      smax = max( smax, abs( s-(L*i)/NQ ) );
+    }
+    cout
+      << "points along the lane\n"
+      << "  linear scan      " << setw(10) << 1000*t_scan/NS << " [us/query]\n"
+      << "  closestPoint_ISO " << setw(10) << 1000*t_tree/NQ << " [us/query]"
+      << "  max difference " << err << ", abscissa error " << smax << '\n';
+    ok = ok && err < 1e-12 && e2 < 1e-12 && smax < 0.5;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // short polylines and both trees agree with the linear scan
+  {
+    int_type nbad = 0;
+    for ( int_type flat = 0; flat < 2; ++flat ) {
+      if ( flat == 0 ) G2lib::noFlatAABBtree();
+      else             G2lib::yesFlatAABBtree();
+      for ( int_type n = 2; n < 40; ++n ) {
+        G2lib::PolyLine P;
+        P.build( &xp.front()+100*n, &yp.front()+100*n, n );
+        for ( int_type k = 0; k < 20; ++k ) {
+          real_type qx = xp[100*n] + 10*(rnd()-0.5);
+          real_type qy = yp[100*n] + 10*(rnd()-0.5);
+          real_type xx, yy, s, t, d, s0;
+          P.closestPoint_ISO( qx, qy, xx, yy, s, t, d );
+          if ( abs( d - linear_scan( P, qx, qy, s0 ) ) > 1e-12 ) ++nbad;
+        }
+      }
+    }
+    cout << "short polylines: " << nbad << " differences from the linear scan\n";
+    ok = ok && nbad == 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // many threads on polylines not prepared: the first calls build the trees
+  {
+    int_type const NQ = 4000;
+    int_type const NT = 4;
+    vector<real_type> qx(NQ), qy(NQ), d0(NQ), d1(NQ), s0(NQ), s1(NQ);
+    vector<int_type>  ncross(NT);
+    for ( int_type i = 0; i < NQ; ++i ) {
+      qx[i] = xmin + (xmax-xmin)*rnd();
+      qy[i] = ymin + (ymax-ymin)*rnd();
+      real_type xx, yy, t;
+      PL.closestPoint_ISO( qx[i], qy[i], xx, yy, s0[i], t, d0[i] );
+    }
+    G2lib::PolyLine PU, PX;
+    PU.build( &xp.front(), &yp.front(), NP );
+    // a segment across the polyline in the middle of its box
+    real_type xc = (xmin+xmax)/2;
+    real_type xx[] = { xc, xc }, yx[] = { ymin-1, ymax+1 };
+    PX.build( xx, yx, 2 );
+    vector<thread> workers;
+    for ( int_type k = 0; k < NT; ++k )
+      workers.push_back( thread( [&,k] {
+        vector<real_type> sa, sb;
+        PU.intersect( PX, sa, sb );
+        ncross[k] = int_type(sa.size()) + ( PX.collision( PU ) ? 1 : 0 );
+        for ( int_type i = k; i < NQ; i += NT ) {
+          real_type xx, yy, t;
+          PU.closestPoint_ISO( qx[i], qy[i], xx, yy, s1[i], t, d1[i] );
+          d1[i] = max( d1[i], PU.distance( qx[i], qy[i] ) );
+        }
+      } ) );
+    for ( int_type k = 0; k < NT; ++k ) workers[k].join();
+    real_type err = 0;
+    for ( int_type i = 0; i < NQ; ++i )
+      err = max( err, abs( d0[i]-d1[i] ) + abs( s0[i]-s1[i] ) );
+    bool okk = err < 1e-12 && ncross[0] > 1;
+    for ( int_type k = 1; k < NT; ++k ) okk = okk && ncross[k] == ncross[0];
+    cout
+      << NT << " threads on polylines not prepared, max difference " << err
+      << ", " << ncross[0]-1 << " crossings" << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  if ( !ok ) {
+    cout << "\n\nPOLYLINE CLOSEST POINT FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
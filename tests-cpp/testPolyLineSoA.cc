@@ -0,0 +1,223 @@
+//#define _USE_MATH_DEFINES
+#include "PolyLine.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+static unsigned seed = 31415u;
+
+static
+real_type
+rnd() {
+  seed = seed*1664525u + 1013904223u;
+  return real_type(seed>>8)/real_type(1u<<24);
+}
+
+int
+main() {
+
+  bool ok = true;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // a trajectory of 1M vertices: y = sin(x) with some noise
+  int_type const NP = 1000000;
+  vector<real_type> xp(NP), yp(NP);
+  for ( int_type i = 0; i < NP; ++i ) {
+    xp[i] = i*1e-3;
+    yp[i] = sin(xp[i]) + 1e-4*(rnd()-0.5);
+  }
+
+  TicToc tictoc;
+
+  G2lib::PolyLine PL;
+  tictoc.tic();
+  PL.build( &xp.front(), &yp.front(), NP );
+  tictoc.toc();
+  real_type t_build = tictoc.elapsed_ms();
+
+  // the segments as separate objects, as they were stored before
+  tictoc.tic();
+  vector<G2lib::LineSegment> segs;
+  vector<real_type>          ss;
+  segs.reserve( size_t(PL.numSegment()) );
+  ss.reserve( size_t(PL.numSegment()) );
+  for ( int_type i = 0; i < PL.numSegment(); ++i ) {
+    segs.push_back( PL.getSegment(i) );
+    ss.push_back( PL.sVertices()[i] );
+  }
+  tictoc.toc();
+  real_type t_segs = tictoc.elapsed_ms();
+
+  size_t n        = size_t(NP);
+  size_t mem_segs = sizeof(G2lib::LineSegment)*(n-1) + sizeof(real_type)*n;
+  size_t mem_soa  = 3*sizeof(real_type)*n;
+  cout
+    << "PolyLine of " << NP << " vertices\n"
+    << "  memory: vector of LineSegment " << setw(6) << mem_segs/(1024*1024)
+    << " [MB], vertex arrays " << setw(6) << mem_soa/(1024*1024) << " [MB]\n"
+    << "  build:  vector of LineSegment " << setw(10) << t_segs
+    << " [ms], vertex arrays " << setw(10) << t_build << " [ms]\n";
+  ok = ok && mem_soa < mem_segs;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // bounding box
+  {
+    real_type xmin0 = 1e100, ymin0 = 1e100, xmax0 = -1e100, ymax0 = -1e100;
+    tictoc.tic();
+    for ( size_t i = 0; i < segs.size(); ++i ) {
+      real_type x0, y0, x1, y1;
+      segs[i].bbox( x0, y0, x1, y1 );
+      xmin0 = min( xmin0, x0 ); ymin0 = min( ymin0, y0 );
+      xmax0 = max( xmax0, x1 ); ymax0 = max( ymax0, y1 );
+    }
+    tictoc.toc();
+    real_type t_segs = tictoc.elapsed_ms();
+
+    real_type xmin, ymin, xmax, ymax;
+    tictoc.tic();
+    PL.bbox( xmin, ymin, xmax, ymax );
+    tictoc.toc();
+    real_type t_soa = tictoc.elapsed_ms();
+
+    bool okk = xmin == xmin0 && ymin == ymin0 && xmax == xmax0 && ymax == ymax0;
+    cout
+      << "  bbox:   vector of LineSegment " << setw(10) << t_segs
+      << " [ms], vertex arrays " << setw(10) << t_soa << " [ms]"
+      << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // closest segment by a linear scan (no AABB tree)
+  {
+    int_type const NQ = 20;
+    vector<real_type> qx(NQ), qy(NQ);
+    for ( int_type i = 0; i < NQ; ++i ) {
+      qx[i] = 1000*rnd();
+      qy[i] = 3*rnd()-1.5;
+    }
+    vector<real_type> d0(NQ), d1(NQ);
+    vector<int_type>  i0(NQ), i1(NQ);
+    tictoc.tic();
+    for ( int_type k = 0; k < NQ; ++k ) {
+      d0[k] = 1e100;
+      for ( size_t i = 0; i < segs.size(); ++i ) {
+        real_type x, y, s, t, d;
+        segs[i].closestPoint_ISO( qx[k], qy[k], x, y, s, t, d );
+        if ( d < d0[k] ) { d0[k] = d; i0[k] = int_type(i); }
+      }
+    }
+    tictoc.toc();
+    real_type t_segs = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    for ( int_type k = 0; k < NQ; ++k )
+      i1[k] = PL.closestSegment( qx[k], qy[k], 0, PL.numSegment(), d1[k] );
+    tictoc.toc();
+    real_type t_soa = tictoc.elapsed_ms();
+
+    real_type err = 0;
+    for ( int_type k = 0; k < NQ; ++k ) err = max( err, abs( d0[k]-d1[k] ) );
+    cout
+      << "  scan:   vector of LineSegment " << setw(10) << 1000*t_segs/NQ
+      << " [us], vertex arrays " << setw(10) << 1000*t_soa/NQ << " [us]"
+      << "  max difference " << err << '\n';
+    ok = ok && err < 1e-12;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // intersection with a polyline crossing the trajectory
+  {
+    real_type xs[] = { -1, 250, 500, 750, 1001 };
+    real_type ys[] = { 0.3, 0.3, 0.3, 0.3, 0.3 };
+    G2lib::PolyLine PL2;
+    PL2.build( xs, ys, 5 );
+
+    // the crossings counted on the vertices
+    size_t nc = 0;
+    for ( int_type i = 1; i < NP; ++i )
+      if ( (yp[i-1]-0.3)*(yp[i]-0.3) < 0 ) ++nc;
+
+    vector<real_type> s1, s2;
+    tictoc.tic();
+    for ( size_t i = 0; i < segs.size(); ++i ) {
+      for ( int_type j = 0; j < PL2.numSegment(); ++j ) {
+        real_type a, b;
+        if ( segs[i].intersect( PL2.getSegment(j), a, b ) ) s1.push_back( ss[i]+a );
+      }
+    }
+    tictoc.toc();
+    real_type t_segs = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    PL.prepare_AABBtree();
+    tictoc.toc();
+    real_type t_tree = tictoc.elapsed_ms();
+
+    vector<real_type> s3, s4;
+    tictoc.tic();
+    PL.intersect( PL2, s3, s4 );
+    tictoc.toc();
+    real_type t_soa = tictoc.elapsed_ms();
+
+    sort( s1.begin(), s1.end() );
+    sort( s3.begin(), s3.end() );
+    bool okk = s1.size() == nc && s3.size() == nc;
+    for ( size_t i = 0; okk && i < nc; ++i ) okk = abs( s1[i]-s3[i] ) < 1e-9;
+    cout
+      << "  intersect (" << nc << " crossings, AABB tree built in " << t_tree << " [ms])\n"
+      << "          vector of LineSegment " << setw(10) << t_segs
+      << " [ms], vertex arrays " << setw(10) << t_soa << " [ms]"
+      << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // touching and collinear segments: the same crossings of all the pairs
+  {
+    int_type const NZ = 201;
+    vector<real_type> xz(NZ), yz(NZ), xw(NZ), yw(NZ);
+    for ( int_type i = 0; i < NZ; ++i ) {
+      xz[i] = i;     yz[i] = i%2;         // zig zag between y = 0 and y = 1
+      xw[i] = i/2.0; yw[i] = (i/4)%2 == 0 ? 0 : 0.5; // on the vertices and along y = 0
+    }
+    G2lib::PolyLine PZ, PW;
+    PZ.build( &xz.front(), &yz.front(), NZ );
+    PW.build( &xw.front(), &yw.front(), NZ );
+    vector<real_type> sa, sb;
+    for ( int_type i = 0; i+1 < NZ; ++i ) {
+      for ( int_type j = 0; j+1 < NZ; ++j ) {
+        real_type a, b;
+        if ( G2lib::segmentIntersect(
+               xz[i], yz[i], xz[i+1], yz[i+1], xw[j], yw[j], xw[j+1], yw[j+1], a, b
+             ) ) {
+          sa.push_back( PZ.sVertices()[i]+a );
+          sb.push_back( PW.sVertices()[j]+b );
+        }
+      }
+    }
+    vector<real_type> sc, sd;
+    PZ.intersect( PW, sc, sd );
+    sort( sa.begin(), sa.end() ); sort( sb.begin(), sb.end() );
+    sort( sc.begin(), sc.end() ); sort( sd.begin(), sd.end() );
+    bool okk = !sa.empty() && sa == sc && sb == sd;
+    cout
+      << "  touching and collinear: " << sc.size() << " intersections, "
+      << sa.size() << " by all the pairs" << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  if ( !ok ) {
+    cout << "\n\nPOLYLINE SOA FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
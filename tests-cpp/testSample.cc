@@ -0,0 +1,199 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "BiarcList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// distance of (px,py) from the segment (ax,ay)-(bx,by)
+static
+real_type
+segment_distance(
+  real_type px, real_type py,
+  real_type ax, real_type ay,
+  real_type bx, real_type by
+) {
+  real_type dx = bx-ax, dy = by-ay;
+  real_type d2 = dx*dx+dy*dy;
+  real_type t  = d2 > 0 ? ((px-ax)*dx+(py-ay)*dy)/d2 : 0;
+  t = max( real_type(0), min( real_type(1), t ) );
+  return hypot( px-ax-t*dx, py-ay-t*dy );
+}
+
+// maximum distance of the offset curve from the chords of the samples,
+// the curve is checked on `nsub` points inside each chord
+static
+real_type
+chord_error(
+  G2lib::BaseCurve    const & C,
+  real_type                   offs,
+  G2lib::CurveSamples const & S,
+  int_type                    nsub
+) {
+  real_type err = 0;
+  for ( size_t i = 0; i+1 < S.size(); ++i ) {
+    for ( int_type j = 1; j < nsub; ++j ) {
+      real_type s = S.s[i] + ((S.s[i+1]-S.s[i])*j)/nsub;
+      real_type px, py;
+      C.eval_ISO( s, offs, px, py );
+      err = max( err, segment_distance( px, py, S.x[i], S.y[i], S.x[i+1], S.y[i+1] ) );
+    }
+  }
+  return err;
+}
+
+// samples sorted from 0 to L, points on the curve, error below `tol`
+static
+bool
+check(
+  char             const * name,
+  G2lib::BaseCurve const & C,
+  real_type                offs,
+  real_type                tol
+) {
+  G2lib::CurveSamples S;
+  C.sample_ISO( offs, tol, S );
+  bool ok = S.size() >= 2 && S.s.front() == 0 && S.s.back() == C.length();
+  real_type perr = 0;
+  for ( size_t i = 0; ok && i < S.size(); ++i ) {
+    if ( i > 0 ) ok = S.s[i] > S.s[i-1];
+    real_type x, y;
+    C.eval_ISO( S.s[i], offs, x, y );
+    perr = max( perr, hypot( x-S.x[i], y-S.y[i] ) );
+  }
+  real_type err = chord_error( C, offs, S, 64 );
+  ok = ok && perr < 1e-10 && err <= tol*(1+1e-6);
+  cout
+    << setw(14) << left << name << right
+    << " offs = " << setw(5) << offs
+    << " tol = " << setw(6) << tol
+    << setw(8) << S.size() << " points, max error/tol = "
+    << setprecision(3) << err/tol << setprecision(6)
+    << ( ok ? "" : "  FAILED" ) << '\n';
+  return ok;
+}
+
+int
+main() {
+
+  bool ok = true;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // every curve type
+  G2lib::LineSegment   LS( 0, 0, 0.3, 10 );
+  G2lib::CircleArc     CA( 0, 0, 0.3, 0.4, 10 );
+  G2lib::Biarc         BA( 0, 0, 0.3, 4, 1, -1.2 );
+  G2lib::ClothoidCurve CC( 0, 0, 0.3, -0.4, 0.1, 12 ); // flex inside
+  G2lib::ClothoidCurve CF( 0, 0, 0.3, 0, 0.5, 5 );     // flex at the start
+
+  int_type const NP = 41;
+  vector<real_type> xp(NP), yp(NP);
+  for ( int_type i = 0; i < NP; ++i ) {
+    real_type t = i*0.25;
+    xp[i] = 2*t;
+    yp[i] = 2*sin(t) + 0.3*sin(5*t);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( NP, &xp.front(), &yp.front() );
+  G2lib::BiarcList BL;
+  BL.build_G1( NP, &xp.front(), &yp.front() );
+  G2lib::PolyLine PL;
+  PL.build( &xp.front(), &yp.front(), NP );
+
+  G2lib::BaseCurve const * curves[] = { &LS, &CA, &BA, &CC, &CF, &CL, &BL, &PL };
+  char const * names[] = {
+    "LineSegment", "CircleArc", "Biarc", "ClothoidCurve", "Clothoid flex",
+    "ClothoidList", "BiarcList", "PolyLine"
+  };
+  real_type offsets[] = { 0, 0.2, -0.2 };
+  real_type tols[]    = { 1e-2, 1e-4 };
+  // the offset of a polyline is not continuous at the vertices
+  for ( int_type ic = 0; ic < 8; ++ic )
+    for ( int_type io = 0; io < ( ic == 7 ? 1 : 3 ); ++io )
+      for ( int_type it = 0; it < 2; ++it )
+        ok = check( names[ic], *curves[ic], offsets[io], tols[it] ) && ok;
+
+  // offset at the radius of curvature: the offset curve has cusps
+  {
+    G2lib::CircleArc     C1( 0, 0, 0, 0.5, 6 );      // all of it in the center
+    G2lib::ClothoidCurve C2( 0, 0, 0, 0.1, 0.1, 8 ); // kappa*offs = 1 at s = 4
+    G2lib::BaseCurve const * cusp[] = { &C1, &C2 };
+    bool okk = true;
+    for ( int_type k = 0; k < 2; ++k ) {
+      G2lib::CurveSamples S;
+      cusp[k]->sample_ISO( 2, 1e-3, S );
+      okk = okk && S.size() >= 2 && S.s.back() == cusp[k]->length();
+      for ( size_t i = 0; okk && i < S.size(); ++i )
+        okk = isfinite( S.x[i] ) && isfinite( S.y[i] ) && isfinite( S.kappa[i] );
+    }
+    cout << "offset through the center of curvature" << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // number of points and time compared with PolyLine::build, which uses
+  // uniform steps from the maximum curvature of each clothoid
+  cout << "\nClothoidList, " << CL.numSegment() << " segments\n";
+  for ( int_type it = 0; it < 2; ++it ) {
+    real_type tol = tols[it];
+    G2lib::PolyLine P;
+    P.build( CL, tol );
+    G2lib::CurveSamples S;
+    CL.sample_ISO( 0, tol, S );
+    // distance of the curve from the polyline
+    size_t nv = size_t(P.numSegment()+1);
+    vector<real_type> xv(nv), yv(nv);
+    P.polygon( &xv.front(), &yv.front() );
+    real_type err = 0;
+    for ( int_type i = 0; i <= 20000; ++i ) {
+      real_type x, y;
+      CL.eval( (i*CL.length())/20000, x, y );
+      real_type dst = segment_distance( x, y, xv[0], yv[0], xv[1], yv[1] );
+      for ( size_t j = 1; j+1 < nv; ++j )
+        dst = min( dst, segment_distance( x, y, xv[j], yv[j], xv[j+1], yv[j+1] ) );
+      err = max( err, dst );
+    }
+    cout
+      << "tol = " << setw(6) << tol
+      << "  PolyLine::build " << setw(6) << P.numSegment()+1 << " points"
+      << " (max error/tol = " << setprecision(3) << err/tol << ")"
+      << ", sample_ISO " << setw(6) << S.size() << " points"
+      << " (max error/tol = " << chord_error( CL, 0, S, 64 )/tol << ")\n"
+      << setprecision(6);
+    ok = ok && S.size() <= nv;
+  }
+
+  G2lib::CurveSamples S;
+  int_type const NREP = 200;
+  TicToc tictoc;
+  real_type tol = 1e-4;
+
+  tictoc.tic();
+  for ( int_type k = 0; k < NREP; ++k ) {
+    G2lib::PolyLine P;
+    P.build( CL, tol );
+  }
+  tictoc.toc();
+  real_type t_poly = tictoc.elapsed_ms()/NREP;
+
+  tictoc.tic();
+  for ( int_type k = 0; k < NREP; ++k ) CL.sample_ISO( 0, tol, S );
+  tictoc.toc();
+  real_type t_sample = tictoc.elapsed_ms()/NREP;
+
+  cout << "PolyLine::build " << t_poly << " [ms]"
+       << ", sample_ISO (s,x,y,theta,kappa) " << t_sample << " [ms]\n";
+
+  if ( !ok ) {
+    cout << "\n\nSAMPLE FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,206 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "PolyLine.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// the crossings of a polyline by comparing all the pairs of segments
+static
+void
+brute_force( G2lib::PolyLine const & PL, G2lib::IntersectList & il ) {
+  real_type const * x = PL.xVertices();
+  real_type const * y = PL.yVertices();
+  real_type const * s = PL.sVertices();
+  int_type n = PL.numSegment();
+  for ( int_type i = 0; i < n; ++i ) {
+    for ( int_type j = i+2; j < n; ++j ) {
+      real_type a, b;
+      if ( G2lib::segmentIntersect(
+             x[i], y[i], x[i+1], y[i+1], x[j], y[j], x[j+1], y[j+1], a, b
+           ) )
+        il.push_back( G2lib::Ipair( s[i]+a, s[j]+b ) );
+    }
+  }
+  sort( il.begin(), il.end() );
+}
+
+// the two abscissa of each crossing are the same point and s1 < s2
+static
+bool
+check(
+  G2lib::BaseCurve    const & C,
+  real_type                   offs,
+  G2lib::IntersectList const & il
+) {
+  for ( size_t i = 0; i < il.size(); ++i ) {
+    real_type x1, y1, x2, y2;
+    C.eval_ISO( il[i].first,  offs, x1, y1 );
+    C.eval_ISO( il[i].second, offs, x2, y2 );
+    if ( hypot( x2-x1, y2-y1 ) > 1e-6 ) return false;
+    if ( il[i].first >= il[i].second ) return false;
+    if ( i > 0 && il[i-1].first > il[i].first ) return false;
+  }
+  return true;
+}
+
+int
+main() {
+
+  bool ok = true;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // a prolate cycloid with NL loops, each loop crosses itself once
+  int_type const NL  = 200;
+  int_type const NPL = 40; // points per loop
+  int_type const NP  = NL*NPL+1;
+  vector<real_type> xp(NP), yp(NP);
+  for ( int_type i = 0; i < NP; ++i ) {
+    real_type t = G2lib::m_pi + (2*G2lib::m_pi*i)/NPL;
+    xp[i] = t - 2*sin(t);
+    yp[i] = -2*cos(t);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( NP, &xp.front(), &yp.front() );
+  G2lib::PolyLine PL;
+  PL.build( &xp.front(), &yp.front(), NP );
+
+  // an open curve without loops and a closed circle
+  vector<real_type> xo(NP), yo(NP), xc(NPL+1), yc(NPL+1);
+  for ( int_type i = 0; i < NP; ++i ) {
+    real_type t = (2*G2lib::m_pi*i)/NPL;
+    xo[i] = t - 0.5*sin(t);
+    yo[i] = -0.5*cos(t);
+  }
+  for ( int_type i = 0; i < NPL; ++i ) {
+    xc[i] = cos( (2*G2lib::m_pi*i)/NPL );
+    yc[i] = sin( (2*G2lib::m_pi*i)/NPL );
+  }
+  xc[NPL] = xc[0]; yc[NPL] = yc[0];
+  G2lib::ClothoidList CLo, CLc;
+  CLo.build_G1( NP, &xo.front(), &yo.front() );
+  CLc.build_G1( NPL+1, &xc.front(), &yc.front() );
+  G2lib::PolyLine PLo, PLc;
+  PLo.build( &xo.front(), &yo.front(), NP );
+  PLc.build( &xc.front(), &yc.front(), NPL+1 );
+
+  TicToc tictoc;
+
+  for ( int_type flat = 0; flat < 2; ++flat ) {
+    if ( flat == 0 ) G2lib::noFlatAABBtree();
+    else             G2lib::yesFlatAABBtree();
+    cout << ( flat == 0 ? "AABBtree\n" : "AABBtreeFlat\n" );
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // ClothoidList: one crossing per loop, also at an offset
+    for ( int_type k = 0; k < 3; ++k ) {
+      real_type offs = 0.2*(k-1);
+      G2lib::IntersectList il;
+      CL.self_intersect_ISO( offs, il );
+      bool okk = il.size() == size_t(NL) && check( CL, offs, il ) &&
+                 CL.self_collision_ISO( offs );
+      cout
+        << "  ClothoidList, offset " << setw(5) << offs << ": "
+        << il.size() << " crossings" << ( okk ? "" : "  FAILED" ) << '\n';
+      ok = ok && okk;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // PolyLine: the same crossings of all the pairs of segments
+    {
+      G2lib::IntersectList il, bf;
+      PL.self_intersect( il );
+      brute_force( PL, bf );
+      bool okk = il.size() == size_t(NL) && bf.size() == size_t(NL) &&
+                 check( PL, 0, il ) && PL.self_collision();
+      for ( size_t i = 0; okk && i < il.size(); ++i )
+        okk = abs( il[i].first-bf[i].first ) < 1e-9 &&
+              abs( il[i].second-bf[i].second ) < 1e-9;
+      cout
+        << "  PolyLine: " << il.size() << " crossings, "
+        << bf.size() << " by all the pairs" << ( okk ? "" : "  FAILED" ) << '\n';
+      ok = ok && okk;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // no crossings: an open curve without loops and a closed circle
+    {
+      G2lib::IntersectList il;
+      CLo.self_intersect( il );
+      CLc.self_intersect( il );
+      PLo.self_intersect( il );
+      PLc.self_intersect( il );
+      bool okk = il.empty() &&
+                 !CLo.self_collision() && !CLc.self_collision() &&
+                 !CLc.self_collision_ISO( 0.1 ) &&
+                 !PLo.self_collision() && !PLc.self_collision();
+      cout << "  no crossings" << ( okk ? "" : "  FAILED" ) << '\n';
+      ok = ok && okk;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // the tree prepared for the offset
+  {
+    G2lib::ClothoidList CP( CL );
+    CP.prepare_AABBtree_ISO( 0.2 );
+    G2lib::IntersectList il;
+    CP.self_intersect_ISO( 0.2, il );
+    bool okk = il.size() == size_t(NL) && check( CP, 0.2, il ) &&
+               CP.self_collision_ISO( 0.2 );
+    cout << "prepared tree: " << il.size() << " crossings" << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // timing: the curve against itself and the self traversal
+  {
+    int_type const NR = 5;
+    G2lib::IntersectList il;
+    tictoc.tic();
+    for ( int_type r = 0; r < NR; ++r ) {
+      il.clear();
+      CL.intersect( CL, il, false );
+    }
+    tictoc.toc();
+    real_type t_two = tictoc.elapsed_ms()/NR;
+    size_t n_two = il.size();
+
+    tictoc.tic();
+    for ( int_type r = 0; r < NR; ++r ) {
+      il.clear();
+      CL.self_intersect( il );
+    }
+    tictoc.toc();
+    real_type t_self = tictoc.elapsed_ms()/NR;
+
+    tictoc.tic();
+    bool hit = false;
+    for ( int_type r = 0; r < NR; ++r ) hit = CL.self_collision();
+    tictoc.toc();
+    real_type t_coll = tictoc.elapsed_ms()/NR;
+
+    cout
+      << "\nClothoidList of " << CL.numSegment() << " segments, "
+      << il.size() << " crossings\n"
+      << "  intersect( itself )  " << setw(10) << t_two << " [ms] ("
+      << n_two << " points, also the trivial ones)\n"
+      << "  self_intersect       " << setw(10) << t_self << " [ms]\n"
+      << "  self_collision       " << setw(10) << t_coll << " [ms]\n";
+    ok = ok && hit;
+  }
+
+  if ( !ok ) {
+    cout << "\n\nSELF INTERSECT FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,158 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+typedef G2lib::ClothoidSplineG2 Spline;
+
+// points on a road (open) or on a wavy closed loop
+static
+void
+points( int_type n, bool closed, vector<real_type> & x, vector<real_type> & y ) {
+  x.resize(n); y.resize(n);
+  for ( int_type i = 0; i < n; ++i ) {
+    if ( closed ) {
+      real_type t = (G2lib::m_2pi*i)/(n-1);
+      real_type r = n*(1+0.05*sin(5*t));
+      x[i] = r*cos(t);
+      y[i] = 0.7*r*sin(t);
+    } else {
+      x[i] = 2*i + 0.3*sin(i*0.7);
+      y[i] = 20*sin(i*0.02) + 2*sin(i*0.15);
+    }
+  }
+  if ( closed ) { x[n-1] = x[0]; y[n-1] = y[0]; }
+}
+
+// maximum curvature jump of the spline (relative to the maximum curvature)
+static
+real_type
+kappa_jump( G2lib::ClothoidList const & C, bool closed ) {
+  real_type err = 0, kmax = 0;
+  int_type  ns  = C.numSegment();
+  for ( int_type i = 0; i < ns; ++i ) {
+    G2lib::ClothoidCurve const & c = C.get(i);
+    kmax = max( kmax, max( abs(c.kappaBegin()), abs(c.kappaEnd()) ) );
+    if ( i+1 < ns ) err = max( err, abs(c.kappaEnd()-C.get(i+1).kappaBegin()) );
+  }
+  if ( closed ) err = max( err, abs(C.get(ns-1).kappaEnd()-C.get(0).kappaBegin()) );
+  return err/max(kmax,real_type(1e-300));
+}
+
+int
+main() {
+
+  char const * names[] = { "", "P1", "P2", "P3", "P4", "P5", "P6", "P7", "P8", "P9" };
+  int_type const sizes[] = { 100, 1000, 10000, 100000 };
+  bool ok = true;
+
+  cout << "   N target   iter  inner  jump          time [ms]\n";
+  for ( int_type is = 0; is < 4; ++is ) {
+    int_type n = sizes[is];
+    for ( int_type itt = 1; itt <= 9; ++itt ) {
+      if ( itt == 3 ) continue; // P3 has no target
+      // the optimization targets are timed up to 10000 points
+      if ( itt > 3 && n > 10000 ) continue;
+      bool closed = itt == 2;
+      vector<real_type> x, y;
+      points( n, closed, x, y );
+      Spline S;
+      S.build( &x.front(), &y.front(), n );
+      switch ( itt ) {
+      case 1: S.setP1( atan2(y[1]-y[0],x[1]-x[0]), atan2(y[n-1]-y[n-2],x[n-1]-x[n-2]) ); break;
+      case 2: S.setP2(); break;
+      case 4: S.setP4(); break;
+      case 5: S.setP5(); break;
+      case 6: S.setP6(); break;
+      case 7: S.setP7(); break;
+      case 8: S.setP8(); break;
+      case 9: S.setP9(); break;
+      }
+      G2lib::ClothoidList C;
+      TicToc tictoc;
+      tictoc.tic();
+      bool conv = S.solve( C );
+      tictoc.toc();
+      real_type jmp = kappa_jump( C, closed );
+      cout
+        << setw(6) << n << "   " << names[itt]
+        << setw(7) << S.numIterations()
+        << setw(7) << S.numInnerIterations()
+        << setw(12) << jmp
+        << setw(14) << tictoc.elapsed_ms()
+        << ( conv ? "" : "  NOT CONVERGED" ) << '\n';
+      if ( !conv || jmp > 1e-6 ) ok = false;
+    }
+  }
+
+  // the solution of P4-P9 is a minimum: moving the initial angle
+  // (and projecting on the curvature continuity with P1) the target grows
+  int_type n = 100;
+  vector<real_type> x, y;
+  points( n, false, x, y );
+  for ( int_type itt = 4; itt <= 9; ++itt ) {
+    Spline S, S1;
+    S.build( &x.front(), &y.front(), n );
+    S1.build( &x.front(), &y.front(), n );
+    switch ( itt ) {
+    case 4: S.setP4(); break;
+    case 5: S.setP5(); break;
+    case 6: S.setP6(); break;
+    case 7: S.setP7(); break;
+    case 8: S.setP8(); break;
+    case 9: S.setP9(); break;
+    }
+    vector<real_type> theta(n), tmin(n), tmax(n), theta1;
+    S.guess( &theta.front(), &tmin.front(), &tmax.front() );
+    S.solve( &theta.front() );
+    real_type F, F1;
+    S.objective( &theta.front(), F );
+    bool is_min = true;
+    for ( int_type k = 0; k < 4; ++k ) {
+      real_type d0 = k == 0 ? 1e-3 : ( k == 1 ? -1e-3 : 0 );
+      real_type d1 = k == 2 ? 1e-3 : ( k == 3 ? -1e-3 : 0 );
+      theta1 = theta;
+      S1.setP1( theta[0]+d0, theta[n-1]+d1 );
+      S1.solve( &theta1.front() );
+      S.objective( &theta1.front(), F1 );
+      if ( F1 < F ) is_min = false;
+    }
+    cout << names[itt] << " target " << F << " minimum = " << is_min << '\n';
+    if ( !is_min ) ok = false;
+  }
+
+  // warm start from the previous solution
+  {
+    points( 10000, false, x, y );
+    Spline S;
+    S.build( &x.front(), &y.front(), 10000 );
+    S.setP7();
+    vector<real_type> theta(10000), tmin(10000), tmax(10000);
+    S.guess( &theta.front(), &tmin.front(), &tmax.front() );
+    S.solve( &theta.front() );
+    for ( int_type i = 0; i < 10000; ++i ) y[i] += 0.01*sin(i*0.1);
+    S.build( &x.front(), &y.front(), 10000 );
+    TicToc tictoc;
+    tictoc.tic();
+    bool conv = S.solve( &theta.front() );
+    tictoc.toc();
+    cout << "P7, 10000 points moved, warm start: " << S.numIterations()
+         << " iterations " << tictoc.elapsed_ms() << " [ms]\n";
+    if ( !conv ) ok = false;
+  }
+
+  if ( !ok ) {
+    cout << "\n\nClothoidSplineG2 solve FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}
@@ -0,0 +1,216 @@
+//#define _USE_MATH_DEFINES
+#include "ClothoidList.hh"
+#include "TicToc.hh"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using G2lib::real_type;
+using G2lib::int_type;
+using namespace std;
+
+// the text export of `ClothoidList::export_table` read by the stream operators
+static
+int_type
+stream_table( istream & stream, vector<real_type> c[6] ) {
+  string line;
+  getline( stream, line ); // header
+  real_type v[6];
+  int_type  n = 0;
+  while ( stream >> v[0] >> v[1] >> v[2] >> v[3] >> v[4] >> v[5] ) {
+    for ( int_type k = 0; k < 6; ++k ) c[k].push_back( v[k] );
+    ++n;
+  }
+  return n;
+}
+
+static
+bool
+same_list( G2lib::ClothoidList const & A, G2lib::ClothoidList const & B ) {
+  if ( A.numSegment() != B.numSegment() ) return false;
+  for ( int_type i = 0; i < A.numSegment(); ++i ) {
+    G2lib::ClothoidCurve const & a = A.get(i);
+    G2lib::ClothoidCurve const & b = B.get(i);
+    if ( a.xBegin()     != b.xBegin()     ||
+         a.yBegin()     != b.yBegin()     ||
+         a.thetaBegin() != b.thetaBegin() ||
+         a.kappaBegin() != b.kappaBegin() ||
+         a.dkappa()     != b.dkappa()     ||
+         a.length()     != b.length() ) return false;
+  }
+  return true;
+}
+
+int
+main() {
+
+  bool ok = true;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // the fast parser gives the same doubles of strtod
+  {
+    int_type nbad = 0, ntot = 0;
+    unsigned seed = 4321u;
+    char buf[64];
+    for ( int_type i = 0; i < 200000; ++i ) {
+      seed = seed*1664525u + 1013904223u;
+      real_type v = real_type(seed) / 4294967296.0;
+      seed = seed*1664525u + 1013904223u;
+      v = ( seed & 1 ? -v : v ) * pow( 10.0, int_type(seed>>8)%40-20 );
+      seed = seed*1664525u + 1013904223u;
+      int_type prec = 1+int_type(seed>>8)%17;
+      snprintf( buf, sizeof(buf), "%.*g\n", int(prec), v );
+      vector<real_type> c[1];
+      istringstream is( buf );
+      G2lib::read_table( is, 1, c );
+      ++ntot;
+      if ( c[0].size() != 1 || c[0][0] != strtod( buf, nullptr ) ) ++nbad;
+    }
+    cout << "parser versus strtod, " << nbad << " differences of " << ntot << '\n';
+    ok = ok && nbad == 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // points with header, commas, comments and CRLF
+  {
+    istringstream is(
+      "x, y\r\n"
+      "# a comment\r\n"
+      "0, 0\r\n"
+      "\r\n"
+      "10 , 0 , 1\r\n"
+      "10;10\r\n"
+      "  0\t10\r\n"
+      "0, 20"
+    );
+    vector<real_type> x, y;
+    int_type n = G2lib::read_points( is, x, y );
+    real_type xe[] = { 0, 10, 10, 0, 0 };
+    real_type ye[] = { 0, 0, 10, 10, 20 };
+    bool okk = n == 5 && x.size() == 5;
+    for ( int_type i = 0; okk && i < n; ++i ) okk = x[i] == xe[i] && y[i] == ye[i];
+    G2lib::ClothoidList CL;
+    okk = okk && CL.build_G1( n, &x.front(), &y.front() );
+
+    // a bad row is an error, the columns are unchanged
+    int_type nerr = 0;
+    istringstream bad( "x y\n1 2\n3 x\n" );
+    try { G2lib::read_points( bad, x, y ); }
+    catch ( exception const & e ) { ++nerr; cout << "expected error: " << e.what() << '\n'; }
+    okk = okk && nerr == 1 && x.size() == 5;
+
+    // a short row or a blank field is an error, not merged with the next row
+    char const * shortrows[] = {
+      "1 2\n3\n4 5\n6 7\n",
+      "1 2\n3,\n4 5\n",
+      "1 2\n3, ,\n4 5\n",
+      "1 2\n , 4\n5 6\n",
+      "1 2\n3 \t"
+    };
+    for ( int_type k = 0; k < 5; ++k ) {
+      istringstream sr( shortrows[k] );
+      vector<real_type> xs, ys;
+      try { G2lib::read_points( sr, xs, ys ); }
+      catch ( exception const & ) { ++nerr; }
+    }
+    // the same in one of the parts of the parallel parser
+    {
+      string big;
+      for ( int_type i = 0; i < 20000; ++i ) big += i == 12345 ? "3\n" : "1.5 2.5\n";
+      istringstream sr( big );
+      vector<real_type> xs, ys;
+      try { G2lib::read_points( sr, xs, ys, 4 ); }
+      catch ( exception const & ) { ++nerr; }
+    }
+    // numbers left to strtod
+    {
+      istringstream sr( "1e400 -inf\nnan 1.00000000000000000000001\n" );
+      vector<real_type> xs, ys;
+      G2lib::read_points( sr, xs, ys );
+      okk = okk && xs.size() == 2 && isinf( xs[0] ) && isinf( ys[0] ) && ys[0] < 0 &&
+            isnan( xs[1] ) && ys[1] == 1;
+    }
+    okk = okk && nerr == 7;
+    cout << "CSV points, " << n << " rows" << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // round trip of a large list
+  int_type const NP = 1000001;
+  vector<real_type> xp(NP), yp(NP);
+  for ( int_type i = 0; i < NP; ++i ) {
+    real_type t = i*0.002;
+    xp[i] = 10*t;
+    yp[i] = 5*sin(t) + 0.5*sin(7*t);
+  }
+  G2lib::ClothoidList CL;
+  CL.build_G1( NP, &xp.front(), &yp.front() );
+
+  TicToc tictoc;
+  int_type const prec[] = { 6, 17 };
+  cout << "\nClothoidList, " << CL.numSegment() << " segments\n";
+  for ( int_type ip = 0; ip < 2; ++ip ) {
+    ostringstream text;
+    text.precision( prec[ip] );
+    CL.export_table( text );
+    string stext = text.str();
+
+    vector<real_type> c0[6], c1[6], c4[6];
+    tictoc.tic();
+    istringstream is0( stext );
+    int_type n0 = stream_table( is0, c0 );
+    tictoc.toc();
+    real_type t_stream = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    istringstream is1( stext );
+    int_type n1 = G2lib::read_table( is1, 6, c1 );
+    tictoc.toc();
+    real_type t_fast = tictoc.elapsed_ms();
+
+    tictoc.tic();
+    istringstream is4( stext );
+    int_type n4 = G2lib::read_table( is4, 6, c4, 4 );
+    tictoc.toc();
+    real_type t_fast4 = tictoc.elapsed_ms();
+
+    bool okk = n0 == CL.numSegment() && n1 == n0 && n4 == n0;
+    for ( int_type k = 0; okk && k < 6; ++k ) okk = c0[k] == c1[k] && c1[k] == c4[k];
+
+    tictoc.tic();
+    istringstream isl( stext );
+    G2lib::ClothoidList CL2;
+    CL2.import_table( isl );
+    tictoc.toc();
+    real_type t_import = tictoc.elapsed_ms();
+    if ( prec[ip] == 17 ) okk = okk && same_list( CL, CL2 );
+    else                  okk = okk && CL2.numSegment() == CL.numSegment();
+
+    cout
+      << "precision " << setw(2) << prec[ip] << ", "
+      << stext.size()/1048576.0 << " MB\n"
+      << "  operator >>       " << setw(8) << t_stream << " [ms] "
+      << setw(12) << int_type(1000*n0/t_stream) << " [rows/s]\n"
+      << "  read_table        " << setw(8) << t_fast << " [ms] "
+      << setw(12) << int_type(1000*n1/t_fast) << " [rows/s]\n"
+      << "  read_table, 4 thr " << setw(8) << t_fast4 << " [ms] "
+      << setw(12) << int_type(1000*n4/t_fast4) << " [rows/s]\n"
+      << "  import_table      " << setw(8) << t_import << " [ms]"
+      << ( okk ? "" : "  FAILED" ) << '\n';
+    ok = ok && okk;
+  }
+
+  if ( !ok ) {
+    cout << "\n\nTABLE IMPORT FAILED\n";
+    return 1;
+  }
+  cout << "\n\nALL DONE FOLKS!!!\n";
+  return 0;
+}